@@ -81,6 +81,11 @@ extern "C"
 
 #ifdef WITH_BWT
 #define CA_DEFAULT_BLOCK_SIZE       CA_BLOCK_SIZE_1024_BYTE
+
+/**
+ * Max number of Block2 requests kept in flight by a pipelined block-wise transfer
+ */
+#define CA_MAX_BLOCK_PIPELINE_DEPTH (16)
 #endif
 
 /**
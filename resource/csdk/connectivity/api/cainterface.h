@@ -61,6 +61,38 @@ typedef void (*CAResponseCallback)(const CAEndpoint_t *object,
  */
 typedef void (*CAErrorCallback)(const CAEndpoint_t *object,
                                 const CAErrorInfo_t *errorInfo);
+
+#ifdef WITH_BWT
+/**
+ * Callback function type for the blocks of a block-wise transfer, delivered as they arrive.
+ * @param[out]   object         Endpoint object from which the block is received.
+ * @param[out]   info           Info of the request or response the block belongs to.
+ * @param[out]   offset         Offset of the block in the payload. It restarts from 0 when
+ *                              the transfer is restarted after a lost block.
+ * @param[out]   block          Payload of the block.
+ * @param[out]   blockLength    Length of the block.
+ * @param[out]   totalLength    Length of the whole payload, 0 if the peer did not send it.
+ * @return  true if the callback consumes the payload. When it is returned for the first block,
+ *          the next blocks of the transfer are given to the callback too, and the request
+ *          or response is delivered without payload once the last block is received.
+ */
+typedef bool (*CABlockReceivedCallback)(const CAEndpoint_t *object, const CAInfo_t *info,
+                                        size_t offset, const uint8_t *block,
+                                        size_t blockLength, size_t totalLength);
+
+/**
+ * Statistics of a block-wise transfer.
+ */
+typedef struct
+{
+    size_t payloadLength;       /**< payload bytes sent or received in blocks */
+    uint32_t blocks;            /**< number of blocks sent or received */
+    uint32_t lostBlocks;        /**< number of blocks lost or received out of order */
+    CABlockSize_t blockSize;    /**< block size at the end of the transfer */
+    uint64_t elapsedTime;       /**< duration of the transfer in microseconds */
+    uint64_t throughput;        /**< payload bytes per second */
+} CABlockWiseStats_t;
+#endif
 #ifdef RA_ADAPTER
 
 /**
@@ -137,6 +169,40 @@ CAResult_t CAStartDiscoveryServer();
 void CARegisterHandler(CARequestCallback ReqHandler, CAResponseCallback RespHandler,
                        CAErrorCallback ErrorHandler);
 
+#ifdef WITH_BWT
+/**
+ * Register a callback receiving the blocks of block-wise transfers as they arrive,
+ *          so that large payloads like firmware images need not be held in memory.
+ * @param[in]   BlockHandler    Block callback, NULL to reassemble all payloads.
+ * @return  ::CA_STATUS_OK or ::CA_STATUS_NOT_INITIALIZED
+ * @see     CABlockReceivedCallback
+ */
+CAResult_t CARegisterBlockReceivedHandler(CABlockReceivedCallback BlockHandler);
+
+/**
+ * Set the number of Block2 requests a client keeps in flight while it receives a block-wise
+ *          response, so that high latency links are not paid once per block. Pipelining
+ *          starts once the first block told the payload length, and needs servers answering
+ *          each request with the block it asks for. 1, the default, requests a block once
+ *          the previous one is received.
+ * @param[in]   depth    Number of requests in flight, up to ::CA_MAX_BLOCK_PIPELINE_DEPTH.
+ * @return  ::CA_STATUS_OK, ::CA_STATUS_INVALID_PARAM or ::CA_STATUS_NOT_INITIALIZED
+ */
+CAResult_t CASetBlockWisePipelineDepth(uint8_t depth);
+
+/**
+ * Get the statistics of a block-wise transfer, in progress or among the last completed ones.
+ * @param[in]   object         Remote endpoint of the transfer.
+ * @param[in]   token          Token of the request or response transferred.
+ * @param[in]   tokenLength    Length of the token.
+ * @param[out]  stats          Statistics of the transfer.
+ * @return  ::CA_STATUS_OK, ::CA_STATUS_INVALID_PARAM, ::CA_STATUS_NOT_INITIALIZED or
+ *          ::CA_STATUS_FAILED if the transfer is unknown.
+ */
+CAResult_t CAGetBlockWiseStats(const CAEndpoint_t *object, const CAToken_t token,
+                               uint8_t tokenLength, CABlockWiseStats_t *stats);
+#endif
+
 /**
  * Create an endpoint description.
  * @param[in]   flags                 how the adapter should be used.
@@ -33,6 +33,7 @@
 #include "camutex.h"
 #include "uarraylist.h"
 #include "cacommon.h"
+#include "cainterface.h"
 #include "caprotocolmessage.h"
 
 /**
@@ -66,6 +67,21 @@ typedef struct
 
     /** sender mutex for synchronization. **/
     ca_mutex blockDataSenderMutex;
+
+    /** buckets of the block data in dataList, hashed by block ID. **/
+    struct CABlockData **index;
+
+    /** number of buckets of the index. **/
+    size_t indexSize;
+
+    /** number of block data in the index. **/
+    size_t indexCount;
+
+    /** callback receiving the blocks as they arrive. **/
+    CABlockReceivedCallback blockReceivedCallback;
+
+    /** number of Block2 requests a client keeps in flight, 0 or 1 not to pipeline. **/
+    uint8_t pipelineDepth;
 } CABlockWiseContext_t;
 
 /**
@@ -80,7 +96,7 @@ typedef struct
 /**
  * Block Data Set.
  */
-typedef struct
+typedef struct CABlockData
 {
     coap_block_t block1;                /**< block1 option. */
     coap_block_t block2;                /**< block2 option. */
@@ -90,6 +106,23 @@ typedef struct
     CAPayload_t payload;                /**< payload buffer. */
     size_t payloadLength;               /**< the total payload length to be received. */
     size_t receivedPayloadLen;          /**< currently received payload length. */
+    size_t payloadCapacity;             /**< allocated length of the payload buffer. */
+    bool streamed;                      /**< blocks are given to the block callback
+                                             instead of being reassembled. */
+    struct CABlockData *indexNext;      /**< next block data in the same index bucket. */
+    uint8_t pipelineDepth;              /**< Block2 requests kept in flight, 0 when the
+                                             requests are not pipelined. */
+    uint32_t nextBlockNum;              /**< next block number to request when pipelined. */
+    uint32_t receivedBlocks;            /**< blocks received from block2.num on when
+                                             pipelined, one bit per block. */
+    uint32_t queuedBlockNums[CA_MAX_BLOCK_PIPELINE_DEPTH]; /**< block numbers of the
+                                             queued block2 messages, in sending order. */
+    uint8_t queuedBlockHead;            /**< index of the first queued block number. */
+    uint8_t queuedBlockCount;           /**< number of queued block numbers. */
+    bool lastBlockSent;                 /**< last response block is sent. */
+    uint32_t retriedBlockNum;           /**< block requested again when pipelined, plus 1. */
+    uint64_t startTime;                 /**< start of the transfer in microseconds. */
+    CABlockWiseStats_t stats;           /**< statistics of the transfer. */
 } CABlockData_t;
 
 /**
@@ -109,7 +142,8 @@ typedef enum
     CA_SENT_PREVIOUS_NON_MSG,
     CA_BLOCK_INCOMPLETE,
     CA_BLOCK_TOO_LARGE,
-    CA_BLOCK_RECEIVED_ALREADY
+    CA_BLOCK_RECEIVED_ALREADY,
+    CA_OPTION2_PIPELINED
 } CABlockState_t;
 
 #ifdef __cplusplus
@@ -132,6 +166,28 @@ CAResult_t CAInitializeBlockWiseTransfer(CASendThreadFunc blockSendMethod,
  */
 CAResult_t CATerminateBlockWiseTransfer();
 
+/**
+ * Set the callback receiving the blocks of the transfers as they arrive.
+ * @param[in]   callback    block callback, NULL to reassemble all payloads.
+ */
+void CASetBlockReceivedCallback(CABlockReceivedCallback callback);
+
+/**
+ * Set the number of Block2 requests a client keeps in flight.
+ * @param[in]   depth       number of requests, from 1 to ::CA_MAX_BLOCK_PIPELINE_DEPTH.
+ * @return ::CASTATUS_OK or ::CA_STATUS_INVALID_PARAM.
+ */
+CAResult_t CASetBlockPipelineDepth(uint8_t depth);
+
+/**
+ * Get the statistics of a transfer in progress or among the last completed ones.
+ * @param[in]   blockID     ID set of the transfer.
+ * @param[out]  stats       statistics of the transfer.
+ * @return ::CASTATUS_OK or ::CA_STATUS_FAILED if the transfer is unknown.
+ */
+CAResult_t CAGetBlockWiseTransferStats(const CABlockDataID_t *blockID,
+                                       CABlockWiseStats_t *stats);
+
 /**
  * initialize mutex.
  * @return ::CASTATUS_OK or ERROR CODES (::CAResult_t error codes in cacommon.h).
@@ -200,6 +256,13 @@ CAResult_t CAProcessNextStep(const coap_pdu_t *pdu, const CAData_t *receivedData
 CAResult_t CASendBlockMessage(const coap_pdu_t *pdu, CAMessageType_t msgType,
                               uint8_t status, const CABlockDataID_t *blockID);
 
+/**
+ * send the block2 requests of a pipelined transfer up to its depth.
+ * @param[in]   blockID     ID set of CABlockData.
+ * @return ::CASTATUS_OK or ERROR CODES (::CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CASendPipelinedBlockRequests(const CABlockDataID_t *blockID);
+
 /**
  * send error message to remote device.
  * @param[in]   pdu    received pdu binary data.
@@ -247,6 +310,17 @@ CAResult_t CASetNextBlockOption2(coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
                                  const CAData_t *receivedData, coap_block_t block,
                                  size_t dataLen);
 
+/**
+ * store a block received by a pipelined transfer, in or out of order.
+ * @param[in]   currData    stored block data information.
+ * @param[in]   block   block option data.
+ * @param[in]   receivedData    received CAData.
+ * @return block state, ::CA_BLOCK_RECEIVED_ALREADY for blocks to be ignored and
+ *         ::CA_BLOCK_INCOMPLETE when the transfer falls back to one request at a time.
+ */
+uint8_t CAReceivePipelinedBlock(CABlockData_t *currData, coap_block_t block,
+                                const CAData_t *receivedData);
+
 /**
  * Update the block option in block-wise transfer list.
  * @param[in]   currData   stored block data information.
@@ -170,6 +170,12 @@ CAResult_t CARetransmissionDestroy(CARetransmission_t *context);
  */
 void CARetransmissionBaseRoutine(void *threadValue);
 
+/**
+ * Get the current monotonic time.
+ * @return  current time in microseconds.
+ */
+uint64_t getCurrentTimeInMicroSeconds();
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
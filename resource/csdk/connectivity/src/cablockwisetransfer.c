@@ -39,7 +39,9 @@
 #include "camessagehandler.h"
 #include "caremotehandler.h"
 #include "cablockwisetransfer.h"
+#include "caretransmission.h"
 #include "oic_malloc.h"
+#include "oic_string.h"
 #include "camutex.h"
 #include "logger.h"
 
@@ -52,9 +54,341 @@
 
 #define BLOCK_SIZE(arg) (1 << ((arg) + 4))
 
+#define BLOCK_INDEX_INITIAL_SIZE   16
+
+#define BLOCK_HEADER_RESERVE       64
+#define MIN_ADAPTIVE_BLOCK_SIZE    CA_BLOCK_SIZE_128_BYTE
+#define BLOCK_PATH_COUNT           8
+#define BLOCK_STATS_HISTORY_COUNT  8
+#define USECS_PER_SEC              1000000
+
+/**
+ * Block size learned for a remote endpoint.
+ */
+typedef struct
+{
+    bool used;                          /**< entry is in use. */
+    CATransportAdapter_t adapter;       /**< adapter of the endpoint. */
+    char addr[MAX_ADDR_STR_SIZE_CA];    /**< address of the endpoint. */
+    uint16_t port;                      /**< port of the endpoint. */
+    uint8_t szx;                        /**< block size of the next transfer. */
+} CABlockPath_t;
+
+/**
+ * Statistics of a completed transfer.
+ */
+typedef struct
+{
+    uint8_t id[CA_MAX_TOKEN_LEN + PORT_LENGTH]; /**< blockData ID of the transfer. */
+    size_t idLength;                    /**< length of blockData ID. */
+    CABlockWiseStats_t stats;           /**< statistics of the transfer. */
+} CABlockStatsHistory_t;
+
 // context for block-wise transfer
 static CABlockWiseContext_t g_context = { 0 };
 
+// block sizes of the next transfers to the remote endpoints
+static CABlockPath_t g_blockPaths[BLOCK_PATH_COUNT];
+static size_t g_nextBlockPath = 0;
+
+// statistics of the last completed transfers
+static CABlockStatsHistory_t g_statsHistory[BLOCK_STATS_HISTORY_COUNT];
+static size_t g_nextStatsHistory = 0;
+
+static size_t CAHashBlockID(const CABlockDataID_t *blockID)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < blockID->idLength; i++)
+    {
+        hash ^= blockID->id[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// blockDataListMutex has to be locked by the caller of the index functions.
+static CABlockData_t *CAFindBlockData(const CABlockDataID_t *blockID)
+{
+    if (!g_context.index || !blockID->id)
+    {
+        return NULL;
+    }
+
+    size_t bucket = CAHashBlockID(blockID) & (g_context.indexSize - 1);
+    for (CABlockData_t *currData = g_context.index[bucket]; currData;
+         currData = currData->indexNext)
+    {
+        if (CABlockidMatches(currData, blockID))
+        {
+            return currData;
+        }
+    }
+    return NULL;
+}
+
+static bool CAAddBlockDataToIndex(CABlockData_t *data)
+{
+    if (g_context.indexCount >= g_context.indexSize)
+    {
+        size_t newSize = g_context.indexSize ? g_context.indexSize * 2 : BLOCK_INDEX_INITIAL_SIZE;
+        CABlockData_t **newIndex = (CABlockData_t **) OICCalloc(newSize, sizeof(CABlockData_t *));
+        if (newIndex)
+        {
+            for (size_t i = 0; i < g_context.indexSize; i++)
+            {
+                CABlockData_t *currData = g_context.index[i];
+                while (currData)
+                {
+                    CABlockData_t *next = currData->indexNext;
+                    size_t bucket = CAHashBlockID(currData->blockDataId) & (newSize - 1);
+                    currData->indexNext = newIndex[bucket];
+                    newIndex[bucket] = currData;
+                    currData = next;
+                }
+            }
+            OICFree(g_context.index);
+            g_context.index = newIndex;
+            g_context.indexSize = newSize;
+        }
+        else if (!g_context.index)
+        {
+            OIC_LOG(ERROR, TAG, "memory alloc has failed");
+            return false;
+        }
+        // otherwise the buckets just get longer
+    }
+
+    size_t bucket = CAHashBlockID(data->blockDataId) & (g_context.indexSize - 1);
+    data->indexNext = g_context.index[bucket];
+    g_context.index[bucket] = data;
+    g_context.indexCount++;
+    return true;
+}
+
+static void CARemoveBlockDataFromIndex(const CABlockData_t *data)
+{
+    size_t bucket = CAHashBlockID(data->blockDataId) & (g_context.indexSize - 1);
+    for (CABlockData_t **currData = &g_context.index[bucket]; *currData;
+         currData = &(*currData)->indexNext)
+    {
+        if (*currData == data)
+        {
+            *currData = data->indexNext;
+            g_context.indexCount--;
+            return;
+        }
+    }
+}
+
+static CAResult_t CAReservePayload(CABlockData_t *currData, size_t length)
+{
+    if (length <= currData->payloadCapacity)
+    {
+        return CA_STATUS_OK;
+    }
+
+    // grow geometrically, so that reassembling n blocks copies O(n) bytes
+    size_t capacity = currData->payloadCapacity * 2;
+    if (capacity < length)
+    {
+        capacity = length;
+    }
+
+    CAPayload_t newPayload = OICRealloc(currData->payload, capacity);
+    if (NULL == newPayload)
+    {
+        OIC_LOG(ERROR, TAG, "out of memory");
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+    currData->payload = newPayload;
+    currData->payloadCapacity = capacity;
+    return CA_STATUS_OK;
+}
+
+// the biggest block fitting in a PDU along with the header and the options
+static uint8_t CAGetMaxBlockSize()
+{
+    uint8_t szx = CA_DEFAULT_BLOCK_SIZE;
+    while (szx > CA_BLOCK_SIZE_16_BYTE &&
+           BLOCK_SIZE(szx) + BLOCK_HEADER_RESERVE > COAP_MAX_PDU_SIZE)
+    {
+        szx--;
+    }
+    return szx;
+}
+
+// smaller blocks are less likely to be lost again
+static uint8_t CAShrinkBlockSize(uint8_t szx)
+{
+    return (szx > MIN_ADAPTIVE_BLOCK_SIZE) ? szx - 1 : szx;
+}
+
+// blockDataListMutex has to be locked by the caller of the path and statistics functions.
+static CABlockPath_t *CAFindBlockPath(const CAEndpoint_t *endpoint)
+{
+    for (size_t i = 0; i < BLOCK_PATH_COUNT; i++)
+    {
+        CABlockPath_t *path = &g_blockPaths[i];
+        if (path->used && path->adapter == endpoint->adapter && path->port == endpoint->port
+            && !strncmp(path->addr, endpoint->addr, sizeof(path->addr)))
+        {
+            return path;
+        }
+    }
+    return NULL;
+}
+
+static uint8_t CAGetBlockSizeForEndpoint(const CAEndpoint_t *endpoint)
+{
+    CABlockPath_t *path = endpoint ? CAFindBlockPath(endpoint) : NULL;
+    return path ? path->szx : CAGetMaxBlockSize();
+}
+
+static void CAUpdateBlockPath(const CAEndpoint_t *endpoint, uint8_t szx, bool isLost)
+{
+    // a transfer without loss lets the next one try bigger blocks
+    if (!isLost && szx < CAGetMaxBlockSize())
+    {
+        szx++;
+    }
+
+    CABlockPath_t *path = CAFindBlockPath(endpoint);
+    if (!path)
+    {
+        path = &g_blockPaths[g_nextBlockPath];
+        g_nextBlockPath = (g_nextBlockPath + 1) % BLOCK_PATH_COUNT;
+
+        path->used = true;
+        path->adapter = endpoint->adapter;
+        path->port = endpoint->port;
+        OICStrcpy(path->addr, sizeof(path->addr), endpoint->addr);
+    }
+    path->szx = szx;
+}
+
+static void CAAddBlockToStats(CABlockData_t *currData, size_t blockLength)
+{
+    currData->stats.blocks++;
+    currData->stats.payloadLength += blockLength;
+}
+
+static CABlockWiseStats_t CAGetStats(const CABlockData_t *currData)
+{
+    CABlockWiseStats_t stats = currData->stats;
+    stats.blockSize = (COAP_OPTION_BLOCK1 == currData->type) ? currData->block1.szx :
+                                                               currData->block2.szx;
+    stats.elapsedTime = getCurrentTimeInMicroSeconds() - currData->startTime;
+    if (stats.elapsedTime)
+    {
+        stats.throughput = stats.payloadLength * (uint64_t) USECS_PER_SEC / stats.elapsedTime;
+    }
+    return stats;
+}
+
+static void CARecordCompletedTransfer(const CABlockData_t *currData)
+{
+    // nothing to record of the messages which were not transferred by blocks
+    if (!currData->stats.blocks)
+    {
+        return;
+    }
+
+    CABlockWiseStats_t stats = CAGetStats(currData);
+    OIC_LOG_V(INFO, TAG, "%u bytes in %u blocks, %u lost, %u us: %u bytes/s",
+              (unsigned int) stats.payloadLength, stats.blocks, stats.lostBlocks,
+              (unsigned int) stats.elapsedTime, (unsigned int) stats.throughput);
+
+    if (currData->sentData && currData->sentData->remoteEndpoint)
+    {
+        CAUpdateBlockPath(currData->sentData->remoteEndpoint, stats.blockSize,
+                          0 != stats.lostBlocks);
+    }
+
+    const CABlockDataID_t *blockID = currData->blockDataId;
+    if (blockID && blockID->idLength <= sizeof(g_statsHistory[0].id))
+    {
+        CABlockStatsHistory_t *entry = &g_statsHistory[g_nextStatsHistory];
+        g_nextStatsHistory = (g_nextStatsHistory + 1) % BLOCK_STATS_HISTORY_COUNT;
+
+        memcpy(entry->id, blockID->id, blockID->idLength);
+        entry->idLength = blockID->idLength;
+        entry->stats = stats;
+    }
+}
+
+// block numbers are queued along with the block2 messages of pipelined transfers,
+// since the block option of a message is written when the send thread takes it.
+static void CAQueueBlockNumber(CABlockData_t *currData, uint32_t num)
+{
+    ca_mutex_lock(g_context.blockDataListMutex);
+    if (currData->queuedBlockCount < CA_MAX_BLOCK_PIPELINE_DEPTH)
+    {
+        size_t tail = (currData->queuedBlockHead + currData->queuedBlockCount)
+                      % CA_MAX_BLOCK_PIPELINE_DEPTH;
+        currData->queuedBlockNums[tail] = num;
+        currData->queuedBlockCount++;
+    }
+    else
+    {
+        OIC_LOG(ERROR, TAG, "too many block messages are queued");
+    }
+    ca_mutex_unlock(g_context.blockDataListMutex);
+}
+
+static bool CATakeQueuedBlockNumber(CABlockData_t *currData, uint32_t *num)
+{
+    ca_mutex_lock(g_context.blockDataListMutex);
+    bool isQueued = (0 < currData->queuedBlockCount);
+    if (isQueued)
+    {
+        *num = currData->queuedBlockNums[currData->queuedBlockHead];
+        currData->queuedBlockHead = (currData->queuedBlockHead + 1)
+                                    % CA_MAX_BLOCK_PIPELINE_DEPTH;
+        currData->queuedBlockCount--;
+    }
+    ca_mutex_unlock(g_context.blockDataListMutex);
+    return isQueued;
+}
+
+static bool CAStartPipelining(CABlockData_t *currData)
+{
+    // the blocks are taken out of order in the payload buffer allocated from the size option
+    if (g_context.pipelineDepth <= 1 || currData->nextBlockNum || currData->streamed
+        || !currData->sentData || !currData->sentData->requestInfo
+        || !currData->payloadLength || currData->payloadCapacity < currData->payloadLength
+        || currData->receivedPayloadLen
+           != (size_t) currData->block2.num * BLOCK_SIZE(currData->block2.szx))
+    {
+        return false;
+    }
+
+    currData->pipelineDepth = g_context.pipelineDepth;
+    currData->nextBlockNum = currData->block2.num;
+    currData->receivedBlocks = 0;
+    OIC_LOG_V(INFO, TAG, "pipeline %d block requests", currData->pipelineDepth);
+    return true;
+}
+
+static CAResult_t CAInsertBlockOption(const coap_block_t *block, uint8_t blockType,
+                                      coap_list_t **options)
+{
+    unsigned char buf[BLOCKWISE_OPTION_BUFFER] = { 0 };
+    unsigned int optionLength = coap_encode_var_bytes(buf,
+                                                      ((block->num << BLOCK_NUMBER_IDX)
+                                                       | (block->m << BLOCK_M_BIT_IDX)
+                                                       | block->szx));
+
+    int ret = coap_insert(options,
+                          CACreateNewOptionNode(blockType, optionLength, (char *) buf),
+                          CAOrderOpts);
+    if (ret <= 0)
+    {
+        return CA_STATUS_INVALID_PARAM;
+    }
+    return CA_STATUS_OK;
+}
+
 static bool CACheckPayloadLength(const CAData_t *sendData)
 {
     size_t payloadLen = 0;
@@ -111,11 +445,74 @@ CAResult_t CATerminateBlockWiseTransfer()
         u_arraylist_free(&g_context.dataList);
     }
 
+    OICFree(g_context.index);
+    g_context.index = NULL;
+    g_context.indexSize = 0;
+    g_context.indexCount = 0;
+    g_context.blockReceivedCallback = NULL;
+    g_context.pipelineDepth = 0;
+
+    memset(g_blockPaths, 0, sizeof(g_blockPaths));
+    g_nextBlockPath = 0;
+    memset(g_statsHistory, 0, sizeof(g_statsHistory));
+    g_nextStatsHistory = 0;
+
     CATerminateBlockWiseMutexVariables();
 
     return CA_STATUS_OK;
 }
 
+void CASetBlockReceivedCallback(CABlockReceivedCallback callback)
+{
+    g_context.blockReceivedCallback = callback;
+}
+
+CAResult_t CASetBlockPipelineDepth(uint8_t depth)
+{
+    if (0 == depth || CA_MAX_BLOCK_PIPELINE_DEPTH < depth)
+    {
+        OIC_LOG_V(ERROR, TAG, "invalid pipeline depth [%d]", depth);
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    g_context.pipelineDepth = depth;
+    return CA_STATUS_OK;
+}
+
+CAResult_t CAGetBlockWiseTransferStats(const CABlockDataID_t *blockID,
+                                       CABlockWiseStats_t *stats)
+{
+    VERIFY_NON_NULL(blockID, TAG, "blockID");
+    VERIFY_NON_NULL(stats, TAG, "stats");
+
+    ca_mutex_lock(g_context.blockDataListMutex);
+
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
+    {
+        *stats = CAGetStats(currData);
+        ca_mutex_unlock(g_context.blockDataListMutex);
+        return CA_STATUS_OK;
+    }
+
+    // the most recent transfer first, if the token was used again
+    for (size_t i = 1; i <= BLOCK_STATS_HISTORY_COUNT; i++)
+    {
+        const CABlockStatsHistory_t *entry = &g_statsHistory[
+                (g_nextStatsHistory + BLOCK_STATS_HISTORY_COUNT - i) % BLOCK_STATS_HISTORY_COUNT];
+        if (entry->idLength == blockID->idLength &&
+            !memcmp(entry->id, blockID->id, entry->idLength))
+        {
+            *stats = entry->stats;
+            ca_mutex_unlock(g_context.blockDataListMutex);
+            return CA_STATUS_OK;
+        }
+    }
+    ca_mutex_unlock(g_context.blockDataListMutex);
+
+    return CA_STATUS_FAILED;
+}
+
 CAResult_t CAInitBlockWiseMutexVariables()
 {
     if (!g_context.blockDataListMutex)
@@ -410,6 +807,7 @@ CAResult_t CAReceiveBlockWiseData(coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
                     return res;
                 }
             }
+            CADestroyBlockID(blockDataID);
         }
         else
         {
@@ -503,6 +901,15 @@ CAResult_t CAProcessNextStep(const coap_pdu_t *pdu, const CAData_t *receivedData
             }
             break;
 
+        case CA_OPTION2_PIPELINED:
+            res = CASendPipelinedBlockRequests(blockID);
+            if (CA_STATUS_OK != res)
+            {
+                OIC_LOG(ERROR, TAG, "send has failed");
+                return res;
+            }
+            break;
+
         case CA_OPTION2_LAST_BLOCK:
             // process last block and send upper layer
             res = CAReceiveLastBlock(blockID, receivedData);
@@ -656,6 +1063,40 @@ CAResult_t CASendBlockMessage(const coap_pdu_t *pdu, CAMessageType_t msgType,
     return res;
 }
 
+CAResult_t CASendPipelinedBlockRequests(const CABlockDataID_t *blockID)
+{
+    VERIFY_NON_NULL(blockID, TAG, "blockID");
+
+    CABlockData_t *currData = CAGetBlockDataFromBlockDataList(blockID);
+    if (!currData || !currData->sentData || !currData->sentData->requestInfo)
+    {
+        OIC_LOG(ERROR, TAG, "request is unavailable");
+        return CA_STATUS_FAILED;
+    }
+
+    // keep the requests of the blocks following the first missing one in flight
+    size_t blockSize = BLOCK_SIZE(currData->block2.szx);
+    uint32_t lastNum = (currData->payloadLength - 1) / blockSize;
+    uint32_t endNum = currData->block2.num + currData->pipelineDepth;
+    while (currData->nextBlockNum < endNum && currData->nextBlockNum <= lastNum)
+    {
+        CAQueueBlockNumber(currData, currData->nextBlockNum);
+        currData->nextBlockNum++;
+
+        OIC_LOG(DEBUG, TAG, "need new msgID");
+        currData->sentData->requestInfo->info.messageId = 0;
+
+        CAResult_t res = CAAddSendThreadQueue(currData->sentData, blockID);
+        if (CA_STATUS_OK != res)
+        {
+            OIC_LOG(ERROR, TAG, "add has failed");
+            return res;
+        }
+    }
+
+    return CA_STATUS_OK;
+}
+
 CAResult_t CASendErrorMessage(const coap_pdu_t *pdu, uint8_t status,
                               CAResponseResult_t responseResult,
                               const CABlockDataID_t *blockID)
@@ -724,8 +1165,22 @@ CAResult_t CASendErrorMessage(const coap_pdu_t *pdu, uint8_t status,
         data->payload = NULL;
         data->payloadLength = 0;
         data->receivedPayloadLen = 0;
+        data->payloadCapacity = 0;
         data->block1.num = 0;
         data->block2.num = 0;
+        data->pipelineDepth = 0;
+        data->receivedBlocks = 0;
+
+        // the transfer starts again with smaller blocks
+        data->stats.lostBlocks++;
+        if (COAP_OPTION_BLOCK2 == data->type)
+        {
+            data->block2.szx = CAShrinkBlockSize(data->block2.szx);
+        }
+        else
+        {
+            data->block1.szx = CAShrinkBlockSize(data->block1.szx);
+        }
     }
 
     return CA_STATUS_OK;
@@ -745,18 +1200,31 @@ CAResult_t CAReceiveLastBlock(const CABlockDataID_t *blockID,
         return CA_MEMORY_ALLOC_FAILED;
     }
 
-    // update payload
-    size_t fullPayloadLen = 0;
-    CAPayload_t fullPayload = CAGetPayloadFromBlockDataList(blockID,
-                                                            &fullPayloadLen);
-    if (fullPayload)
+    CABlockData_t *blockData = CAGetBlockDataFromBlockDataList(blockID);
+    if (blockData && blockData->streamed)
     {
-        CAResult_t res = CAUpdatePayloadToCAData(cloneData, fullPayload, fullPayloadLen);
-        if (CA_STATUS_OK != res)
+        // the blocks were consumed by the block callback, including the last one
+        CAInfo_t *info = cloneData->requestInfo ? &cloneData->requestInfo->info :
+                                                  &cloneData->responseInfo->info;
+        OICFree(info->payload);
+        info->payload = NULL;
+        info->payloadSize = 0;
+    }
+    else
+    {
+        // update payload
+        size_t fullPayloadLen = 0;
+        CAPayload_t fullPayload = CAGetPayloadFromBlockDataList(blockID,
+                                                                &fullPayloadLen);
+        if (fullPayload)
         {
-            OIC_LOG(ERROR, TAG, "update has failed");
-            CADestroyDataSet(cloneData);
-            return res;
+            CAResult_t res = CAUpdatePayloadToCAData(cloneData, fullPayload, fullPayloadLen);
+            if (CA_STATUS_OK != res)
+            {
+                OIC_LOG(ERROR, TAG, "update has failed");
+                CADestroyDataSet(cloneData);
+                return res;
+            }
         }
     }
 
@@ -1058,7 +1526,18 @@ CAResult_t CASetNextBlockOption2(coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
     else
     {
         // received type from remote device
-        if (CA_MSG_ACKNOWLEDGE == pdu->hdr->coap_hdr_udp_t.type ||
+        if (data->pipelineDepth && CA_MSG_ACKNOWLEDGE == pdu->hdr->coap_hdr_udp_t.type)
+        {
+            OIC_LOG(DEBUG, TAG, "received pipelined ACK");
+
+            blockWiseStatus = CAReceivePipelinedBlock(data, block, receivedData);
+            if (CA_BLOCK_RECEIVED_ALREADY == blockWiseStatus)
+            {
+                CADestroyBlockID(blockDataID);
+                return CA_STATUS_OK;
+            }
+        }
+        else if (CA_MSG_ACKNOWLEDGE == pdu->hdr->coap_hdr_udp_t.type ||
                 (CA_MSG_NONCONFIRM == pdu->hdr->coap_hdr_udp_t.type &&
                         NULL != receivedData->responseInfo))
         {
@@ -1130,6 +1609,11 @@ CAResult_t CASetNextBlockOption2(coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
                     CADestroyBlockID(blockDataID);
                     return res;
                 }
+
+                if (CA_OPTION2_ACK == blockWiseStatus && CAStartPipelining(data))
+                {
+                    blockWiseStatus = CA_OPTION2_PIPELINED;
+                }
             }
         }
         else // CON message and so on.
@@ -1155,6 +1639,12 @@ CAResult_t CASetNextBlockOption2(coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
                 CADestroyBlockID(blockDataID);
                 return res;
             }
+
+            // requests may be pipelined, the response has to carry the block asked for
+            if (CA_MSG_CONFIRM == pdu->hdr->coap_hdr_udp_t.type)
+            {
+                CAQueueBlockNumber(data, block.num);
+            }
         }
     }
 
@@ -1171,6 +1661,88 @@ CAResult_t CASetNextBlockOption2(coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
     return CA_STATUS_OK;
 }
 
+uint8_t CAReceivePipelinedBlock(CABlockData_t *currData, coap_block_t block,
+                                const CAData_t *receivedData)
+{
+    OIC_LOG(DEBUG, TAG, "IN-ReceivePipelinedBlock");
+    VERIFY_NON_NULL_RET(currData, TAG, "currData", CA_BLOCK_INCOMPLETE);
+    VERIFY_NON_NULL_RET(receivedData, TAG, "receivedData", CA_BLOCK_INCOMPLETE);
+
+    // blocks before the window are duplicates, blocks after it were not requested
+    uint32_t expectedNum = currData->block2.num;
+    if (block.num < expectedNum || block.num - expectedNum >= (uint32_t) currData->pipelineDepth ||
+        (currData->receivedBlocks & (1u << (block.num - expectedNum))))
+    {
+        OIC_LOG_V(DEBUG, TAG, "block [%d] is ignored", block.num);
+        return CA_BLOCK_RECEIVED_ALREADY;
+    }
+
+    size_t blockPayloadLen = 0;
+    CAPayload_t blockPayload = CAGetPayloadInfo(receivedData, &blockPayloadLen);
+
+    size_t blockSize = BLOCK_SIZE(currData->block2.szx);
+    size_t offset = (size_t) block.num * blockSize;
+    size_t expectedLen = 0;
+    if (offset < currData->payloadLength)
+    {
+        expectedLen = currData->payloadLength - offset;
+        if (expectedLen > blockSize)
+        {
+            expectedLen = blockSize;
+        }
+    }
+
+    if (block.szx != currData->block2.szx || !blockPayload || !expectedLen ||
+        blockPayloadLen != expectedLen)
+    {
+        currData->stats.lostBlocks++;
+        if (currData->retriedBlockNum == (uint32_t) block.num + 1)
+        {
+            // 408 Error handling of the block, one request at a time from now on
+            OIC_LOG(ERROR, TAG, "pipelined block is wrong again");
+            currData->pipelineDepth = 0;
+            return CA_BLOCK_INCOMPLETE;
+        }
+
+        OIC_LOG_V(ERROR, TAG, "pipelined block [%d] is wrong, request it again", block.num);
+        currData->retriedBlockNum = block.num + 1;
+        CAQueueBlockNumber(currData, block.num);
+        currData->sentData->requestInfo->info.messageId = 0;
+        CAAddSendThreadQueue(currData->sentData, currData->blockDataId);
+        return CA_BLOCK_RECEIVED_ALREADY;
+    }
+
+    if (block.num == expectedNum && currData->receivedBlocks &&
+        currData->retriedBlockNum != (uint32_t) block.num + 1)
+    {
+        OIC_LOG_V(DEBUG, TAG, "block [%d] has been overtaken", block.num);
+        currData->stats.lostBlocks++;
+    }
+
+    memcpy(currData->payload + offset, blockPayload, blockPayloadLen);
+    CAAddBlockToStats(currData, blockPayloadLen);
+    currData->receivedBlocks |= 1u << (block.num - expectedNum);
+
+    // move the window past the blocks received in order
+    while (currData->receivedBlocks & 1)
+    {
+        size_t remainingLen = currData->payloadLength - currData->receivedPayloadLen;
+        currData->receivedPayloadLen += (remainingLen < blockSize) ? remainingLen : blockSize;
+        currData->block2.num++;
+        currData->receivedBlocks >>= 1;
+    }
+    OIC_LOG_V(DEBUG, TAG, "updated payload len: %u",
+              (unsigned int) currData->receivedPayloadLen);
+
+    if (currData->receivedPayloadLen == currData->payloadLength)
+    {
+        return CA_OPTION2_LAST_BLOCK;
+    }
+
+    OIC_LOG(DEBUG, TAG, "OUT-ReceivePipelinedBlock");
+    return CA_OPTION2_PIPELINED;
+}
+
 CAResult_t CAUpdateBlockOptionItems(CABlockData_t *currData, const coap_pdu_t *pdu,
                                     coap_block_t *block, uint16_t blockType,
                                     uint32_t status)
@@ -1185,6 +1757,11 @@ CAResult_t CAUpdateBlockOptionItems(CABlockData_t *currData, const coap_pdu_t *p
 
     if (CA_REQUEST_ENTITY_INCOMPLETE == code || CA_REQUEST_ENTITY_TOO_LARGE == code)
     {
+        if (CA_REQUEST_ENTITY_INCOMPLETE == code)
+        {
+            currData->stats.lostBlocks++;
+        }
+
         // response error code of the received block message
         res = CAHandleBlockErrorResponse(block, blockType, code);
         if (CA_STATUS_OK != res)
@@ -1516,15 +2093,24 @@ CAResult_t CAAddBlockOption2(coap_pdu_t **pdu, const CAInfo_t *info, size_t data
     VERIFY_NON_NULL(options, TAG, "options");
 
     // get set block data from CABlock list-set.
-    coap_block_t *block1 = CAGetBlockOption(blockID,
-                                            COAP_OPTION_BLOCK1);
-    coap_block_t *block2 = CAGetBlockOption(blockID,
-                                            COAP_OPTION_BLOCK2);
-    if (!block1 || !block2)
+    CABlockData_t *currData = CAGetBlockDataFromBlockDataList(blockID);
+    if (!currData)
     {
         OIC_LOG(ERROR, TAG, "getting has failed");
         return CA_STATUS_FAILED;
     }
+    coap_block_t *block1 = &currData->block1;
+    coap_block_t *block2 = &currData->block2;
+
+    // pipelined messages carry the block number queued when they were requested
+    coap_block_t queuedBlock2;
+    uint32_t queuedNum = 0;
+    if (CATakeQueuedBlockNumber(currData, &queuedNum))
+    {
+        queuedBlock2 = *block2;
+        queuedBlock2.num = queuedNum;
+        block2 = &queuedBlock2;
+    }
 
     CALogBlockInfo(block2);
 
@@ -1533,29 +2119,20 @@ CAResult_t CAAddBlockOption2(coap_pdu_t **pdu, const CAInfo_t *info, size_t data
             (CA_MSG_NONCONFIRM == (*pdu)->hdr->coap_hdr_udp_t.type &&
                     CA_GET != (*pdu)->hdr->coap_hdr_udp_t.code))
     {
-        int32_t res = coap_write_block_opt(block2, COAP_OPTION_BLOCK2, *pdu, dataLength);
-        switch (res)
+        size_t start = (size_t) block2->num * BLOCK_SIZE(block2->szx);
+        if (dataLength <= start)
         {
-            case -2: /* illegal block */
-                code = COAP_RESPONSE_CODE(CA_BAD_REQ);
-                OIC_LOG(ERROR, TAG, "write block option : -2");
-                goto error;
-            case -1: /* should really not happen */
-                OIC_LOG(ERROR, TAG, "write block option : -1");
-                break;
-            case -3: /* cannot handle request */
-                code = COAP_RESPONSE_CODE(CA_INTERNAL_SERVER_ERROR);
-                OIC_LOG(ERROR, TAG, "write block option : -3");
-                goto error;
-            default:
-                OIC_LOG(INFO, TAG, "success write block option");
+            code = COAP_RESPONSE_CODE(CA_BAD_REQ);
+            OIC_LOG(ERROR, TAG, "illegal block requested");
+            goto error;
         }
+        block2->m = (size_t) BLOCK_SIZE(block2->szx) < dataLength - start;
         CALogBlockInfo(block2);
 
         // if block number is 0, add size2 option
         if (0 == block2->num)
         {
-            res = CAAddBlockSizeOption(*pdu, COAP_OPTION_SIZE2, dataLength, options);
+            CAResult_t res = CAAddBlockSizeOption(*pdu, COAP_OPTION_SIZE2, dataLength, options);
             if (CA_STATUS_OK != res)
             {
                 OIC_LOG(ERROR, TAG, "add has failed");
@@ -1567,7 +2144,7 @@ CAResult_t CAAddBlockOption2(coap_pdu_t **pdu, const CAInfo_t *info, size_t data
         if (block1->num)
         {
             OIC_LOG(DEBUG, TAG, "combining block1 and block2");
-            CAResult_t res = CAAddBlockOptionImpl(*pdu, block1, COAP_OPTION_BLOCK1, options);
+            CAResult_t res = CAInsertBlockOption(block1, COAP_OPTION_BLOCK1, options);
             if (CA_STATUS_OK != res)
             {
                 OIC_LOG(ERROR, TAG, "add has failed");
@@ -1578,17 +2155,37 @@ CAResult_t CAAddBlockOption2(coap_pdu_t **pdu, const CAInfo_t *info, size_t data
             block1->num = 0;
         }
 
+        // the block option is written along with the other options, in order
+        CAResult_t res = CAAddBlockOptionImpl(*pdu, block2, COAP_OPTION_BLOCK2, options);
+        if (CA_STATUS_OK != res)
+        {
+            OIC_LOG(ERROR, TAG, "add has failed");
+            CARemoveBlockDataFromList(blockID);
+            return res;
+        }
+
         if (!coap_add_block(*pdu, dataLength, (const unsigned char *) info->payload,
                             block2->num, block2->szx))
         {
             OIC_LOG(ERROR, TAG, "Data length is smaller than the start index");
             return CA_STATUS_FAILED;
         }
+        size_t blockSize = BLOCK_SIZE(block2->szx);
+        size_t blockLength = dataLength - (size_t) block2->num * blockSize;
+        CAAddBlockToStats(currData, (blockLength < blockSize) ? blockLength : blockSize);
 
-        if (!block2->m)
+        if (!block2->m || currData->lastBlockSent)
         {
             // if sent message is last response block message, remove data
-            CARemoveBlockDataFromList(blockID);
+            // once the responses to the pipelined requests are sent too.
+            if (currData->queuedBlockCount)
+            {
+                currData->lastBlockSent = true;
+            }
+            else
+            {
+                CARemoveBlockDataFromList(blockID);
+            }
         }
         else
         {
@@ -1647,12 +2244,13 @@ CAResult_t CAAddBlockOption1(coap_pdu_t **pdu, const CAInfo_t *info, size_t data
     VERIFY_NON_NULL(options, TAG, "options");
 
     // get set block data from CABlock list-set.
-    coap_block_t *block1 = CAGetBlockOption(blockID, COAP_OPTION_BLOCK1);
-    if (!block1)
+    CABlockData_t *currData = CAGetBlockDataFromBlockDataList(blockID);
+    if (!currData)
     {
         OIC_LOG(ERROR, TAG, "getting has failed");
         return CA_STATUS_FAILED;
     }
+    coap_block_t *block1 = &currData->block1;
 
     CALogBlockInfo(block1);
 
@@ -1717,6 +2315,9 @@ CAResult_t CAAddBlockOption1(coap_pdu_t **pdu, const CAInfo_t *info, size_t data
             OIC_LOG(ERROR, TAG, "Data length is smaller than the start index");
             return CA_STATUS_FAILED;
         }
+        size_t blockSize = BLOCK_SIZE(block1->szx);
+        size_t blockLength = dataLength - (size_t) block1->num * blockSize;
+        CAAddBlockToStats(currData, (blockLength < blockSize) ? blockLength : blockSize);
 
         // check the message type and if message type is NON, next block message will be sent
         if (CA_MSG_NONCONFIRM == (*pdu)->hdr->coap_hdr_udp_t.type)
@@ -1756,18 +2357,10 @@ CAResult_t CAAddBlockOptionImpl(coap_pdu_t *pdu, coap_block_t *block, uint8_t bl
     VERIFY_NON_NULL(block, TAG, "block");
     VERIFY_NON_NULL(options, TAG, "options");
 
-    unsigned char buf[BLOCKWISE_OPTION_BUFFER] = { 0 };
-    unsigned int optionLength = coap_encode_var_bytes(buf,
-                                                      ((block->num << BLOCK_NUMBER_IDX)
-                                                       | (block->m << BLOCK_M_BIT_IDX)
-                                                       | block->szx));
-
-    int ret = coap_insert(options,
-                          CACreateNewOptionNode(blockType, optionLength, (char *) buf),
-                          CAOrderOpts);
-    if (ret <= 0)
+    CAResult_t res = CAInsertBlockOption(block, blockType, options);
+    if (CA_STATUS_OK != res)
     {
-        return CA_STATUS_INVALID_PARAM;
+        return res;
     }
 
     // after adding the block option to option list, add option list to pdu.
@@ -1984,55 +2577,48 @@ CAResult_t CAUpdatePayloadData(CABlockData_t *currData, const CAData_t *received
                 BLOCK_SIZE(currData->block2.szx) : BLOCK_SIZE(currData->block1.szx);
     }
 
-    // memory allocation for the received block payload
     size_t prePayloadLen = currData->receivedPayloadLen;
     if (blockPayload)
     {
-        if (currData->payloadLength)
+        // the block callback takes over a transfer from its first block
+        CABlockReceivedCallback blockReceivedCallback = g_context.blockReceivedCallback;
+        if (blockReceivedCallback && (currData->streamed || 0 == prePayloadLen))
         {
-            // in case the block message has the size option
-            // allocate the memory for the total payload
-            if (isSizeOption)
+            const CAInfo_t *info = receivedData->requestInfo ?
+                    &receivedData->requestInfo->info : &receivedData->responseInfo->info;
+            bool consumed = blockReceivedCallback(receivedData->remoteEndpoint, info,
+                                                  prePayloadLen, blockPayload,
+                                                  blockPayloadLen, currData->payloadLength);
+            if (0 == prePayloadLen)
             {
-                CAPayload_t prePayload = currData->payload;
-
-                OIC_LOG(DEBUG, TAG, "allocate memory for the total payload");
-                currData->payload = (CAPayload_t) OICCalloc(1, currData->payloadLength);
-                if (NULL == currData->payload)
-                {
-                    OIC_LOG(ERROR, TAG, "out of memory");
-                    return CA_MEMORY_ALLOC_FAILED;
-                }
-                memcpy(currData->payload, prePayload, prePayloadLen);
-                OICFree(prePayload);
+                currData->streamed = consumed;
             }
-
-            // update the total payload
-            memcpy(currData->payload + prePayloadLen, blockPayload, blockPayloadLen);
         }
-        else
+
+        if (!currData->streamed)
         {
-            OIC_LOG(DEBUG, TAG, "allocate memory for the received block payload");
+            // allocate the memory for the total payload at once if the size option tells it
+            size_t requiredLen = prePayloadLen + blockPayloadLen;
+            if (isSizeOption && currData->payloadLength > requiredLen)
+            {
+                requiredLen = currData->payloadLength;
+            }
 
-            size_t totalPayloadLen = prePayloadLen + blockPayloadLen;
-            CAPayload_t newPayload = OICRealloc(currData->payload, totalPayloadLen);
-            if (NULL == newPayload)
+            CAResult_t res = CAReservePayload(currData, requiredLen);
+            if (CA_STATUS_OK != res)
             {
-                OIC_LOG(ERROR, TAG, "out of memory");
-                return CA_MEMORY_ALLOC_FAILED;
+                return res;
             }
 
             // update the total payload
-            memset(newPayload + prePayloadLen, 0, blockPayloadLen);
-            currData->payload = newPayload;
             memcpy(currData->payload + prePayloadLen, blockPayload, blockPayloadLen);
         }
 
         // update received payload length
         currData->receivedPayloadLen += blockPayloadLen;
+        CAAddBlockToStats(currData, blockPayloadLen);
 
-        OIC_LOG_V(DEBUG, TAG, "updated payload: %s, len: %d", currData->payload,
-                  currData->receivedPayloadLen);
+        OIC_LOG_V(DEBUG, TAG, "updated payload len: %d", currData->receivedPayloadLen);
     }
 
     OIC_LOG(DEBUG, TAG, "OUT-UpdatePayloadData");
@@ -2201,7 +2787,9 @@ CAResult_t CAHandleBlockErrorResponse(coap_block_t *block, uint16_t blockType,
     switch (responseResult)
     {
         case CA_REQUEST_ENTITY_INCOMPLETE:
+            // the transfer starts again with smaller blocks
             block->num = 0;
+            block->szx = CAShrinkBlockSize(block->szx);
             break;
         case CA_REQUEST_ENTITY_TOO_LARGE:
             if (COAP_OPTION_BLOCK1 == blockType)
@@ -2226,17 +2814,13 @@ CAResult_t CAUpdateBlockOptionType(const CABlockDataID_t *blockID,
 
     ca_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            currData->type = blockType;
-            ca_mutex_unlock(g_context.blockDataListMutex);
-            OIC_LOG(DEBUG, TAG, "OUT-UpdateBlockOptionType");
-            return CA_STATUS_OK;
-        }
+        currData->type = blockType;
+        ca_mutex_unlock(g_context.blockDataListMutex);
+        OIC_LOG(DEBUG, TAG, "OUT-UpdateBlockOptionType");
+        return CA_STATUS_OK;
     }
     ca_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2251,16 +2835,12 @@ uint8_t CAGetBlockOptionType(const CABlockDataID_t *blockID)
 
     ca_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            ca_mutex_unlock(g_context.blockDataListMutex);
-            OIC_LOG(DEBUG, TAG, "OUT-GetBlockOptionType");
-            return currData->type;
-        }
+        ca_mutex_unlock(g_context.blockDataListMutex);
+        OIC_LOG(DEBUG, TAG, "OUT-GetBlockOptionType");
+        return currData->type;
     }
     ca_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2274,19 +2854,10 @@ CAData_t *CAGetDataSetFromBlockDataList(const CABlockDataID_t *blockID)
 
     ca_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
-    {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            ca_mutex_unlock(g_context.blockDataListMutex);
-            return currData->sentData;
-        }
-    }
+    CABlockData_t *currData = CAFindBlockData(blockID);
     ca_mutex_unlock(g_context.blockDataListMutex);
 
-    return NULL;
+    return currData ? currData->sentData : NULL;
 }
 
 CAResult_t CAGetTokenFromBlockDataList(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
@@ -2346,93 +2917,44 @@ CAResult_t CACheckBlockDataValidation(const CAData_t *sendData, CABlockData_t **
     VERIFY_NON_NULL(sendData, TAG, "sendData");
     VERIFY_NON_NULL(blockData, TAG, "blockData");
 
-    ca_mutex_lock(g_context.blockDataListMutex);
-
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    // only a response continues a transfer, the one started by its request
+    if (sendData->requestInfo || !sendData->responseInfo
+        || !sendData->responseInfo->info.token)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-
-        if (!currData)
-        {
-            continue;
-        }
-
-        if (sendData->requestInfo) // sendData is requestMessage
-        {
-            OIC_LOG(DEBUG, TAG, "Send request");
-            if (NULL != currData->blockDataId
-                    && NULL != currData->blockDataId->id
-                    && currData->blockDataId->idLength > 0
-                    && NULL != sendData->requestInfo->info.token)
-            {
-                CABlockDataID_t* blockDataID = CACreateBlockDatablockId(
-                        (CAToken_t)sendData->requestInfo->info.token,
-                        sendData->requestInfo->info.tokenLength,
-                        sendData->remoteEndpoint->port);
+        return CA_STATUS_FAILED;
+    }
 
-                if(NULL == blockDataID || NULL == blockDataID->id || blockDataID->idLength < 1)
-                {
-                    OIC_LOG(ERROR, TAG, "blockId is null");
-                    CADestroyBlockID(blockDataID);
-                    return CA_STATUS_FAILED;
-                }
+    OIC_LOG(DEBUG, TAG, "Send response");
+    CABlockDataID_t* blockDataID = CACreateBlockDatablockId(
+            (CAToken_t)sendData->responseInfo->info.token,
+            sendData->responseInfo->info.tokenLength,
+            sendData->remoteEndpoint->port);
 
-                if (CABlockidMatches(currData, blockDataID))
-                {
-                    OIC_LOG(ERROR, TAG, "already sent");
-                    CADestroyBlockID(blockDataID);
-                    continue;
-                }
-                CADestroyBlockID(blockDataID);
-            }
-        }
-        else if (sendData->responseInfo) // sendData is responseMessage
-        {
-            OIC_LOG(DEBUG, TAG, "Send response");
-            if (NULL != currData->blockDataId
-                    && NULL != currData->blockDataId->id
-                    && currData->blockDataId->idLength > 0
-                    && NULL != sendData->responseInfo->info.token)
-            {
-                CABlockDataID_t* blockDataID = CACreateBlockDatablockId(
-                        (CAToken_t)sendData->responseInfo->info.token,
-                        sendData->responseInfo->info.tokenLength,
-                        sendData->remoteEndpoint->port);
+    if(NULL == blockDataID || NULL == blockDataID->id || blockDataID->idLength < 1)
+    {
+        OIC_LOG(ERROR, TAG, "blockId is null");
+        CADestroyBlockID(blockDataID);
+        return CA_STATUS_FAILED;
+    }
 
-                if(NULL == blockDataID || NULL == blockDataID->id || blockDataID->idLength < 1)
-                {
-                    OIC_LOG(ERROR, TAG, "blockId is null");
-                    CADestroyBlockID(blockDataID);
-                    return CA_STATUS_FAILED;
-                }
+    ca_mutex_lock(g_context.blockDataListMutex);
 
-                if (CABlockidMatches(currData, blockDataID))
-                {
-                    // set sendData
-                    if (NULL != currData->sentData)
-                    {
-                        OIC_LOG(DEBUG, TAG, "init block number");
-                        CADestroyDataSet(currData->sentData);
-                    }
-                    currData->sentData = CACloneCAData(sendData);
-                    *blockData = currData;
-                    CADestroyBlockID(blockDataID);
-                    ca_mutex_unlock(g_context.blockDataListMutex);
-                    return CA_STATUS_OK;
-                }
-                CADestroyBlockID(blockDataID);
-            }
-        }
-        else
+    CABlockData_t *currData = CAFindBlockData(blockDataID);
+    if (currData)
+    {
+        // set sendData
+        if (NULL != currData->sentData)
         {
-            OIC_LOG(ERROR, TAG, "no CAInfo data");
-            continue;
+            OIC_LOG(DEBUG, TAG, "init block number");
+            CADestroyDataSet(currData->sentData);
         }
+        currData->sentData = CACloneCAData(sendData);
+        *blockData = currData;
     }
     ca_mutex_unlock(g_context.blockDataListMutex);
 
-    return CA_STATUS_FAILED;
+    CADestroyBlockID(blockDataID);
+    return currData ? CA_STATUS_OK : CA_STATUS_FAILED;
 }
 
 CABlockData_t *CAGetBlockDataFromBlockDataList(const CABlockDataID_t *blockID)
@@ -2441,19 +2963,10 @@ CABlockData_t *CAGetBlockDataFromBlockDataList(const CABlockDataID_t *blockID)
 
     ca_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
-    {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            ca_mutex_unlock(g_context.blockDataListMutex);
-            return currData;
-        }
-    }
+    CABlockData_t *currData = CAFindBlockData(blockID);
     ca_mutex_unlock(g_context.blockDataListMutex);
 
-    return NULL;
+    return currData;
 }
 
 coap_block_t *CAGetBlockOption(const CABlockDataID_t *blockID,
@@ -2464,22 +2977,18 @@ coap_block_t *CAGetBlockOption(const CABlockDataID_t *blockID,
 
     ca_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
+        ca_mutex_unlock(g_context.blockDataListMutex);
+        OIC_LOG(DEBUG, TAG, "OUT-GetBlockOption");
+        if (COAP_OPTION_BLOCK2 == blockType)
         {
-            ca_mutex_unlock(g_context.blockDataListMutex);
-            OIC_LOG(DEBUG, TAG, "OUT-GetBlockOption");
-            if (COAP_OPTION_BLOCK2 == blockType)
-            {
-                return &currData->block2;
-            }
-            else
-            {
-                return &currData->block1;
-            }
+            return &currData->block2;
+        }
+        else
+        {
+            return &currData->block1;
         }
     }
     ca_mutex_unlock(g_context.blockDataListMutex);
@@ -2497,17 +3006,13 @@ CAPayload_t CAGetPayloadFromBlockDataList(const CABlockDataID_t *blockID,
 
     ca_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (currData)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            ca_mutex_unlock(g_context.blockDataListMutex);
-            *fullPayloadLen = currData->receivedPayloadLen;
-            OIC_LOG(DEBUG, TAG, "OUT-GetFullPayload");
-            return currData->payload;
-        }
+        ca_mutex_unlock(g_context.blockDataListMutex);
+        *fullPayloadLen = currData->receivedPayloadLen;
+        OIC_LOG(DEBUG, TAG, "OUT-GetFullPayload");
+        return currData->payload;
     }
     ca_mutex_unlock(g_context.blockDataListMutex);
 
@@ -2528,8 +3033,6 @@ CABlockData_t *CACreateNewBlockData(const CAData_t *sendData)
         return NULL;
     }
 
-    data->block1.szx = CA_DEFAULT_BLOCK_SIZE;
-    data->block2.szx = CA_DEFAULT_BLOCK_SIZE;
     data->sentData = CACloneCAData(sendData);
     if(!data->sentData)
     {
@@ -2567,7 +3070,20 @@ CABlockData_t *CACreateNewBlockData(const CAData_t *sendData)
 
     ca_mutex_lock(g_context.blockDataListMutex);
 
-    bool res = u_arraylist_add(g_context.dataList, (void *) data);
+    // start from the block size the last transfer with the endpoint ended with
+    data->block1.szx = CAGetBlockSizeForEndpoint(data->sentData->remoteEndpoint);
+    data->block2.szx = data->block1.szx;
+    data->startTime = getCurrentTimeInMicroSeconds();
+
+    bool res = CAAddBlockDataToIndex(data);
+    if (res)
+    {
+        res = u_arraylist_add(g_context.dataList, (void *) data);
+        if (!res)
+        {
+            CARemoveBlockDataFromIndex(data);
+        }
+    }
     if (!res)
     {
         OIC_LOG(ERROR, TAG, "add has failed");
@@ -2590,11 +3106,18 @@ CAResult_t CARemoveBlockDataFromList(const CABlockDataID_t *blockID)
 
     ca_mutex_lock(g_context.blockDataListMutex);
 
+    CABlockData_t *currData = CAFindBlockData(blockID);
+    if (!currData)
+    {
+        ca_mutex_unlock(g_context.blockDataListMutex);
+        return CA_STATUS_OK;
+    }
+    CARemoveBlockDataFromIndex(currData);
+
     size_t len = u_arraylist_length(g_context.dataList);
     for (size_t i = 0; i < len; i++)
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
+        if (currData == u_arraylist_get(g_context.dataList, i))
         {
             CABlockData_t *removedData = u_arraylist_remove(g_context.dataList, i);
             if (!removedData)
@@ -2604,6 +3127,8 @@ CAResult_t CARemoveBlockDataFromList(const CABlockDataID_t *blockID)
                 return CA_STATUS_FAILED;
             }
 
+            CARecordCompletedTransfer(currData);
+
             // destroy memory
             if (currData->sentData)
             {
@@ -2628,16 +3153,11 @@ bool CAIsBlockDataInList(const CABlockDataID_t *blockID)
 
     ca_mutex_lock(g_context.blockDataListMutex);
 
-    size_t len = u_arraylist_length(g_context.dataList);
-    for (size_t i = 0; i < len; i++)
+    if (CAFindBlockData(blockID))
     {
-        CABlockData_t *currData = (CABlockData_t *) u_arraylist_get(g_context.dataList, i);
-        if (CABlockidMatches(currData, blockID))
-        {
-            OIC_LOG(DEBUG, TAG, "found block data");
-            ca_mutex_unlock(g_context.blockDataListMutex);
-            return true;
-        }
+        OIC_LOG(DEBUG, TAG, "found block data");
+        ca_mutex_unlock(g_context.blockDataListMutex);
+        return true;
     }
     ca_mutex_unlock(g_context.blockDataListMutex);
 
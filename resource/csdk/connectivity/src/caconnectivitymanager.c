@@ -38,6 +38,10 @@
 #include "catcpadapter.h"
 #endif
 
+#ifdef WITH_BWT
+#include "cablockwisetransfer.h"
+#endif
+
 CAGlobals_t caglobals = { 0 };
 
 #define TAG "CA_CONN_MGR"
@@ -137,6 +141,59 @@ void CARegisterHandler(CARequestCallback ReqHandler, CAResponseCallback RespHand
     CASetInterfaceCallbacks(ReqHandler, RespHandler, ErrorHandler);
 }
 
+#ifdef WITH_BWT
+CAResult_t CARegisterBlockReceivedHandler(CABlockReceivedCallback BlockHandler)
+{
+    OIC_LOG(DEBUG, TAG, "CARegisterBlockReceivedHandler");
+
+    if(!g_isInitialized)
+    {
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    CASetBlockReceivedCallback(BlockHandler);
+    return CA_STATUS_OK;
+}
+
+CAResult_t CASetBlockWisePipelineDepth(uint8_t depth)
+{
+    OIC_LOG(DEBUG, TAG, "CASetBlockWisePipelineDepth");
+
+    if(!g_isInitialized)
+    {
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    return CASetBlockPipelineDepth(depth);
+}
+
+CAResult_t CAGetBlockWiseStats(const CAEndpoint_t *object, const CAToken_t token,
+                               uint8_t tokenLength, CABlockWiseStats_t *stats)
+{
+    OIC_LOG(DEBUG, TAG, "CAGetBlockWiseStats");
+
+    if(!g_isInitialized)
+    {
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    if (!object || !token || !tokenLength || !stats)
+    {
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    CABlockDataID_t *blockID = CACreateBlockDatablockId(token, tokenLength, object->port);
+    if (!blockID)
+    {
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+
+    CAResult_t res = CAGetBlockWiseTransferStats(blockID, stats);
+    CADestroyBlockID(blockID);
+    return res;
+}
+#endif
+
 #ifdef __WITH_DTLS__
 CAResult_t CARegisterDTLSCredentialsHandler(CAGetDTLSPskCredentialsHandler GetDTLSCredentialsHandler)
 {
@@ -78,12 +78,6 @@ typedef struct
 
 static const uint64_t USECS_PER_SEC = 1000000;
 
-/**
- * @brief   getCurrent monotonic time
- * @return  current time in microseconds
- */
-uint64_t getCurrentTimeInMicroSeconds();
-
 #ifndef SINGLE_THREAD
 /**
  * @brief   timeout value is
@@ -93,6 +93,38 @@ static char *ipv6mcnames[IPv6_DOMAINS] = {
     NULL
 };
 
+/** Maximum number of multicast messages given to the kernel at once */
+#define MULTICAST_BATCH_SIZE 16
+
+/**
+ * Network interface multicast messages are sent on. The interfaces are cached between
+ * interface changes, which netlink reports.
+ */
+typedef struct
+{
+    uint16_t family;
+    uint32_t index;
+    struct in_addr ipv4addr;      /**< used for IPv4 only. */
+#ifdef __linux__
+    size_t controlLength;
+    union
+    {
+        struct cmsghdr align;
+        char buf[CMSG_SPACE(sizeof (struct in6_pktinfo))];
+    } control;                    /**< packet info selecting the interface */
+#endif
+} CAMulticastInterface_t;
+
+static CAMulticastInterface_t *g_multicastInterfaces = NULL;
+static size_t g_multicastInterfaceCount = 0;
+static bool g_multicastInterfacesValid = false;
+
+/** Changed by the receive thread whenever an interface changes */
+static uint32_t g_interfaceGeneration = 0;
+
+/** Value of g_interfaceGeneration the cached interfaces were read at */
+static uint32_t g_multicastInterfacesGeneration = 0;
+
 static CAIPExceptionCallback g_exceptionCallback;
 
 static CAIPPacketReceivedCallback g_packetReceivedCallback;
@@ -433,7 +465,9 @@ static void CAInitializeNetlink()
 {
 #ifdef __linux__
     // create NETLINK fd for interface change notifications
-    struct sockaddr_nl sa = { AF_NETLINK, 0, 0, RTMGRP_LINK };
+    // address changes matter too, they change the interfaces multicast is sent on
+    struct sockaddr_nl sa = { AF_NETLINK, 0, 0,
+                              RTMGRP_LINK | RTMGRP_IPV4_IFADDR | RTMGRP_IPV6_IFADDR };
 
     caglobals.ip.netlinkFd = socket(AF_NETLINK, SOCK_RAW|SOCK_CLOEXEC, NETLINK_ROUTE);
     if (caglobals.ip.netlinkFd == -1)
@@ -586,6 +620,12 @@ void CAIPStopServer()
     caglobals.ip.started = false;
     caglobals.ip.terminate = true;
 
+    // the send thread is already stopped
+    OICFree(g_multicastInterfaces);
+    g_multicastInterfaces = NULL;
+    g_multicastInterfaceCount = 0;
+    g_multicastInterfacesValid = false;
+
     if (caglobals.ip.shutdownFds[1] != -1)
     {
         close(caglobals.ip.shutdownFds[1]);
@@ -764,8 +804,14 @@ CAResult_t CAIPStopListenServer()
     return CA_STATUS_OK;
 }
 
+static void CAInvalidateMulticastInterfaces()
+{
+    __atomic_add_fetch(&g_interfaceGeneration, 1, __ATOMIC_RELEASE);
+}
+
 static void CAProcessNewInterface(CAInterface_t *ifitem)
 {
+    CAInvalidateMulticastInterfaces();
     applyMulticastToInterface6(ifitem->index);
     struct in_addr inaddr;
     inaddr.s_addr = ifitem->ipv4addr;
@@ -784,6 +830,11 @@ static void CAHandleNetlink()
 
     for (nh = (struct nlmsghdr *)buf; NLMSG_OK(nh, len); nh = NLMSG_NEXT(nh, len))
     {
+        if (nh->nlmsg_type == RTM_NEWLINK || nh->nlmsg_type == RTM_DELLINK ||
+            nh->nlmsg_type == RTM_NEWADDR || nh->nlmsg_type == RTM_DELADDR)
+        {
+            CAInvalidateMulticastInterfaces();
+        }
         if (nh->nlmsg_type != RTM_NEWLINK)
         {
             continue;
@@ -884,21 +935,66 @@ static void sendData(int fd, const CAEndpoint_t *endpoint,
     }
 }
 
-static void sendMulticastData6(const u_arraylist_t *iflist,
-                               CAEndpoint_t *endpoint,
-                               const void *data, uint32_t datalen)
+#ifdef __linux__
+static void CASetMulticastPacketInfo(CAMulticastInterface_t *mcif)
 {
-    int scope = endpoint->flags & CA_SCOPE_MASK;
-    char *ipv6mcname = ipv6mcnames[scope];
-    if (!ipv6mcname)
+    struct msghdr msg = { .msg_control = mcif->control.buf,
+                          .msg_controllen = sizeof (mcif->control.buf) };
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+
+    if (mcif->family == AF_INET6)
     {
-        OIC_LOG_V(INFO, TAG, "IPv6 multicast scope invalid: %d", scope);
-        return;
+        struct in6_pktinfo info = { .ipi6_ifindex = mcif->index };
+        cmsg->cmsg_level = IPPROTO_IPV6;
+        cmsg->cmsg_type = IPV6_PKTINFO;
+        cmsg->cmsg_len = CMSG_LEN(sizeof (info));
+        memcpy(CMSG_DATA(cmsg), &info, sizeof (info));
+        mcif->controlLength = CMSG_SPACE(sizeof (info));
+    }
+    else
+    {
+        struct in_pktinfo info = { .ipi_ifindex = mcif->index,
+                                   .ipi_spec_dst = mcif->ipv4addr };
+        cmsg->cmsg_level = IPPROTO_IP;
+        cmsg->cmsg_type = IP_PKTINFO;
+        cmsg->cmsg_len = CMSG_LEN(sizeof (info));
+        memcpy(CMSG_DATA(cmsg), &info, sizeof (info));
+        mcif->controlLength = CMSG_SPACE(sizeof (info));
+    }
+}
+#endif
+
+/**
+ * Read the interfaces multicast messages are sent on again if one of them changed.
+ * Without netlink nothing tells of the changes, so they are read for every message.
+ */
+static bool CAUpdateMulticastInterfaces()
+{
+    uint32_t generation = __atomic_load_n(&g_interfaceGeneration, __ATOMIC_ACQUIRE);
+    if (g_multicastInterfacesValid && caglobals.ip.netlinkFd != -1 &&
+        g_multicastInterfacesGeneration == generation)
+    {
+        return true;
+    }
+
+    u_arraylist_t *iflist = CAIPGetInterfaceInformation(0);
+    if (!iflist)
+    {
+        OIC_LOG_V(ERROR, TAG, "get interface info failed: %s", strerror(errno));
+        return false;
     }
-    OICStrcpy(endpoint->addr, sizeof(endpoint->addr), ipv6mcname);
-    int fd = caglobals.ip.u6.fd;
 
     uint32_t len = u_arraylist_length(iflist);
+    CAMulticastInterface_t *interfaces =
+        (CAMulticastInterface_t *)OICCalloc(len ? len : 1, sizeof (CAMulticastInterface_t));
+    if (!interfaces)
+    {
+        OIC_LOG(ERROR, TAG, "Malloc Failed");
+        u_arraylist_destroy(iflist);
+        return false;
+    }
+
+    size_t count = 0;
     for (uint32_t i = 0; i < len; i++)
     {
         CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
@@ -910,12 +1006,133 @@ static void sendMulticastData6(const u_arraylist_t *iflist,
         {
             continue;
         }
-        if (ifitem->family != AF_INET6)
+        if (ifitem->family != AF_INET && ifitem->family != AF_INET6)
         {
             continue;
         }
 
-        int index = ifitem->index;
+        CAMulticastInterface_t *mcif = &interfaces[count++];
+        mcif->family = ifitem->family;
+        mcif->index = ifitem->index;
+        mcif->ipv4addr.s_addr = ifitem->ipv4addr;
+#ifdef __linux__
+        CASetMulticastPacketInfo(mcif);
+#endif
+    }
+    u_arraylist_destroy(iflist);
+
+    OICFree(g_multicastInterfaces);
+    g_multicastInterfaces = interfaces;
+    g_multicastInterfaceCount = count;
+    g_multicastInterfacesGeneration = generation;
+    g_multicastInterfacesValid = true;
+    OIC_LOG_V(DEBUG, TAG, "multicast interfaces updated: %u", (unsigned int)count);
+    return true;
+}
+
+#ifdef __linux__
+static void sendMulticastBatch(int fd, struct mmsghdr *msgs, unsigned int count,
+                               const char *fam)
+{
+    unsigned int done = 0;
+    while (done < count)
+    {
+        int ret = sendmmsg(fd, msgs + done, count - done, 0);
+        if (ret <= 0)
+        {
+            // If logging is not defined/enabled.
+            (void)fam;
+            OIC_LOG_V(ERROR, TAG, "multicast %s sendmmsg failed: %s", fam, strerror(errno));
+            done++;     // skip the interface failing, e.g. going down
+        }
+        else
+        {
+            done += ret;
+        }
+    }
+    OIC_LOG_V(INFO, TAG, "multicast %s sent on %u interfaces", fam, count);
+}
+
+/**
+ * Send a multicast message on all the interfaces of a family with one system call, which
+ * the packet info of each message sends on its interface. Messages leave from the unicast
+ * socket, so that responses come back to it.
+ */
+static void sendMulticastData(int fd, uint16_t family, const CAEndpoint_t *endpoint,
+                              const void *data, uint32_t datalen, const char *fam)
+{
+    struct sockaddr_storage sock;
+    CAConvertNameToAddr(endpoint->addr, endpoint->port, &sock);
+
+    socklen_t socklen;
+    if (family == AF_INET6)
+    {
+        // the packet info selects the interface, a different scope would be refused
+        ((struct sockaddr_in6 *)&sock)->sin6_scope_id = 0;
+        socklen = sizeof (struct sockaddr_in6);
+    }
+    else
+    {
+        socklen = sizeof (struct sockaddr_in);
+    }
+
+    struct iovec iov = { .iov_base = (void *)data, .iov_len = datalen };
+    struct mmsghdr msgs[MULTICAST_BATCH_SIZE];
+    unsigned int count = 0;
+
+    for (size_t i = 0; i < g_multicastInterfaceCount; i++)
+    {
+        CAMulticastInterface_t *mcif = &g_multicastInterfaces[i];
+        if (mcif->family != family)
+        {
+            continue;
+        }
+
+        memset(&msgs[count], 0, sizeof (msgs[count]));
+        msgs[count].msg_hdr.msg_name = &sock;
+        msgs[count].msg_hdr.msg_namelen = socklen;
+        msgs[count].msg_hdr.msg_iov = &iov;
+        msgs[count].msg_hdr.msg_iovlen = 1;
+        msgs[count].msg_hdr.msg_control = mcif->control.buf;
+        msgs[count].msg_hdr.msg_controllen = mcif->controlLength;
+        if (++count == MULTICAST_BATCH_SIZE)
+        {
+            sendMulticastBatch(fd, msgs, count, fam);
+            count = 0;
+        }
+    }
+    if (count)
+    {
+        sendMulticastBatch(fd, msgs, count, fam);
+    }
+}
+#endif
+
+static void sendMulticastData6(CAEndpoint_t *endpoint,
+                               const void *data, uint32_t datalen)
+{
+    int scope = endpoint->flags & CA_SCOPE_MASK;
+    char *ipv6mcname = ipv6mcnames[scope];
+    if (!ipv6mcname)
+    {
+        OIC_LOG_V(INFO, TAG, "IPv6 multicast scope invalid: %d", scope);
+        return;
+    }
+    OICStrcpy(endpoint->addr, sizeof(endpoint->addr), ipv6mcname);
+    int fd = caglobals.ip.u6.fd;
+
+#ifdef __linux__
+    sendMulticastData(fd, AF_INET6, endpoint, data, datalen, "ipv6");
+#else
+    for (size_t i = 0; i < g_multicastInterfaceCount; i++)
+    {
+        CAMulticastInterface_t *mcif = &g_multicastInterfaces[i];
+        if (mcif->family != AF_INET6)
+        {
+            continue;
+        }
+
+        int index = mcif->index;
         if (setsockopt(fd, IPPROTO_IPV6, IPV6_MULTICAST_IF, &index, sizeof (index)))
         {
             OIC_LOG_V(ERROR, TAG, "setsockopt6 failed: %s", strerror(errno));
@@ -923,36 +1140,28 @@ static void sendMulticastData6(const u_arraylist_t *iflist,
         }
         sendData(fd, endpoint, data, datalen, "multicast", "ipv6");
     }
+#endif
 }
 
-static void sendMulticastData4(const u_arraylist_t *iflist,
-                               CAEndpoint_t *endpoint,
+static void sendMulticastData4(CAEndpoint_t *endpoint,
                                const void *data, uint32_t datalen)
 {
-    struct ip_mreq mreq = { .imr_multiaddr = IPv4MulticastAddress };
     OICStrcpy(endpoint->addr, sizeof(endpoint->addr), IPv4_MULTICAST);
     int fd = caglobals.ip.u4.fd;
 
-    uint32_t len = u_arraylist_length(iflist);
-    for (uint32_t i = 0; i < len; i++)
+#ifdef __linux__
+    sendMulticastData(fd, AF_INET, endpoint, data, datalen, "ipv4");
+#else
+    struct ip_mreq mreq = { .imr_multiaddr = IPv4MulticastAddress };
+    for (size_t i = 0; i < g_multicastInterfaceCount; i++)
     {
-        CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
-        if (!ifitem)
-        {
-            continue;
-        }
-        if ((ifitem->flags & (IFF_UP|IFF_RUNNING)) != (IFF_UP|IFF_RUNNING))
-        {
-            continue;
-        }
-        if (ifitem->family != AF_INET)
+        CAMulticastInterface_t *mcif = &g_multicastInterfaces[i];
+        if (mcif->family != AF_INET)
         {
             continue;
         }
 
-        struct in_addr inaddr;
-        inaddr.s_addr = ifitem->ipv4addr;
-        mreq.imr_interface = inaddr;
+        mreq.imr_interface = mcif->ipv4addr;
         if (setsockopt(fd, IPPROTO_IP, IP_MULTICAST_IF, &mreq, sizeof (mreq)))
         {
             OIC_LOG_V(ERROR, TAG, "send IP_MULTICAST_IF failed: %s (using defualt)",
@@ -960,6 +1169,7 @@ static void sendMulticastData4(const u_arraylist_t *iflist,
         }
         sendData(fd, endpoint, data, datalen, "multicast", "ipv4");
     }
+#endif
 }
 
 void CAIPSendData(CAEndpoint_t *endpoint, const void *data, uint32_t datalen,
@@ -974,23 +1184,19 @@ void CAIPSendData(CAEndpoint_t *endpoint, const void *data, uint32_t datalen,
     {
         endpoint->port = isSecure ? CA_SECURE_COAP : CA_COAP;
 
-        u_arraylist_t *iflist = CAIPGetInterfaceInformation(0);
-        if (!iflist)
+        if (!CAUpdateMulticastInterfaces())
         {
-            OIC_LOG_V(ERROR, TAG, "get interface info failed: %s", strerror(errno));
             return;
         }
 
         if ((endpoint->flags & CA_IPV6) && caglobals.ip.ipv6enabled)
         {
-            sendMulticastData6(iflist, endpoint, data, datalen);
+            sendMulticastData6(endpoint, data, datalen);
         }
         if ((endpoint->flags & CA_IPV4) && caglobals.ip.ipv4enabled)
         {
-            sendMulticastData4(iflist, endpoint, data, datalen);
+            sendMulticastData4(endpoint, data, datalen);
         }
-
-        u_arraylist_destroy(iflist);
     }
     else
     {
@@ -0,0 +1,696 @@
+//******************************************************************
+//
+// Copyright 2015 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <string.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#ifdef WITH_BWT
+
+#include "cainterface.h"
+#include "camessagehandler.h"
+#include "cablockwisetransfer.h"
+#include "caremotehandler.h"
+#include "caprotocolmessage.h"
+#include "oic_malloc.h"
+
+namespace {
+
+const size_t BLOCK_LENGTH = 1024;
+
+CAData_t *createRequestData(const std::string &token, const uint8_t *payload,
+                            size_t payloadSize)
+{
+    CAData_t *data = (CAData_t *) OICCalloc(1, sizeof(CAData_t));
+    data->dataType = CA_REQUEST_DATA;
+    data->remoteEndpoint = CACreateEndpointObject(CA_DEFAULT_FLAGS, CA_ADAPTER_IP,
+                                                  "127.0.0.1", 5683);
+    data->requestInfo = (CARequestInfo_t *) OICCalloc(1, sizeof(CARequestInfo_t));
+    data->requestInfo->method = CA_PUT;
+    data->requestInfo->info.type = CA_MSG_NONCONFIRM;
+    data->requestInfo->info.tokenLength = token.size();
+    data->requestInfo->info.token = (CAToken_t) OICMalloc(token.size());
+    memcpy(data->requestInfo->info.token, token.data(), token.size());
+    if (payload)
+    {
+        data->requestInfo->info.payload = (CAPayload_t) OICMalloc(payloadSize);
+        memcpy(data->requestInfo->info.payload, payload, payloadSize);
+        data->requestInfo->info.payloadSize = payloadSize;
+    }
+    return data;
+}
+
+CABlockDataID_t *createBlockID(const std::string &token)
+{
+    return CACreateBlockDatablockId((CAToken_t) token.data(), token.size(), 5683);
+}
+
+std::vector<uint8_t> createPayload(size_t length)
+{
+    std::vector<uint8_t> payload(length);
+    for (size_t i = 0; i < length; i++)
+    {
+        payload[i] = (uint8_t) (i * 7);
+    }
+    return payload;
+}
+
+/**
+ * Feeds a payload block by block to a transfer.
+ *
+ * @return number of times the reassembly buffer was allocated.
+ */
+int receiveBlocks(CABlockData_t *blockData, const std::string &token,
+                  const std::vector<uint8_t> &payload, bool isSizeOption)
+{
+    int allocations = 0;
+    for (size_t offset = 0; offset < payload.size(); offset += BLOCK_LENGTH)
+    {
+        size_t length = std::min(BLOCK_LENGTH, payload.size() - offset);
+        CAData_t *received = createRequestData(token, &payload[offset], length);
+        size_t capacity = blockData->payloadCapacity;
+        EXPECT_EQ(CA_STATUS_OK, CAUpdatePayloadData(blockData, received, CA_BLOCK_UNKNOWN,
+                                                    isSizeOption, COAP_OPTION_BLOCK1));
+        if (capacity != blockData->payloadCapacity)
+        {
+            allocations++;
+        }
+        CADestroyDataSet(received);
+    }
+    return allocations;
+}
+
+std::vector<size_t> g_streamedOffsets;
+std::vector<uint8_t> g_streamedPayload;
+size_t g_streamedTotalLength = 0;
+bool g_consumeStream = true;
+
+bool streamBlock(const CAEndpoint_t *, const CAInfo_t *, size_t offset, const uint8_t *block,
+                 size_t blockLength, size_t totalLength)
+{
+    g_streamedOffsets.push_back(offset);
+    g_streamedPayload.insert(g_streamedPayload.end(), block, block + blockLength);
+    g_streamedTotalLength = totalLength;
+    return g_consumeStream;
+}
+
+class CABlockWiseTransferTest : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        CAInitializeBlockWiseTransfer(NULL, NULL);
+        g_streamedOffsets.clear();
+        g_streamedPayload.clear();
+        g_streamedTotalLength = 0;
+        g_consumeStream = true;
+    }
+
+    virtual void TearDown()
+    {
+        CASetBlockReceivedCallback(NULL);
+        CATerminateBlockWiseTransfer();
+    }
+
+    CABlockData_t *createBlockData(const std::string &token)
+    {
+        CAData_t *data = createRequestData(token, NULL, 0);
+        CABlockData_t *blockData = CACreateNewBlockData(data);
+        CADestroyDataSet(data);
+        return blockData;
+    }
+
+    void removeBlockData(const std::string &token)
+    {
+        CABlockDataID_t *blockID = createBlockID(token);
+        EXPECT_EQ(CA_STATUS_OK, CARemoveBlockDataFromList(blockID));
+        CADestroyBlockID(blockID);
+    }
+};
+
+const uint16_t SERVER_PORT = 5683;
+const uint16_t CLIENT_PORT = 5684;
+
+/**
+ * Carries the messages of a client and a server of the same process over a link with delay,
+ * encoded and parsed as they are by the message handler.
+ */
+class Loopback
+{
+public:
+    typedef std::function<int(const coap_pdu_t *pdu, uint16_t toPort)> DelayFunc;
+    typedef std::function<void(const coap_pdu_t *pdu, std::vector<uint8_t> &bytes)> TamperFunc;
+
+    static Loopback *instance;
+
+    Loopback(const std::vector<uint8_t> &serverPayload, DelayFunc delay, TamperFunc tamper)
+        : m_serverPayload(serverPayload), m_delay(delay), m_tamper(tamper), m_stopped(false),
+          m_received(false)
+    {
+        instance = this;
+        m_thread = std::thread(&Loopback::run, this);
+    }
+
+    ~Loopback()
+    {
+        stop();
+        instance = NULL;
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopped = true;
+        }
+        m_cond.notify_all();
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+        for (auto &message : m_messages)
+        {
+            CADestroyDataSet(message.second.data);
+        }
+        m_messages.clear();
+    }
+
+    void get(const std::string &token)
+    {
+        CAData_t *data = createRequestData(token, NULL, 0);
+        data->requestInfo->method = CA_GET;
+        data->requestInfo->info.type = CA_MSG_CONFIRM;
+        if (CA_NOT_SUPPORTED == CASendBlockWiseData(data))
+        {
+            send(data);
+        }
+        else
+        {
+            CADestroyDataSet(data);
+        }
+    }
+
+    bool waitForResponse(std::vector<uint8_t> &payload)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cond.wait_for(lock, std::chrono::seconds(10), [this] { return m_received; });
+        payload = m_response;
+        return m_received;
+    }
+
+    void send(CAData_t *data)
+    {
+        schedule(0, Message{ data, std::vector<uint8_t>(), 0 });
+    }
+
+    void receive(CAData_t *data)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            CAInfo_t *info = data->responseInfo ? &data->responseInfo->info : NULL;
+            if (info && info->payload)
+            {
+                m_response.assign(info->payload, info->payload + info->payloadSize);
+            }
+            m_received = true;
+        }
+        m_cond.notify_all();
+        CADestroyDataSet(data);
+    }
+
+private:
+    struct Message
+    {
+        CAData_t *data;                 // to encode, NULL once encoded
+        std::vector<uint8_t> bytes;     // encoded message
+        uint16_t toPort;
+    };
+
+    void schedule(int delayMs, Message message)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_messages.insert(std::make_pair(
+                std::chrono::steady_clock::now() + std::chrono::milliseconds(delayMs),
+                std::move(message)));
+        }
+        m_cond.notify_all();
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stopped)
+        {
+            if (m_messages.empty())
+            {
+                m_cond.wait(lock);
+                continue;
+            }
+            auto next = m_messages.begin();
+            if (next->first > std::chrono::steady_clock::now())
+            {
+                m_cond.wait_until(lock, next->first);
+                continue;
+            }
+            Message message = std::move(next->second);
+            m_messages.erase(next);
+
+            lock.unlock();
+            if (message.data)
+            {
+                encode(message.data);
+            }
+            else
+            {
+                deliver(message);
+            }
+            lock.lock();
+        }
+    }
+
+    void encode(CAData_t *data)
+    {
+        coap_list_t *options = NULL;
+        coap_transport_type transport = coap_udp;
+        CAInfo_t *info = data->requestInfo ? &data->requestInfo->info :
+                                             &data->responseInfo->info;
+        uint32_t code = data->requestInfo ? (uint32_t) data->requestInfo->method :
+                                            (uint32_t) data->responseInfo->result;
+        coap_pdu_t *pdu = CAGeneratePDU(code, info, data->remoteEndpoint, &options, &transport);
+        if (pdu && CA_STATUS_OK == CAAddBlockOption(&pdu, info, data->remoteEndpoint, &options))
+        {
+            Message message{ NULL, std::vector<uint8_t>((uint8_t *) pdu->hdr,
+                                                        (uint8_t *) pdu->hdr + pdu->length),
+                             data->remoteEndpoint->port };
+            if (m_tamper)
+            {
+                m_tamper(pdu, message.bytes);
+            }
+            schedule(m_delay(pdu, message.toPort), std::move(message));
+        }
+        coap_delete_list(options);
+        coap_delete_pdu(pdu);
+        CADestroyDataSet(data);
+    }
+
+    void deliver(const Message &message)
+    {
+        CAEndpoint_t *from = CACreateEndpointObject(CA_DEFAULT_FLAGS, CA_ADAPTER_IP, "127.0.0.1",
+                                                    (SERVER_PORT == message.toPort) ?
+                                                    CLIENT_PORT : SERVER_PORT);
+        uint32_t code = 0;
+        coap_pdu_t *pdu = (coap_pdu_t *) CAParsePDU((const char *) &message.bytes[0],
+                                                    message.bytes.size(), &code, from);
+        if (!pdu)
+        {
+            CAFreeEndpoint(from);
+            return;
+        }
+
+        CAData_t *data = (CAData_t *) OICCalloc(1, sizeof(CAData_t));
+        data->remoteEndpoint = CACloneEndpoint(from);
+        bool isRequest = (CA_GET == code || CA_POST == code || CA_PUT == code ||
+                          CA_DELETE == code);
+        if (isRequest)
+        {
+            data->dataType = CA_REQUEST_DATA;
+            data->requestInfo = (CARequestInfo_t *) OICCalloc(1, sizeof(CARequestInfo_t));
+            CAGetRequestInfoFromPDU(pdu, from, data->requestInfo);
+        }
+        else
+        {
+            data->dataType = CA_RESPONSE_DATA;
+            data->responseInfo = (CAResponseInfo_t *) OICCalloc(1, sizeof(CAResponseInfo_t));
+            CAGetResponseInfoFromPDU(pdu, data->responseInfo, from);
+        }
+
+        if (CA_NOT_SUPPORTED == CAReceiveBlockWiseData(pdu, from, data, message.bytes.size())
+            && isRequest)
+        {
+            respond(data);
+        }
+
+        CADestroyDataSet(data);
+        coap_delete_pdu(pdu);
+        CAFreeEndpoint(from);
+    }
+
+    // the server answers the requests without block option with the whole payload
+    void respond(const CAData_t *request)
+    {
+        CAData_t *data = (CAData_t *) OICCalloc(1, sizeof(CAData_t));
+        data->dataType = CA_RESPONSE_DATA;
+        data->remoteEndpoint = CACloneEndpoint(request->remoteEndpoint);
+        data->responseInfo = (CAResponseInfo_t *) OICCalloc(1, sizeof(CAResponseInfo_t));
+        data->responseInfo->result = CA_CONTENT;
+
+        CAInfo_t *info = &data->responseInfo->info;
+        const CAInfo_t *requestInfo = &request->requestInfo->info;
+        info->type = CA_MSG_ACKNOWLEDGE;
+        info->messageId = requestInfo->messageId;
+        info->tokenLength = requestInfo->tokenLength;
+        info->token = (CAToken_t) OICMalloc(requestInfo->tokenLength);
+        memcpy(info->token, requestInfo->token, requestInfo->tokenLength);
+        info->payloadSize = m_serverPayload.size();
+        info->payload = (CAPayload_t) OICMalloc(m_serverPayload.size());
+        memcpy(info->payload, &m_serverPayload[0], m_serverPayload.size());
+
+        CASendBlockWiseData(data);
+        CADestroyDataSet(data);
+    }
+
+    std::vector<uint8_t> m_serverPayload;
+    DelayFunc m_delay;
+    TamperFunc m_tamper;
+    std::multimap<std::chrono::steady_clock::time_point, Message> m_messages;
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::thread m_thread;
+    bool m_stopped;
+    bool m_received;
+    std::vector<uint8_t> m_response;
+};
+
+Loopback *Loopback::instance = NULL;
+
+void loopbackSend(CAData_t *data)
+{
+    Loopback::instance->send(data);
+}
+
+void loopbackReceive(CAData_t *data)
+{
+    Loopback::instance->receive(data);
+}
+
+uint32_t getBlockNum(const coap_pdu_t *pdu)
+{
+    coap_block_t block = { 0, 0, 0 };
+    coap_get_block((coap_pdu_t *) pdu, COAP_OPTION_BLOCK2, &block);
+    return block.num;
+}
+
+class CABlockWisePipelineTest : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        CAInitializeBlockWiseTransfer(loopbackSend, loopbackReceive);
+    }
+
+    virtual void TearDown()
+    {
+        CATerminateBlockWiseTransfer();
+    }
+
+    /**
+     * Gets a payload from the server.
+     *
+     * @return statistics of the client transfer.
+     */
+    CABlockWiseStats_t transfer(const std::string &token, const std::vector<uint8_t> &payload,
+                                Loopback::DelayFunc delay, Loopback::TamperFunc tamper = NULL)
+    {
+        std::vector<uint8_t> received;
+        Loopback loopback(payload, delay, tamper);
+        loopback.get(token);
+        EXPECT_TRUE(loopback.waitForResponse(received));
+        loopback.stop();
+        EXPECT_EQ(payload, received);
+
+        CABlockWiseStats_t stats = { 0, 0, 0, CA_BLOCK_SIZE_16_BYTE, 0, 0 };
+        CABlockDataID_t *blockID = CACreateBlockDatablockId((CAToken_t) token.data(),
+                                                            token.size(), SERVER_PORT);
+        EXPECT_EQ(CA_STATUS_OK, CAGetBlockWiseTransferStats(blockID, &stats));
+        CADestroyBlockID(blockID);
+        return stats;
+    }
+};
+
+} // namespace
+
+TEST_F(CABlockWiseTransferTest, FindManyTransfers)
+{
+    const int numTransfers = 100;
+    std::vector<CABlockData_t *> blockData;
+    for (int i = 0; i < numTransfers; i++)
+    {
+        blockData.push_back(createBlockData("token" + std::to_string(i)));
+        ASSERT_TRUE(blockData.back() != NULL);
+    }
+
+    for (int i = 0; i < numTransfers; i += 2)
+    {
+        removeBlockData("token" + std::to_string(i));
+    }
+
+    for (int i = 0; i < numTransfers; i++)
+    {
+        CABlockDataID_t *blockID = createBlockID("token" + std::to_string(i));
+        CABlockData_t *found = CAGetBlockDataFromBlockDataList(blockID);
+        if (i % 2)
+        {
+            EXPECT_EQ(blockData[i], found);
+            EXPECT_TRUE(CAIsBlockDataInList(blockID));
+        }
+        else
+        {
+            EXPECT_TRUE(found == NULL);
+            EXPECT_FALSE(CAIsBlockDataInList(blockID));
+        }
+        CADestroyBlockID(blockID);
+    }
+
+    for (int i = 1; i < numTransfers; i += 2)
+    {
+        removeBlockData("token" + std::to_string(i));
+    }
+}
+
+TEST_F(CABlockWiseTransferTest, ReassemblePresizedFromSizeOption)
+{
+    std::vector<uint8_t> payload = createPayload(100 * BLOCK_LENGTH + 10);
+    CABlockData_t *blockData = createBlockData("token");
+    ASSERT_TRUE(blockData != NULL);
+    blockData->payloadLength = payload.size();
+
+    EXPECT_EQ(1, receiveBlocks(blockData, "token", payload, true));
+    ASSERT_EQ(payload.size(), blockData->receivedPayloadLen);
+    EXPECT_EQ(0, memcmp(&payload[0], blockData->payload, payload.size()));
+
+    removeBlockData("token");
+}
+
+TEST_F(CABlockWiseTransferTest, ReassembleWithoutSizeOption)
+{
+    std::vector<uint8_t> payload = createPayload(100 * BLOCK_LENGTH + 10);
+    CABlockData_t *blockData = createBlockData("token");
+    ASSERT_TRUE(blockData != NULL);
+
+    // the buffer doubles, 101 blocks take 8 allocations
+    EXPECT_EQ(8, receiveBlocks(blockData, "token", payload, false));
+    ASSERT_EQ(payload.size(), blockData->receivedPayloadLen);
+    EXPECT_EQ(0, memcmp(&payload[0], blockData->payload, payload.size()));
+
+    removeBlockData("token");
+}
+
+TEST_F(CABlockWiseTransferTest, StreamBlocksToCallback)
+{
+    std::vector<uint8_t> payload = createPayload(10 * BLOCK_LENGTH + 10);
+    CASetBlockReceivedCallback(streamBlock);
+    CABlockData_t *blockData = createBlockData("token");
+    ASSERT_TRUE(blockData != NULL);
+    blockData->payloadLength = payload.size();
+
+    EXPECT_EQ(0, receiveBlocks(blockData, "token", payload, true));
+    EXPECT_TRUE(blockData->streamed);
+    EXPECT_TRUE(blockData->payload == NULL);
+    EXPECT_EQ(payload.size(), blockData->receivedPayloadLen);
+
+    ASSERT_EQ(11u, g_streamedOffsets.size());
+    for (size_t i = 0; i < g_streamedOffsets.size(); i++)
+    {
+        EXPECT_EQ(i * BLOCK_LENGTH, g_streamedOffsets[i]);
+    }
+    EXPECT_EQ(payload, g_streamedPayload);
+    EXPECT_EQ(payload.size(), g_streamedTotalLength);
+
+    removeBlockData("token");
+}
+
+TEST_F(CABlockWiseTransferTest, ReassembleWhenCallbackDeclines)
+{
+    std::vector<uint8_t> payload = createPayload(10 * BLOCK_LENGTH);
+    g_consumeStream = false;
+    CASetBlockReceivedCallback(streamBlock);
+    CABlockData_t *blockData = createBlockData("token");
+    ASSERT_TRUE(blockData != NULL);
+
+    receiveBlocks(blockData, "token", payload, false);
+    EXPECT_FALSE(blockData->streamed);
+    EXPECT_EQ(1u, g_streamedOffsets.size());
+    ASSERT_EQ(payload.size(), blockData->receivedPayloadLen);
+    EXPECT_EQ(0, memcmp(&payload[0], blockData->payload, payload.size()));
+
+    removeBlockData("token");
+}
+
+TEST_F(CABlockWiseTransferTest, ReassemblyCostPerPayloadLength)
+{
+    const size_t payloadLengths[] = { 64 * BLOCK_LENGTH, 256 * BLOCK_LENGTH, 1024 * BLOCK_LENGTH };
+
+    for (size_t payloadLength : payloadLengths)
+    {
+        std::vector<uint8_t> payload = createPayload(payloadLength);
+        for (int isSizeOption = 1; isSizeOption >= 0; isSizeOption--)
+        {
+            CABlockData_t *blockData = createBlockData("token");
+            ASSERT_TRUE(blockData != NULL);
+            if (isSizeOption)
+            {
+                blockData->payloadLength = payloadLength;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            int allocations = receiveBlocks(blockData, "token", payload, isSizeOption);
+            auto reassembling = std::chrono::steady_clock::now() - start;
+            EXPECT_EQ(payloadLength, blockData->receivedPayloadLen);
+
+            std::string suffix = std::to_string(payloadLength / BLOCK_LENGTH) + "Blocks"
+                                 + (isSizeOption ? "WithSizeOption" : "WithoutSizeOption");
+            RecordProperty("AllocationsFor" + suffix, allocations);
+            RecordProperty("MicrosecondsFor" + suffix,
+                           (int)std::chrono::duration_cast<std::chrono::microseconds>(
+                               reassembling).count());
+
+            removeBlockData("token");
+        }
+    }
+}
+
+TEST_F(CABlockWiseTransferTest, SetPipelineDepth)
+{
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CASetBlockPipelineDepth(0));
+    EXPECT_EQ(CA_STATUS_INVALID_PARAM, CASetBlockPipelineDepth(CA_MAX_BLOCK_PIPELINE_DEPTH + 1));
+    EXPECT_EQ(CA_STATUS_OK, CASetBlockPipelineDepth(CA_MAX_BLOCK_PIPELINE_DEPTH));
+    EXPECT_EQ(CA_STATUS_OK, CASetBlockPipelineDepth(1));
+}
+
+TEST_F(CABlockWisePipelineTest, PipelinedThroughput)
+{
+    std::vector<uint8_t> payload = createPayload(64 * BLOCK_LENGTH);
+    Loopback::DelayFunc delay = [](const coap_pdu_t *, uint16_t) { return 5; };
+
+    CABlockWiseStats_t lockStep = transfer("lockstep", payload, delay);
+
+    ASSERT_EQ(CA_STATUS_OK, CASetBlockPipelineDepth(8));
+    CABlockWiseStats_t pipelined = transfer("pipeline", payload, delay);
+
+    for (const CABlockWiseStats_t *stats : { &lockStep, &pipelined })
+    {
+        EXPECT_EQ(payload.size(), stats->payloadLength);
+        EXPECT_EQ(0u, stats->lostBlocks);
+        std::string suffix = stats == &pipelined ? "AtDepth8" : "AtDepth1";
+        RecordProperty("Blocks" + suffix, (int)stats->blocks);
+        RecordProperty("Microseconds" + suffix, (int)stats->elapsedTime);
+        RecordProperty("KilobytesPerSecond" + suffix, (int)(stats->throughput / 1000));
+    }
+    EXPECT_GT(pipelined.throughput, 2 * lockStep.throughput);
+}
+
+TEST_F(CABlockWisePipelineTest, PipelinedBlocksOutOfOrder)
+{
+    std::vector<uint8_t> payload = createPayload(40 * BLOCK_LENGTH + 10);
+    ASSERT_EQ(CA_STATUS_OK, CASetBlockPipelineDepth(4));
+
+    // every third block overtakes the block before it
+    CABlockWiseStats_t stats = transfer("reorder", payload,
+        [](const coap_pdu_t *pdu, uint16_t toPort)
+        {
+            return (CLIENT_PORT == toPort && getBlockNum(pdu) % 3 == 2) ? 1 : 8;
+        });
+
+    EXPECT_EQ(payload.size(), stats.payloadLength);
+    EXPECT_LT(0u, stats.lostBlocks);
+}
+
+TEST_F(CABlockWisePipelineTest, RequestWrongBlockAgain)
+{
+    std::vector<uint8_t> payload = createPayload(20 * BLOCK_LENGTH);
+    ASSERT_EQ(CA_STATUS_OK, CASetBlockPipelineDepth(4));
+
+    bool isTruncated = false;
+    CABlockWiseStats_t stats = transfer("truncate", payload,
+        [](const coap_pdu_t *, uint16_t) { return 2; },
+        [&isTruncated](const coap_pdu_t *pdu, std::vector<uint8_t> &bytes)
+        {
+            if (!isTruncated && 5 == getBlockNum(pdu) && pdu->data)
+            {
+                isTruncated = true;
+                bytes.resize(bytes.size() - 100);
+            }
+        });
+
+    EXPECT_TRUE(isTruncated);
+    EXPECT_EQ(1u, stats.lostBlocks);
+    EXPECT_EQ(CA_BLOCK_SIZE_1024_BYTE, stats.blockSize);
+}
+
+TEST_F(CABlockWisePipelineTest, AdaptBlockSizeToLosses)
+{
+    std::vector<uint8_t> payload = createPayload(20 * BLOCK_LENGTH);
+    Loopback::DelayFunc delay = [](const coap_pdu_t *, uint16_t) { return 1; };
+
+    // the block lost in the first transfer makes the blocks smaller
+    bool isTruncated = false;
+    CABlockWiseStats_t lossy = transfer("lossy", payload, delay,
+        [&isTruncated](const coap_pdu_t *pdu, std::vector<uint8_t> &bytes)
+        {
+            if (!isTruncated && 5 == getBlockNum(pdu) && pdu->data)
+            {
+                isTruncated = true;
+                bytes.resize(bytes.size() - 100);
+            }
+        });
+    EXPECT_TRUE(isTruncated);
+    EXPECT_LT(0u, lossy.lostBlocks);
+    EXPECT_EQ(CA_BLOCK_SIZE_512_BYTE, lossy.blockSize);
+
+    // and they grow back after a transfer without loss
+    CABlockWiseStats_t clean = transfer("clean", payload, delay);
+    EXPECT_EQ(0u, clean.lostBlocks);
+    EXPECT_EQ(CA_BLOCK_SIZE_512_BYTE, clean.blockSize);
+
+    CABlockWiseStats_t grown = transfer("grown", payload, delay);
+    EXPECT_EQ(CA_BLOCK_SIZE_1024_BYTE, grown.blockSize);
+}
+
+#endif // WITH_BWT
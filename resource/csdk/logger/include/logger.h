@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdbool.h>
 #include "oc_logger.h"
 #include "oc_console_logger.h"
 
@@ -55,6 +56,12 @@ extern "C" {
 // Max buffer size used in variable argument log function
 #define MAX_LOG_V_BUFFER_SIZE (256)
 
+// Max number of tags given their own level with OCLogSetTagLevel
+#define MAX_LOG_TAG_LEVELS (16)
+
+// Max length of the tags given their own level, including the null termination
+#define MAX_LOG_TAG_LENGTH (32)
+
 // Log levels
 #ifdef __TIZEN__
 typedef enum {
@@ -97,6 +104,52 @@ typedef enum {
      */
     void OCLogShutdown();
 
+    /**
+     * Set the lowest level of the messages which are logged, DEBUG by default.
+     *
+     * @param level  - DEBUG, INFO, WARNING, ERROR, FATAL
+     */
+    void OCLogSetLevel(LogLevel level);
+
+    /**
+     * Set the lowest level of the messages which are logged with a tag, instead of the level
+     * set with OCLogSetLevel.  Up to MAX_LOG_TAG_LEVELS tags shorter than MAX_LOG_TAG_LENGTH.
+     *
+     * @param tag    - Module name
+     * @param level  - DEBUG, INFO, WARNING, ERROR, FATAL
+     */
+    void OCLogSetTagLevel(const char * tag, LogLevel level);
+
+    /**
+     * Check if a message is logged.  The log macros check it before formatting the message.
+     *
+     * @param level  - DEBUG, INFO, WARNING, ERROR, FATAL
+     * @param tag    - Module name
+     * @return true if the messages of the level are logged with the tag
+     */
+    bool OCLogIsEnabled(LogLevel level, const char * tag);
+
+    /**
+     * Write the messages from a background thread.  The logging threads queue them in
+     * their own ring buffer without locking, and drop them when it is full.
+     *
+     * @param binaryOutput - file to write the messages to as binary records, which leave
+     *                       the buffers to be formatted by the reader.  NULL to write the
+     *                       messages as text with the custom logger or the console.
+     * @return true if the background thread is started
+     */
+    bool OCLogStartAsync(FILE * binaryOutput);
+
+    /**
+     * Write the queued messages and stop the background thread.  Called by OCLogShutdown.
+     */
+    void OCLogStopAsync();
+
+    /**
+     * Wait until the messages queued are written by the background thread.
+     */
+    void OCLogFlush();
+
     /**
      * Output a variable argument list log string with the specified priority level.
      * Only defined for Linux and Android
@@ -171,6 +224,22 @@ typedef enum {
     ;
 #endif
 
+// Types of the binary log records
+typedef enum {
+    OC_LOG_RECORD_TEXT = 0,     // message string
+    OC_LOG_RECORD_BUFFER        // bytes logged with OCLogBuffer, 16 per line in hex
+} OCLogRecordType;
+
+// Header of the binary log records, in host byte order.
+// It is followed by the tag and the data, none of them null terminated.
+typedef struct {
+    uint64_t time;              // microseconds since the Epoch
+    uint8_t level;              // LogLevel
+    uint8_t type;               // OCLogRecordType
+    uint16_t tagLength;
+    uint16_t dataLength;
+} OCLogRecordHeader;
+
 #ifdef TB_LOG
 #ifdef __TIZEN__
     #define OC_LOG(level,tag,mes) LOG_(LOG_ID_MAIN, level, tag, mes)
@@ -178,22 +247,28 @@ typedef enum {
     #define OC_LOG_BUFFER(level, tag, buffer, bufferSize)
 #else // These macros are defined for Linux, Android, and Arduino
     #define OC_LOG_INIT()    OCLogInit()
-    #define OC_LOG_BUFFER(level, tag, buffer, bufferSize)  OCLogBuffer((level), PCF(tag), (buffer), (bufferSize))
 
     #ifdef ARDUINO
         #define OC_LOG_CONFIG(ctx)
         #define OC_LOG_SHUTDOWN()
         #define OC_LOG(level, tag, logStr)  OCLog((level), PCF(tag), PCF(logStr))
+        #define OC_LOG_BUFFER(level, tag, buffer, bufferSize)  OCLogBuffer((level), PCF(tag), (buffer), (bufferSize))
         // Use full namespace for logInit to avoid function name collision
         #define OC_LOG_INIT()    OCLogInit()
         // Don't define variable argument log function for Arduino
         #define OC_LOG_V(level, tag, format, ...) OCLogv((level), PCF(tag), PCF(format), __VA_ARGS__)
     #else
+        // The level is checked before the arguments are evaluated and formatted
         #define OC_LOG_CONFIG(ctx)    OCLogConfig((ctx))
-        #define OC_LOG(level, tag, logStr)  OCLog((level), (tag), (logStr))
+        #define OC_LOG(level, tag, logStr) \
+            do { if (OCLogIsEnabled((level), (tag))) OCLog((level), (tag), (logStr)); } while (0)
+        #define OC_LOG_BUFFER(level, tag, buffer, bufferSize) \
+            do { if (OCLogIsEnabled((level), (tag))) \
+                     OCLogBuffer((level), (tag), (buffer), (bufferSize)); } while (0)
         #define OC_LOG_SHUTDOWN()     OCLogShutdown()
         // Define variable argument log function for Linux and Android
-        #define OC_LOG_V(level, tag, ...)  OCLogv((level), (tag), __VA_ARGS__)
+        #define OC_LOG_V(level, tag, ...) \
+            do { if (OCLogIsEnabled((level), (tag))) OCLogv((level), (tag), __VA_ARGS__); } while (0)
     #endif
 #endif
 #else
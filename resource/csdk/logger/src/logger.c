@@ -48,6 +48,10 @@
 
 #include "logger.h"
 #include "string.h"
+#if !defined(ARDUINO) && !defined(__TIZEN__)
+#include <stdlib.h>
+#include <pthread.h>
+#endif
 #include "oc_logger.h"
 #include "oc_console_logger.h"
 
@@ -90,6 +94,66 @@ static const uint16_t LINE_BUFFER_SIZE = (16 * 2) + 16 + 1;  // Show 16 bytes, 2
 
 #ifndef ARDUINO
 #ifndef __TIZEN__
+
+// Number of messages queued by a thread for the background writer
+#define LOG_RING_SLOTS (128)
+
+// Time waited by the background writer when no message is queued, in nanoseconds
+#define LOG_WRITER_WAIT_NS (10 * 1000 * 1000)
+
+// Tag used for the messages of the logger itself
+#define LOG_TAG "OCLog"
+
+typedef struct {
+    char tag[MAX_LOG_TAG_LENGTH];
+    LogLevel level;
+} LogTagLevel;
+
+// Levels changed at run time, read without locking by the logging threads
+static LogLevel globalLevel = DEBUG;
+static LogLevel lowestLevel = DEBUG;     // lowest of globalLevel and the tag levels
+static LogTagLevel tagLevels[MAX_LOG_TAG_LEVELS];
+static uint32_t tagLevelCount = 0;       // published after the entry is written
+static pthread_mutex_t levelMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Message queued for the background writer
+typedef struct {
+    uint64_t time;
+    LogLevel level;
+    OCLogRecordType type;
+    uint16_t dataLength;
+    char tag[MAX_LOG_TAG_LENGTH];
+    char data[MAX_LOG_V_BUFFER_SIZE];
+} LogSlot;
+
+// Ring buffer of a logging thread.  The thread only writes head and the background writer
+// only writes tail, both increase forever and wrap around with the unsigned arithmetic.
+typedef struct LogRing {
+    LogSlot slots[LOG_RING_SLOTS];
+    uint32_t head;
+    uint32_t tail;
+    uint32_t dropped;                    // messages dropped because the ring was full
+    bool isOrphan;                       // the thread exited, freed once the ring is empty
+    struct LogRing *next;
+} LogRing;
+
+static LogRing *rings = NULL;            // protected by ringMutex
+static pthread_mutex_t ringMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t ringKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t ringKey;
+
+static bool isAsync = false;
+static bool isWriterRunning = false;
+static FILE *binaryFile = NULL;
+static pthread_t writerThread;
+static pthread_mutex_t writerMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t writerCond = PTHREAD_COND_INITIALIZER;
+
+static void OCLogWrite(LogLevel level, const char * tag, uint64_t time, const char * logStr);
+
+static void OCLogWriteBuffer(LogLevel level, const char * tag, uint64_t time,
+                             const uint8_t * buffer, uint16_t bufferSize);
+
 void OCLogConfig(oc_log_ctx_t *ctx) {
     logCtx = ctx;
 }
@@ -99,6 +163,7 @@ void OCLogInit() {
 }
 
 void OCLogShutdown() {
+    OCLogStopAsync();
 #if defined(__linux__) || defined(__APPLE__)
     if (logCtx && logCtx->destroy)
     {
@@ -107,68 +172,379 @@ void OCLogShutdown() {
 #endif
 }
 
+static void OCLogUpdateLowestLevel() {
+    LogLevel lowest = globalLevel;
+    uint32_t i;
+    for (i = 0; i < tagLevelCount; i++) {
+        if (tagLevels[i].level < lowest) {
+            lowest = tagLevels[i].level;
+        }
+    }
+    __atomic_store_n(&lowestLevel, lowest, __ATOMIC_RELAXED);
+}
+
+void OCLogSetLevel(LogLevel level) {
+    pthread_mutex_lock(&levelMutex);
+    __atomic_store_n(&globalLevel, level, __ATOMIC_RELAXED);
+    OCLogUpdateLowestLevel();
+    pthread_mutex_unlock(&levelMutex);
+}
+
+void OCLogSetTagLevel(const char * tag, LogLevel level) {
+    if (!tag || strlen(tag) >= MAX_LOG_TAG_LENGTH) {
+        return;
+    }
+
+    pthread_mutex_lock(&levelMutex);
+    uint32_t i;
+    for (i = 0; i < tagLevelCount; i++) {
+        if (!strcmp(tagLevels[i].tag, tag)) {
+            break;
+        }
+    }
+    if (i < tagLevelCount) {
+        __atomic_store_n(&tagLevels[i].level, level, __ATOMIC_RELAXED);
+    } else if (tagLevelCount < MAX_LOG_TAG_LEVELS) {
+        strcpy(tagLevels[i].tag, tag);
+        tagLevels[i].level = level;
+        __atomic_store_n(&tagLevelCount, tagLevelCount + 1, __ATOMIC_RELEASE);
+    }
+    OCLogUpdateLowestLevel();
+    pthread_mutex_unlock(&levelMutex);
+}
+
+bool OCLogIsEnabled(LogLevel level, const char * tag) {
+    // Most messages are below every level set, don't look at the tags for them
+    if (level < __atomic_load_n(&lowestLevel, __ATOMIC_RELAXED)) {
+        return false;
+    }
+
+    uint32_t count = __atomic_load_n(&tagLevelCount, __ATOMIC_ACQUIRE);
+    uint32_t i;
+    for (i = 0; tag && i < count; i++) {
+        if (!strcmp(tagLevels[i].tag, tag)) {
+            return level >= __atomic_load_n(&tagLevels[i].level, __ATOMIC_RELAXED);
+        }
+    }
+    return level >= __atomic_load_n(&globalLevel, __ATOMIC_RELAXED);
+}
+
+static uint64_t osalGetTime()
+{
+#if defined(_POSIX_TIMERS) && _POSIX_TIMERS > 0
+    struct timespec when = { .tv_sec = 0 };
+    clockid_t clk = CLOCK_REALTIME;
+#ifdef CLOCK_REALTIME_COARSE
+    clk = CLOCK_REALTIME_COARSE;
+#endif
+    if (!clock_gettime(clk, &when))
+    {
+        return (uint64_t)when.tv_sec * 1000000 + when.tv_nsec / 1000;
+    }
+#else
+    struct timeval now;
+    if (!gettimeofday(&now, NULL))
+    {
+        return (uint64_t)now.tv_sec * 1000000 + now.tv_usec;
+    }
+#endif
+    return 0;
+}
+
+static void OCLogFreeRing(void *ring) {
+    // Called when the thread exits, the writer frees the ring once it is empty
+    __atomic_store_n(&((LogRing *)ring)->isOrphan, true, __ATOMIC_RELEASE);
+}
+
+static void OCLogCreateRingKey() {
+    pthread_key_create(&ringKey, OCLogFreeRing);
+}
+
+static LogRing *OCLogGetRing() {
+    pthread_once(&ringKeyOnce, OCLogCreateRingKey);
+    LogRing *ring = (LogRing *)pthread_getspecific(ringKey);
+    if (ring) {
+        return ring;
+    }
+
+    ring = (LogRing *)calloc(1, sizeof(LogRing));
+    if (!ring) {
+        return NULL;
+    }
+    if (pthread_setspecific(ringKey, ring)) {
+        free(ring);
+        return NULL;
+    }
+    pthread_mutex_lock(&ringMutex);
+    ring->next = rings;
+    rings = ring;
+    pthread_mutex_unlock(&ringMutex);
+    return ring;
+}
+
 /**
- * Output a variable argument list log string with the specified priority level.
- * Only defined for Linux and Android
+ * Get the slot of the calling thread to queue a message in.
  *
  * @param level  - DEBUG, INFO, WARNING, ERROR, FATAL
  * @param tag    - Module name
- * @param format - variadic log string
+ * @param type   - OC_LOG_RECORD_TEXT or OC_LOG_RECORD_BUFFER
+ * @param ring   - ring buffer of the thread, to give to OCLogCommitSlot
+ * @return the slot with its header filled, NULL if the message is not queued
  */
-void OCLogv(LogLevel level, const char * tag, const char * format, ...) {
-    if (!format || !tag) {
+static LogSlot *OCLogReserveSlot(LogLevel level, const char * tag, OCLogRecordType type,
+                                 LogRing **ring) {
+    *ring = OCLogGetRing();
+    if (!*ring) {
+        return NULL;
+    }
+
+    uint32_t head = (*ring)->head;
+    if (head - __atomic_load_n(&(*ring)->tail, __ATOMIC_ACQUIRE) >= LOG_RING_SLOTS) {
+        __atomic_add_fetch(&(*ring)->dropped, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    LogSlot *slot = &(*ring)->slots[head % LOG_RING_SLOTS];
+    slot->time = osalGetTime();
+    slot->level = level;
+    slot->type = type;
+    strncpy(slot->tag, tag, sizeof slot->tag - 1);
+    slot->tag[sizeof slot->tag - 1] = '\0';
+    return slot;
+}
+
+static void OCLogCommitSlot(LogRing *ring) {
+    uint32_t head = ring->head;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    // Wake the writer when the ring was empty, it polls anyway when a signal is missed
+    if (head == __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)) {
+        pthread_cond_signal(&writerCond);
+    }
+}
+
+static void OCLogWriteSlot(const LogSlot *slot) {
+    if (binaryFile) {
+        OCLogRecordHeader header = {
+            .time = slot->time,
+            .level = slot->level,
+            .type = slot->type,
+            .tagLength = strlen(slot->tag),
+            .dataLength = slot->dataLength
+        };
+        fwrite(&header, sizeof header, 1, binaryFile);
+        fwrite(slot->tag, 1, header.tagLength, binaryFile);
+        fwrite(slot->data, 1, header.dataLength, binaryFile);
+    } else if (slot->type == OC_LOG_RECORD_BUFFER) {
+        OCLogWriteBuffer(slot->level, slot->tag, slot->time,
+                         (const uint8_t *)slot->data, slot->dataLength);
+    } else {
+        OCLogWrite(slot->level, slot->tag, slot->time, slot->data);
+    }
+}
+
+/**
+ * Write the oldest message queued by the logging threads.
+ * Only called by the background writer.
+ *
+ * @return true if a message is written
+ */
+static bool OCLogWriteNext() {
+    LogRing *oldest = NULL;
+    uint64_t oldestTime = 0;
+    uint32_t dropped = 0;
+
+    pthread_mutex_lock(&ringMutex);
+    LogRing **prev = &rings;
+    while (*prev) {
+        LogRing *ring = *prev;
+        bool isOrphan = __atomic_load_n(&ring->isOrphan, __ATOMIC_ACQUIRE);
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        dropped += __atomic_exchange_n(&ring->dropped, 0, __ATOMIC_RELAXED);
+
+        if (head != ring->tail) {
+            const LogSlot *slot = &ring->slots[ring->tail % LOG_RING_SLOTS];
+            if (!oldest || slot->time < oldestTime) {
+                oldest = ring;
+                oldestTime = slot->time;
+            }
+        } else if (isOrphan) {
+            *prev = ring->next;
+            free(ring);
+            continue;
+        }
+        prev = &ring->next;
+    }
+    pthread_mutex_unlock(&ringMutex);
+
+    if (dropped) {
+        LogSlot notice = {
+            .time = osalGetTime(),
+            .level = WARNING,
+            .type = OC_LOG_RECORD_TEXT,
+            .tag = LOG_TAG
+        };
+        notice.dataLength = snprintf(notice.data, sizeof notice.data,
+                                     "%u messages dropped", dropped);
+        OCLogWriteSlot(&notice);
+    }
+
+    if (!oldest) {
+        return false;
+    }
+
+    // Orphan rings are only freed by this thread, the slot stays valid
+    OCLogWriteSlot(&oldest->slots[oldest->tail % LOG_RING_SLOTS]);
+    __atomic_store_n(&oldest->tail, oldest->tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static void *OCLogWriterThread(void *arg) {
+    (void)arg;
+    pthread_mutex_lock(&writerMutex);
+    while (isWriterRunning) {
+        pthread_mutex_unlock(&writerMutex);
+        bool isWritten = OCLogWriteNext();
+        pthread_mutex_lock(&writerMutex);
+
+        if (!isWritten && isWriterRunning) {
+            if (binaryFile) {
+                fflush(binaryFile);
+            }
+            struct timespec until = { .tv_sec = 0 };
+            clock_gettime(CLOCK_REALTIME, &until);
+            until.tv_nsec += LOG_WRITER_WAIT_NS;
+            if (until.tv_nsec >= 1000000000) {
+                until.tv_sec++;
+                until.tv_nsec -= 1000000000;
+            }
+            pthread_cond_timedwait(&writerCond, &writerMutex, &until);
+        }
+    }
+    pthread_mutex_unlock(&writerMutex);
+
+    while (OCLogWriteNext()) {
+    }
+    return NULL;
+}
+
+bool OCLogStartAsync(FILE * binaryOutput) {
+    pthread_mutex_lock(&writerMutex);
+    if (isWriterRunning) {
+        pthread_mutex_unlock(&writerMutex);
+        return false;
+    }
+    binaryFile = binaryOutput;
+    isWriterRunning = true;
+    if (pthread_create(&writerThread, NULL, OCLogWriterThread, NULL)) {
+        isWriterRunning = false;
+        binaryFile = NULL;
+        pthread_mutex_unlock(&writerMutex);
+        return false;
+    }
+    pthread_mutex_unlock(&writerMutex);
+
+    __atomic_store_n(&isAsync, true, __ATOMIC_RELEASE);
+    return true;
+}
+
+static void OCLogStopWriter() {
+    pthread_mutex_lock(&writerMutex);
+    if (!isWriterRunning) {
+        pthread_mutex_unlock(&writerMutex);
         return;
     }
-    char buffer[MAX_LOG_V_BUFFER_SIZE] = {};
-    va_list args;
-    va_start(args, format);
-    vsnprintf(buffer, sizeof buffer - 1, format, args);
-    va_end(args);
-    OCLog(level, tag, buffer);
+    isWriterRunning = false;
+    pthread_cond_signal(&writerCond);
+    pthread_mutex_unlock(&writerMutex);
+
+    pthread_join(writerThread, NULL);
+    if (binaryFile) {
+        fflush(binaryFile);
+        binaryFile = NULL;
+    }
 }
 
-static void osalGetTime(int *min,int *sec, int *ms)
-{
-    if (min && sec && ms)
-    {
-#if defined(_POSIX_TIMERS) && _POSIX_TIMERS > 0
-        struct timespec when = { .tv_sec = 0 };
-        clockid_t clk = CLOCK_REALTIME;
-#ifdef CLOCK_REALTIME_COARSE
-        clk = CLOCK_REALTIME_COARSE;
-#endif
-        if (!clock_gettime(clk, &when))
-        {
-            *min = (when.tv_sec / 60) % 60;
-            *sec = when.tv_sec % 60;
-            *ms = when.tv_nsec / 1000000;
+void OCLogStopAsync() {
+    // The messages logged from now on are written by their thread
+    __atomic_store_n(&isAsync, false, __ATOMIC_RELEASE);
+    OCLogStopWriter();
+}
+
+void OCLogFlush() {
+    if (!__atomic_load_n(&isAsync, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    bool isPending = true;
+    while (isPending) {
+        isPending = false;
+        pthread_mutex_lock(&ringMutex);
+        LogRing *ring;
+        for (ring = rings; ring; ring = ring->next) {
+            if (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) !=
+                __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)) {
+                isPending = true;
+                break;
+            }
         }
-#else
-        struct timeval now;
-        if (!gettimeofday(&now, NULL))
-        {
-            *min = (now.tv_sec / 60) % 60;
-            *sec = now.tv_sec % 60;
-            *ms = now.tv_usec * 1000;
+        pthread_mutex_unlock(&ringMutex);
+
+        if (isPending) {
+            pthread_cond_signal(&writerCond);
+            struct timespec pause = { .tv_sec = 0, .tv_nsec = 1000000 };
+            nanosleep(&pause, NULL);
         }
-#endif
     }
+
+    pthread_mutex_lock(&writerMutex);
+    if (binaryFile) {
+        fflush(binaryFile);
+    }
+    pthread_mutex_unlock(&writerMutex);
 }
 
 /**
- * Output a log string with the specified priority level.
+ * Output a variable argument list log string with the specified priority level.
  * Only defined for Linux and Android
  *
  * @param level  - DEBUG, INFO, WARNING, ERROR, FATAL
  * @param tag    - Module name
- * @param logStr - log string
+ * @param format - variadic log string
  */
-void OCLog(LogLevel level, const char * tag, const char * logStr) {
-    if (!logStr || !tag) {
+void OCLogv(LogLevel level, const char * tag, const char * format, ...) {
+    if (!format || !tag || !OCLogIsEnabled(level, tag)) {
         return;
     }
 
+    va_list args;
+    va_start(args, format);
+    if (__atomic_load_n(&isAsync, __ATOMIC_ACQUIRE)) {
+        // Format straight into the ring, the writer has nothing left to format
+        LogRing *ring = NULL;
+        LogSlot *slot = OCLogReserveSlot(level, tag, OC_LOG_RECORD_TEXT, &ring);
+        if (slot) {
+            int length = vsnprintf(slot->data, sizeof slot->data, format, args);
+            if (length < 0) {
+                length = 0;
+            } else if (length >= (int)sizeof slot->data) {
+                length = sizeof slot->data - 1;
+            }
+            slot->dataLength = length;
+            OCLogCommitSlot(ring);
+        }
+        va_end(args);
+        return;
+    }
+
+    char buffer[MAX_LOG_V_BUFFER_SIZE] = {};
+    vsnprintf(buffer, sizeof buffer - 1, format, args);
+    va_end(args);
+    OCLogWrite(level, tag, osalGetTime(), buffer);
+}
+
+static void OCLogWrite(LogLevel level, const char * tag, uint64_t time, const char * logStr) {
 #ifdef __ANDROID__
+    (void)time;
     __android_log_write(LEVEL[level], tag, logStr);
 #elif defined(__linux__) || defined(__APPLE__)
     if (logCtx && logCtx->write_level)
@@ -177,10 +553,10 @@ void OCLog(LogLevel level, const char * tag, const char * logStr) {
     }
     else
     {
-        int min = 0;
-        int sec = 0;
-        int ms = 0;
-        osalGetTime(&min,&sec,&ms);
+        uint64_t seconds = time / 1000000;
+        int min = (seconds / 60) % 60;
+        int sec = seconds % 60;
+        int ms = (time % 1000000) / 1000;
 
         printf("%02d:%02d.%03d %s: %s: %s\n", min, sec, ms, LEVEL[level], tag, logStr);
     }
@@ -188,18 +564,39 @@ void OCLog(LogLevel level, const char * tag, const char * logStr) {
 }
 
 /**
- * Output the contents of the specified buffer (in hex) with the specified priority level.
+ * Output a log string with the specified priority level.
+ * Only defined for Linux and Android
  *
- * @param level      - DEBUG, INFO, WARNING, ERROR, FATAL
- * @param tag        - Module name
- * @param buffer     - pointer to buffer of bytes
- * @param bufferSize - max number of byte in buffer
+ * @param level  - DEBUG, INFO, WARNING, ERROR, FATAL
+ * @param tag    - Module name
+ * @param logStr - log string
  */
-void OCLogBuffer(LogLevel level, const char * tag, const uint8_t * buffer, uint16_t bufferSize) {
-    if (!buffer || !tag || (bufferSize == 0)) {
+void OCLog(LogLevel level, const char * tag, const char * logStr) {
+    if (!logStr || !tag || !OCLogIsEnabled(level, tag)) {
+        return;
+    }
+
+    if (__atomic_load_n(&isAsync, __ATOMIC_ACQUIRE)) {
+        LogRing *ring = NULL;
+        LogSlot *slot = OCLogReserveSlot(level, tag, OC_LOG_RECORD_TEXT, &ring);
+        if (slot) {
+            size_t length = strlen(logStr);
+            if (length >= sizeof slot->data) {
+                length = sizeof slot->data - 1;
+            }
+            memcpy(slot->data, logStr, length);
+            slot->data[length] = '\0';
+            slot->dataLength = length;
+            OCLogCommitSlot(ring);
+        }
         return;
     }
 
+    OCLogWrite(level, tag, osalGetTime(), logStr);
+}
+
+static void OCLogWriteBuffer(LogLevel level, const char * tag, uint64_t time,
+                             const uint8_t * buffer, uint16_t bufferSize) {
     // No idea why the static initialization won't work here, it seems the compiler is convinced
     // that this is a variable-sized object.
     char lineBuffer[LINE_BUFFER_SIZE];
@@ -212,14 +609,52 @@ void OCLogBuffer(LogLevel level, const char * tag, const uint8_t * buffer, uint1
         lineIndex++;
         // Output 16 values per line
         if (((i+1)%16) == 0) {
-            OCLog(level, tag, lineBuffer);
+            OCLogWrite(level, tag, time, lineBuffer);
             memset(lineBuffer, 0, sizeof lineBuffer);
             lineIndex = 0;
         }
     }
     // Output last values in the line, if any
     if (bufferSize % 16) {
-        OCLog(level, tag, lineBuffer);
+        OCLogWrite(level, tag, time, lineBuffer);
+    }
+}
+
+/**
+ * Output the contents of the specified buffer (in hex) with the specified priority level.
+ *
+ * @param level      - DEBUG, INFO, WARNING, ERROR, FATAL
+ * @param tag        - Module name
+ * @param buffer     - pointer to buffer of bytes
+ * @param bufferSize - max number of byte in buffer
+ */
+void OCLogBuffer(LogLevel level, const char * tag, const uint8_t * buffer, uint16_t bufferSize) {
+    if (!buffer || !tag || (bufferSize == 0) || !OCLogIsEnabled(level, tag)) {
+        return;
+    }
+
+    if (!__atomic_load_n(&isAsync, __ATOMIC_ACQUIRE)) {
+        OCLogWriteBuffer(level, tag, osalGetTime(), buffer, bufferSize);
+        return;
+    }
+
+    // Queue the bytes, they are formatted by the writer or the reader of the binary log.
+    // The slots hold a multiple of 16 bytes so the lines are the same.
+    uint16_t offset = 0;
+    while (offset < bufferSize) {
+        LogRing *ring = NULL;
+        LogSlot *slot = OCLogReserveSlot(level, tag, OC_LOG_RECORD_BUFFER, &ring);
+        if (!slot) {
+            return;
+        }
+        uint16_t length = bufferSize - offset;
+        if (length > sizeof slot->data) {
+            length = sizeof slot->data;
+        }
+        memcpy(slot->data, buffer + offset, length);
+        slot->dataLength = length;
+        OCLogCommitSlot(ring);
+        offset += length;
     }
 }
 #endif //__TIZEN__
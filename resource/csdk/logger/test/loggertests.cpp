@@ -36,6 +36,7 @@ extern "C" {
 
 #include <iostream>
 #include <stdint.h>
+#include <pthread.h>
 using namespace std;
 
 
@@ -364,3 +365,133 @@ TEST(LoggerTest, LogBuffer) {
         EXPECT_STREQ(stdFileMD5, testFileMD5);
     }
 }
+
+TEST(LoggerTest, RuntimeLevels) {
+    const char *tag = "RuntimeLevels";
+    const char *verboseTag = "RuntimeLevelsVerbose";
+
+    OCLogSetLevel(WARNING);
+    EXPECT_FALSE(OCLogIsEnabled(INFO, tag));
+    EXPECT_TRUE(OCLogIsEnabled(WARNING, tag));
+    EXPECT_FALSE(OCLogIsEnabled(DEBUG, verboseTag));
+
+    OCLogSetTagLevel(verboseTag, DEBUG);
+    EXPECT_TRUE(OCLogIsEnabled(DEBUG, verboseTag));
+    EXPECT_FALSE(OCLogIsEnabled(INFO, tag));
+
+    // The arguments of the messages not logged are not evaluated
+    int calls = 0;
+    OC_LOG_V(INFO, tag, "call %d", ++calls);
+    EXPECT_EQ(0, calls);
+    OC_LOG_V(ERROR, tag, "call %d", ++calls);
+    EXPECT_EQ(1, calls);
+
+    OCLogSetTagLevel(verboseTag, FATAL);
+    EXPECT_FALSE(OCLogIsEnabled(ERROR, verboseTag));
+    EXPECT_TRUE(OCLogIsEnabled(ERROR, tag));
+
+    OCLogSetLevel(DEBUG);
+    EXPECT_TRUE(OCLogIsEnabled(DEBUG, tag));
+}
+
+static bool readRecord(FILE *file, OCLogRecordHeader *header, char *tag, char *data) {
+    if (fread(header, sizeof *header, 1, file) != 1 ||
+        header->tagLength >= MAX_LOG_TAG_LENGTH ||
+        header->dataLength > MAX_LOG_V_BUFFER_SIZE ||
+        fread(tag, 1, header->tagLength, file) != header->tagLength ||
+        fread(data, 1, header->dataLength, file) != header->dataLength) {
+        return false;
+    }
+    tag[header->tagLength] = '\0';
+    return true;
+}
+
+TEST(LoggerTest, AsyncBinaryLog) {
+    const char *tag = "AsyncBinaryLog";
+    FILE *file = tmpfile();
+    ASSERT_TRUE(file != NULL);
+    ASSERT_TRUE(OCLogStartAsync(file));
+    EXPECT_FALSE(OCLogStartAsync(file));
+
+    uint8_t buffer[300];
+    for (int i = 0; i < (int)(sizeof buffer); i++) {
+        buffer[i] = i;
+    }
+    OC_LOG_V(INFO, tag, "this is an integer: %d", 123);
+    OC_LOG_BUFFER(DEBUG, tag, buffer, sizeof buffer);
+    OCLogStopAsync();
+
+    rewind(file);
+    OCLogRecordHeader header;
+    char recordTag[MAX_LOG_TAG_LENGTH];
+    char data[MAX_LOG_V_BUFFER_SIZE + 1];
+
+    ASSERT_TRUE(readRecord(file, &header, recordTag, data));
+    EXPECT_EQ(INFO, header.level);
+    EXPECT_EQ(OC_LOG_RECORD_TEXT, header.type);
+    EXPECT_STREQ(tag, recordTag);
+    data[header.dataLength] = '\0';
+    EXPECT_STREQ("this is an integer: 123", data);
+    EXPECT_NE(0u, header.time);
+
+    // The buffer is kept in binary, split in records of whole lines
+    size_t offset = 0;
+    while (offset < sizeof buffer) {
+        ASSERT_TRUE(readRecord(file, &header, recordTag, data));
+        EXPECT_EQ(DEBUG, header.level);
+        EXPECT_EQ(OC_LOG_RECORD_BUFFER, header.type);
+        if (offset + header.dataLength < sizeof buffer) {
+            EXPECT_EQ(0, header.dataLength % 16);
+        }
+        EXPECT_EQ(0, memcmp(buffer + offset, data, header.dataLength));
+        offset += header.dataLength;
+    }
+    EXPECT_EQ(sizeof buffer, offset);
+    EXPECT_FALSE(readRecord(file, &header, recordTag, data));
+    fclose(file);
+}
+
+static const int ASYNC_THREAD_MESSAGES = 100;
+
+static void *logFromThread(void *arg) {
+    for (int i = 0; i < ASYNC_THREAD_MESSAGES; i++) {
+        OC_LOG_V(INFO, (const char *)arg, "%d", i);
+    }
+    return NULL;
+}
+
+TEST(LoggerTest, AsyncFromThreads) {
+    const char *tags[] = { "AsyncThread0", "AsyncThread1", "AsyncThread2", "AsyncThread3" };
+    const int threadCount = sizeof tags / sizeof tags[0];
+    FILE *file = tmpfile();
+    ASSERT_TRUE(file != NULL);
+    ASSERT_TRUE(OCLogStartAsync(file));
+
+    pthread_t threads[threadCount];
+    for (int i = 0; i < threadCount; i++) {
+        ASSERT_EQ(0, pthread_create(&threads[i], NULL, logFromThread, (void *)tags[i]));
+    }
+    for (int i = 0; i < threadCount; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    OCLogFlush();
+    OCLogStopAsync();
+
+    // Every message is written once, in the order of its thread
+    rewind(file);
+    int next[threadCount] = {};
+    OCLogRecordHeader header;
+    char recordTag[MAX_LOG_TAG_LENGTH];
+    char data[MAX_LOG_V_BUFFER_SIZE + 1];
+    while (readRecord(file, &header, recordTag, data)) {
+        data[header.dataLength] = '\0';
+        int thread = recordTag[strlen(recordTag) - 1] - '0';
+        ASSERT_TRUE(thread >= 0 && thread < threadCount);
+        EXPECT_EQ(next[thread], atoi(data));
+        next[thread]++;
+    }
+    for (int i = 0; i < threadCount; i++) {
+        EXPECT_EQ(ASYNC_THREAD_MESSAGES, next[i]);
+    }
+    fclose(file);
+}
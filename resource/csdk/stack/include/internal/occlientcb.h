@@ -40,6 +40,9 @@
  * Data structure For presence Discovery.
  * This is the TTL associated with presence.
  */
+/** Index of the presence callbacks not waiting for a deadline.*/
+#define PRESENCE_NOT_SCHEDULED SIZE_MAX
+
 typedef struct OCPresence
 {
     /** Time to Live. */
@@ -50,6 +53,12 @@ typedef struct OCPresence
 
     /** TTL Level. */
     uint32_t TTLlevel;
+
+    /** Ticks at which the presence has to be checked again.*/
+    uint32_t deadline;
+
+    /** Position of the callback in the presence schedule, or PRESENCE_NOT_SCHEDULED.*/
+    size_t heapIndex;
 } OCPresence;
 
 /**
@@ -201,6 +210,38 @@ ClientCB* GetClientCB(const CAToken_t token, uint8_t tokenLength,
  */
 
 OCStackResult InsertResourceTypeFilter(ClientCB * cbNode, char * resourceTypeName);
+
+/**
+ * Schedules the next presence check of this cb node, or moves it to a new deadline.
+ * Presence callbacks are ordered by deadline apart from cbList, so checking them does
+ * not scan the other callbacks.
+ *
+ * @param[in] cbNode      the node to schedule, with its presence allocated.
+ * @param[in] deadline    ticks at which the presence has to be checked.
+ *
+ * @return
+ *      OC_STACK_OK on success
+ *      OC_STACK_INVALID_PARAM with invalid parameters
+ *      OC_STACK_NO_MEMORY when out of memory
+ */
+OCStackResult SchedulePresenceCB(ClientCB * cbNode, uint32_t deadline);
+
+/**
+ * Removes this cb node from the presence schedule, if it is scheduled.
+ *
+ * @param[in] cbNode    the node to remove.
+ */
+void UnschedulePresenceCB(ClientCB * cbNode);
+
+/**
+ * Gets the presence callback with the earliest deadline, if it has passed.
+ * The callback stays scheduled until it is moved or removed.
+ *
+ * @param[in] now    current ticks.
+ *
+ * @return the expired cb node, NULL if no deadline has passed.
+ */
+ClientCB* GetExpiredPresenceCB(uint32_t now);
 #endif // WITH_PRESENCE
 
 /** @ingroup ocstack
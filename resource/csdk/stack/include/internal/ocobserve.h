@@ -39,6 +39,24 @@
 /** Maximum number of observers to reach for resources with low QOS */
 #define MAX_OBSERVER_NON_COUNT           (3)
 
+/**
+ * Policy limiting the notifications of a resource or an observer, see ::OCObservePolicy.
+ */
+typedef struct ObservePolicy
+{
+    /** Minimum time between two notifications, in milliseconds; 0 for none.*/
+    uint32_t interval;
+
+    /** Send the latest value once the interval is over.*/
+    bool coalesce;
+
+    /** Property the change threshold applies to; NULL for none.*/
+    char *changeProperty;
+
+    /** Minimum change of changeProperty.*/
+    double changeThreshold;
+} ObservePolicy;
+
 /**
  * Data structure to hold informations for each registered observer.
  */
@@ -83,6 +101,27 @@ typedef struct ResourceObserver
     /** requested payload encoding format. */
     OCPayloadFormat acceptFormat;
 
+    /** Policy of this observer overriding the one of the resource; NULL for none.*/
+    ObservePolicy *policy;
+
+    /** Time the last notification was sent, in ticks.*/
+    uint32_t lastNotified;
+
+    /** Value of the change property in the last notification sent.*/
+    double lastValue;
+
+    /** True once lastValue is set.*/
+    bool hasLastValue;
+
+    /** True when a notification withheld by the policy is to be sent after the interval.*/
+    bool pending;
+
+    /** Quality of service of the pending notification.*/
+    OCQualityOfService pendingQos;
+
+    /** Payload of the pending notification, NULL to ask the entity handler for it.*/
+    OCRepPayload *pendingPayload;
+
 } ResourceObserver;
 
 #ifdef WITH_PRESENCE
@@ -131,6 +170,55 @@ OCStackResult SendListObserverNotification (OCResource * resource,
         const OCRepPayload *payload, uint32_t maxAge,
         OCQualityOfService qos);
 
+/**
+ * Set the policy of a resource, or of one of its observers when observer is not NULL.
+ *
+ * @param resource        Observed resource.
+ * @param observer        Observer of the resource, or NULL.
+ * @param policy          Policy to apply, NULL to remove the current one.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult SetObservePolicy (OCResource *resource, ResourceObserver *observer,
+                                const OCObservePolicy *policy);
+
+/**
+ * Remove the policies of a resource and of its observers and drop their pending
+ * notifications, so that the resource can be deleted.
+ *
+ * @param resource        Resource being deleted.
+ */
+void DeleteObservePolicies (OCResource *resource);
+
+/**
+ * Check a notification about to be sent against the change threshold of the observer, and
+ * count it as suppressed if it is below.
+ *
+ * @param token           Token of the observer.
+ * @param tokenLength     Length of token.
+ * @param payload         Payload of the notification, may be NULL.
+ *
+ * @return true if the notification is to be sent.
+ */
+bool AcceptObserverNotification (const CAToken_t token, uint8_t tokenLength,
+                                 const OCPayload *payload);
+
+/**
+ * Record a notification sent to the observer, which starts its interval and becomes the
+ * reference of its change threshold, and count it as delivered.
+ *
+ * @param token           Token of the observer.
+ * @param tokenLength     Length of token.
+ * @param payload         Payload of the notification, may be NULL.
+ */
+void ObserverNotificationSent (const CAToken_t token, uint8_t tokenLength,
+                               const OCPayload *payload);
+
+/**
+ * Send the notifications withheld by coalescing policies whose interval is over.
+ */
+void SendPendingObserverNotifications ();
+
 /**
  * Delete all observers in the observe list.
  */
@@ -0,0 +1,149 @@
+//******************************************************************
+//
+// Copyright 2015 Intel Mobile Communications GmbH All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+/**
+ * @file
+ *
+ * This file contains the interfaces of the regions which payload trees living for the
+ * duration of a single handler are allocated in.
+ */
+
+#ifndef OC_PAYLOAD_ARENA_H
+#define OC_PAYLOAD_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "octypes.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * Region in which the memory of a payload tree is bump allocated. Nothing is freed until
+ * the whole region is destroyed. Heap memory handed over to the payloads of the region is
+ * recorded and freed along with it.
+ */
+typedef struct OCPayloadArena OCPayloadArena;
+
+/**
+ * Destructor of a heap allocation handed over to a region.
+ */
+typedef void (*OCPayloadArenaDestructor)(void *ptr);
+
+/**
+ * Counters of a region, for measurements.
+ */
+typedef struct
+{
+    /** Allocations served by the region.*/
+    size_t allocations;
+    /** Blocks of memory obtained from the heap.*/
+    size_t blocks;
+    /** Heap allocations handed over to the region.*/
+    size_t adopted;
+} OCPayloadArenaStats;
+
+/**
+ * Creates a region.
+ *
+ * @param sizeHint    Expected number of bytes allocated in the region, which sizes its
+ *                    first block.
+ *
+ * @return The region, or NULL without memory.
+ */
+OCPayloadArena *OCPayloadArenaCreate(size_t sizeHint);
+
+/**
+ * Frees a region, all the memory allocated in it and the heap allocations handed over to it.
+ *
+ * @param arena    Region to free.
+ */
+void OCPayloadArenaDestroy(OCPayloadArena *arena);
+
+/**
+ * Allocates zeroed memory in a region, aligned for any type.
+ *
+ * @param arena   Region to allocate in.
+ * @param size    Number of bytes.
+ *
+ * @return The memory, or NULL without memory or if size is 0.
+ */
+void *OCPayloadArenaAlloc(OCPayloadArena *arena, size_t size);
+
+/**
+ * Copies a string in a region.
+ *
+ * @param arena   Region to allocate in.
+ * @param str     String to copy.
+ *
+ * @return The copy, or NULL without memory or if str is NULL.
+ */
+char *OCPayloadArenaStrdup(OCPayloadArena *arena, const char *str);
+
+/**
+ * Checks if memory was allocated in a region.
+ *
+ * @param arena   Region to check.
+ * @param ptr     Memory to check.
+ *
+ * @return true if ptr belongs to one of the blocks of the region.
+ */
+bool OCPayloadArenaContains(const OCPayloadArena *arena, const void *ptr);
+
+/**
+ * Hands over heap allocations to a region, which frees them when it is destroyed.
+ *
+ * @param arena      Region taking the ownership.
+ * @param ptrs       Heap allocations, those which are NULL or part of the region are skipped.
+ * @param count      Number of allocations.
+ * @param destroy    Function freeing each allocation.
+ *
+ * @return false without memory to record the allocations, which are then all still owned
+ *         by the caller.
+ */
+bool OCPayloadArenaAdopt(OCPayloadArena *arena, void **ptrs, size_t count,
+                         OCPayloadArenaDestructor destroy);
+
+/**
+ * Gets the counters of a region.
+ *
+ * @param arena   Region to look at.
+ *
+ * @return The counters.
+ */
+OCPayloadArenaStats OCPayloadArenaGetStats(const OCPayloadArena *arena);
+
+/**
+ * Creates a representation in a region. It does not own the region, the owner is
+ * set by the creator of the payload tree.
+ *
+ * @param arena   Region to allocate in.
+ *
+ * @return The representation, or NULL without memory.
+ */
+OCRepPayload *OCRepPayloadCreateInArena(OCPayloadArena *arena);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -30,6 +30,14 @@ extern "C"
 OCStackResult OCParsePayload(OCPayload** outPayload, OCPayloadType type,
         const uint8_t* payload, size_t payloadSize);
 
+/**
+ * Like OCParsePayload, but a representation is allocated in a single region released
+ * by OCPayloadDestroy. Meant for payloads which do not outlive the handler they are
+ * given to.
+ */
+OCStackResult OCParseScopedPayload(OCPayload** outPayload, OCPayloadType type,
+        const uint8_t* payload, size_t payloadSize);
+
 OCStackResult OCConvertPayload(OCPayload* payload, uint8_t** outPayload, size_t* size);
 
 #ifdef __cplusplus
@@ -101,6 +101,12 @@ typedef struct ocaction {
 
     /** head pointer of a linked list of capability nodes.*/
     OCCapability* head;
+
+    /** CBOR encoded body of the request sent to the target resource.*/
+    uint8_t *encodedPayload;
+
+    /** Size of the encoded body.*/
+    size_t encodedPayloadSize;
 } OCAction;
 
 /**
@@ -207,7 +213,13 @@ typedef struct OCResource {
     /** Array of pointers to resources; can be used to represent a container of resources.
      * (i.e. hierarchies of resources) or for reference resources (i.e. for a resource collection).*/
 
-    struct OCResource *rsrcResources[MAX_CONTAINED_RESOURCES];
+    struct OCResource **rsrcResources;
+
+    /** Number of resources contained in rsrcResources.*/
+    uint16_t numRsrcResources;
+
+    /** Number of slots allocated for rsrcResources.*/
+    uint16_t rsrcResourcesCapacity;
 
     /** Pointer to function that handles the entity bound to the resource.
      *  This handler has to be explicitly defined by the programmer.*/
@@ -232,6 +244,15 @@ typedef struct OCResource {
 
     /** Pointer of ActionSet which to support group action.*/
     OCActionSet *actionsetHead;
+
+    /** Policy limiting the notifications of the observers; NULL for none.*/
+    struct ObservePolicy *observePolicy;
+
+    /** Number of notifications sent to the observers.*/
+    uint32_t notificationsDelivered;
+
+    /** Number of notifications withheld by observe policies.*/
+    uint32_t notificationsSuppressed;
 } OCResource;
 
 
@@ -180,6 +180,16 @@ OCStackResult BuildVirtualResourceResponse(const OCResource *resourcePtr,
                                            OCDiscoveryPayload* payload,
                                            OCDevAddr *endpoint);
 
+/**
+ * Internal API used to drop the cached discovery responses when the resources change.
+ */
+void InvalidateDiscoveryCache();
+
+/**
+ * Internal API used to free the cached discovery responses.
+ */
+void FlushDiscoveryCache();
+
 /**
  * A helper function that Maps an @ref OCEntityHandlerResult type to an
  * @ref OCStackResult type.
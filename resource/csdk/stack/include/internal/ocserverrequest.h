@@ -65,7 +65,11 @@ typedef struct OCServerRequest
     OCStackResult observeResult;
 
     /** number of Responses.*/
-    uint8_t numResponses;
+    uint16_t numResponses;
+
+    /** CoAP ticks after which an aggregated response is sent with the fragments received
+     *  so far; 0 when there is no deadline.*/
+    uint32_t aggregateDeadline;
 
     /** Response Entity Handler .*/
     OCEHResponseHandler ehResponseHandler;
@@ -73,12 +77,15 @@ typedef struct OCServerRequest
     /** Remote endpoint address **/
     OCDevAddr devAddr;
 
-    /** Token for the request.*/
+    /** Token for the request, it points to tokenBuffer.*/
     CAToken_t requestToken;
 
     /** token length the request.*/
     uint8_t tokenLength;
 
+    /** Storage of the token.*/
+    char tokenBuffer[CA_MAX_TOKEN_LEN];
+
     /** The ID of CoAP pdu (Kept in CoAp).*/
     uint16_t coapID;
 
@@ -97,6 +104,18 @@ typedef struct OCServerRequest
     /** Linked list; for multiple server request.*/
     struct OCServerRequest * next;
 
+    /** Previous server request, the list is doubly linked so deleting does not scan it.*/
+    struct OCServerRequest * prev;
+
+    /** Next server request in the same bucket of the token index.*/
+    struct OCServerRequest * nextByToken;
+
+    /** Next server request in the same bucket of the handle index.*/
+    struct OCServerRequest * nextByHandle;
+
+    /** Flag indicating the request is a fixed size object returned to the pool.*/
+    uint8_t pooledFlag;
+
     /** Flag indicating slow response.*/
     uint8_t slowFlag;
 
@@ -126,6 +145,9 @@ typedef struct OCServerResponse {
     /** this is the pointer to server payload data to be transferred.*/
     OCPayload* payload;
 
+    /** Last fragment of an aggregated payload; fragments are appended here.*/
+    OCRepPayload* lastPayload;
+
     /** Remaining size of the payload data to be transferred.*/
     uint16_t remainingPayloadSize;
 
@@ -143,12 +165,28 @@ typedef struct OCServerResponse {
  */
 OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse);
 
+/**
+ * Handler function for sending a response from a single resource, with a body which
+ * is already encoded in CBOR. The payload of the response is ignored.
+ *
+ * @param ehResponse           Pointer to the response from the resource.
+ * @param encodedPayload       CBOR encoded body of the response, the caller keeps
+ *                             the ownership of it.
+ * @param encodedPayloadSize   Size of encodedPayload.
+ *
+ * @return
+ *     ::OCStackResult
+ */
+OCStackResult HandleSingleEncodedResponse(OCEntityHandlerResponse * ehResponse,
+                                          const uint8_t *encodedPayload,
+                                          size_t encodedPayloadSize);
+
 /**
  * Handler function for sending a response from multiple resources, such as a collection.
  * Aggregates responses from multiple resource until all responses are received then sends the
  * concatenated response
  *
- * TODO: Need to add a timeout in case a (remote?) resource does not respond
+ * @see HandleAggregateResponseTimeout
  *
  * @param ehResponse      Pointer to the response from the resource.
  *
@@ -157,6 +195,12 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse);
  */
 OCStackResult HandleAggregateResponse(OCEntityHandlerResponse * ehResponse);
 
+/**
+ * Send the aggregated responses whose deadline has passed with the fragments received so far.
+ * Fragments arriving afterwards are dropped, since their request is gone.
+ */
+void HandleAggregateResponseTimeout();
+
 /**
  * Get a server request from the server request list using the specified token.
  *
@@ -261,5 +305,10 @@ OCStackResult FormOCEntityHandlerRequest(
  */
 void FindAndDeleteServerRequest(OCServerRequest * serverRequest);
 
+/**
+ * Delete all the server requests and free the pool of server requests.
+ */
+void DeleteServerRequestList();
+
 #endif //OC_SERVER_REQUEST_H
 
@@ -223,6 +223,14 @@ OCStackResult SendPresenceNotification(OCResourceType *resourceType,
  * @return ::OC_STACK_OK on success, some other value upon failure.
  */
 OCStackResult SendStopNotification();
+
+/**
+ * Check the presence of the servers whose presence deadline has passed, and notify
+ * the subscribers whose presence timed out.  Called by OCProcess.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OCProcessPresence();
 #endif // WITH_PRESENCE
 
 /**
@@ -310,6 +318,36 @@ void CopyEndpointToDevAddr(const CAEndpoint_t *in, OCDevAddr *out);
 
 void CopyDevAddrToEndpoint(const OCDevAddr *in, CAEndpoint_t *out);
 
+/**
+ * Perform a request like OCDoResource, with a body which is already encoded in CBOR.
+ * The encoded body is copied, so the caller keeps the ownership of it.
+ *
+ * @param encodedPayload        CBOR encoded body of the request.
+ * @param encodedPayloadSize    Size of encodedPayload.
+ *
+ * @see OCDoResource
+ */
+OCStackResult OCDoEncodedResource(OCDoHandle *handle,
+                                  OCMethod method,
+                                  const char *requestUri,
+                                  const OCDevAddr *destination,
+                                  const uint8_t *encodedPayload,
+                                  size_t encodedPayloadSize,
+                                  OCConnectivityType connectivityType,
+                                  OCQualityOfService qos,
+                                  OCCallbackData *cbData,
+                                  OCHeaderOption *options,
+                                  uint8_t numOptions);
+
+/**
+ * Get the CoAP ticks after the specified number of milli-seconds.
+ *
+ * @param afterMilliSeconds Milli-seconds.
+ * @return
+ *     CoAP ticks
+ */
+uint32_t GetTicks(uint32_t afterMilliSeconds);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
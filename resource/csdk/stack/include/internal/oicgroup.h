@@ -51,6 +51,12 @@ OCStackResult BuildActionSetFromString(OCActionSet **set, char* actiondesc);
 
 OCStackResult BuildStringFromActionSet(OCActionSet* actionset, char** desc);
 
+/**
+ * Encode the request body of an action, so that it can be sent without
+ * building a payload on every execution of its action set.
+ */
+OCStackResult CompileAction(OCAction* action);
+
 OCStackApplicationResult ActionSetCB(void* context, OCDoHandle handle,
         OCClientResponse* clientResponse);
 
@@ -502,6 +502,46 @@ OCNotifyListOfObservers (OCResourceHandle handle,
                             const OCRepPayload *payload,
                             OCQualityOfService qos);
 
+/**
+ * Set the policy limiting the notifications sent to the observers of a resource, by
+ * ::OCNotifyAllObservers as well as ::OCNotifyListOfObservers. It applies to the current and
+ * future observers which have no policy of their own.
+ *
+ * @param handle    Handle of resource.
+ * @param policy    Policy of the resource, NULL to notify observers of every change.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OCSetObservePolicy(OCResourceHandle handle, const OCObservePolicy *policy);
+
+/**
+ * Set the policy limiting the notifications sent to one observer of a resource, overriding
+ * the policy of the resource, e.g. for an observer behind a slow link.
+ *
+ * @param handle    Handle of resource.
+ * @param obsId     Observation ID of the observer.
+ * @param policy    Policy of the observer, NULL to apply the policy of the resource again.
+ *
+ * @return ::OC_STACK_OK on success, ::OC_STACK_NO_OBSERVERS if the resource has no such
+ *         observer, some other value upon failure.
+ */
+OCStackResult OCSetObserverPolicy(OCResourceHandle handle, OCObservationId obsId,
+                                  const OCObservePolicy *policy);
+
+/**
+ * This function returns the counters of the notifications of a resource, summed over all its
+ * observers. Notifications which failed to be sent are in neither counter. A notification
+ * withheld by a coalescing policy and sent once the interval is over is only delivered.
+ *
+ * @param handle        Handle of resource.
+ * @param delivered     Number of notifications sent to observers.
+ * @param suppressed    Number of notifications withheld by observe policies.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OCGetObserveStatistics(OCResourceHandle handle, uint32_t *delivered,
+                                     uint32_t *suppressed);
+
 
 /**
  * This function sends a response to a request.
@@ -514,6 +554,17 @@ OCNotifyListOfObservers (OCResourceHandle handle,
  */
 OCStackResult OCDoResponse(OCEntityHandlerResponse *response);
 
+/**
+ * This function returns the counters of the cache of encoded discovery (/oic/res) responses.
+ * Cached responses are dropped whenever a resource is created, deleted or changed.
+ *
+ * @param hits      Number of discovery requests answered with a cached response.
+ * @param misses    Number of discovery requests whose response was built and encoded.
+ *
+ * @return ::OC_STACK_OK on success, ::OC_STACK_INVALID_PARAM if a pointer is NULL.
+ */
+OCStackResult OCGetDiscoveryCacheStatistics(uint32_t *hits, uint32_t *misses);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
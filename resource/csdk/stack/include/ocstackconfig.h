@@ -54,11 +54,19 @@
 #define MAX_MANUFACTURER_URL_LENGTH (32)
 
 /**
- * Maximum number of resources which can be contained inside collection
- * resource.
+ * Initial number of slots allocated for the resources contained inside
+ * a collection resource. The membership grows on demand when more
+ * resources are bound.
  */
 #define MAX_CONTAINED_RESOURCES  (5)
 
+/**
+ * Maximum time in milliseconds to wait for the members of a collection
+ * to respond to a batch request. Members which do not respond in time are
+ * left out of the aggregated response.
+ */
+#define MAX_CONTAINED_RESOURCE_RESPONSE_TIME  (2000)
+
 /**
  *  Maximum number of vendor specific header options an application can set or receive
  *  in PDU
@@ -751,6 +751,33 @@ typedef enum
     OC_OBSERVE_NO_OPTION = 2
 } OCObserveAction;
 
+/**
+ * Policy limiting the notifications sent to the observers of a resource, e.g. to spare a slow
+ * link the samples of a sensor read much faster than its observers need them.
+ * Notifications withheld by the policy are dropped, they are never queued.
+ */
+typedef struct
+{
+    /** Minimum time between two notifications sent to an observer, in milliseconds.*/
+    uint32_t minInterval;
+
+    /** Maximum number of notifications per second sent to an observer, 0 for no limit.
+     *  The stricter of maxRate and minInterval applies.*/
+    uint16_t maxRate;
+
+    /** When notifications were withheld during the interval, send the latest value to the
+     *  observer once the interval is over. Otherwise the observer may miss the last change.*/
+    bool coalesce;
+
+    /** Name of an integer or double property of the representation which must have changed
+     *  by at least changeThreshold since the value last sent to the observer, NULL for none.
+     *  Notifications lacking the property are always sent.*/
+    const char *changeProperty;
+
+    /** Minimum change of changeProperty.*/
+    double changeThreshold;
+} OCObservePolicy;
+
 
 /**
  * Persistent storage handlers. An APP must provide OCPersistentStorage handler pointers
@@ -994,6 +1021,12 @@ typedef struct OCRepPayload
     OCStringLL* types;
     OCStringLL* interfaces;
     OCRepPayloadValue* values;
+    /** Index of the values by name, maintained by the OCRepPayloadSet* APIs.*/
+    struct OCRepPayloadIndex* index;
+    /** Region the payload is allocated in, NULL if it is allocated on the heap.*/
+    struct OCPayloadArena* arena;
+    /** Whether destroying the payload releases its region.*/
+    bool ownsArena;
     struct OCRepPayload* next;
 } OCRepPayload;
 
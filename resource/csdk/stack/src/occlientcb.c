@@ -41,6 +41,16 @@
 struct ClientCB *cbList = NULL;
 static OCMulticastNode * mcPresenceNodes = NULL;
 
+#ifdef WITH_PRESENCE
+/**
+ * Presence callbacks are kept in a min-heap ordered by their deadline, so OCProcess
+ * only looks at the expired ones instead of walking cbList.
+ */
+static ClientCB **presenceHeap = NULL;
+static size_t presenceHeapSize = 0;
+static size_t presenceHeapCapacity = 0;
+#endif // WITH_PRESENCE
+
 OCStackResult
 AddClientCB (ClientCB** clientCB, OCCallbackData* cbData,
              CAToken_t token, uint8_t tokenLength,
@@ -165,6 +175,7 @@ void DeleteClientCB(ClientCB * cbNode)
 #ifdef WITH_PRESENCE
         if(cbNode->presence)
         {
+            UnschedulePresenceCB(cbNode);
             OICFree(cbNode->presence->timeOut);
             OICFree(cbNode->presence);
         }
@@ -226,7 +237,7 @@ ClientCB* GetClientCB(const CAToken_t token, uint8_t tokenLength,
         OC_LOG(INFO, TAG, "\tFound in callback list");
         LL_FOREACH(cbList, out)
         {
-            OC_LOG_BUFFER(INFO, TAG, (const uint8_t *)out->token, tokenLength);
+            OC_LOG_BUFFER(DEBUG, TAG, (const uint8_t *)out->token, tokenLength);
 
             if(memcmp(out->token, token, tokenLength) == 0)
             {
@@ -251,7 +262,7 @@ ClientCB* GetClientCB(const CAToken_t token, uint8_t tokenLength,
         OC_LOG_V(INFO, TAG, "Looking for uri %s", requestUri);
         LL_FOREACH(cbList, out)
         {
-            OC_LOG_V(INFO, TAG, "\tFound %s", out->requestUri);
+            OC_LOG_V(DEBUG, TAG, "\tFound %s", out->requestUri);
             if(out->requestUri && strcmp(out->requestUri, requestUri ) == 0)
             {
                 return out;
@@ -284,6 +295,125 @@ OCStackResult InsertResourceTypeFilter(ClientCB * cbNode, char * resourceTypeNam
     }
     return OC_STACK_ERROR;
 }
+
+static void SetPresenceCBAt(size_t index, ClientCB *cbNode)
+{
+    presenceHeap[index] = cbNode;
+    cbNode->presence->heapIndex = index;
+}
+
+static void SiftUpPresenceCB(size_t index)
+{
+    ClientCB *cbNode = presenceHeap[index];
+
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / 2;
+        if (presenceHeap[parent]->presence->deadline <= cbNode->presence->deadline)
+        {
+            break;
+        }
+        SetPresenceCBAt(index, presenceHeap[parent]);
+        index = parent;
+    }
+    SetPresenceCBAt(index, cbNode);
+}
+
+static void SiftDownPresenceCB(size_t index)
+{
+    ClientCB *cbNode = presenceHeap[index];
+
+    while (2 * index + 1 < presenceHeapSize)
+    {
+        size_t child = 2 * index + 1;
+        if (child + 1 < presenceHeapSize &&
+            presenceHeap[child + 1]->presence->deadline < presenceHeap[child]->presence->deadline)
+        {
+            child++;
+        }
+        if (cbNode->presence->deadline <= presenceHeap[child]->presence->deadline)
+        {
+            break;
+        }
+        SetPresenceCBAt(index, presenceHeap[child]);
+        index = child;
+    }
+    SetPresenceCBAt(index, cbNode);
+}
+
+OCStackResult SchedulePresenceCB(ClientCB * cbNode, uint32_t deadline)
+{
+    if (!cbNode || !cbNode->presence)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    size_t index = cbNode->presence->heapIndex;
+    if (index == PRESENCE_NOT_SCHEDULED)
+    {
+        if (presenceHeapSize == presenceHeapCapacity)
+        {
+            size_t capacity = presenceHeapCapacity ? presenceHeapCapacity * 2 : 8;
+            ClientCB **heap = (ClientCB **) OICRealloc(presenceHeap,
+                    capacity * sizeof(ClientCB *));
+            if (!heap)
+            {
+                return OC_STACK_NO_MEMORY;
+            }
+            presenceHeap = heap;
+            presenceHeapCapacity = capacity;
+        }
+        cbNode->presence->deadline = deadline;
+        SetPresenceCBAt(presenceHeapSize++, cbNode);
+        SiftUpPresenceCB(cbNode->presence->heapIndex);
+        return OC_STACK_OK;
+    }
+
+    uint32_t previous = cbNode->presence->deadline;
+    cbNode->presence->deadline = deadline;
+    if (deadline < previous)
+    {
+        SiftUpPresenceCB(index);
+    }
+    else
+    {
+        SiftDownPresenceCB(index);
+    }
+    return OC_STACK_OK;
+}
+
+void UnschedulePresenceCB(ClientCB * cbNode)
+{
+    if (!cbNode || !cbNode->presence || cbNode->presence->heapIndex == PRESENCE_NOT_SCHEDULED)
+    {
+        return;
+    }
+
+    size_t index = cbNode->presence->heapIndex;
+    cbNode->presence->heapIndex = PRESENCE_NOT_SCHEDULED;
+
+    presenceHeapSize--;
+    if (index != presenceHeapSize)
+    {
+        ClientCB *last = presenceHeap[presenceHeapSize];
+
+        SetPresenceCBAt(index, last);
+        SiftUpPresenceCB(index);
+        if (presenceHeap[index] == last)
+        {
+            SiftDownPresenceCB(index);
+        }
+    }
+}
+
+ClientCB* GetExpiredPresenceCB(uint32_t now)
+{
+    if (presenceHeapSize == 0 || now < presenceHeap[0]->presence->deadline)
+    {
+        return NULL;
+    }
+    return presenceHeap[0];
+}
 #endif // WITH_PRESENCE
 
 void DeleteClientCBList()
@@ -295,6 +425,12 @@ void DeleteClientCBList()
         DeleteClientCB(out);
     }
     cbList = NULL;
+#ifdef WITH_PRESENCE
+    OICFree(presenceHeap);
+    presenceHeap = NULL;
+    presenceHeapSize = 0;
+    presenceHeapCapacity = 0;
+#endif // WITH_PRESENCE
 }
 
 void FindAndDeleteClientCB(ClientCB * cbNode)
@@ -248,15 +248,11 @@ HandleLinkedListInterface(OCEntityHandlerRequest *ehRequest,
 
     if (ret == OC_STACK_OK)
     {
-        for  (int i = 0; i < MAX_CONTAINED_RESOURCES && ret == OC_STACK_OK; i++)
+        for  (uint16_t i = 0; i < collResource->numRsrcResources && ret == OC_STACK_OK; i++)
         {
-            OCResource* temp = collResource->rsrcResources[i];
-            if (temp)
-            {
-                //TODO : Add resource type filtering once collections
-                // start supporting queries.
-                ret = BuildResponseRepresentation(temp, &payload);
-            }
+            //TODO : Add resource type filtering once collections
+            // start supporting queries.
+            ret = BuildResponseRepresentation(collResource->rsrcResources[i], &payload);
         }
     }
 
@@ -285,6 +281,13 @@ HandleBatchInterface(OCEntityHandlerRequest *ehRequest)
     OCStackResult stackRet = OC_STACK_OK;
     OCEntityHandlerResult ehResult = OC_EH_ERROR;
     OCResource * collResource = (OCResource *) ehRequest->resource;
+    OCServerRequest * serverRequest = (OCServerRequest *) ehRequest->requestHandle;
+
+    // Every member gets the same deadline, so a slow member only delays the
+    // aggregated response up to MAX_CONTAINED_RESOURCE_RESPONSE_TIME.
+    serverRequest->ehResponseHandler = HandleAggregateResponse;
+    serverRequest->numResponses = GetNumOfResourcesInCollection(collResource) + 1;
+    serverRequest->aggregateDeadline = GetTicks(MAX_CONTAINED_RESOURCE_RESPONSE_TIME);
 
     OCRepPayload* payload = OCRepPayloadCreate();
     if(!payload)
@@ -313,36 +316,32 @@ HandleBatchInterface(OCEntityHandlerRequest *ehRequest)
 
     if (stackRet == OC_STACK_OK)
     {
-        for  (uint8_t i = 0; i < MAX_CONTAINED_RESOURCES; i++)
+        // Members answer through OCDoResponse, and slow members answer later on,
+        // so no member waits for another one; the responses are aggregated as they come.
+        for  (uint16_t i = 0; i < collResource->numRsrcResources; i++)
         {
             OCResource* temp = collResource->rsrcResources[i];
-            if (temp)
+
+            // Note that all entity handlers called through a collection
+            // will get the same pointer to ehRequest, the only difference
+            // is ehRequest->resource
+            ehRequest->resource = (OCResourceHandle) temp;
+
+            ehResult = temp->entityHandler(OC_REQUEST_FLAG, ehRequest,
+                                    temp->entityHandlerCallbackParam);
+
+            // The default collection handler is returning as OK
+            if(stackRet != OC_STACK_SLOW_RESOURCE)
             {
-                // Note that all entity handlers called through a collection
-                // will get the same pointer to ehRequest, the only difference
-                // is ehRequest->resource
-                ehRequest->resource = (OCResourceHandle) temp;
-
-                ehResult = temp->entityHandler(OC_REQUEST_FLAG, ehRequest,
-                                        temp->entityHandlerCallbackParam);
-
-                // The default collection handler is returning as OK
-                if(stackRet != OC_STACK_SLOW_RESOURCE)
-                {
-                    stackRet = OC_STACK_OK;
-                }
-                // if a single resource is slow, then entire response will be treated
-                // as slow response
-                if(ehResult == OC_EH_SLOW)
-                {
-                    OC_LOG(INFO, TAG, "This is a slow resource");
-                    ((OCServerRequest *)ehRequest->requestHandle)->slowFlag = 1;
-                    stackRet = EntityHandlerCodeToOCStackCode(ehResult);
-                }
+                stackRet = OC_STACK_OK;
             }
-            else
+            // if a single resource is slow, then entire response will be treated
+            // as slow response
+            if(ehResult == OC_EH_SLOW)
             {
-                break;
+                OC_LOG(INFO, TAG, "This is a slow resource");
+                serverRequest->slowFlag = 1;
+                stackRet = EntityHandlerCodeToOCStackCode(ehResult);
             }
         }
         ehRequest->resource = (OCResourceHandle) collResource;
@@ -350,23 +349,15 @@ HandleBatchInterface(OCEntityHandlerRequest *ehRequest)
     return stackRet;
 }
 
-uint8_t GetNumOfResourcesInCollection (OCResource *resource)
+uint16_t GetNumOfResourcesInCollection (OCResource *resource)
 {
     if(resource)
     {
-        uint8_t num = 0;
-        for (uint8_t i = 0; i < MAX_CONTAINED_RESOURCES; i++)
-        {
-            if (resource->rsrcResources[i])
-            {
-                num++;
-            }
-        }
-        return num;
+        return resource->numRsrcResources;
     }
     else
     {
-        return -1;
+        return 0;
     }
 }
 
@@ -416,12 +407,6 @@ OCStackResult DefaultCollectionEntityHandler (OCEntityHandlerFlag flag,
 
                 case STACK_IF_BATCH:
                     OC_LOG(INFO, TAG, "STACK_IF_BATCH");
-                    ((OCServerRequest *)ehRequest->requestHandle)->ehResponseHandler =
-                                                                            HandleAggregateResponse;
-
-                    ((OCServerRequest *)ehRequest->requestHandle)->numResponses =
-                            GetNumOfResourcesInCollection((OCResource *)ehRequest->resource) + 1;
-
                     return HandleBatchInterface(ehRequest);
 
                 case STACK_IF_GROUP:
@@ -444,10 +429,6 @@ OCStackResult DefaultCollectionEntityHandler (OCEntityHandlerFlag flag,
                     return OC_STACK_ERROR;
 
                 case STACK_IF_BATCH:
-                    ((OCServerRequest *)ehRequest->requestHandle)->ehResponseHandler =
-                                                                            HandleAggregateResponse;
-                    ((OCServerRequest *)ehRequest->requestHandle)->numResponses =
-                            GetNumOfResourcesInCollection((OCResource *)ehRequest->resource) + 1;
                     return HandleBatchInterface(ehRequest);
 
                 case STACK_IF_GROUP:
@@ -472,10 +453,6 @@ OCStackResult DefaultCollectionEntityHandler (OCEntityHandlerFlag flag,
                     return OC_STACK_ERROR;
 
                 case STACK_IF_BATCH:
-                    ((OCServerRequest *)ehRequest->requestHandle)->ehResponseHandler =
-                                                                            HandleAggregateResponse;
-                    ((OCServerRequest *)ehRequest->requestHandle)->numResponses =
-                            GetNumOfResourcesInCollection((OCResource *)ehRequest->resource) + 1;
                     return HandleBatchInterface(ehRequest);
 
                 case STACK_IF_GROUP:
@@ -43,6 +43,10 @@
 #define VERIFY_NON_NULL(arg) { if (!arg) {OC_LOG(FATAL, TAG, #arg " is NULL"); goto exit;} }
 
 static struct ResourceObserver * serverObsList = NULL;
+
+/** Number of observers holding a notification withheld by a coalescing policy.*/
+static uint16_t pendingObserverCount = 0;
+
 /**
  * Determine observe QOS based on the QOS of the request.
  * The qos passed as a parameter overrides what the client requested.
@@ -96,6 +100,211 @@ static OCQualityOfService DetermineObserverQoS(OCMethod method,
     return decidedQoS;
 }
 
+/**
+ * Get the policy applying to an observer, its own or the one of its resource.
+ *
+ * @param observer Observer.
+ * @return The policy, NULL if the notifications of the observer are not limited.
+ */
+static const ObservePolicy *GetObserverPolicy(const ResourceObserver *observer)
+{
+    if (observer->policy)
+    {
+        return observer->policy;
+    }
+    return observer->resource ? observer->resource->observePolicy : NULL;
+}
+
+static void ClearPendingNotification(ResourceObserver *observer)
+{
+    if (observer->pending)
+    {
+        observer->pending = false;
+        pendingObserverCount--;
+    }
+    OCRepPayloadDestroy(observer->pendingPayload);
+    observer->pendingPayload = NULL;
+}
+
+static void FreeObservePolicy(ObservePolicy *policy)
+{
+    if (policy)
+    {
+        OICFree(policy->changeProperty);
+        OICFree(policy);
+    }
+}
+
+/**
+ * Check whether the interval of the observer policy lets a notification go now. A withheld
+ * notification is dropped, but with a coalescing policy the observer is marked so that the
+ * latest value is sent by SendPendingObserverNotifications once the interval is over.
+ *
+ * @param observer Observer.
+ * @param qos Quality of service of the notification.
+ * @param payload Payload of the notification, NULL if the entity handler builds it.
+ * @return true if the notification is to be sent now.
+ */
+static bool IsObserverDue(ResourceObserver *observer, OCQualityOfService qos,
+        const OCRepPayload *payload)
+{
+    const ObservePolicy *policy = GetObserverPolicy(observer);
+    if (!policy || !policy->interval ||
+        (uint32_t)(GetTicks(0) - observer->lastNotified) >= policy->interval)
+    {
+        // The notification sent now supersedes the one withheld, which would be stale
+        if (observer->pending)
+        {
+            observer->resource->notificationsSuppressed++;
+        }
+        ClearPendingNotification(observer);
+        return true;
+    }
+
+    OC_LOG_V(DEBUG, TAG, "Notification to observer id %u withheld", observer->observeId);
+    if (policy->coalesce)
+    {
+        // Latest value wins, the one withheld before is dropped. The one kept is counted
+        // once it is sent.
+        if (observer->pending)
+        {
+            observer->resource->notificationsSuppressed++;
+        }
+        OCRepPayloadDestroy(observer->pendingPayload);
+        observer->pendingPayload = payload ? OCRepPayloadClone(payload) : NULL;
+        observer->pendingQos = qos;
+        if (!observer->pending)
+        {
+            observer->pending = true;
+            pendingObserverCount++;
+        }
+    }
+    else
+    {
+        observer->resource->notificationsSuppressed++;
+    }
+    return false;
+}
+
+/**
+ * Notify an observer with the representation built by the entity handler of its resource.
+ *
+ * @param method RESTful method.
+ * @param observer Observer.
+ * @param qos Quality of service of the notification.
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+static OCStackResult NotifyObserver(OCMethod method, ResourceObserver *observer,
+        OCQualityOfService qos)
+{
+    OCResource *resPtr = observer->resource;
+    OCServerRequest * request = NULL;
+    OCEntityHandlerRequest ehRequest = {0};
+    OCEntityHandlerResult ehResult = OC_EH_ERROR;
+
+    qos = DetermineObserverQoS(method, observer, qos);
+
+    OCStackResult result = AddServerRequest(&request, 0, 0, 1, OC_REST_GET,
+            0, resPtr->sequenceNum, qos, observer->query,
+            NULL, NULL,
+            observer->token, observer->tokenLength,
+            observer->resUri, 0, observer->acceptFormat,
+            &observer->devAddr);
+
+    if(request)
+    {
+        request->observeResult = OC_STACK_OK;
+        if(result == OC_STACK_OK)
+        {
+            result = FormOCEntityHandlerRequest(
+                        &ehRequest,
+                        (OCRequestHandle) request,
+                        request->method,
+                        &request->devAddr,
+                        (OCResourceHandle) resPtr,
+                        request->query,
+                        PAYLOAD_TYPE_REPRESENTATION,
+                        request->payload,
+                        request->payloadSize,
+                        request->numRcvdVendorSpecificHeaderOptions,
+                        request->rcvdVendorSpecificHeaderOptions,
+                        OC_OBSERVE_NO_OPTION,
+                        0);
+            if(result == OC_STACK_OK)
+            {
+                ehResult = resPtr->entityHandler(OC_REQUEST_FLAG, &ehRequest,
+                                    resPtr->entityHandlerCallbackParam);
+                if(ehResult == OC_EH_ERROR)
+                {
+                    FindAndDeleteServerRequest(request);
+                }
+            }
+            OCPayloadDestroy(ehRequest.payload);
+        }
+    }
+    return result;
+}
+
+/**
+ * Notify an observer with a representation given by the application.
+ *
+ * @param observer Observer.
+ * @param payload Representation to send.
+ * @param qos Quality of service of the notification.
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+static OCStackResult NotifyObserverWithPayload(ResourceObserver *observer,
+        const OCRepPayload *payload, OCQualityOfService qos)
+{
+    OCResource *resource = observer->resource;
+    OCServerRequest * request = NULL;
+
+    qos = DetermineObserverQoS(OC_REST_GET, observer, qos);
+
+    OCStackResult result = AddServerRequest(&request, 0, 0, 1, OC_REST_GET,
+            0, resource->sequenceNum, qos, observer->query,
+            NULL, NULL, observer->token, observer->tokenLength,
+            observer->resUri, 0, observer->acceptFormat,
+            &observer->devAddr);
+
+    if(request)
+    {
+        request->observeResult = OC_STACK_OK;
+        if(result == OC_STACK_OK)
+        {
+            OCEntityHandlerResponse ehResponse = {0};
+            ehResponse.ehResult = OC_EH_OK;
+            ehResponse.payload = (OCPayload*)OCRepPayloadCreate();
+            if(!ehResponse.payload)
+            {
+                FindAndDeleteServerRequest(request);
+                return OC_STACK_NO_MEMORY;
+            }
+            memcpy(ehResponse.payload, payload, sizeof(*payload));
+            ehResponse.persistentBufferFlag = 0;
+            ehResponse.requestHandle = (OCRequestHandle) request;
+            ehResponse.resourceHandle = (OCResourceHandle) resource;
+            result = OCDoResponse(&ehResponse);
+            if(result == OC_STACK_OK)
+            {
+                OC_LOG_V(INFO, TAG, "Observer id %d notified.", observer->observeId);
+                FindAndDeleteServerRequest(request);
+            }
+            else
+            {
+                OC_LOG_V(INFO, TAG, "Error notifying observer id %d.", observer->observeId);
+            }
+            // Only the shell is ours, its members belong to the caller
+            OICFree(ehResponse.payload);
+        }
+        else
+        {
+            FindAndDeleteServerRequest(request);
+        }
+    }
+    return result;
+}
+
 #ifdef WITH_PRESENCE
 OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr, uint32_t maxAge,
         OCPresenceTrigger trigger, OCResourceType *resourceType, OCQualityOfService qos)
@@ -113,10 +322,12 @@ OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr,
     OCStackResult result = OC_STACK_ERROR;
     ResourceObserver * resourceObserver = serverObsList;
     uint8_t numObs = 0;
-    OCServerRequest * request = NULL;
-    OCEntityHandlerRequest ehRequest = {0};
-    OCEntityHandlerResult ehResult = OC_EH_ERROR;
     bool observeErrorFlag = false;
+#ifdef WITH_PRESENCE
+    OCServerRequest * request = NULL;
+#else
+    (void)maxAge;
+#endif
 
     // Find clients that are observing this resource
     while (resourceObserver)
@@ -128,45 +339,14 @@ OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr,
             if(method != OC_REST_PRESENCE)
             {
 #endif
-                qos = DetermineObserverQoS(method, resourceObserver, qos);
-
-                result = AddServerRequest(&request, 0, 0, 1, OC_REST_GET,
-                        0, resPtr->sequenceNum, qos, resourceObserver->query,
-                        NULL, NULL,
-                        resourceObserver->token, resourceObserver->tokenLength,
-                        resourceObserver->resUri, 0, resourceObserver->acceptFormat,
-                        &resourceObserver->devAddr);
-
-                if(request)
+                if (IsObserverDue(resourceObserver, qos, NULL))
                 {
-                    request->observeResult = OC_STACK_OK;
-                    if(result == OC_STACK_OK)
-                    {
-                        result = FormOCEntityHandlerRequest(
-                                    &ehRequest,
-                                    (OCRequestHandle) request,
-                                    request->method,
-                                    &request->devAddr,
-                                    (OCResourceHandle) resPtr,
-                                    request->query,
-                                    PAYLOAD_TYPE_REPRESENTATION,
-                                    request->payload,
-                                    request->payloadSize,
-                                    request->numRcvdVendorSpecificHeaderOptions,
-                                    request->rcvdVendorSpecificHeaderOptions,
-                                    OC_OBSERVE_NO_OPTION,
-                                    0);
-                        if(result == OC_STACK_OK)
-                        {
-                            ehResult = resPtr->entityHandler(OC_REQUEST_FLAG, &ehRequest,
-                                                resPtr->entityHandlerCallbackParam);
-                            if(ehResult == OC_EH_ERROR)
-                            {
-                                FindAndDeleteServerRequest(request);
-                            }
-                        }
-                        OCPayloadDestroy(ehRequest.payload);
-                    }
+                    result = NotifyObserver(method, resourceObserver, qos);
+                }
+                else
+                {
+                    // A notification withheld by the policy is not an error
+                    result = OC_STACK_OK;
                 }
 #ifdef WITH_PRESENCE
             }
@@ -248,7 +428,6 @@ OCStackResult SendListObserverNotification (OCResource * resource,
     uint8_t numIds = numberOfIds;
     ResourceObserver *observer = NULL;
     uint8_t numSentNotification = 0;
-    OCServerRequest * request = NULL;
     OCStackResult result = OC_STACK_ERROR;
     bool observeErrorFlag = false;
 
@@ -261,56 +440,24 @@ OCStackResult SendListObserverNotification (OCResource * resource,
             // Found observer - verify if it matches the resource handle
             if (observer->resource == resource)
             {
-                qos = DetermineObserverQoS(OC_REST_GET, observer, qos);
-
-
-                result = AddServerRequest(&request, 0, 0, 1, OC_REST_GET,
-                        0, resource->sequenceNum, qos, observer->query,
-                        NULL, NULL, observer->token, observer->tokenLength,
-                        observer->resUri, 0, observer->acceptFormat,
-                        &observer->devAddr);
+                if (IsObserverDue(observer, qos, payload))
+                {
+                    result = NotifyObserverWithPayload(observer, payload, qos);
+                }
+                else
+                {
+                    // A notification withheld by the policy is not an error
+                    result = OC_STACK_OK;
+                }
 
-                if(request)
+                // Increment only if the observer was handled successfully
+                if (result == OC_STACK_OK)
                 {
-                    request->observeResult = OC_STACK_OK;
-                    if(result == OC_STACK_OK)
-                    {
-                        OCEntityHandlerResponse ehResponse = {0};
-                        ehResponse.ehResult = OC_EH_OK;
-                        ehResponse.payload = (OCPayload*)OCRepPayloadCreate();
-                        if(!ehResponse.payload)
-                        {
-                            FindAndDeleteServerRequest(request);
-                            continue;
-                        }
-                        memcpy(ehResponse.payload, payload, sizeof(*payload));
-                        ehResponse.persistentBufferFlag = 0;
-                        ehResponse.requestHandle = (OCRequestHandle) request;
-                        ehResponse.resourceHandle = (OCResourceHandle) resource;
-                        result = OCDoResponse(&ehResponse);
-                        if(result == OC_STACK_OK)
-                        {
-                            OC_LOG_V(INFO, TAG, "Observer id %d notified.", *obsIdList);
-
-                            // Increment only if OCDoResponse is successful
-                            numSentNotification++;
-
-                            OICFree(ehResponse.payload);
-                            FindAndDeleteServerRequest(request);
-                        }
-                        else
-                        {
-                            OC_LOG_V(INFO, TAG, "Error notifying observer id %d.", *obsIdList);
-                        }
-                    }
-                    else
-                    {
-                        FindAndDeleteServerRequest(request);
-                    }
+                    numSentNotification++;
                 }
                 // Since we are in a loop, set an error flag to indicate
                 // at least one error occurred.
-                if (result != OC_STACK_OK)
+                else
                 {
                     observeErrorFlag = true;
                 }
@@ -335,6 +482,198 @@ OCStackResult SendListObserverNotification (OCResource * resource,
     }
 }
 
+void SendPendingObserverNotifications()
+{
+    if (!pendingObserverCount)
+    {
+        return;
+    }
+
+    uint32_t now = GetTicks(0);
+    ResourceObserver *observer = NULL;
+    ResourceObserver *tmp = NULL;
+    LL_FOREACH_SAFE (serverObsList, observer, tmp)
+    {
+        if (!observer->pending)
+        {
+            continue;
+        }
+        const ObservePolicy *policy = GetObserverPolicy(observer);
+        if (policy && policy->interval &&
+            (uint32_t)(now - observer->lastNotified) < policy->interval)
+        {
+            continue;
+        }
+
+        OCRepPayload *payload = observer->pendingPayload;
+        OCQualityOfService qos = observer->pendingQos;
+        observer->pendingPayload = NULL;
+        ClearPendingNotification(observer);
+
+        OC_LOG_V(INFO, TAG, "Sending withheld notification to observer id %u",
+                observer->observeId);
+        if (payload)
+        {
+            NotifyObserverWithPayload(observer, payload, qos);
+            OCRepPayloadDestroy(payload);
+        }
+        else
+        {
+            NotifyObserver(OC_REST_OBSERVE, observer, qos);
+        }
+    }
+}
+
+OCStackResult SetObservePolicy (OCResource *resource, ResourceObserver *observer,
+                                const OCObservePolicy *policy)
+{
+    if (!resource)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    ObservePolicy *newPolicy = NULL;
+    if (policy)
+    {
+        newPolicy = (ObservePolicy *) OICCalloc(1, sizeof(ObservePolicy));
+        if (!newPolicy)
+        {
+            return OC_STACK_NO_MEMORY;
+        }
+        newPolicy->interval = policy->minInterval;
+        if (policy->maxRate && 1000 / policy->maxRate > newPolicy->interval)
+        {
+            newPolicy->interval = 1000 / policy->maxRate;
+        }
+        newPolicy->coalesce = policy->coalesce;
+        newPolicy->changeThreshold = policy->changeThreshold;
+        if (policy->changeProperty)
+        {
+            newPolicy->changeProperty = OICStrdup(policy->changeProperty);
+            if (!newPolicy->changeProperty)
+            {
+                OICFree(newPolicy);
+                return OC_STACK_NO_MEMORY;
+            }
+        }
+    }
+
+    if (observer)
+    {
+        FreeObservePolicy(observer->policy);
+        observer->policy = newPolicy;
+    }
+    else
+    {
+        FreeObservePolicy(resource->observePolicy);
+        resource->observePolicy = newPolicy;
+    }
+    return OC_STACK_OK;
+}
+
+void DeleteObservePolicies (OCResource *resource)
+{
+    if (!resource)
+    {
+        return;
+    }
+
+    ResourceObserver *observer = NULL;
+    LL_FOREACH (serverObsList, observer)
+    {
+        if (observer->resource == resource)
+        {
+            ClearPendingNotification(observer);
+            FreeObservePolicy(observer->policy);
+            observer->policy = NULL;
+        }
+    }
+    FreeObservePolicy(resource->observePolicy);
+    resource->observePolicy = NULL;
+}
+
+/**
+ * Get a numeric property of a representation as a double.
+ */
+static bool GetNumericProperty(const OCRepPayload *payload, const char *name, double *value)
+{
+    int64_t intValue = 0;
+    if (OCRepPayloadGetPropDouble(payload, name, value))
+    {
+        return true;
+    }
+    if (OCRepPayloadGetPropInt(payload, name, &intValue))
+    {
+        *value = (double)intValue;
+        return true;
+    }
+    return false;
+}
+
+static ResourceObserver *GetNotifiedObserver(const CAToken_t token, uint8_t tokenLength)
+{
+    ResourceObserver *observer = NULL;
+    LL_FOREACH (serverObsList, observer)
+    {
+        if (observer->tokenLength == tokenLength &&
+            memcmp(observer->token, token, tokenLength) == 0)
+        {
+            break;
+        }
+    }
+    return (observer && observer->resource) ? observer : NULL;
+}
+
+bool AcceptObserverNotification (const CAToken_t token, uint8_t tokenLength,
+                                 const OCPayload *payload)
+{
+    ResourceObserver *observer = GetNotifiedObserver(token, tokenLength);
+    if (!observer)
+    {
+        return true;
+    }
+
+    const ObservePolicy *policy = GetObserverPolicy(observer);
+    double value = 0;
+    if (policy && policy->changeProperty && payload &&
+        payload->type == PAYLOAD_TYPE_REPRESENTATION &&
+        GetNumericProperty((const OCRepPayload *)payload, policy->changeProperty, &value))
+    {
+        double change = value - observer->lastValue;
+        if (observer->hasLastValue && (change < 0 ? -change : change) < policy->changeThreshold)
+        {
+            OC_LOG_V(DEBUG, TAG, "Notification to observer id %u below threshold",
+                    observer->observeId);
+            observer->resource->notificationsSuppressed++;
+            return false;
+        }
+    }
+    return true;
+}
+
+void ObserverNotificationSent (const CAToken_t token, uint8_t tokenLength,
+                               const OCPayload *payload)
+{
+    ResourceObserver *observer = GetNotifiedObserver(token, tokenLength);
+    if (!observer)
+    {
+        return;
+    }
+
+    const ObservePolicy *policy = GetObserverPolicy(observer);
+    double value = 0;
+    if (policy && policy->changeProperty && payload &&
+        payload->type == PAYLOAD_TYPE_REPRESENTATION &&
+        GetNumericProperty((const OCRepPayload *)payload, policy->changeProperty, &value))
+    {
+        observer->lastValue = value;
+        observer->hasLastValue = true;
+    }
+
+    observer->lastNotified = GetTicks(0);
+    observer->resource->notificationsDelivered++;
+}
+
 OCStackResult GenerateObserverId (OCObservationId *observationId)
 {
     ResourceObserver *resObs = NULL;
@@ -409,6 +748,8 @@ OCStackResult AddObserver (const char         *resUri,
 
         obsNode->devAddr = *devAddr;
         obsNode->resource = resHandle;
+        // The registration response is the first notification of the observer
+        obsNode->lastNotified = GetTicks(0);
 
         LL_APPEND (serverObsList, obsNode);
 
@@ -486,6 +827,8 @@ OCStackResult DeleteObserverUsingToken (CAToken_t token, uint8_t tokenLength)
         OC_LOG_V(INFO, TAG, "deleting observer id  %u with token", obsNode->observeId);
         OC_LOG_BUFFER(INFO, TAG, (const uint8_t *)obsNode->token, tokenLength);
         LL_DELETE (serverObsList, obsNode);
+        ClearPendingNotification(obsNode);
+        FreeObservePolicy(obsNode->policy);
         OICFree(obsNode->resUri);
         OICFree(obsNode->query);
         OICFree(obsNode->token);
@@ -20,6 +20,7 @@
 
 
 #include "ocpayload.h"
+#include "ocpayloadarena.h"
 #include "octypes.h"
 #include <string.h>
 #include "oic_malloc.h"
@@ -30,6 +31,30 @@
 #include "rdpayload.h"
 
 #define TAG "OCPayload"
+
+/** Number of values from which a representation indexes them by name.*/
+#define REP_PAYLOAD_INDEX_THRESHOLD (8)
+
+typedef struct
+{
+    uint32_t hash;
+    OCRepPayloadValue* value;
+} OCRepPayloadIndexSlot;
+
+/**
+ * Open addressing table of the values of a representation, the values list keeps
+ * their insertion order.
+ */
+typedef struct OCRepPayloadIndex
+{
+    /** Number of slots, a power of two.*/
+    size_t capacity;
+    size_t count;
+    /** Last value of the list, where new values are appended.*/
+    OCRepPayloadValue* tail;
+    OCRepPayloadIndexSlot slots[];
+} OCRepPayloadIndex;
+
 static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val);
 static void FreeOCDiscoveryResource(OCResourcePayload* payload);
 
@@ -83,6 +108,78 @@ OCRepPayload* OCRepPayloadCreate()
     return payload;
 }
 
+OCRepPayload* OCRepPayloadCreateInArena(OCPayloadArena* arena)
+{
+    OCRepPayload* payload = (OCRepPayload*)OCPayloadArenaAlloc(arena, sizeof(OCRepPayload));
+
+    if(!payload)
+    {
+        return NULL;
+    }
+
+    payload->base.type = PAYLOAD_TYPE_REPRESENTATION;
+    payload->arena = arena;
+
+    return payload;
+}
+
+/*
+ * The memory of a payload in a region is allocated in the region, and only released
+ * with the whole region.
+ */
+static void* OCRepPayloadAlloc(const OCRepPayload* payload, size_t size)
+{
+    if (payload->arena)
+    {
+        return OCPayloadArenaAlloc(payload->arena, size);
+    }
+    return OICCalloc(1, size);
+}
+
+static void OCRepPayloadFree(const OCRepPayload* payload, void* ptr)
+{
+    if (!payload->arena)
+    {
+        OICFree(ptr);
+    }
+}
+
+static char* OCRepPayloadStrdup(const OCRepPayload* payload, const char* str)
+{
+    if (payload->arena)
+    {
+        return OCPayloadArenaStrdup(payload->arena, str);
+    }
+    return OICStrdup(str);
+}
+
+/*
+ * Gets heap memory handed over to a payload in a region as part of the region. It is
+ * copied, and the caller frees the heap memory once nothing can fail anymore.
+ *
+ * @return ptr itself if the payload is on the heap or if ptr is already in its region,
+ *         NULL without memory.
+ */
+static void* OCRepPayloadCopyToArena(const OCRepPayload* payload, void* ptr, size_t size)
+{
+    if (!payload->arena || !ptr || OCPayloadArenaContains(payload->arena, ptr))
+    {
+        return ptr;
+    }
+
+    void* copy = OCPayloadArenaAlloc(payload->arena, size);
+    if (copy)
+    {
+        memcpy(copy, ptr, size);
+    }
+    return copy;
+}
+
+static void OCRepPayloadDestroyAdopted(void* payload)
+{
+    OCRepPayloadDestroy((OCRepPayload*)payload);
+}
+
 void OCRepPayloadAppend(OCRepPayload* parent, OCRepPayload* child)
 {
     if(!parent)
@@ -99,6 +196,64 @@ void OCRepPayloadAppend(OCRepPayload* parent, OCRepPayload* child)
     child->next = NULL;
 }
 
+static uint32_t OCRepPayloadHashName(const char* name)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (const unsigned char* c = (const unsigned char*)name; *c; ++c)
+    {
+        hash = (hash ^ *c) * 16777619u;
+    }
+    return hash;
+}
+
+static OCRepPayloadIndexSlot* OCRepPayloadIndexFindSlot(const OCRepPayloadIndex* index,
+        const char* name, uint32_t hash)
+{
+    size_t mask = index->capacity - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+        OCRepPayloadIndexSlot* slot = (OCRepPayloadIndexSlot*)&index->slots[i];
+        if (!slot->value
+            || (slot->hash == hash && 0 == strcmp(slot->value->name, name)))
+        {
+            return slot;
+        }
+    }
+}
+
+/*
+ * Builds an index of the values with room for count values, the index is kept at
+ * most half full so that the probe sequences stay short.
+ */
+static OCRepPayloadIndex* OCRepPayloadIndexCreate(const OCRepPayload* payload, size_t count)
+{
+    size_t capacity = REP_PAYLOAD_INDEX_THRESHOLD * 2;
+    while (capacity < count * 2)
+    {
+        capacity *= 2;
+    }
+
+    OCRepPayloadIndex* index = (OCRepPayloadIndex*)OCRepPayloadAlloc(payload,
+            sizeof(OCRepPayloadIndex) + capacity * sizeof(OCRepPayloadIndexSlot));
+    if (!index)
+    {
+        return NULL;
+    }
+    index->capacity = capacity;
+
+    for (OCRepPayloadValue* val = payload->values; val; val = val->next)
+    {
+        uint32_t hash = OCRepPayloadHashName(val->name);
+        OCRepPayloadIndexSlot* slot = OCRepPayloadIndexFindSlot(index, val->name, hash);
+        slot->hash = hash;
+        slot->value = val;
+        index->tail = val;
+        ++index->count;
+    }
+    return index;
+}
+
 static OCRepPayloadValue* OCRepPayloadFindValue(const OCRepPayload* payload, const char* name)
 {
     if(!payload || !name)
@@ -106,6 +261,12 @@ static OCRepPayloadValue* OCRepPayloadFindValue(const OCRepPayload* payload, con
         return NULL;
     }
 
+    if (payload->index)
+    {
+        return OCRepPayloadIndexFindSlot(payload->index, name,
+                OCRepPayloadHashName(name))->value;
+    }
+
     OCRepPayloadValue* val = payload->values;
     while(val)
     {
@@ -238,58 +399,103 @@ static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val)
 
 static void OCFreeRepPayloadValue(OCRepPayloadValue* val)
 {
-    if(!val)
+    while(val)
     {
-        return;
+        OCRepPayloadValue* next = val->next;
+        // The name is allocated along with the value.
+        OCFreeRepPayloadValueContents(val);
+        OICFree(val);
+        val = next;
     }
-
-    OICFree(val->name);
-    OCFreeRepPayloadValueContents(val);
-    OCFreeRepPayloadValue(val->next);
-    OICFree(val);
 }
-static OCRepPayloadValue* OCRepPayloadValueClone (OCRepPayloadValue* source)
-{
-    if (!source)
-    {
-        return NULL;
-    }
 
-    OCRepPayloadValue *sourceIter = source;
-    OCRepPayloadValue *destIter = (OCRepPayloadValue*) OICCalloc(1, sizeof(OCRepPayloadValue));
-    if (!destIter)
+/*
+ * Allocates a value and its name in a single block.
+ */
+static OCRepPayloadValue* OCRepPayloadValueCreate(const OCRepPayload* payload,
+        const char* name, OCRepPayloadPropType type)
+{
+    size_t nameSize = strlen(name) + 1;
+    OCRepPayloadValue* val = (OCRepPayloadValue*)OCRepPayloadAlloc(payload,
+            sizeof(OCRepPayloadValue) + nameSize);
+    if(!val)
     {
         return NULL;
     }
 
-    OCRepPayloadValue *headOfClone = destIter;
-
-    // Copy payload type and non pointer types in union.
-    *destIter = *sourceIter;
-    destIter->name = OICStrdup (sourceIter->name);
-    OCCopyPropertyValue (destIter, sourceIter);
+    val->name = (char*)(val + 1);
+    memcpy(val->name, name, nameSize);
+    val->type = type;
+    return val;
+}
 
-    sourceIter = sourceIter->next;
+static OCRepPayloadValue* OCRepPayloadValueClone (const OCRepPayload* clone,
+        OCRepPayloadValue* source)
+{
+    OCRepPayloadValue *headOfClone = NULL;
+    OCRepPayloadValue **destIter = &headOfClone;
 
-    while (sourceIter)
+    for (OCRepPayloadValue *sourceIter = source; sourceIter; sourceIter = sourceIter->next)
     {
-        destIter->next = (OCRepPayloadValue*) OICCalloc(1, sizeof(OCRepPayloadValue));
-        if (!destIter->next)
+        OCRepPayloadValue *dest = OCRepPayloadValueCreate(clone, sourceIter->name,
+                sourceIter->type);
+        if (!dest)
         {
             OCFreeRepPayloadValue (headOfClone);
             return NULL;
         }
 
-        *(destIter->next) = *sourceIter;
-        destIter->next->name = OICStrdup (sourceIter->name);
-        OCCopyPropertyValue (destIter->next, sourceIter);
+        // Copy payload type and non pointer types in union.
+        char *name = dest->name;
+        *dest = *sourceIter;
+        dest->name = name;
+        dest->next = NULL;
+        OCCopyPropertyValue (dest, sourceIter);
 
-        sourceIter = sourceIter->next;
-        destIter = destIter->next;
+        *destIter = dest;
+        destIter = &dest->next;
     }
     return headOfClone;
 }
 
+static OCRepPayloadValue* OCRepPayloadIndexedFindAndSetValue(OCRepPayload* payload,
+        const char* name, OCRepPayloadPropType type)
+{
+    OCRepPayloadIndex* index = payload->index;
+    uint32_t hash = OCRepPayloadHashName(name);
+    OCRepPayloadIndexSlot* slot = OCRepPayloadIndexFindSlot(index, name, hash);
+    if (slot->value)
+    {
+        if (!payload->arena)
+        {
+            OCFreeRepPayloadValueContents(slot->value);
+        }
+        slot->value->type = type;
+        return slot->value;
+    }
+
+    OCRepPayloadValue* val = OCRepPayloadValueCreate(payload, name, type);
+    if (!val)
+    {
+        return NULL;
+    }
+    index->tail->next = val;
+    index->tail = val;
+
+    if ((index->count + 1) * 2 > index->capacity)
+    {
+        payload->index = OCRepPayloadIndexCreate(payload, index->count + 1);
+        OCRepPayloadFree(payload, index);
+        // Lookups fall back to the list until the index can be rebuilt.
+        return val;
+    }
+
+    slot->hash = hash;
+    slot->value = val;
+    ++index->count;
+    return val;
+}
+
 static OCRepPayloadValue* OCRepPayloadFindAndSetValue(OCRepPayload* payload, const char* name,
         OCRepPayloadPropType type)
 {
@@ -298,102 +504,93 @@ static OCRepPayloadValue* OCRepPayloadFindAndSetValue(OCRepPayload* payload, con
         return NULL;
     }
 
-    OCRepPayloadValue* val = payload->values;
-    if(val == NULL)
+    if (payload->index)
     {
-        payload->values = (OCRepPayloadValue*)OICCalloc(1, sizeof(OCRepPayloadValue));
-        if(!payload->values)
-        {
-            return NULL;
-        }
-        payload->values->name = OICStrdup(name);
-        if(!payload->values->name)
-        {
-            OICFree(payload->values);
-            payload->values = NULL;
-            return NULL;
-        }
-        payload->values->type =type;
-        return payload->values;
+        return OCRepPayloadIndexedFindAndSetValue(payload, name, type);
     }
 
-    while(val)
+    OCRepPayloadValue** last = &payload->values;
+    size_t count = 0;
+    for (OCRepPayloadValue* val = payload->values; val; val = val->next)
     {
         if(0 == strcmp(val->name, name))
         {
-            OCFreeRepPayloadValueContents(val);
-            val->type = type;
-            return val;
-        }
-        else if(val->next == NULL)
-        {
-            val->next = (OCRepPayloadValue*)OICCalloc(1, sizeof(OCRepPayloadValue));
-            if(!val->next)
+            if (!payload->arena)
             {
-                return NULL;
+                OCFreeRepPayloadValueContents(val);
             }
-            val->next->name = OICStrdup(name);
-            if(!val->next->name)
-            {
-                OICFree(val->next);
-                val->next = NULL;
-                return NULL;
-            }
-            val->next->type =type;
-            return val->next;
+            val->type = type;
+            return val;
         }
-
-        val = val->next;
+        last = &val->next;
+        ++count;
     }
 
-    OC_LOG(ERROR, TAG, "FindAndSetValue reached point after while loop, pointer corruption?");
-    return NULL;
+    *last = OCRepPayloadValueCreate(payload, name, type);
+    if(*last && count + 1 >= REP_PAYLOAD_INDEX_THRESHOLD)
+    {
+        // Without memory for the index, lookups keep on walking the list.
+        payload->index = OCRepPayloadIndexCreate(payload, count + 1);
+    }
+    return *last;
 }
 
 bool OCRepPayloadAddResourceType(OCRepPayload* payload, const char* resourceType)
 {
-    return OCRepPayloadAddResourceTypeAsOwner(payload, OICStrdup(resourceType));
+    if(!payload)
+    {
+        return false;
+    }
+
+    return OCRepPayloadAddResourceTypeAsOwner(payload, OCRepPayloadStrdup(payload, resourceType));
 }
 
-bool OCRepPayloadAddResourceTypeAsOwner(OCRepPayload* payload, char* resourceType)
+static bool OCRepPayloadAddStringAsOwner(OCRepPayload* payload, OCStringLL** list, char* str)
 {
-    if(!payload || !resourceType)
+    char* stored = (char*)OCRepPayloadCopyToArena(payload, str, strlen(str) + 1);
+    if(!stored)
     {
         return false;
     }
 
-    if(payload->types)
+    OCStringLL** last = list;
+    while(*last)
     {
-        OCStringLL* cur = payload->types;
-        while(cur->next)
-        {
-            cur = cur->next;
-        }
-        cur->next = (OCStringLL*)OICCalloc(1, sizeof(OCStringLL));
+        last = &(*last)->next;
+    }
+    *last = (OCStringLL*)OCRepPayloadAlloc(payload, sizeof(OCStringLL));
 
-        if(!cur->next)
-        {
-            return false;
-        }
+    if(!*last)
+    {
+        return false;
+    }
 
-        cur->next->value = resourceType;
-        return true;
+    (*last)->value = stored;
+    if(stored != str)
+    {
+        OICFree(str);
     }
-    else
+    return true;
+}
+
+bool OCRepPayloadAddResourceTypeAsOwner(OCRepPayload* payload, char* resourceType)
+{
+    if(!payload || !resourceType)
     {
-        payload->types = (OCStringLL*)OICCalloc(1, sizeof(OCStringLL));
-        if(!payload->types)
-        {
-            return false;
-        }
-        payload->types->value = resourceType;
-        return true;
+        return false;
     }
+
+    return OCRepPayloadAddStringAsOwner(payload, &payload->types, resourceType);
 }
 
 bool OCRepPayloadAddInterface(OCRepPayload* payload, const char* interface)
 {
-    return OCRepPayloadAddInterfaceAsOwner(payload, OICStrdup(interface));
+    if(!payload)
+    {
+        return false;
+    }
+
+    return OCRepPayloadAddInterfaceAsOwner(payload, OCRepPayloadStrdup(payload, interface));
 }
 
 bool OCRepPayloadAddInterfaceAsOwner(OCRepPayload* payload, char* interface)
@@ -403,32 +600,7 @@ bool OCRepPayloadAddInterfaceAsOwner(OCRepPayload* payload, char* interface)
         return false;
     }
 
-    if(payload->interfaces)
-    {
-        OCStringLL* cur = payload->interfaces;
-        while(cur->next)
-        {
-            cur = cur->next;
-        }
-        cur->next = (OCStringLL*)OICCalloc(1, sizeof(OCStringLL));
-
-        if(!cur->next)
-        {
-            return false;
-        }
-        cur->next->value = interface;
-        return true;
-    }
-    else
-    {
-        payload->interfaces = (OCStringLL*)OICCalloc(1, sizeof(OCStringLL));
-        if(!payload->interfaces)
-        {
-            return false;
-        }
-        payload->interfaces->value = interface;
-        return true;
-    }
+    return OCRepPayloadAddStringAsOwner(payload, &payload->interfaces, interface);
 }
 
 bool OCRepPayloadSetUri(OCRepPayload* payload, const char*  uri)
@@ -438,7 +610,8 @@ bool OCRepPayloadSetUri(OCRepPayload* payload, const char*  uri)
         return false;
     }
 
-    payload->uri = OICStrdup(uri);
+    OCRepPayloadFree(payload, payload->uri);
+    payload->uri = OCRepPayloadStrdup(payload, uri);
     return payload->uri != NULL;
 }
 
@@ -534,19 +707,39 @@ bool OCRepPayloadGetPropDouble(const OCRepPayload* payload, const char* name, do
 
 bool OCRepPayloadSetPropString(OCRepPayload* payload, const char* name, const char* value)
 {
-    char* temp = OICStrdup(value);
+    if(!payload)
+    {
+        return false;
+    }
+
+    char* temp = OCRepPayloadStrdup(payload, value);
     bool b = OCRepPayloadSetPropStringAsOwner(payload, name, temp);
 
     if(!b)
     {
-        OICFree(temp);
+        OCRepPayloadFree(payload, temp);
     }
     return b;
 }
 
 bool OCRepPayloadSetPropStringAsOwner(OCRepPayload* payload, const char* name, char* value)
 {
-    return OCRepPayloadSetProp(payload, name, value, OCREP_PROP_STRING);
+    if(!payload || !value)
+    {
+        return false;
+    }
+
+    char* stored = (char*)OCRepPayloadCopyToArena(payload, value, strlen(value) + 1);
+    if(!stored || !OCRepPayloadSetProp(payload, name, stored, OCREP_PROP_STRING))
+    {
+        return false;
+    }
+
+    if(stored != value)
+    {
+        OICFree(value);
+    }
+    return true;
 }
 
 bool OCRepPayloadGetPropString(const OCRepPayload* payload, const char* name, char** value)
@@ -595,7 +788,20 @@ bool OCRepPayloadSetPropObject(OCRepPayload* payload, const char* name, const OC
 
 bool OCRepPayloadSetPropObjectAsOwner(OCRepPayload* payload, const char* name, OCRepPayload* value)
 {
-    return OCRepPayloadSetProp(payload, name, value, OCREP_PROP_OBJECT);
+    if(!payload || !OCRepPayloadSetProp(payload, name, value, OCREP_PROP_OBJECT))
+    {
+        return false;
+    }
+
+    // A heap object is destroyed along with the region of the payload.
+    if(payload->arena && !OCPayloadArenaAdopt(payload->arena, (void**)&value, 1,
+                OCRepPayloadDestroyAdopted))
+    {
+        OCRepPayloadValue* val = OCRepPayloadFindValue(payload, name);
+        val->type = OCREP_PROP_NULL;
+        return false;
+    }
+    return true;
 }
 
 bool OCRepPayloadGetPropObject(const OCRepPayload* payload, const char* name, OCRepPayload** value)
@@ -629,6 +835,18 @@ size_t calcDimTotal(const size_t dimensions[MAX_REP_ARRAY_DEPTH])
 bool OCRepPayloadSetIntArrayAsOwner(OCRepPayload* payload, const char* name,
         int64_t* array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    if(!payload)
+    {
+        return false;
+    }
+
+    int64_t* stored = (int64_t*)OCRepPayloadCopyToArena(payload, array,
+            calcDimTotal(dimensions) * sizeof(int64_t));
+    if(!stored && array)
+    {
+        return false;
+    }
+
     OCRepPayloadValue* val = OCRepPayloadFindAndSetValue(payload, name, OCREP_PROP_ARRAY);
 
     if(!val)
@@ -638,8 +856,12 @@ bool OCRepPayloadSetIntArrayAsOwner(OCRepPayload* payload, const char* name,
 
     val->arr.type = OCREP_PROP_INT;
     memcpy(val->arr.dimensions, dimensions, MAX_REP_ARRAY_DEPTH * sizeof(size_t));
-    val->arr.iArray = array;
+    val->arr.iArray = stored;
 
+    if(stored != array)
+    {
+        OICFree(array);
+    }
     return true;
 }
 
@@ -700,6 +922,18 @@ bool OCRepPayloadGetIntArray(const OCRepPayload* payload, const char* name,
 bool OCRepPayloadSetDoubleArrayAsOwner(OCRepPayload* payload, const char* name,
         double* array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    if(!payload)
+    {
+        return false;
+    }
+
+    double* stored = (double*)OCRepPayloadCopyToArena(payload, array,
+            calcDimTotal(dimensions) * sizeof(double));
+    if(!stored && array)
+    {
+        return false;
+    }
+
     OCRepPayloadValue* val = OCRepPayloadFindAndSetValue(payload, name, OCREP_PROP_ARRAY);
 
     if(!val)
@@ -709,8 +943,12 @@ bool OCRepPayloadSetDoubleArrayAsOwner(OCRepPayload* payload, const char* name,
 
     val->arr.type = OCREP_PROP_DOUBLE;
     memcpy(val->arr.dimensions, dimensions, MAX_REP_ARRAY_DEPTH * sizeof(size_t));
-    val->arr.dArray = array;
+    val->arr.dArray = stored;
 
+    if(stored != array)
+    {
+        OICFree(array);
+    }
     return true;
 }
 bool OCRepPayloadSetDoubleArray(OCRepPayload* payload, const char* name,
@@ -769,6 +1007,29 @@ bool OCRepPayloadGetDoubleArray(const OCRepPayload* payload, const char* name,
 bool OCRepPayloadSetStringArrayAsOwner(OCRepPayload* payload, const char* name,
         char** array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    if(!payload)
+    {
+        return false;
+    }
+
+    size_t dimTotal = calcDimTotal(dimensions);
+    char** stored = (char**)OCRepPayloadCopyToArena(payload, array, dimTotal * sizeof(char*));
+    if(!stored && array)
+    {
+        return false;
+    }
+    for(size_t i = 0; stored != array && i < dimTotal; ++i)
+    {
+        if(array[i])
+        {
+            stored[i] = (char*)OCRepPayloadCopyToArena(payload, array[i], strlen(array[i]) + 1);
+            if(!stored[i])
+            {
+                return false;
+            }
+        }
+    }
+
     OCRepPayloadValue* val = OCRepPayloadFindAndSetValue(payload, name, OCREP_PROP_ARRAY);
 
     if(!val)
@@ -778,8 +1039,16 @@ bool OCRepPayloadSetStringArrayAsOwner(OCRepPayload* payload, const char* name,
 
     val->arr.type = OCREP_PROP_STRING;
     memcpy(val->arr.dimensions, dimensions, MAX_REP_ARRAY_DEPTH * sizeof(size_t));
-    val->arr.strArray = array;
+    val->arr.strArray = stored;
 
+    if(stored != array)
+    {
+        for(size_t i = 0; i < dimTotal; ++i)
+        {
+            OICFree(array[i]);
+        }
+        OICFree(array);
+    }
     return true;
 }
 bool OCRepPayloadSetStringArray(OCRepPayload* payload, const char* name,
@@ -852,6 +1121,17 @@ bool OCRepPayloadGetStringArray(const OCRepPayload* payload, const char* name,
 bool OCRepPayloadSetBoolArrayAsOwner(OCRepPayload* payload, const char* name,
         bool* array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    if(!payload)
+    {
+        return false;
+    }
+
+    bool* stored = (bool*)OCRepPayloadCopyToArena(payload, array,
+            calcDimTotal(dimensions) * sizeof(bool));
+    if(!stored && array)
+    {
+        return false;
+    }
 
     OCRepPayloadValue* val = OCRepPayloadFindAndSetValue(payload, name, OCREP_PROP_ARRAY);
 
@@ -862,8 +1142,12 @@ bool OCRepPayloadSetBoolArrayAsOwner(OCRepPayload* payload, const char* name,
 
     val->arr.type = OCREP_PROP_BOOL;
     memcpy(val->arr.dimensions, dimensions, MAX_REP_ARRAY_DEPTH * sizeof(size_t));
-    val->arr.bArray = array;
+    val->arr.bArray = stored;
 
+    if(stored != array)
+    {
+        OICFree(array);
+    }
     return true;
 }
 bool OCRepPayloadSetBoolArray(OCRepPayload* payload, const char* name,
@@ -923,6 +1207,19 @@ bool OCRepPayloadGetBoolArray(const OCRepPayload* payload, const char* name,
 bool OCRepPayloadSetPropObjectArrayAsOwner(OCRepPayload* payload, const char* name,
         OCRepPayload** array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    if(!payload)
+    {
+        return false;
+    }
+
+    size_t dimTotal = calcDimTotal(dimensions);
+    OCRepPayload** stored = (OCRepPayload**)OCRepPayloadCopyToArena(payload, array,
+            dimTotal * sizeof(OCRepPayload*));
+    if(!stored && array)
+    {
+        return false;
+    }
+
     OCRepPayloadValue* val = OCRepPayloadFindAndSetValue(payload, name, OCREP_PROP_ARRAY);
 
     if(!val)
@@ -930,10 +1227,23 @@ bool OCRepPayloadSetPropObjectArrayAsOwner(OCRepPayload* payload, const char* na
         return false;
     }
 
+    // Heap objects are destroyed along with the region of the payload.
+    if(payload->arena && stored
+            && !OCPayloadArenaAdopt(payload->arena, (void**)stored, dimTotal,
+                OCRepPayloadDestroyAdopted))
+    {
+        val->type = OCREP_PROP_NULL;
+        return false;
+    }
+
     val->arr.type = OCREP_PROP_OBJECT;
     memcpy(val->arr.dimensions, dimensions, MAX_REP_ARRAY_DEPTH * sizeof(size_t));
-    val->arr.objArray = array;
+    val->arr.objArray = stored;
 
+    if(stored != array)
+    {
+        OICFree(array);
+    }
     return true;
 }
 
@@ -1068,7 +1378,11 @@ OCRepPayload* OCRepPayloadClone (const OCRepPayload* payload)
     clone->uri = OICStrdup (payload->uri);
     clone->types = CloneOCStringLL (payload->types);
     clone->interfaces = CloneOCStringLL (payload->interfaces);
-    clone->values = OCRepPayloadValueClone (payload->values);
+    clone->values = OCRepPayloadValueClone (clone, payload->values);
+    if (clone->values && payload->index)
+    {
+        clone->index = OCRepPayloadIndexCreate(clone, payload->index->count);
+    }
 
     return clone;
 }
@@ -1081,10 +1395,22 @@ void OCRepPayloadDestroy(OCRepPayload* payload)
         return;
     }
 
+    if(payload->arena)
+    {
+        // Everything else is released along with the region, by the payload owning it.
+        OCRepPayloadDestroy(payload->next);
+        if(payload->ownsArena)
+        {
+            OCPayloadArenaDestroy(payload->arena);
+        }
+        return;
+    }
+
     OICFree(payload->uri);
     OCFreeOCStringLL(payload->types);
     OCFreeOCStringLL(payload->interfaces);
     OCFreeRepPayloadValue(payload->values);
+    OICFree(payload->index);
     OCRepPayloadDestroy(payload->next);
     OICFree(payload);
 }
@@ -0,0 +1,245 @@
+//******************************************************************
+//
+// Copyright 2015 Intel Mobile Communications GmbH All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "ocpayloadarena.h"
+#include <stdint.h>
+#include <string.h>
+#include "oic_malloc.h"
+
+/** Smallest first block of a region.*/
+#define ARENA_MIN_BLOCK_SIZE (512)
+
+typedef union
+{
+    int64_t i;
+    double d;
+    void *p;
+} ArenaAlign;
+
+#define ARENA_ALIGNMENT (sizeof(ArenaAlign))
+
+typedef struct ArenaBlock
+{
+    struct ArenaBlock *next;
+    size_t size;
+    size_t used;
+    ArenaAlign data[];
+} ArenaBlock;
+
+typedef struct ArenaAdopted
+{
+    struct ArenaAdopted *next;
+    void *ptr;
+    OCPayloadArenaDestructor destroy;
+} ArenaAdopted;
+
+struct OCPayloadArena
+{
+    /** Blocks, the one allocations are served from first.*/
+    ArenaBlock *blocks;
+    ArenaAdopted *adopted;
+    OCPayloadArenaStats stats;
+};
+
+static size_t alignSize(size_t size)
+{
+    return (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+}
+
+static ArenaBlock *createBlock(size_t size)
+{
+    // Blocks are never reused, so zeroing them once is enough.
+    ArenaBlock *block = (ArenaBlock *)OICCalloc(1, sizeof(ArenaBlock) + size);
+    if (block)
+    {
+        block->size = size;
+    }
+    return block;
+}
+
+static void *allocInBlock(ArenaBlock *block, size_t size)
+{
+    void *ptr = (uint8_t *)block->data + block->used;
+    block->used += size;
+    return ptr;
+}
+
+OCPayloadArena *OCPayloadArenaCreate(size_t sizeHint)
+{
+    size_t arenaSize = alignSize(sizeof(OCPayloadArena));
+    size_t blockSize = alignSize(sizeHint) + arenaSize;
+    if (blockSize < ARENA_MIN_BLOCK_SIZE)
+    {
+        blockSize = ARENA_MIN_BLOCK_SIZE;
+    }
+
+    // The region itself lives in its first block.
+    ArenaBlock *block = createBlock(blockSize);
+    if (!block)
+    {
+        return NULL;
+    }
+
+    OCPayloadArena *arena = (OCPayloadArena *)allocInBlock(block, arenaSize);
+    arena->blocks = block;
+    arena->stats.blocks = 1;
+    return arena;
+}
+
+void OCPayloadArenaDestroy(OCPayloadArena *arena)
+{
+    if (!arena)
+    {
+        return;
+    }
+
+    for (ArenaAdopted *adopted = arena->adopted; adopted; adopted = adopted->next)
+    {
+        adopted->destroy(adopted->ptr);
+    }
+
+    // The first block, holding the region, is the last one of the list.
+    ArenaBlock *block = arena->blocks;
+    while (block)
+    {
+        ArenaBlock *next = block->next;
+        OICFree(block);
+        block = next;
+    }
+}
+
+void *OCPayloadArenaAlloc(OCPayloadArena *arena, size_t size)
+{
+    if (!arena || !size)
+    {
+        return NULL;
+    }
+
+    size = alignSize(size);
+    ArenaBlock *block = arena->blocks;
+    if (block->size - block->used < size)
+    {
+        size_t blockSize = block->size * 2;
+        if (blockSize < size)
+        {
+            blockSize = size;
+        }
+
+        block = createBlock(blockSize);
+        if (!block)
+        {
+            return NULL;
+        }
+        block->next = arena->blocks;
+        arena->blocks = block;
+        ++arena->stats.blocks;
+    }
+
+    ++arena->stats.allocations;
+    return allocInBlock(block, size);
+}
+
+char *OCPayloadArenaStrdup(OCPayloadArena *arena, const char *str)
+{
+    if (!str)
+    {
+        return NULL;
+    }
+
+    size_t size = strlen(str) + 1;
+    char *dup = (char *)OCPayloadArenaAlloc(arena, size);
+    if (dup)
+    {
+        memcpy(dup, str, size);
+    }
+    return dup;
+}
+
+bool OCPayloadArenaContains(const OCPayloadArena *arena, const void *ptr)
+{
+    if (!arena || !ptr)
+    {
+        return false;
+    }
+
+    const uint8_t *p = (const uint8_t *)ptr;
+    for (const ArenaBlock *block = arena->blocks; block; block = block->next)
+    {
+        const uint8_t *data = (const uint8_t *)block->data;
+        if (p >= data && p < data + block->size)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OCPayloadArenaAdopt(OCPayloadArena *arena, void **ptrs, size_t count,
+                         OCPayloadArenaDestructor destroy)
+{
+    if (!arena || !ptrs || !destroy)
+    {
+        return false;
+    }
+
+    size_t foreign = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (ptrs[i] && !OCPayloadArenaContains(arena, ptrs[i]))
+        {
+            ++foreign;
+        }
+    }
+    if (!foreign)
+    {
+        return true;
+    }
+
+    // All the records are allocated first, so that nothing is adopted on failure.
+    ArenaAdopted *adopted = (ArenaAdopted *)OCPayloadArenaAlloc(arena,
+            foreign * sizeof(ArenaAdopted));
+    if (!adopted)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (ptrs[i] && !OCPayloadArenaContains(arena, ptrs[i]))
+        {
+            adopted->ptr = ptrs[i];
+            adopted->destroy = destroy;
+            adopted->next = arena->adopted;
+            arena->adopted = adopted;
+            ++adopted;
+        }
+    }
+    arena->stats.adopted += foreign;
+    return true;
+}
+
+OCPayloadArenaStats OCPayloadArenaGetStats(const OCPayloadArena *arena)
+{
+    OCPayloadArenaStats stats = {0, 0, 0};
+    if (arena)
+    {
+        stats = arena->stats;
+    }
+    return stats;
+}
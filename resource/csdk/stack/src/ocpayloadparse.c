@@ -34,6 +34,7 @@
 #include "oic_malloc.h"
 #include "ocstackinternal.h"
 #include "ocpayload.h"
+#include "ocpayloadarena.h"
 #include "cbor.h"
 #include "oic_string.h"
 #include "payload_logging.h"
@@ -41,16 +42,21 @@
 
 #define TAG "OCPayloadParse"
 
+/** Size of the region of a representation, relative to its encoded size.*/
+#define REP_PAYLOAD_ARENA_SIZE_RATIO (4)
+
 static OCStackResult OCParseDiscoveryPayload(OCPayload** outPayload, CborValue* arrayVal);
 static OCStackResult OCParseDevicePayload(OCPayload** outPayload, CborValue* arrayVal);
 static OCStackResult OCParsePlatformPayload(OCPayload** outPayload, CborValue* arrayVal);
-static bool OCParseSingleRepPayload(OCRepPayload** outPayload, CborValue* repParent);
-static OCStackResult OCParseRepPayload(OCPayload** outPayload, CborValue* arrayVal);
+static bool OCParseSingleRepPayload(OCRepPayload** outPayload, CborValue* repParent,
+        OCPayloadArena* arena);
+static OCStackResult OCParseRepPayload(OCPayload** outPayload, CborValue* arrayVal,
+        OCPayloadArena* arena);
 static OCStackResult OCParsePresencePayload(OCPayload** outPayload, CborValue* arrayVal);
 static OCStackResult OCParseSecurityPayload(OCPayload** outPayload, CborValue* arrayVal);
 
-OCStackResult OCParsePayload(OCPayload** outPayload, OCPayloadType payloadType,
-        const uint8_t* payload, size_t payloadSize)
+static OCStackResult OCParsePayloadWithArena(OCPayload** outPayload,
+        OCPayloadType payloadType, const uint8_t* payload, size_t payloadSize, bool useArena)
 {
     CborParser parser;
     CborValue rootValue;
@@ -92,7 +98,20 @@ OCStackResult OCParsePayload(OCPayload** outPayload, OCPayloadType payloadType,
             result = OCParsePlatformPayload(outPayload, &arrayValue);
             break;
         case PAYLOAD_TYPE_REPRESENTATION:
-            result = OCParseRepPayload(outPayload, &arrayValue);
+            if (useArena)
+            {
+                OCPayloadArena* arena = OCPayloadArenaCreate(
+                        payloadSize * REP_PAYLOAD_ARENA_SIZE_RATIO);
+                if (!arena)
+                {
+                    return OC_STACK_NO_MEMORY;
+                }
+                result = OCParseRepPayload(outPayload, &arrayValue, arena);
+            }
+            else
+            {
+                result = OCParseRepPayload(outPayload, &arrayValue, NULL);
+            }
             break;
         case PAYLOAD_TYPE_PRESENCE:
             result = OCParsePresencePayload(outPayload, &arrayValue);
@@ -125,8 +144,55 @@ OCStackResult OCParsePayload(OCPayload** outPayload, OCPayloadType payloadType,
     return result;
 }
 
+OCStackResult OCParsePayload(OCPayload** outPayload, OCPayloadType payloadType,
+        const uint8_t* payload, size_t payloadSize)
+{
+    return OCParsePayloadWithArena(outPayload, payloadType, payload, payloadSize, false);
+}
+
+OCStackResult OCParseScopedPayload(OCPayload** outPayload, OCPayloadType payloadType,
+        const uint8_t* payload, size_t payloadSize)
+{
+    return OCParsePayloadWithArena(outPayload, payloadType, payload, payloadSize, true);
+}
+
 void OCFreeOCStringLL(OCStringLL* ll);
 
+/*
+ * Copies a text string in the region, or on the heap without region.
+ */
+static CborError OCParseDupString(const CborValue* value, char** str, OCPayloadArena* arena)
+{
+    size_t len;
+    if (!arena)
+    {
+        return cbor_value_dup_text_string(value, str, &len, NULL);
+    }
+
+    len = SIZE_MAX;
+    CborError err = cbor_value_copy_text_string(value, NULL, &len, NULL);
+    if (err)
+    {
+        return err;
+    }
+
+    ++len;
+    *str = (char*)OCPayloadArenaAlloc(arena, len);
+    if (!*str)
+    {
+        return CborErrorOutOfMemory;
+    }
+    return cbor_value_copy_text_string(value, *str, &len, NULL);
+}
+
+static void OCParseFreeString(char* str, OCPayloadArena* arena)
+{
+    if (!arena)
+    {
+        OICFree(str);
+    }
+}
+
 static OCStackResult OCParseSecurityPayload(OCPayload** outPayload, CborValue* arrayVal)
 {
     if (!outPayload)
@@ -819,7 +885,7 @@ static size_t arrayStep(size_t dimensions[MAX_REP_ARRAY_DEPTH], size_t elementNu
 }
 
 static bool OCParseArrayFillArray(const CborValue* parent, size_t dimensions[MAX_REP_ARRAY_DEPTH],
-        OCRepPayloadPropType type, void* targetArray)
+        OCRepPayloadPropType type, void* targetArray, OCPayloadArena* arena)
 {
     bool err = false;
     CborValue insideArray;
@@ -828,7 +894,6 @@ static bool OCParseArrayFillArray(const CborValue* parent, size_t dimensions[MAX
 
     size_t i = 0;
     char* tempStr = NULL;
-    size_t tempLen = 0;
     OCRepPayload* tempPl = NULL;
 
     size_t newdim[MAX_REP_ARRAY_DEPTH];
@@ -852,8 +917,8 @@ static bool OCParseArrayFillArray(const CborValue* parent, size_t dimensions[MAX
                     {
                         err = err || OCParseArrayFillArray(&insideArray, newdim,
                             type,
-                            &(((int64_t*)targetArray)[arrayStep(dimensions, i)])
-                            );
+                            &(((int64_t*)targetArray)[arrayStep(dimensions, i)]),
+                            arena);
                     }
                     break;
                 case OCREP_PROP_DOUBLE:
@@ -866,8 +931,8 @@ static bool OCParseArrayFillArray(const CborValue* parent, size_t dimensions[MAX
                     {
                         err = err || OCParseArrayFillArray(&insideArray, newdim,
                             type,
-                            &(((double*)targetArray)[arrayStep(dimensions, i)])
-                            );
+                            &(((double*)targetArray)[arrayStep(dimensions, i)]),
+                            arena);
                     }
                     break;
                 case OCREP_PROP_BOOL:
@@ -880,15 +945,14 @@ static bool OCParseArrayFillArray(const CborValue* parent, size_t dimensions[MAX
                     {
                         err = err || OCParseArrayFillArray(&insideArray, newdim,
                             type,
-                            &(((bool*)targetArray)[arrayStep(dimensions, i)])
-                            );
+                            &(((bool*)targetArray)[arrayStep(dimensions, i)]),
+                            arena);
                     }
                     break;
                 case OCREP_PROP_STRING:
                     if (dimensions[1] == 0)
                     {
-                        err = err || cbor_value_dup_text_string(&insideArray,
-                                &tempStr, &tempLen, NULL);
+                        err = err || OCParseDupString(&insideArray, &tempStr, arena);
                         ((char**)targetArray)[i] = tempStr;
                         tempStr = NULL;
                     }
@@ -896,14 +960,14 @@ static bool OCParseArrayFillArray(const CborValue* parent, size_t dimensions[MAX
                     {
                         err = err || OCParseArrayFillArray(&insideArray, newdim,
                             type,
-                            &(((char**)targetArray)[arrayStep(dimensions, i)])
-                            );
+                            &(((char**)targetArray)[arrayStep(dimensions, i)]),
+                            arena);
                     }
                     break;
                 case OCREP_PROP_OBJECT:
                     if (dimensions[1] == 0)
                     {
-                        err = err || OCParseSingleRepPayload(&tempPl, &insideArray);
+                        err = err || OCParseSingleRepPayload(&tempPl, &insideArray, arena);
                         ((OCRepPayload**)targetArray)[i] = tempPl;
                         tempPl = NULL;
                     }
@@ -911,8 +975,8 @@ static bool OCParseArrayFillArray(const CborValue* parent, size_t dimensions[MAX
                     {
                         err = err || OCParseArrayFillArray(&insideArray, newdim,
                             type,
-                            &(((OCRepPayload**)targetArray)[arrayStep(dimensions, i)])
-                            );
+                            &(((OCRepPayload**)targetArray)[arrayStep(dimensions, i)]),
+                            arena);
                     }
                     break;
                 default:
@@ -928,7 +992,8 @@ static bool OCParseArrayFillArray(const CborValue* parent, size_t dimensions[MAX
     return err;
 }
 
-static bool OCParseArray(OCRepPayload* out, const char* name, CborValue* container)
+static bool OCParseArray(OCRepPayload* out, const char* name, CborValue* container,
+        OCPayloadArena* arena)
 {
     OCRepPayloadPropType type;
     size_t dimensions[MAX_REP_ARRAY_DEPTH];
@@ -949,7 +1014,8 @@ static bool OCParseArray(OCRepPayload* out, const char* name, CborValue* contain
 
     size_t dimTotal = calcDimTotal(dimensions);
     size_t allocSize = getAllocSize(type);
-    void* arr = OICCalloc(dimTotal, allocSize);
+    void* arr = arena ? OCPayloadArenaAlloc(arena, dimTotal * allocSize)
+                      : OICCalloc(dimTotal, allocSize);
 
     if (!arr)
     {
@@ -957,7 +1023,33 @@ static bool OCParseArray(OCRepPayload* out, const char* name, CborValue* contain
         return true;
     }
 
-    err = err || OCParseArrayFillArray(container, dimensions, type, arr);
+    err = err || OCParseArrayFillArray(container, dimensions, type, arr, arena);
+
+    if (arena)
+    {
+        // The elements belong to the region, which is released when parsing fails.
+        switch (type)
+        {
+            case OCREP_PROP_INT:
+                return err || !OCRepPayloadSetIntArrayAsOwner(out, name, (int64_t*)arr,
+                        dimensions);
+            case OCREP_PROP_DOUBLE:
+                return err || !OCRepPayloadSetDoubleArrayAsOwner(out, name, (double*)arr,
+                        dimensions);
+            case OCREP_PROP_BOOL:
+                return err || !OCRepPayloadSetBoolArrayAsOwner(out, name, (bool*)arr,
+                        dimensions);
+            case OCREP_PROP_STRING:
+                return err || !OCRepPayloadSetStringArrayAsOwner(out, name, (char**)arr,
+                        dimensions);
+            case OCREP_PROP_OBJECT:
+                return err || !OCRepPayloadSetPropObjectArrayAsOwner(out, name,
+                        (OCRepPayload**)arr, dimensions);
+            default:
+                OC_LOG(ERROR, TAG, "Invalid Array type in Parse Array");
+                return true;
+        }
+    }
 
     switch (type)
     {
@@ -1013,14 +1105,15 @@ static bool OCParseArray(OCRepPayload* out, const char* name, CborValue* contain
     return err;
 }
 
-static bool OCParseSingleRepPayload(OCRepPayload** outPayload, CborValue* repParent)
+static bool OCParseSingleRepPayload(OCRepPayload** outPayload, CborValue* repParent,
+        OCPayloadArena* arena)
 {
     if (!outPayload)
     {
         return false;
     }
 
-    *outPayload = OCRepPayloadCreate();
+    *outPayload = arena ? OCRepPayloadCreateInArena(arena) : OCRepPayloadCreate();
     OCRepPayload* curPayload = *outPayload;
     bool err = false;
     if(!*outPayload)
@@ -1028,13 +1121,11 @@ static bool OCParseSingleRepPayload(OCRepPayload** outPayload, CborValue* repPar
         return CborErrorOutOfMemory;
     }
 
-    size_t len;
     CborValue curVal;
     err = err || cbor_value_map_find_value(repParent, OC_RSRVD_HREF, &curVal);
     if(cbor_value_is_valid(&curVal))
     {
-        err = err || cbor_value_dup_text_string(&curVal, &curPayload->uri, &len,
-            NULL);
+        err = err || OCParseDupString(&curVal, &curPayload->uri, arena);
     }
 
     err = err || cbor_value_map_find_value(repParent, OC_RSRVD_PROPERTY, &curVal);
@@ -1047,7 +1138,7 @@ static bool OCParseSingleRepPayload(OCRepPayload** outPayload, CborValue* repPar
         if(cbor_value_is_text_string(&insidePropValue))
         {
             char* allRt = NULL;
-            err = err || cbor_value_dup_text_string(&insidePropValue, &allRt, &len, NULL);
+            err = err || OCParseDupString(&insidePropValue, &allRt, arena);
 
             char* savePtr;
 
@@ -1065,7 +1156,7 @@ static bool OCParseSingleRepPayload(OCRepPayload** outPayload, CborValue* repPar
                     curPtr = strtok_r(NULL, " ", &savePtr);
                 }
             }
-            OICFree(allRt);
+            OCParseFreeString(allRt, arena);
         }
 
         err = err || cbor_value_map_find_value(&curVal, OC_RSRVD_INTERFACE, &insidePropValue);
@@ -1073,7 +1164,7 @@ static bool OCParseSingleRepPayload(OCRepPayload** outPayload, CborValue* repPar
         if(cbor_value_is_text_string(&insidePropValue))
         {
             char* allIf = NULL;
-            err = err || cbor_value_dup_text_string(&insidePropValue, &allIf, &len, NULL);
+            err = err || OCParseDupString(&insidePropValue, &allIf, arena);
 
             char* savePtr;
 
@@ -1091,7 +1182,7 @@ static bool OCParseSingleRepPayload(OCRepPayload** outPayload, CborValue* repPar
                     curPtr = strtok_r(NULL, " ", &savePtr);
                 }
             }
-            OICFree(allIf);
+            OCParseFreeString(allIf, arena);
         }
     }
 
@@ -1104,7 +1195,7 @@ static bool OCParseSingleRepPayload(OCRepPayload** outPayload, CborValue* repPar
         while(!err && cbor_value_is_valid(&repMap))
         {
             char* name;
-            err = err || cbor_value_dup_text_string(&repMap, &name, &len, NULL);
+            err = err || OCParseDupString(&repMap, &name, arena);
 
             err = err || cbor_value_advance(&repMap);
 
@@ -1141,21 +1232,21 @@ static bool OCParseSingleRepPayload(OCRepPayload** outPayload, CborValue* repPar
                     }
                     break;
                 case CborTextStringType:
-                    err = err || cbor_value_dup_text_string(&repMap, &strval, &len, NULL);
+                    err = err || OCParseDupString(&repMap, &strval, arena);
                     if (!err)
                     {
                         err = !OCRepPayloadSetPropStringAsOwner(curPayload, name, strval);
                     }
                     break;
                 case CborMapType:
-                    err = err || OCParseSingleRepPayload(&pl, &repMap);
+                    err = err || OCParseSingleRepPayload(&pl, &repMap, arena);
                     if (!err)
                     {
                         err = !OCRepPayloadSetPropObjectAsOwner(curPayload, name, pl);
                     }
                     break;
                 case CborArrayType:
-                    err = err || OCParseArray(curPayload, name, &repMap);
+                    err = err || OCParseArray(curPayload, name, &repMap, arena);
                     break;
                 default:
                     OC_LOG_V(ERROR, TAG, "Parsing rep property, unknown type %d", repMap.type);
@@ -1163,7 +1254,7 @@ static bool OCParseSingleRepPayload(OCRepPayload** outPayload, CborValue* repPar
             }
 
              err = err || cbor_value_advance(&repMap);
-            OICFree(name);
+            OCParseFreeString(name, arena);
         }
         err = err || cbor_value_leave_container(&curVal, &repMap);
     }
@@ -1176,10 +1267,15 @@ static bool OCParseSingleRepPayload(OCRepPayload** outPayload, CborValue* repPar
 
     return err;
 }
-static OCStackResult OCParseRepPayload(OCPayload** outPayload, CborValue* arrayVal)
+/*
+ * With a region, the whole payload tree is allocated in it and the first payload owns it.
+ */
+static OCStackResult OCParseRepPayload(OCPayload** outPayload, CborValue* arrayVal,
+        OCPayloadArena* arena)
 {
     if (!outPayload)
     {
+        OCPayloadArenaDestroy(arena);
         return OC_STACK_INVALID_PARAM;
     }
 
@@ -1190,7 +1286,7 @@ static OCStackResult OCParseRepPayload(OCPayload** outPayload, CborValue* arrayV
     OCRepPayload* temp = NULL;
     while(!err && cbor_value_is_map(arrayVal))
     {
-         err = err || OCParseSingleRepPayload(&temp, arrayVal);
+         err = err || OCParseSingleRepPayload(&temp, arrayVal, arena);
 
         if(rootPayload == NULL)
         {
@@ -1207,12 +1303,27 @@ static OCStackResult OCParseRepPayload(OCPayload** outPayload, CborValue* arrayV
          err = err || cbor_value_advance(arrayVal);
         if(err)
         {
-            OCRepPayloadDestroy(rootPayload);
+            if (arena)
+            {
+                OCPayloadArenaDestroy(arena);
+            }
+            else
+            {
+                OCRepPayloadDestroy(rootPayload);
+            }
             OC_LOG(ERROR, TAG, "CBOR error in ParseRepPayload");
             return OC_STACK_MALFORMED_RESPONSE;
         }
     }
 
+    if (rootPayload && arena)
+    {
+        rootPayload->ownsArena = true;
+    }
+    else
+    {
+        OCPayloadArenaDestroy(arena);
+    }
     *outPayload = (OCPayload*)rootPayload;
 
     return OC_STACK_OK;
@@ -35,6 +35,7 @@
 #include "logger.h"
 #include "cJSON.h"
 #include "ocpayload.h"
+#include "ocpayloadcbor.h"
 #include "secureresourcemanager.h"
 #include "cacommon.h"
 #include "cainterface.h"
@@ -60,6 +61,30 @@ extern OCResource *headResource;
 static OCPlatformInfo savedPlatformInfo = {0};
 static OCDeviceInfo savedDeviceInfo = {0};
 
+/** Number of encoded discovery responses kept, each for a combination of filters. */
+#define DISCOVERY_CACHE_SIZE (8)
+
+/** Encoded /oic/res response for a combination of filters. */
+typedef struct
+{
+    /** Version of the resources the response was built from, 0 if the entry is unused. */
+    uint32_t version;
+    char *interfaceFilter;
+    char *resourceTypeFilter;
+    /** Transport of the request, which decides the port of secure resources. */
+    OCTransportAdapter adapter;
+    OCTransportFlags ipFamily;
+    uint8_t *payload;
+    size_t payloadSize;
+    uint32_t lastUsed;
+} DiscoveryCacheEntry;
+
+static DiscoveryCacheEntry discoveryCache[DISCOVERY_CACHE_SIZE];
+static uint32_t discoveryCacheVersion = 1;
+static uint32_t discoveryCacheClock = 0;
+static uint32_t discoveryCacheHits = 0;
+static uint32_t discoveryCacheMisses = 0;
+
 //-----------------------------------------------------------------------------
 // Default resource entity handler function
 //-----------------------------------------------------------------------------
@@ -317,14 +342,7 @@ uint8_t IsCollectionResource (OCResource *resource)
         return 0;
     }
 
-    for (int i = 0; i < MAX_CONTAINED_RESOURCES; i++)
-    {
-        if (resource->rsrcResources[i])
-        {
-            return 1;
-        }
-    }
-    return 0;
+    return resource->numRsrcResources ? 1 : 0;
 }
 
 OCResource *FindResourceByUri(const char* resourceUri)
@@ -567,6 +585,179 @@ OCStackResult SendNonPersistantDiscoveryResponse(OCServerRequest *request, OCRes
     return OCDoResponse(&response);
 }
 
+static void freeDiscoveryCacheEntry(DiscoveryCacheEntry *entry)
+{
+    OICFree(entry->interfaceFilter);
+    OICFree(entry->resourceTypeFilter);
+    OICFree(entry->payload);
+    memset(entry, 0, sizeof(DiscoveryCacheEntry));
+}
+
+void FlushDiscoveryCache()
+{
+    for (size_t i = 0; i < DISCOVERY_CACHE_SIZE; ++i)
+    {
+        freeDiscoveryCacheEntry(&discoveryCache[i]);
+    }
+}
+
+void InvalidateDiscoveryCache()
+{
+    // Entries of older versions are never used again, they are replaced when needed.
+    if (++discoveryCacheVersion == 0)
+    {
+        FlushDiscoveryCache();
+        discoveryCacheVersion = 1;
+    }
+}
+
+OCStackResult OCGetDiscoveryCacheStatistics(uint32_t *hits, uint32_t *misses)
+{
+    if (!hits || !misses)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+    *hits = discoveryCacheHits;
+    *misses = discoveryCacheMisses;
+    return OC_STACK_OK;
+}
+
+static bool discoveryFilterEquals(const char *cachedFilter, const char *filter)
+{
+    // Null or empty is analogous to no filter.
+    if (!filter || !*filter)
+    {
+        return !cachedFilter;
+    }
+    return cachedFilter && strcmp(cachedFilter, filter) == 0;
+}
+
+static OCTransportFlags getIpFamily(const OCDevAddr *devAddr)
+{
+    return (OCTransportFlags)(devAddr->flags & (OC_IP_USE_V6 | OC_IP_USE_V4));
+}
+
+static DiscoveryCacheEntry *findDiscoveryCacheEntry(const char *interfaceFilter,
+        const char *resourceTypeFilter, const OCDevAddr *devAddr)
+{
+    for (size_t i = 0; i < DISCOVERY_CACHE_SIZE; ++i)
+    {
+        DiscoveryCacheEntry *entry = &discoveryCache[i];
+        if (entry->version == discoveryCacheVersion
+            && entry->adapter == devAddr->adapter
+            && entry->ipFamily == getIpFamily(devAddr)
+            && discoveryFilterEquals(entry->interfaceFilter, interfaceFilter)
+            && discoveryFilterEquals(entry->resourceTypeFilter, resourceTypeFilter))
+        {
+            entry->lastUsed = ++discoveryCacheClock;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Keeps an encoded response, which is then owned by the cache.
+ */
+static DiscoveryCacheEntry *addDiscoveryCacheEntry(const char *interfaceFilter,
+        const char *resourceTypeFilter, const OCDevAddr *devAddr,
+        uint8_t *payload, size_t payloadSize)
+{
+    // An entry of an older version is replaced first, then the least recently used one.
+    DiscoveryCacheEntry *entry = &discoveryCache[0];
+    for (size_t i = 0; i < DISCOVERY_CACHE_SIZE; ++i)
+    {
+        if (discoveryCache[i].version != discoveryCacheVersion)
+        {
+            entry = &discoveryCache[i];
+            break;
+        }
+        if (discoveryCache[i].lastUsed < entry->lastUsed)
+        {
+            entry = &discoveryCache[i];
+        }
+    }
+    freeDiscoveryCacheEntry(entry);
+
+    entry->payload = payload;
+    if (interfaceFilter && *interfaceFilter)
+    {
+        entry->interfaceFilter = OICStrdup(interfaceFilter);
+        if (!entry->interfaceFilter)
+        {
+            freeDiscoveryCacheEntry(entry);
+            return NULL;
+        }
+    }
+    if (resourceTypeFilter && *resourceTypeFilter)
+    {
+        entry->resourceTypeFilter = OICStrdup(resourceTypeFilter);
+        if (!entry->resourceTypeFilter)
+        {
+            freeDiscoveryCacheEntry(entry);
+            return NULL;
+        }
+    }
+    entry->version = discoveryCacheVersion;
+    entry->adapter = devAddr->adapter;
+    entry->ipFamily = getIpFamily(devAddr);
+    entry->payloadSize = payloadSize;
+    entry->lastUsed = ++discoveryCacheClock;
+    return entry;
+}
+
+static OCStackResult SendNonPersistantEncodedDiscoveryResponse(OCServerRequest *request,
+        OCResource *resource, const uint8_t *payload, size_t payloadSize)
+{
+    OCEntityHandlerResponse response = {0};
+
+    response.ehResult = OC_EH_OK;
+    response.persistentBufferFlag = 0;
+    response.requestHandle = (OCRequestHandle) request;
+    response.resourceHandle = (OCResourceHandle) resource;
+
+    return HandleSingleEncodedResponse(&response, payload, payloadSize);
+}
+
+/*
+ * Encodes and sends the /oic/res response, which is kept for the next requests
+ * with the same filters if it can be cached.
+ */
+static OCStackResult SendDiscoveryResponse(OCServerRequest *request, OCResource *resource,
+        OCPayload *discoveryPayload, const char *interfaceFilter,
+        const char *resourceTypeFilter, bool cacheable)
+{
+    uint8_t *encoded = NULL;
+    size_t encodedSize = 0;
+
+    if (OCConvertPayload(discoveryPayload, &encoded, &encodedSize) != OC_STACK_OK)
+    {
+        return SendNonPersistantDiscoveryResponse(request, resource, discoveryPayload, OC_EH_OK);
+    }
+
+    // The filters and the address belong to the request, which is deleted once answered.
+    DiscoveryCacheEntry *entry = NULL;
+    if (cacheable)
+    {
+        entry = addDiscoveryCacheEntry(interfaceFilter, resourceTypeFilter,
+                &request->devAddr, encoded, encodedSize);
+        if (!entry)
+        {
+            // The encoded response was freed along with the entry.
+            return SendNonPersistantDiscoveryResponse(request, resource, discoveryPayload,
+                    OC_EH_OK);
+        }
+    }
+
+    OCStackResult result = SendNonPersistantEncodedDiscoveryResponse(request, resource,
+            encoded, encodedSize);
+    if (!entry)
+    {
+        OICFree(encoded);
+    }
+    return result;
+}
+
 #ifdef WITH_RD
 static OCStackResult checkResourceExistsAtRD(const char *interfaceType, const char *resourceType,
     OCResourceCollectionPayload **repPayload)
@@ -595,6 +786,9 @@ static OCStackResult HandleVirtualResource (OCServerRequest *request, OCResource
 
     bool bMulticast    = false;     // Was the discovery request a multicast request?
     OCPayload* payload = NULL;
+    char *filterOne = NULL;
+    char *filterTwo = NULL;
+    bool cacheable = false;         // Can the /oic/res response be kept for the next requests?
 
     OC_LOG(INFO, TAG, "Entering HandleVirtualResource");
 
@@ -603,14 +797,26 @@ static OCStackResult HandleVirtualResource (OCServerRequest *request, OCResource
     // Step 1: Generate the response to discovery request
     if (virtualUriInRequest == OC_WELL_KNOWN_URI)
     {
-        char *filterOne = NULL;
-        char *filterTwo = NULL;
-
         discoveryResult = getQueryParamsForFiltering (virtualUriInRequest, request->query,
                 &filterOne, &filterTwo);
 
+        DiscoveryCacheEntry *cached = NULL;
+        if (discoveryResult == OC_STACK_OK)
+        {
+            cached = findDiscoveryCacheEntry(filterOne, filterTwo, &request->devAddr);
+        }
+        if (cached)
+        {
+            ++discoveryCacheHits;
+            SendNonPersistantEncodedDiscoveryResponse(request, resource, cached->payload,
+                    cached->payloadSize);
+            return OC_STACK_OK;
+        }
+
         if (discoveryResult == OC_STACK_OK)
         {
+            ++discoveryCacheMisses;
+            cacheable = true;
             payload = (OCPayload*)OCDiscoveryPayloadCreate();
 
             if(payload)
@@ -621,6 +827,8 @@ static OCStackResult HandleVirtualResource (OCServerRequest *request, OCResource
 #ifdef WITH_RD
                     if (strcmp(resource->uri, OC_RSRVD_RD_URI) == 0)
                     {
+                        // The published resources change without the resources changing.
+                        cacheable = false;
                         OCResourceCollectionPayload *repPayload;
                         discoveryResult = checkResourceExistsAtRD(filterOne, filterTwo, &repPayload);
                         if (discoveryResult != OC_STACK_OK)
@@ -730,7 +938,11 @@ static OCStackResult HandleVirtualResource (OCServerRequest *request, OCResource
     if (OC_GATEWAY != virtualUriInRequest)
 #endif
     {
-        if(discoveryResult == OC_STACK_OK)
+        if(discoveryResult == OC_STACK_OK && virtualUriInRequest == OC_WELL_KNOWN_URI)
+        {
+            SendDiscoveryResponse(request, resource, payload, filterOne, filterTwo, cacheable);
+        }
+        else if(discoveryResult == OC_STACK_OK)
         {
             SendNonPersistantDiscoveryResponse(request, resource, payload, OC_EH_OK);
         }
@@ -22,6 +22,7 @@
 #include "ocstack.h"
 #include "ocserverrequest.h"
 #include "ocresourcehandler.h"
+#include "ocobserve.h"
 #include "oic_malloc.h"
 #include "oic_string.h"
 #include "ocpayload.h"
@@ -43,13 +44,216 @@
 
 #define TAG  "ocserverrequest"
 
+/** Number of buckets the server request indexes start with, a power of 2.*/
+#define SERVER_REQUEST_INDEX_MIN_SIZE (64)
+
+/** Payload size of the pooled server requests, larger ones are allocated on their own.*/
+#define SERVER_REQUEST_POOL_PAYLOAD_SIZE (256)
+
+/** Number of free server requests kept in the pool.*/
+#define SERVER_REQUEST_POOL_SIZE (1024)
+
+/** Number of deleted server requests with a handed out handle kept before their reuse.*/
+#define SERVER_REQUEST_RETIRED_SIZE (64)
+
 static struct OCServerRequest * serverRequestList = NULL;
 static struct OCServerResponse * serverResponseList = NULL;
 
+/**
+ * Server requests are indexed by token and by handle, so that matching a repeated request
+ * or a response of the entity handler does not scan serverRequestList. The indexes are
+ * doubled whenever they hold as many requests as buckets.
+ */
+static OCServerRequest ** requestsByToken = NULL;
+static OCServerRequest ** requestsByHandle = NULL;
+static size_t requestIndexSize = 0;
+static size_t requestCount = 0;
+
+/** Free server requests, linked by next, of SERVER_REQUEST_POOL_PAYLOAD_SIZE payload.*/
+static OCServerRequest * requestPool = NULL;
+static size_t requestPoolSize = 0;
+
+/**
+ * Deleted server requests whose handle may still be held, by a slow entity handler or by
+ * the outstanding fragments of an aggregated response. They are kept away from the pool
+ * and the heap, so that a late response with their handle does not match a new request
+ * at the same address.
+ */
+static OCServerRequest * retiredRequests = NULL;
+static size_t retiredRequestCount = 0;
+
 //-------------------------------------------------------------------------------------------------
 // Local functions
 //-------------------------------------------------------------------------------------------------
 
+static size_t HashRequestToken(const char * token, uint8_t tokenLength)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (uint8_t i = 0; i < tokenLength; i++)
+    {
+        hash = (hash ^ (uint8_t) token[i]) * 16777619u;
+    }
+    return hash & (requestIndexSize - 1);
+}
+
+static size_t HashRequestHandle(const OCServerRequest * handle)
+{
+    uint32_t hash = (uint32_t) ((uintptr_t) handle >> 4);
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3b;
+    hash ^= hash >> 16;
+    return hash & (requestIndexSize - 1);
+}
+
+static void IndexServerRequest(OCServerRequest * request)
+{
+    // Requests sharing a token are found oldest first, as they were in the list
+    OCServerRequest ** bucket =
+            &requestsByToken[HashRequestToken(request->requestToken, request->tokenLength)];
+    while (*bucket)
+    {
+        bucket = &(*bucket)->nextByToken;
+    }
+    request->nextByToken = NULL;
+    *bucket = request;
+
+    size_t handleBucket = HashRequestHandle(request);
+    request->nextByHandle = requestsByHandle[handleBucket];
+    requestsByHandle[handleBucket] = request;
+}
+
+static void UnindexServerRequest(OCServerRequest * request)
+{
+    OCServerRequest ** bucket =
+            &requestsByToken[HashRequestToken(request->requestToken, request->tokenLength)];
+    while (*bucket && *bucket != request)
+    {
+        bucket = &(*bucket)->nextByToken;
+    }
+    if (*bucket)
+    {
+        *bucket = request->nextByToken;
+    }
+
+    bucket = &requestsByHandle[HashRequestHandle(request)];
+    while (*bucket && *bucket != request)
+    {
+        bucket = &(*bucket)->nextByHandle;
+    }
+    if (*bucket)
+    {
+        *bucket = request->nextByHandle;
+    }
+}
+
+static OCStackResult GrowServerRequestIndex()
+{
+    size_t size = requestIndexSize ? requestIndexSize * 2 : SERVER_REQUEST_INDEX_MIN_SIZE;
+    OCServerRequest ** byToken = (OCServerRequest **) OICCalloc(size, sizeof(OCServerRequest *));
+    OCServerRequest ** byHandle = (OCServerRequest **) OICCalloc(size, sizeof(OCServerRequest *));
+    if (!byToken || !byHandle)
+    {
+        OICFree(byToken);
+        OICFree(byHandle);
+        return OC_STACK_NO_MEMORY;
+    }
+
+    OICFree(requestsByToken);
+    OICFree(requestsByHandle);
+    requestsByToken = byToken;
+    requestsByHandle = byHandle;
+    requestIndexSize = size;
+
+    OCServerRequest * request = NULL;
+    LL_FOREACH (serverRequestList, request)
+    {
+        IndexServerRequest(request);
+    }
+    return OC_STACK_OK;
+}
+
+static OCServerRequest * FindServerRequest(const OCServerRequest * handle)
+{
+    if (!handle || !requestIndexSize)
+    {
+        return NULL;
+    }
+
+    OCServerRequest * out = requestsByHandle[HashRequestHandle(handle)];
+    while (out && out != handle)
+    {
+        out = out->nextByHandle;
+    }
+    return out;
+}
+
+/**
+ * Allocate a zeroed server request, from the pool when the payload fits.
+ *
+ * @param payloadSize - size of the payload copied in the request
+ *
+ * @return
+ *     OCServerRequest*
+ */
+static OCServerRequest * AllocateServerRequest(size_t payloadSize)
+{
+    // payload already counts one byte, which keeps the copied payload null terminated
+    if (payloadSize > SERVER_REQUEST_POOL_PAYLOAD_SIZE)
+    {
+        return (OCServerRequest *) OICCalloc(1, sizeof(OCServerRequest) + payloadSize);
+    }
+
+    OCServerRequest * request = requestPool;
+    if (request)
+    {
+        requestPool = request->next;
+        requestPoolSize--;
+    }
+    else
+    {
+        request = (OCServerRequest *) OICMalloc(sizeof(OCServerRequest) +
+                                                SERVER_REQUEST_POOL_PAYLOAD_SIZE);
+        if (!request)
+        {
+            return NULL;
+        }
+    }
+    memset(request, 0, sizeof(OCServerRequest) + SERVER_REQUEST_POOL_PAYLOAD_SIZE);
+    request->pooledFlag = 1;
+    return request;
+}
+
+static void ReleaseServerRequest(OCServerRequest * request)
+{
+    if (request->pooledFlag && requestPoolSize < SERVER_REQUEST_POOL_SIZE)
+    {
+        request->next = requestPool;
+        requestPool = request;
+        requestPoolSize++;
+    }
+    else
+    {
+        OICFree(request);
+    }
+}
+
+static void FreeServerRequest(OCServerRequest * request)
+{
+    if (request->slowFlag || request->ehResponseHandler == HandleAggregateResponse)
+    {
+        DL_APPEND(retiredRequests, request);
+        if (++retiredRequestCount <= SERVER_REQUEST_RETIRED_SIZE)
+        {
+            return;
+        }
+        request = retiredRequests;
+        DL_DELETE(retiredRequests, request);
+        retiredRequestCount--;
+    }
+    ReleaseServerRequest(request);
+}
+
 /**
  * Add a server response to the server response list
  *
@@ -99,9 +303,10 @@ static void DeleteServerRequest(OCServerRequest * serverRequest)
 {
     if(serverRequest)
     {
-        LL_DELETE(serverRequestList, serverRequest);
-        OICFree(serverRequest->requestToken);
-        OICFree(serverRequest);
+        DL_DELETE(serverRequestList, serverRequest);
+        UnindexServerRequest(serverRequest);
+        requestCount--;
+        FreeServerRequest(serverRequest);
         serverRequest = NULL;
         OC_LOG(INFO, TAG, "Server Request Removed!!");
     }
@@ -202,13 +407,17 @@ OCServerRequest * GetServerRequestUsingToken (const CAToken_t token, uint8_t tok
     OC_LOG(INFO, TAG,"Get server request with token");
     OC_LOG_BUFFER(INFO, TAG, (const uint8_t *)token, tokenLength);
 
-    OC_LOG(INFO, TAG,"Found token");
-    LL_FOREACH (serverRequestList, out)
+    if (requestIndexSize)
     {
-        OC_LOG_BUFFER(INFO, TAG, (const uint8_t *)out->requestToken, tokenLength);
-        if(memcmp(out->requestToken, token, tokenLength) == 0)
+        for (out = requestsByToken[HashRequestToken(token, tokenLength)]; out;
+             out = out->nextByToken)
         {
-            return out;
+            if (out->tokenLength == tokenLength &&
+                (!tokenLength || memcmp(out->requestToken, token, tokenLength) == 0))
+            {
+                OC_LOG(INFO, TAG,"Found token");
+                return out;
+            }
         }
     }
     OC_LOG(ERROR, TAG, "Server Request not found!!");
@@ -224,16 +433,12 @@ OCServerRequest * GetServerRequestUsingToken (const CAToken_t token, uint8_t tok
  */
 OCServerRequest * GetServerRequestUsingHandle (const OCServerRequest * handle)
 {
-    OCServerRequest * out = NULL;
-    LL_FOREACH (serverRequestList, out)
+    OCServerRequest * out = FindServerRequest(handle);
+    if (!out)
     {
-        if(out == handle)
-        {
-            return out;
-        }
+        OC_LOG(ERROR, TAG, "Server Request not found!!");
     }
-    OC_LOG(ERROR, TAG, "Server Request not found!!");
-    return NULL;
+    return out;
 }
 
 /**
@@ -267,18 +472,22 @@ OCStackResult AddServerRequest (OCServerRequest ** request, uint16_t coapID,
         char * resourceUrl, size_t reqTotalSize, OCPayloadFormat acceptFormat,
         const OCDevAddr *devAddr)
 {
-    if (!request)
+    if (!request || tokenLength > CA_MAX_TOKEN_LEN)
     {
         return OC_STACK_INVALID_PARAM;
     }
 
     OCServerRequest * serverRequest = NULL;
 
+    VERIFY_NON_NULL(devAddr);
     OC_LOG_V(INFO, TAG, "addserverrequest entry!! [%s:%u]", devAddr->addr, devAddr->port);
 
-    serverRequest = (OCServerRequest *) OICCalloc(1, sizeof(OCServerRequest) +
-        (reqTotalSize ? reqTotalSize : 1) - 1);
-    VERIFY_NON_NULL(devAddr);
+    if (requestCount >= requestIndexSize && GrowServerRequestIndex() != OC_STACK_OK)
+    {
+        goto exit;
+    }
+
+    serverRequest = AllocateServerRequest(reqTotalSize);
     VERIFY_NON_NULL(serverRequest);
 
     serverRequest->coapID = coapID;
@@ -313,17 +522,14 @@ OCStackResult AddServerRequest (OCServerRequest ** request, uint16_t coapID,
     }
 
     serverRequest->requestComplete = 0;
-    if(requestToken)
+    if(requestToken && tokenLength)
     {
-        // If tokenLength is zero, the return value depends on the
-        // particular library implementation (it may or may not be a null pointer).
-        if (tokenLength)
-        {
-            serverRequest->requestToken = (CAToken_t) OICMalloc(tokenLength);
-            VERIFY_NON_NULL(serverRequest->requestToken);
-            memcpy(serverRequest->requestToken, requestToken, tokenLength);
-        }
-
+        serverRequest->requestToken = serverRequest->tokenBuffer;
+        memcpy(serverRequest->requestToken, requestToken, tokenLength);
+    }
+    else
+    {
+        tokenLength = 0;
     }
     serverRequest->tokenLength = tokenLength;
 
@@ -337,15 +543,12 @@ OCStackResult AddServerRequest (OCServerRequest ** request, uint16_t coapID,
 
     *request = serverRequest;
     OC_LOG(INFO, TAG, "Server Request Added!!");
-    LL_APPEND (serverRequestList, serverRequest);
+    DL_APPEND (serverRequestList, serverRequest);
+    IndexServerRequest(serverRequest);
+    requestCount++;
     return OC_STACK_OK;
 
 exit:
-    if (serverRequest)
-    {
-        OICFree(serverRequest);
-        serverRequest = NULL;
-    }
     *request = NULL;
     return OC_STACK_NO_MEMORY;
 }
@@ -377,7 +580,7 @@ OCStackResult FormOCEntityHandlerRequest(
 
         if(payload && payloadSize)
         {
-            if(OCParsePayload(&entityHandlerRequest->payload, payloadType,
+            if(OCParseScopedPayload(&entityHandlerRequest->payload, payloadType,
                         payload, payloadSize) != OC_STACK_OK)
             {
                 return OC_STACK_ERROR;
@@ -404,20 +607,50 @@ OCStackResult FormOCEntityHandlerRequest(
  */
 void FindAndDeleteServerRequest(OCServerRequest * serverRequest)
 {
-    OCServerRequest* tmp;
-    if(serverRequest)
+    if (FindServerRequest(serverRequest))
     {
-        LL_FOREACH(serverRequestList, tmp)
-        {
-            if (serverRequest == tmp)
-            {
-                DeleteServerRequest(tmp);
-                return;
-            }
-        }
+        DeleteServerRequest(serverRequest);
     }
 }
 
+void DeleteServerRequestList()
+{
+    OCServerRequest * request = NULL;
+    OCServerRequest * tmp = NULL;
+    LL_FOREACH_SAFE(serverRequestList, request, tmp)
+    {
+        DeleteServerRequest(request);
+    }
+
+    OCServerResponse * response = NULL;
+    OCServerResponse * nextResponse = NULL;
+    LL_FOREACH_SAFE(serverResponseList, response, nextResponse)
+    {
+        DeleteServerResponse(response);
+    }
+
+    LL_FOREACH_SAFE(retiredRequests, request, tmp)
+    {
+        OICFree(request);
+    }
+    retiredRequests = NULL;
+    retiredRequestCount = 0;
+
+    while (requestPool)
+    {
+        request = requestPool;
+        requestPool = request->next;
+        OICFree(request);
+    }
+    requestPoolSize = 0;
+
+    OICFree(requestsByToken);
+    OICFree(requestsByHandle);
+    requestsByToken = NULL;
+    requestsByHandle = NULL;
+    requestIndexSize = 0;
+}
+
 CAResponseResult_t ConvertEHResultToCAResult (OCEntityHandlerResult result, OCMethod method)
 {
     CAResponseResult_t caResult;
@@ -479,7 +712,13 @@ CAResponseResult_t ConvertEHResultToCAResult (OCEntityHandlerResult result, OCMe
  * @return
  *     OCStackResult
  */
-OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
+/**
+ * Send a response from a single resource, with a body which is either converted from
+ * the payload of the response or already encoded in CBOR.
+ */
+static OCStackResult SendSingleResponse(OCEntityHandlerResponse * ehResponse,
+                                        const uint8_t *encodedPayload,
+                                        size_t encodedPayloadSize)
 {
     OCStackResult result = OC_STACK_ERROR;
     CAEndpoint_t responseEndpoint = {.adapter = CA_DEFAULT_ADAPTER};
@@ -493,6 +732,15 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
 
     OCServerRequest *serverRequest = (OCServerRequest *)ehResponse->requestHandle;
 
+    if (serverRequest->notificationFlag &&
+        !AcceptObserverNotification(serverRequest->requestToken, serverRequest->tokenLength,
+                                    ehResponse->payload))
+    {
+        // Dropped by the observe policy, which is not an error
+        FindAndDeleteServerRequest(serverRequest);
+        return OC_STACK_OK;
+    }
+
     CopyDevAddrToEndpoint(&serverRequest->devAddr, &responseEndpoint);
 
     responseInfo.info.resourceUri = serverRequest->resourceUrl;
@@ -594,9 +842,9 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
     responseInfo.info.payloadFormat = CA_FORMAT_UNDEFINED;
 
     // Put the JSON prefix and suffix around the payload
-    if(ehResponse->payload)
+    if(ehResponse->payload || encodedPayload)
     {
-        if (ehResponse->payload->type == PAYLOAD_TYPE_PRESENCE)
+        if (ehResponse->payload && ehResponse->payload->type == PAYLOAD_TYPE_PRESENCE)
         {
             responseInfo.isMulticast = true;
         }
@@ -610,7 +858,13 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
             case OC_FORMAT_UNDEFINED:
                 // No preference set by the client, so default to CBOR then
             case OC_FORMAT_CBOR:
-                if((result = OCConvertPayload(ehResponse->payload, &responseInfo.info.payload,
+                if (encodedPayload)
+                {
+                    // The encoded body belongs to the caller, it is not freed below.
+                    responseInfo.info.payload = (CAPayload_t)encodedPayload;
+                    responseInfo.info.payloadSize = encodedPayloadSize;
+                }
+                else if((result = OCConvertPayload(ehResponse->payload, &responseInfo.info.payload,
                                 &responseInfo.info.payloadSize))
                         != OC_STACK_OK)
                 {
@@ -690,13 +944,38 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
     result = OCSendResponse(&responseEndpoint, &responseInfo);
 #endif
 
-    OICFree(responseInfo.info.payload);
+    if (serverRequest->notificationFlag && result == OC_STACK_OK)
+    {
+        ObserverNotificationSent(serverRequest->requestToken, serverRequest->tokenLength,
+                                 ehResponse->payload);
+    }
+
+    if (!encodedPayload)
+    {
+        OICFree(responseInfo.info.payload);
+    }
     OICFree(responseInfo.info.options);
     //Delete the request
     FindAndDeleteServerRequest(serverRequest);
     return result;
 }
 
+OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
+{
+    return SendSingleResponse(ehResponse, NULL, 0);
+}
+
+OCStackResult HandleSingleEncodedResponse(OCEntityHandlerResponse * ehResponse,
+                                          const uint8_t *encodedPayload,
+                                          size_t encodedPayloadSize)
+{
+    if (!encodedPayload || !encodedPayloadSize)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+    return SendSingleResponse(ehResponse, encodedPayload, encodedPayloadSize);
+}
+
 /**
  * Handler function for sending a response from multiple resources, such as a collection.
  * Aggregates responses from multiple resource until all responses are received then sends the
@@ -752,8 +1031,14 @@ OCStackResult HandleAggregateResponse(OCEntityHandlerResponse * ehResponse)
         }
         else
         {
-            OCRepPayloadAppend((OCRepPayload*)serverResponse->payload,
-                    (OCRepPayload*)ehResponse->payload);
+            serverResponse->lastPayload->next = (OCRepPayload*)ehResponse->payload;
+        }
+
+        // Keep the tail, so that appending a fragment does not walk the whole list.
+        serverResponse->lastPayload = (OCRepPayload*)ehResponse->payload;
+        while(serverResponse->lastPayload->next)
+        {
+            serverResponse->lastPayload = serverResponse->lastPayload->next;
         }
 
 
@@ -778,3 +1063,36 @@ exit:
     return stackRet;
 }
 
+void HandleAggregateResponseTimeout()
+{
+    OCServerRequest *serverRequest = NULL;
+    OCServerRequest *tmp = NULL;
+    uint32_t now = GetTicks(0);
+
+    LL_FOREACH_SAFE(serverRequestList, serverRequest, tmp)
+    {
+        if (serverRequest->ehResponseHandler != HandleAggregateResponse ||
+            !serverRequest->aggregateDeadline || now < serverRequest->aggregateDeadline)
+        {
+            continue;
+        }
+
+        OC_LOG_V(INFO, TAG, "%u response fragment(s) timed out, sending partial response",
+                serverRequest->numResponses);
+
+        OCServerResponse *serverResponse = GetServerResponseUsingHandle(serverRequest);
+
+        OCEntityHandlerResponse ehResponse = {0};
+        ehResponse.ehResult = OC_EH_OK;
+        ehResponse.requestHandle = (OCRequestHandle) serverRequest;
+        ehResponse.payload = serverResponse ? serverResponse->payload : NULL;
+
+        if (HandleSingleResponse(&ehResponse) != OC_STACK_OK)
+        {
+            OC_LOG(ERROR, TAG, "Error sending partial response");
+        }
+        FindAndDeleteServerRequest(serverRequest);
+        FindAndDeleteServerResponse(serverResponse);
+    }
+}
+
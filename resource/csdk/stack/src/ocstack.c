@@ -280,15 +280,6 @@ static OCStackResult verifyUriQueryLength(const char * inputUri,
  */
 static CAResult_t OCSelectNetwork();
 
-/**
- * Get the CoAP ticks after the specified number of milli-seconds.
- *
- * @param afterMilliSeconds Milli-seconds.
- * @return
- *     CoAP ticks
- */
-static uint32_t GetTicks(uint32_t afterMilliSeconds);
-
 /**
  * Convert CAResponseResult_t to OCStackResult.
  *
@@ -752,10 +743,21 @@ static OCStackResult ResetPresenceTTL(ClientCB *cbNode, uint32_t maxAgeSeconds)
         OC_LOG_V(DEBUG, TAG, "timeOut entry  %d", cbNode->presence->timeOut[index]);
     }
 
+    // The presence times out at the end of the TTL, after the last check
+    if (cbNode->presence->TTL < UINT32_MAX/MILLISECONDS_PER_SECOND)
+    {
+        cbNode->presence->timeOut[PresenceTimeOutSize] =
+                GetTicks(cbNode->presence->TTL * MILLISECONDS_PER_SECOND);
+    }
+    else
+    {
+        cbNode->presence->timeOut[PresenceTimeOutSize] = GetTicks(UINT32_MAX);
+    }
+
     cbNode->presence->TTLlevel = 0;
 
     OC_LOG_V(DEBUG, TAG, "this TTL level %d", cbNode->presence->TTLlevel);
-    return OC_STACK_OK;
+    return SchedulePresenceCB(cbNode, cbNode->presence->timeOut[0]);
 }
 
 const char *convertTriggerEnumToString(OCPresenceTrigger trigger)
@@ -940,6 +942,7 @@ OCStackResult HandlePresenceResponse(const CAEndpoint_t *endpoint,
             response.result = OC_STACK_PRESENCE_STOPPED;
             if(cbNode->presence)
             {
+                UnschedulePresenceCB(cbNode);
                 OICFree(cbNode->presence->timeOut);
                 OICFree(cbNode->presence);
                 cbNode->presence = NULL;
@@ -959,19 +962,25 @@ OCStackResult HandlePresenceResponse(const CAEndpoint_t *endpoint,
                 }
 
                 VERIFY_NON_NULL_V(cbNode->presence);
+                cbNode->presence->heapIndex = PRESENCE_NOT_SCHEDULED;
                 cbNode->presence->timeOut = NULL;
+                // One deadline per check, then the end of the TTL
                 cbNode->presence->timeOut = (uint32_t *)
-                        OICMalloc(PresenceTimeOutSize * sizeof(uint32_t));
+                        OICMalloc((PresenceTimeOutSize + 1) * sizeof(uint32_t));
                 if(!(cbNode->presence->timeOut)){
                     OC_LOG(ERROR, TAG,
                                   "Could not allocate memory for cbNode->presence->timeOut");
                     OICFree(cbNode->presence);
+                    cbNode->presence = NULL;
                     result = OC_STACK_NO_MEMORY;
                     goto exit;
                 }
             }
 
-            ResetPresenceTTL(cbNode, maxAge);
+            if (ResetPresenceTTL(cbNode, maxAge) != OC_STACK_OK)
+            {
+                OC_LOG(ERROR, TAG, "Could not schedule the presence check");
+            }
 
             cbNode->sequenceNumber = response.sequenceNumber;
 
@@ -1218,7 +1227,7 @@ void HandleCAResponses(const CAEndpoint_t* endPoint, const CAResponseInfo_t* res
                     return;
                 }
 
-                if(OC_STACK_OK != OCParsePayload(&response.payload,
+                if(OC_STACK_OK != OCParseScopedPayload(&response.payload,
                             type,
                             responseInfo->info.payload,
                             responseInfo->info.payloadSize))
@@ -1990,11 +1999,14 @@ OCStackResult OCStop()
 
     // Free memory dynamically allocated for resources
     deleteAllResources();
+    FlushDiscoveryCache();
     DeleteDeviceInfo();
     DeletePlatformInfo();
     CATerminate();
     // Remove all observers
     DeleteObserverList();
+    // Remove the server requests not answered yet
+    DeleteServerRequestList();
     // Remove all the client callbacks
     DeleteClientCBList();
 
@@ -2304,21 +2316,22 @@ static OCStackResult OCPreparePresence(CAEndpoint_t *endpoint,
 }
 
 /**
- * Discover or Perform requests on a specified resource
+ * Discover or Perform requests on a specified resource.
+ * The request body is either converted from payload or copied from encodedPayload.
  */
-OCStackResult OCDoResource(OCDoHandle *handle,
-                            OCMethod method,
-                            const char *requestUri,
-                            const OCDevAddr *destination,
-                            OCPayload* payload,
-                            OCConnectivityType connectivityType,
-                            OCQualityOfService qos,
-                            OCCallbackData *cbData,
-                            OCHeaderOption *options,
-                            uint8_t numOptions)
+static OCStackResult OCDoRequest(OCDoHandle *handle,
+                                 OCMethod method,
+                                 const char *requestUri,
+                                 const OCDevAddr *destination,
+                                 OCPayload* payload,
+                                 const uint8_t *encodedPayload,
+                                 size_t encodedPayloadSize,
+                                 OCConnectivityType connectivityType,
+                                 OCQualityOfService qos,
+                                 OCCallbackData *cbData,
+                                 OCHeaderOption *options,
+                                 uint8_t numOptions)
 {
-    OC_LOG(INFO, TAG, "Entering OCDoResource");
-
     // Validate input parameters
     VERIFY_NON_NULL(cbData, FATAL, OC_STACK_INVALID_CALLBACK);
     VERIFY_NON_NULL(cbData->cb, FATAL, OC_STACK_INVALID_CALLBACK);
@@ -2480,6 +2493,18 @@ OCStackResult OCDoResource(OCDoHandle *handle,
         }
         requestInfo.info.payloadFormat = CA_FORMAT_APPLICATION_CBOR;
     }
+    else if(encodedPayload && encodedPayloadSize)
+    {
+        requestInfo.info.payload = (CAPayload_t) OICMalloc(encodedPayloadSize);
+        if (!requestInfo.info.payload)
+        {
+            result = OC_STACK_NO_MEMORY;
+            goto exit;
+        }
+        memcpy(requestInfo.info.payload, encodedPayload, encodedPayloadSize);
+        requestInfo.info.payloadSize = encodedPayloadSize;
+        requestInfo.info.payloadFormat = CA_FORMAT_APPLICATION_CBOR;
+    }
     else
     {
         requestInfo.info.payload = NULL;
@@ -2558,6 +2583,42 @@ exit:
     return result;
 }
 
+OCStackResult OCDoResource(OCDoHandle *handle,
+                            OCMethod method,
+                            const char *requestUri,
+                            const OCDevAddr *destination,
+                            OCPayload* payload,
+                            OCConnectivityType connectivityType,
+                            OCQualityOfService qos,
+                            OCCallbackData *cbData,
+                            OCHeaderOption *options,
+                            uint8_t numOptions)
+{
+    OC_LOG(INFO, TAG, "Entering OCDoResource");
+
+    return OCDoRequest(handle, method, requestUri, destination, payload, NULL, 0,
+                       connectivityType, qos, cbData, options, numOptions);
+}
+
+OCStackResult OCDoEncodedResource(OCDoHandle *handle,
+                                  OCMethod method,
+                                  const char *requestUri,
+                                  const OCDevAddr *destination,
+                                  const uint8_t *encodedPayload,
+                                  size_t encodedPayloadSize,
+                                  OCConnectivityType connectivityType,
+                                  OCQualityOfService qos,
+                                  OCCallbackData *cbData,
+                                  OCHeaderOption *options,
+                                  uint8_t numOptions)
+{
+    OC_LOG(INFO, TAG, "Entering OCDoEncodedResource");
+
+    return OCDoRequest(handle, method, requestUri, destination, NULL,
+                       encodedPayload, encodedPayloadSize,
+                       connectivityType, qos, cbData, options, numOptions);
+}
+
 OCStackResult OCCancel(OCDoHandle handle, OCQualityOfService qos, OCHeaderOption * options,
         uint8_t numOptions)
 {
@@ -2692,33 +2753,21 @@ OCStackResult OCProcessPresence()
     ClientCB* cbNode = NULL;
     OCClientResponse clientResponse;
     OCStackApplicationResult cbResult = OC_STACK_DELETE_TRANSACTION;
+    uint32_t now = GetTicks(0);
 
-    LL_FOREACH(cbList, cbNode)
+    // Presence callbacks are ordered by deadline, only the expired ones are visited
+    while ((cbNode = GetExpiredPresenceCB(now)) != NULL)
     {
-        if (OC_REST_PRESENCE != cbNode->method || !cbNode->presence)
-        {
-            continue;
-        }
-
-        uint32_t now = GetTicks(0);
-        OC_LOG_V(DEBUG, TAG, "this TTL level %d",
-                                                cbNode->presence->TTLlevel);
+        OC_LOG_V(DEBUG, TAG, "this TTL level %d", cbNode->presence->TTLlevel);
         OC_LOG_V(DEBUG, TAG, "current ticks %d", now);
 
-        if (cbNode->presence->TTLlevel > PresenceTimeOutSize)
-        {
-            goto exit;
-        }
-
-        if (cbNode->presence->TTLlevel < PresenceTimeOutSize)
-        {
-            OC_LOG_V(DEBUG, TAG, "timeout ticks %d",
-                    cbNode->presence->timeOut[cbNode->presence->TTLlevel]);
-        }
         if (cbNode->presence->TTLlevel >= PresenceTimeOutSize)
         {
             OC_LOG(DEBUG, TAG, "No more timeout ticks");
 
+            // Nothing is due until the server sends its presence again
+            UnschedulePresenceCB(cbNode);
+
             clientResponse.sequenceNumber = 0;
             clientResponse.result = OC_STACK_PRESENCE_TIMEOUT;
             clientResponse.devAddr = *cbNode->devAddr;
@@ -2736,10 +2785,6 @@ OCStackResult OCProcessPresence()
             {
                 FindAndDeleteClientCB(cbNode);
             }
-        }
-
-        if (now < cbNode->presence->timeOut[cbNode->presence->TTLlevel])
-        {
             continue;
         }
 
@@ -2758,6 +2803,7 @@ OCStackResult OCProcessPresence()
         requestInfo.method = CA_GET;
         requestInfo.info = requestData;
 
+        // The callback stays expired when the request fails, it is retried next time
         result = OCSendRequest(&endpoint, &requestInfo);
         if (OC_STACK_OK != result)
         {
@@ -2766,6 +2812,8 @@ OCStackResult OCProcessPresence()
 
         cbNode->presence->TTLlevel++;
         OC_LOG_V(DEBUG, TAG, "moving to TTL level %d", cbNode->presence->TTLlevel);
+
+        SchedulePresenceCB(cbNode, cbNode->presence->timeOut[cbNode->presence->TTLlevel]);
     }
 exit:
     if (result != OC_STACK_OK)
@@ -2783,6 +2831,8 @@ OCStackResult OCProcess()
     OCProcessPresence();
 #endif
     CAHandleRequestResponse();
+    HandleAggregateResponseTimeout();
+    SendPendingObserverNotifications();
 
 #ifdef ROUTING_GATEWAY
     RMProcess();
@@ -3046,7 +3096,6 @@ OCStackResult OCBindResource(
         OCResourceHandle collectionHandle, OCResourceHandle resourceHandle)
 {
     OCResource *resource = NULL;
-    uint8_t i = 0;
 
     OC_LOG(INFO, TAG, "Entering OCBindResource");
 
@@ -3068,37 +3117,55 @@ OCStackResult OCBindResource(
         return OC_STACK_INVALID_PARAM;
     }
 
-    // Look for an open slot to add add the child resource.
-    // If found, add it and return success
-    for (i = 0; i < MAX_CONTAINED_RESOURCES; i++)
+    // One response is needed per member plus one for the collection itself,
+    // so the count of the responses has to fit as well.
+    if (resource->numRsrcResources >= UINT16_MAX - 1)
     {
-        if (!resource->rsrcResources[i])
-        {
-            resource->rsrcResources[i] = (OCResource *) resourceHandle;
-            OC_LOG(INFO, TAG, "resource bound");
+        OC_LOG(ERROR, TAG, "Collection is full");
+        return OC_STACK_ERROR;
+    }
 
-#ifdef WITH_PRESENCE
-            if (presenceResource.handle)
-            {
-                ((OCResource *)presenceResource.handle)->sequenceNum = OCGetRandom();
-                SendPresenceNotification(((OCResource *) resourceHandle)->rsrcType,
-                        OC_PRESENCE_TRIGGER_CHANGE);
-            }
-#endif
-            return OC_STACK_OK;
+    // Grow the membership when all the slots are in use.
+    if (resource->numRsrcResources == resource->rsrcResourcesCapacity)
+    {
+        uint32_t capacity = resource->rsrcResourcesCapacity ?
+                (uint32_t)resource->rsrcResourcesCapacity * 2 : MAX_CONTAINED_RESOURCES;
+        if (capacity > UINT16_MAX - 1)
+        {
+            capacity = UINT16_MAX - 1;
+        }
 
+        OCResource **resources = (OCResource **) OICRealloc(resource->rsrcResources,
+                capacity * sizeof(OCResource *));
+        if (!resources)
+        {
+            OC_LOG(ERROR, TAG, "Unable to grow the collection");
+            return OC_STACK_NO_MEMORY;
         }
+        resource->rsrcResources = resources;
+        resource->rsrcResourcesCapacity = (uint16_t) capacity;
     }
 
-    // Unable to add resourceHandle, so return error
-    return OC_STACK_ERROR;
+    resource->rsrcResources[resource->numRsrcResources++] = (OCResource *) resourceHandle;
+    InvalidateDiscoveryCache();
+    OC_LOG(INFO, TAG, "resource bound");
+
+#ifdef WITH_PRESENCE
+    if (presenceResource.handle)
+    {
+        ((OCResource *)presenceResource.handle)->sequenceNum = OCGetRandom();
+        SendPresenceNotification(((OCResource *) resourceHandle)->rsrcType,
+                OC_PRESENCE_TRIGGER_CHANGE);
+    }
+#endif
+    return OC_STACK_OK;
 }
 
 OCStackResult OCUnBindResource(
         OCResourceHandle collectionHandle, OCResourceHandle resourceHandle)
 {
     OCResource *resource = NULL;
-    uint8_t i = 0;
+    uint16_t i = 0;
 
     OC_LOG(INFO, TAG, "Entering OCUnBindResource");
 
@@ -3120,13 +3187,16 @@ OCStackResult OCUnBindResource(
         return OC_STACK_INVALID_PARAM;
     }
 
-    // Look for an open slot to add add the child resource.
-    // If found, add it and return success
-    for (i = 0; i < MAX_CONTAINED_RESOURCES; i++)
+    // Look for the child resource and close the gap it leaves.
+    // If found, remove it and return success
+    for (i = 0; i < resource->numRsrcResources; i++)
     {
         if (resourceHandle == resource->rsrcResources[i])
         {
-            resource->rsrcResources[i] = (OCResource *) NULL;
+            memmove(&resource->rsrcResources[i], &resource->rsrcResources[i + 1],
+                    (resource->numRsrcResources - i - 1) * sizeof(OCResource *));
+            resource->numRsrcResources--;
+            InvalidateDiscoveryCache();
             OC_LOG(INFO, TAG, "resource unbound");
 
             // Send notification when resource is unbounded successfully.
@@ -3464,13 +3534,8 @@ OCResourceHandle OCGetResourceHandleFromCollection(OCResourceHandle collectionHa
 {
     OCResource *resource = NULL;
 
-    if (index >= MAX_CONTAINED_RESOURCES)
-    {
-        return NULL;
-    }
-
     resource = findResource((OCResource *) collectionHandle);
-    if (!resource)
+    if (!resource || index >= resource->numRsrcResources)
     {
         return NULL;
     }
@@ -3648,6 +3713,53 @@ OCNotifyListOfObservers (OCResourceHandle handle,
             payload, maxAge, qos));
 }
 
+OCStackResult OCSetObservePolicy(OCResourceHandle handle, const OCObservePolicy *policy)
+{
+    VERIFY_NON_NULL(handle, ERROR, OC_STACK_INVALID_PARAM);
+
+    OCResource *resPtr = findResource((OCResource *) handle);
+    if (NULL == resPtr)
+    {
+        return OC_STACK_NO_RESOURCE;
+    }
+    return SetObservePolicy(resPtr, NULL, policy);
+}
+
+OCStackResult OCSetObserverPolicy(OCResourceHandle handle, OCObservationId obsId,
+                                  const OCObservePolicy *policy)
+{
+    VERIFY_NON_NULL(handle, ERROR, OC_STACK_INVALID_PARAM);
+
+    OCResource *resPtr = findResource((OCResource *) handle);
+    if (NULL == resPtr)
+    {
+        return OC_STACK_NO_RESOURCE;
+    }
+    ResourceObserver *observer = GetObserverUsingId(obsId);
+    if (NULL == observer || observer->resource != resPtr)
+    {
+        return OC_STACK_NO_OBSERVERS;
+    }
+    return SetObservePolicy(resPtr, observer, policy);
+}
+
+OCStackResult OCGetObserveStatistics(OCResourceHandle handle, uint32_t *delivered,
+                                     uint32_t *suppressed)
+{
+    VERIFY_NON_NULL(handle, ERROR, OC_STACK_INVALID_PARAM);
+    VERIFY_NON_NULL(delivered, ERROR, OC_STACK_INVALID_PARAM);
+    VERIFY_NON_NULL(suppressed, ERROR, OC_STACK_INVALID_PARAM);
+
+    OCResource *resPtr = findResource((OCResource *) handle);
+    if (NULL == resPtr)
+    {
+        return OC_STACK_NO_RESOURCE;
+    }
+    *delivered = resPtr->notificationsDelivered;
+    *suppressed = resPtr->notificationsSuppressed;
+    return OC_STACK_OK;
+}
+
 OCStackResult OCDoResponse(OCEntityHandlerResponse *ehResponse)
 {
     OCStackResult result = OC_STACK_ERROR;
@@ -3709,6 +3821,7 @@ OCStackResult OCChangeResourceProperty(OCResourceProperty * inputProperty,
     {
         *inputProperty = (OCResourceProperty) (*inputProperty | resourceProperties);
     }
+    InvalidateDiscoveryCache();
     return OC_STACK_OK;
 }
 #endif
@@ -3746,6 +3859,7 @@ OCStackResult initResources()
 
 void insertResource(OCResource *resource)
 {
+    InvalidateDiscoveryCache();
     if (!headResource)
     {
         headResource = resource;
@@ -3819,8 +3933,11 @@ OCStackResult deleteResource(OCResource *resource)
     {
         if (temp == resource)
         {
+            InvalidateDiscoveryCache();
             // Invalidate all Resource Properties.
             resource->resourceProperties = (OCResourceProperty) 0;
+            // The observers must not miss the last notification
+            DeleteObservePolicies(resource);
 #ifdef WITH_PRESENCE
             if(resource != (OCResource *) presenceResource.handle)
             {
@@ -3879,6 +3996,7 @@ void deleteResourceElements(OCResource *resource)
     }
 
     OICFree(resource->uri);
+    OICFree(resource->rsrcResources);
     deleteResourceType(resource->rsrcType);
     deleteResourceInterface(resource->rsrcInterface);
 }
@@ -3919,8 +4037,10 @@ void insertResourceType(OCResource *resource, OCResourceType *resourceType)
     {
         return;
     }
+
+    InvalidateDiscoveryCache();
     // resource type list is empty.
-    else if (!resource->rsrcType)
+    if (!resource->rsrcType)
     {
         resource->rsrcType = resourceType;
     }
@@ -4004,6 +4124,7 @@ void insertResourceInterface(OCResource *resource, OCResourceInterface *newInter
     OCResourceInterface *pointer = NULL;
     OCResourceInterface *previous = NULL;
 
+    InvalidateDiscoveryCache();
     newInterface->next = NULL;
 
     OCResourceInterface **firstInterface = &(resource->rsrcInterface);
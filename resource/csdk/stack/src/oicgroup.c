@@ -26,6 +26,7 @@
 #include "cJSON.h"
 #include "cbor.h"
 #include "ocpayload.h"
+#include "ocpayloadcbor.h"
 #include "oic_malloc.h"
 #include "oic_string.h"
 #include "occollection.h"
@@ -71,6 +72,9 @@
         pointer = NULL; \
     }
 
+#define SCHEDULE_INDEX_SIZE         64
+#define CLIENT_REQUEST_INDEX_SIZE   64
+
 #ifndef WITH_ARDUINO
 pthread_mutex_t lock;
 #endif
@@ -85,165 +89,243 @@ typedef struct scheduledresourceinfo
     OCResource *resource;
     OCActionSet *actionset;
 
-    int timer_id;
-
-    OCServerRequest *ehRequest;
+    /** Address of the request which scheduled the action set. The request is answered
+     *  when scheduling, so it is not kept.*/
+    OCDevAddr devAddr;
 
     time_t time;
+
+    /** Position of the entry in the schedule heap.*/
+    size_t heapIndex;
+
+    /** Next entry in the same bucket of the action set name index.*/
     struct scheduledresourceinfo* next;
 } ScheduledResourceInfo;
 
-ScheduledResourceInfo *scheduleResourceList = NULL;
+/**
+ * Scheduled action sets are kept in a min-heap ordered by their time, so only the
+ * earliest one needs a timer. Recurring entries are moved in the heap instead of
+ * being reallocated on every tick.
+ */
+static ScheduledResourceInfo **scheduleHeap = NULL;
+static size_t scheduleHeapSize = 0;
+static size_t scheduleHeapCapacity = 0;
+static ScheduledResourceInfo *scheduleIndex[SCHEDULE_INDEX_SIZE];
+static int scheduleTimerId = -1;
+static time_t scheduleTimerDeadline = 0;
+
+void DoScheduledGroupAction();
+
+static void LockSchedule()
+{
+#ifndef WITH_ARDUINO
+    pthread_mutex_lock(&lock);
+#endif
+}
 
-void AddScheduledResource(ScheduledResourceInfo **head,
-        ScheduledResourceInfo* add)
+static void UnlockSchedule()
 {
-    OC_LOG(INFO, TAG, "AddScheduledResource Entering...");
+#ifndef WITH_ARDUINO
+    pthread_mutex_unlock(&lock);
+#endif
+}
 
+static time_t GetCurrentScheduleTime()
+{
+    time_t t_now;
 #ifndef WITH_ARDUINO
-    pthread_mutex_lock(&lock);
+    time(&t_now);
+#else
+    t_now = now();
 #endif
-    ScheduledResourceInfo *tmp = NULL;
+    return t_now;
+}
 
-    if (*head != NULL)
+static size_t HashActionSetName(const char *name)
+{
+    size_t hash = 5381;
+    while (name && *name)
     {
-        tmp = *head;
+        hash = ((hash << 5) + hash) + (unsigned char) *name++;
+    }
+    return hash % SCHEDULE_INDEX_SIZE;
+}
+
+static void SetScheduledResourceAt(size_t index, ScheduledResourceInfo *info)
+{
+    scheduleHeap[index] = info;
+    info->heapIndex = index;
+}
+
+static void SiftUpScheduledResource(size_t index)
+{
+    ScheduledResourceInfo *info = scheduleHeap[index];
 
-        while (tmp->next)
+    while (index > 0)
+    {
+        size_t parent = (index - 1) / 2;
+        if (timespec_diff(scheduleHeap[parent]->time, info->time) <= 0)
         {
-            tmp = tmp->next;
+            break;
         }
-        tmp->next = add;
+        SetScheduledResourceAt(index, scheduleHeap[parent]);
+        index = parent;
     }
-    else
+    SetScheduledResourceAt(index, info);
+}
+
+static void SiftDownScheduledResource(size_t index)
+{
+    ScheduledResourceInfo *info = scheduleHeap[index];
+
+    while (2 * index + 1 < scheduleHeapSize)
     {
-        *head = add;
+        size_t child = 2 * index + 1;
+        if (child + 1 < scheduleHeapSize &&
+            timespec_diff(scheduleHeap[child + 1]->time, scheduleHeap[child]->time) < 0)
+        {
+            child++;
+        }
+        if (timespec_diff(info->time, scheduleHeap[child]->time) <= 0)
+        {
+            break;
+        }
+        SetScheduledResourceAt(index, scheduleHeap[child]);
+        index = child;
     }
-#ifndef WITH_ARDUINO
-    pthread_mutex_unlock(&lock);
-#endif
+    SetScheduledResourceAt(index, info);
 }
 
-ScheduledResourceInfo* GetScheduledResource(ScheduledResourceInfo *head)
+/**
+ * Register a single timer for the earliest scheduled action set.
+ * Must be called with the schedule locked.
+ */
+static void ArmScheduleTimer()
 {
-    OC_LOG(INFO, TAG, "GetScheduledResource Entering...");
+    if (scheduleTimerId >= 0)
+    {
+        unregisterTimer(scheduleTimerId);
+        scheduleTimerId = -1;
+    }
 
-#ifndef WITH_ARDUINO
-    pthread_mutex_lock(&lock);
-#endif
+    if (scheduleHeapSize == 0)
+    {
+        return;
+    }
 
-    time_t t_now;
+    time_t delay = timespec_diff(scheduleHeap[0]->time, GetCurrentScheduleTime());
+    if (delay < 1)
+    {
+        delay = 1;
+    }
 
-    ScheduledResourceInfo *tmp = NULL;
-    tmp = head;
+    scheduleTimerDeadline = registerTimer(delay, &scheduleTimerId, &DoScheduledGroupAction);
+    if (scheduleTimerDeadline == -1)
+    {
+        OC_LOG(ERROR, TAG, "Failed to register timer for scheduled action set.");
+        scheduleTimerId = -1;
+    }
+}
 
-#ifndef WITH_ARDUINO
-    time(&t_now);
-#else
-    t_now = now();
-#endif
+/**
+ * Must be called with the schedule locked.
+ */
+static void DetachScheduledResource(ScheduledResourceInfo *del)
+{
+    size_t index = del->heapIndex;
 
-    if (tmp)
+    scheduleHeapSize--;
+    if (index != scheduleHeapSize)
     {
-        while (tmp)
-        {
-            time_t diffTm = 0;
-#ifndef WITH_ARDUINO
-            diffTm = timespec_diff(tmp->time, t_now);
-#else
-            diffTm = timespec_diff(tmp->time, t_now);
-#endif
+        ScheduledResourceInfo *last = scheduleHeap[scheduleHeapSize];
 
-            if (diffTm <= (time_t) 0)
-            {
-                OC_LOG(INFO, TAG, "return Call INFO.");
-                goto exit;
-            }
-
-            tmp = tmp->next;
+        SetScheduledResourceAt(index, last);
+        SiftUpScheduledResource(index);
+        if (scheduleHeap[index] == last)
+        {
+            SiftDownScheduledResource(index);
         }
     }
 
-    exit:
-#ifndef WITH_ARDUINO
-    pthread_mutex_unlock(&lock);
-#endif
-    if (tmp == NULL)
+    ScheduledResourceInfo **bucket =
+            &scheduleIndex[HashActionSetName(del->actionset->actionsetName)];
+    while (*bucket && *bucket != del)
     {
-        OC_LOG(INFO, TAG, "Cannot Find Call Info.");
+        bucket = &(*bucket)->next;
+    }
+    if (*bucket)
+    {
+        *bucket = del->next;
     }
-    return tmp;
 }
 
-ScheduledResourceInfo* GetScheduledResourceByActionSetName(ScheduledResourceInfo *head, char *setName)
+OCStackResult AddScheduledResource(ScheduledResourceInfo* add)
 {
-    OC_LOG(INFO, TAG, "GetScheduledResourceByActionSetName Entering...");
+    OC_LOG(INFO, TAG, "AddScheduledResource Entering...");
 
-#ifndef WITH_ARDUINO
-    pthread_mutex_lock(&lock);
-#endif
-    ScheduledResourceInfo *tmp = NULL;
-    tmp = head;
+    OCStackResult result = OC_STACK_OK;
 
-    if (tmp)
+    LockSchedule();
+    if (scheduleHeapSize == scheduleHeapCapacity)
     {
-        while (tmp)
+        size_t capacity = scheduleHeapCapacity ? scheduleHeapCapacity * 2 : 8;
+        ScheduledResourceInfo **heap = (ScheduledResourceInfo **) OICRealloc(scheduleHeap,
+                capacity * sizeof(ScheduledResourceInfo *));
+        if (!heap)
         {
-            if (strcmp(tmp->actionset->actionsetName, setName) == 0)
-            {
-                OC_LOG(INFO, TAG, "return Call INFO.");
-                goto exit;
-            }
-            tmp = tmp->next;
+            result = OC_STACK_NO_MEMORY;
+            goto exit;
         }
+        scheduleHeap = heap;
+        scheduleHeapCapacity = capacity;
     }
 
-exit:
-#ifndef WITH_ARDUINO
-    pthread_mutex_unlock(&lock);
-#endif
-    if (tmp == NULL)
+    SetScheduledResourceAt(scheduleHeapSize++, add);
+    SiftUpScheduledResource(add->heapIndex);
+
+    size_t bucket = HashActionSetName(add->actionset->actionsetName);
+    add->next = scheduleIndex[bucket];
+    scheduleIndex[bucket] = add;
+
+    if (add->heapIndex == 0)
     {
-        OC_LOG(INFO, TAG, "Cannot Find Call Info.");
+        ArmScheduleTimer();
     }
-    return tmp;
+
+exit:
+    UnlockSchedule();
+    return result;
 }
 
-void RemoveScheduledResource(ScheduledResourceInfo **head,
-        ScheduledResourceInfo* del)
+OCStackResult RemoveScheduledResource(const char *setName)
 {
-#ifndef WITH_ARDUINO
-    pthread_mutex_lock(&lock);
-#endif
     OC_LOG(INFO, TAG, "RemoveScheduledResource Entering...");
-    ScheduledResourceInfo *tmp = NULL;
 
-    if (del == NULL)
+    LockSchedule();
+    ScheduledResourceInfo *del = scheduleIndex[HashActionSetName(setName)];
+
+    while (del && strcmp(del->actionset->actionsetName, setName) != 0)
     {
-        return;
+        del = del->next;
     }
 
-    if (*head == del)
+    if (del == NULL)
     {
-        *head = (*head)->next;
+        UnlockSchedule();
+        OC_LOG(INFO, TAG, "Cannot Find Call Info.");
+        return OC_STACK_ERROR;
     }
-    else
+
+    bool wasEarliest = (del->heapIndex == 0);
+    DetachScheduledResource(del);
+    if (wasEarliest)
     {
-        tmp = *head;
-        while (tmp->next && (tmp->next != del))
-        {
-            tmp = tmp->next;
-        }
-        if (tmp->next)
-        {
-            tmp->next = del->next;
-        }
+        ArmScheduleTimer();
     }
+    UnlockSchedule();
 
     OCFREE(del)
-#ifndef WITH_ARDUINO
-    pthread_mutex_unlock(&lock);
-#endif
+    return OC_STACK_OK;
 }
 
 typedef struct aggregatehandleinfo
@@ -255,74 +337,49 @@ typedef struct aggregatehandleinfo
     struct aggregatehandleinfo *next;
 } ClientRequestInfo;
 
-ClientRequestInfo *clientRequstList = NULL;
+/**
+ * Outstanding action requests indexed by their handle, so that a response is
+ * matched to its request without scanning every outstanding request.
+ */
+static ClientRequestInfo *clientRequestIndex[CLIENT_REQUEST_INDEX_SIZE];
 
-void AddClientRequestInfo(ClientRequestInfo **head, ClientRequestInfo* add)
+static size_t HashClientRequestHandle(OCDoHandle handle)
 {
-    ClientRequestInfo *tmp = NULL;
+    return ((uintptr_t) handle >> 4) % CLIENT_REQUEST_INDEX_SIZE;
+}
 
-    if (*head != NULL)
-    {
-        tmp = *head;
+void AddClientRequestInfo(ClientRequestInfo* add)
+{
+    size_t bucket = HashClientRequestHandle(add->required);
 
-        while (tmp->next)
-        {
-            tmp = tmp->next;
-        }
-        tmp->next = add;
-    }
-    else
-    {
-        *head = add;
-    }
+    add->next = clientRequestIndex[bucket];
+    clientRequestIndex[bucket] = add;
 }
 
-ClientRequestInfo* GetClientRequestInfo(ClientRequestInfo *head,
-        OCDoHandle handle)
+ClientRequestInfo* GetClientRequestInfo(OCDoHandle handle)
 {
-    ClientRequestInfo *tmp = NULL;
-
-    tmp = head;
+    ClientRequestInfo *tmp = clientRequestIndex[HashClientRequestHandle(handle)];
 
-    if (tmp)
+    while (tmp && tmp->required != handle)
     {
-        while (tmp)
-        {
-            if (tmp->required == handle)
-            {
-                break;
-            }
-
-            tmp = tmp->next;
-        }
-
-        return tmp;
+        tmp = tmp->next;
     }
-    return NULL;
+    return tmp;
 }
 
-void RemoveClientRequestInfo(ClientRequestInfo **head, ClientRequestInfo* del)
+void RemoveClientRequestInfo(ClientRequestInfo* del)
 {
-    ClientRequestInfo *tmp = NULL;
-
     if (del == NULL)
         return;
 
-    if (*head == del)
+    ClientRequestInfo **bucket = &clientRequestIndex[HashClientRequestHandle(del->required)];
+    while (*bucket && *bucket != del)
     {
-        *head = (*head)->next;
+        bucket = &(*bucket)->next;
     }
-    else
+    if (*bucket)
     {
-        tmp = *head;
-        while (tmp->next && (tmp->next != del))
-        {
-            tmp = tmp->next;
-        }
-        if (tmp->next)
-        {
-            tmp->next = del->next;
-        }
+        *bucket = del->next;
     }
 }
 
@@ -418,6 +475,7 @@ void DeleteAction(OCAction** action)
         DeleteCapability(pDel);
     }
     OCFREE((*action)->resourceUri)
+    OCFREE((*action)->encodedPayload)
     (*action)->next = NULL;
     OCFREE(*action)
 }
@@ -637,8 +695,7 @@ OCStackResult BuildActionSetFromString(OCActionSet **set, char* actiondesc)
 
     char *iterToken = NULL, *iterTokenPtr = NULL;
     char *descIterToken = NULL, *descIterTokenPtr = NULL;
-    char *attrIterToken = NULL, *attrIterTokenPtr = NULL;
-    char *desc = NULL, *attr = NULL;
+    char *attrIterTokenPtr = NULL;
     char *key = NULL, *value = NULL;
 
     OCAction *action = NULL;
@@ -646,17 +703,22 @@ OCStackResult BuildActionSetFromString(OCActionSet **set, char* actiondesc)
 
     OC_LOG(INFO, TAG, "Build ActionSet Instance.");
 
-    *set = (OCActionSet*) OICMalloc(sizeof(OCActionSet));
+    if (!set || !actiondesc)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    *set = (OCActionSet*) OICCalloc(1, sizeof(OCActionSet));
     VARIFY_POINTER_NULL(*set, result, exit)
 
+    // The description is tokenized in place; only the strings kept by the
+    // action set are copied out of it.
     iterToken = (char *) strtok_r(actiondesc, ACTION_DELIMITER, &iterTokenPtr);
+    VARIFY_PARAM_NULL(iterToken, result, exit)
 
     // ActionSet Name
-    memset(*set, 0, sizeof(OCActionSet));
-    (*set)->actionsetName = (char *) OICMalloc(strlen(iterToken) + 1);
+    (*set)->actionsetName = OICStrdup(iterToken);
     VARIFY_POINTER_NULL((*set)->actionsetName, result, exit)
-    VARIFY_PARAM_NULL(iterToken, result, exit)
-    strncpy((*set)->actionsetName, iterToken, strlen(iterToken) + 1);
 
     // Time info. for Scheduled/Recursive Group action.
     // d is meant Day of the week.
@@ -668,6 +730,7 @@ OCStackResult BuildActionSetFromString(OCActionSet **set, char* actiondesc)
     if( 2 != sscanf(iterToken, "%ld %u", &(*set)->timesteps, &(*set)->type) )
     {
         // If the return value should be 2, the number of items in the argument. Otherwise, it fails.
+        result = OC_STACK_INVALID_PARAM;
         goto exit;
     }
 #endif
@@ -677,34 +740,14 @@ OCStackResult BuildActionSetFromString(OCActionSet **set, char* actiondesc)
     iterToken = (char *) strtok_r(NULL, ACTION_DELIMITER, &iterTokenPtr);
     while (iterToken)
     {
-        desc = (char *) OICMalloc(strlen(iterToken) + 1);
-        VARIFY_POINTER_NULL(desc, result, exit)
-        VARIFY_PARAM_NULL(desc, result, exit)
-        strncpy(desc, iterToken, strlen(iterToken) + 1);
-        descIterToken = (char *) strtok_r(desc, ATTR_DELIMITER,
+        descIterToken = (char *) strtok_r(iterToken, ATTR_DELIMITER,
                 &descIterTokenPtr);
         while (descIterToken)
         {
-            attr = (char *) OICMalloc(strlen(descIterToken) + 1);
-            VARIFY_POINTER_NULL(attr, result, exit)
-            VARIFY_PARAM_NULL(descIterToken, result, exit)
-            strncpy(attr, descIterToken, strlen(descIterToken) + 1);
-
-            attrIterToken = (char *) strtok_r(attr, ATTR_ASSIGN,
-                    &attrIterTokenPtr);
-            VARIFY_POINTER_NULL(attrIterToken, result, exit);
-
-            key = (char *) OICMalloc(strlen(attrIterToken) + 1);
-            VARIFY_POINTER_NULL(key, result, exit)
-            VARIFY_PARAM_NULL(attrIterToken, result, exit)
-            strncpy(key, attrIterToken, strlen(attrIterToken) + 1);
-
-            attrIterToken = (char *) strtok_r(NULL, ATTR_ASSIGN,
-                    &attrIterTokenPtr);
-            value = (char *) OICMalloc(strlen(attrIterToken) + 1);
-            VARIFY_POINTER_NULL(value, result, exit)
-            VARIFY_PARAM_NULL(attrIterToken, result, exit)
-            strncpy(value, attrIterToken, strlen(attrIterToken) + 1);
+            key = (char *) strtok_r(descIterToken, ATTR_ASSIGN, &attrIterTokenPtr);
+            VARIFY_PARAM_NULL(key, result, exit)
+            value = (char *) strtok_r(NULL, ATTR_ASSIGN, &attrIterTokenPtr);
+            VARIFY_PARAM_NULL(value, result, exit)
 
             if (strcmp(key, "uri") == 0)
             {
@@ -712,70 +755,71 @@ OCStackResult BuildActionSetFromString(OCActionSet **set, char* actiondesc)
 
                 if(action)
                 {
-                    OICFree(action->resourceUri);
-                    OICFree(action);
+                    DeleteAction(&action);
                 }
-                action = (OCAction*) OICMalloc(sizeof(OCAction));
+                action = (OCAction*) OICCalloc(1, sizeof(OCAction));
                 VARIFY_POINTER_NULL(action, result, exit)
-                memset(action, 0, sizeof(OCAction));
-                action->resourceUri = (char *) OICMalloc(strlen(value) + 1);
+                action->resourceUri = OICStrdup(value);
                 VARIFY_POINTER_NULL(action->resourceUri, result, exit)
-                VARIFY_PARAM_NULL(value, result, exit)
-                strncpy(action->resourceUri, value, strlen(value) + 1);
             }
             else
             {
-                if ((key != NULL) && (value != NULL))
-                {
-                    OC_LOG(INFO, TAG, "Build OCCapability Instance.");
+                OC_LOG(INFO, TAG, "Build OCCapability Instance.");
 
-                    capa = (OCCapability*) OICMalloc(sizeof(OCCapability));
-                    VARIFY_POINTER_NULL(capa, result, exit)
-                    memset(capa, 0, sizeof(OCCapability));
+                VARIFY_PARAM_NULL(action, result, exit)
 
-                    capa->capability = (char *) OICMalloc(strlen(key) + 1);
-                    VARIFY_POINTER_NULL(capa->capability, result, exit)
-                    VARIFY_PARAM_NULL(key, result, exit)
-                    strncpy(capa->capability, key, strlen(key) + 1);
+                capa = (OCCapability*) OICCalloc(1, sizeof(OCCapability));
+                VARIFY_POINTER_NULL(capa, result, exit)
+                capa->capability = OICStrdup(key);
+                VARIFY_POINTER_NULL(capa->capability, result, exit)
+                capa->status = OICStrdup(value);
+                VARIFY_POINTER_NULL(capa->status, result, exit)
 
-                    capa->status = (char *) OICMalloc(strlen(value) + 1);
-                    VARIFY_POINTER_NULL(capa->status, result, exit)
-                    VARIFY_PARAM_NULL(value, result, exit)
-                    strncpy(capa->status, value, strlen(value) + 1);
-
-                    VARIFY_POINTER_NULL(action, result, exit)
-
-                    AddCapability(&action->head, capa);
-                }
+                AddCapability(&action->head, capa);
+                capa = NULL;
             }
 
-            OCFREE(key)
-            OCFREE(value)
-            OCFREE(attr)
-
             descIterToken = (char *) strtok_r(NULL, ATTR_DELIMITER,
                     &descIterTokenPtr);
         }
 
+        VARIFY_PARAM_NULL(action, result, exit)
+
+        // Encode the request body once, so executing the action set only replays it.
+        result = CompileAction(action);
+        if (result != OC_STACK_OK)
+        {
+            goto exit;
+        }
+
         AddAction(&(*set)->head, action);
+        action = NULL;
+
         iterToken = (char *) strtok_r(NULL, ACTION_DELIMITER, &iterTokenPtr);
-        OCFREE(desc);
     }
 
     return OC_STACK_OK;
 exit:
-    OCFREE(attr)
-    OCFREE(desc)
-    OCFREE(capa)
-    OCFREE(action)
-    OCFREE(*set)
-    OCFREE(key)
-    OCFREE(value)
-    OCFREE(attr)
+    if (capa)
+    {
+        DeleteCapability(capa);
+    }
+    if (action)
+    {
+        DeleteAction(&action);
+    }
+    DeleteActionSet(set);
 
     return result;
 }
 
+static char *AppendActionString(char *dest, const char *src)
+{
+    size_t length = strlen(src);
+    memcpy(dest, src, length);
+    return dest + length;
+}
+
 OCStackResult BuildStringFromActionSet(OCActionSet* actionset, char** desc)
 {
     // Can't use the macros here as they are hardcoded to 'exit' and will
@@ -784,83 +828,58 @@ OCStackResult BuildStringFromActionSet(OCActionSet* actionset, char** desc)
     {
         return OC_STACK_INVALID_PARAM;
     }
-    char temp[1024] = { 0 };
-    size_t remaining = sizeof(temp) - 1;
     OCStackResult res = OC_STACK_ERROR;
+    OCAction *action = NULL;
+    OCCapability *capas = NULL;
 
-    OCAction *action = actionset->head;
-
-    if (remaining >= strlen(actionset->actionsetName) + 1)
-    {
-        strcat(temp, actionset->actionsetName);
-        remaining -= strlen(actionset->actionsetName);
-        strcat(temp, ACTION_DELIMITER);
-        remaining--;
-    }
-    else
-    {
-        res = OC_STACK_ERROR;
-        goto exit;
-    }
-
-    while (action != NULL)
+    // Size the description first, so action sets of any size fit.
+    size_t length = strlen(actionset->actionsetName) + strlen(ACTION_DELIMITER);
+    for (action = actionset->head; action != NULL; action = action->next)
     {
-        if (remaining < (strlen("uri=") + strlen(action->resourceUri) + 1))
+        length += strlen("uri=") + strlen(action->resourceUri) + strlen(ATTR_DELIMITER);
+        for (capas = action->head; capas != NULL; capas = capas->next)
         {
-            res = OC_STACK_ERROR;
-            goto exit;
-        }
-        strcat(temp, "uri=");
-        remaining -= strlen("uri=");
-        strcat(temp, action->resourceUri);
-        remaining -= strlen(action->resourceUri);
-        strcat(temp, "|");
-        remaining--;
-
-        OCCapability *capas = action->head;
-        while (capas != NULL)
-        {
-            if (remaining < (strlen(capas->capability)
-                             + 1 + strlen(capas->status)))
+            length += strlen(capas->capability) + strlen(ATTR_ASSIGN) + strlen(capas->status);
+            if (capas->next != NULL)
             {
-                res = OC_STACK_ERROR;
-                goto exit;
+                length += strlen(ATTR_DELIMITER);
             }
+        }
+        if (action->next != NULL)
+        {
+            length += strlen(ACTION_DELIMITER);
+        }
+    }
+
+    *desc = (char *) OICMalloc(length + 1);
+    VARIFY_POINTER_NULL(*desc, res, exit);
 
-            strcat(temp, capas->capability);
-            remaining -= strlen(capas->capability);
-            strcat(temp, "=");
-            remaining--;
-            strcat(temp, capas->status);
-            remaining -= strlen(capas->status);
+    char *text = AppendActionString(*desc, actionset->actionsetName);
+    text = AppendActionString(text, ACTION_DELIMITER);
 
-            capas = capas->next;
-            if (capas != NULL)
+    for (action = actionset->head; action != NULL; action = action->next)
+    {
+        text = AppendActionString(text, "uri=");
+        text = AppendActionString(text, action->resourceUri);
+        text = AppendActionString(text, ATTR_DELIMITER);
+
+        for (capas = action->head; capas != NULL; capas = capas->next)
+        {
+            text = AppendActionString(text, capas->capability);
+            text = AppendActionString(text, ATTR_ASSIGN);
+            text = AppendActionString(text, capas->status);
+            if (capas->next != NULL)
             {
-                if (remaining < 1)
-                {
-                    res = OC_STACK_ERROR;
-                    goto exit;
-                }
-                strcat(temp, "|");
+                text = AppendActionString(text, ATTR_DELIMITER);
             }
         }
 
-        action = action->next;
-        if (action != NULL)
+        if (action->next != NULL)
         {
-            if (remaining < strlen(ACTION_DELIMITER))
-            {
-                res = OC_STACK_ERROR;
-                goto exit;
-            }
-            strcat(temp, ACTION_DELIMITER);
-            remaining--;
+            text = AppendActionString(text, ACTION_DELIMITER);
         }
     }
-
-    *desc = OICStrdup(temp);
-    VARIFY_POINTER_NULL(*desc, res, exit);
+    *text = '\0';
 
     return OC_STACK_OK;
 
@@ -876,10 +895,20 @@ OCStackApplicationResult ActionSetCB(void* context, OCDoHandle handle,
     (void)clientResponse;
     OC_LOG(INFO, TAG, "Entering ActionSetCB");
 
-    ClientRequestInfo *info = GetClientRequestInfo(clientRequstList, handle);
+    LockSchedule();
+    ClientRequestInfo *info = GetClientRequestInfo(handle);
+    RemoveClientRequestInfo(info);
+    UnlockSchedule();
 
     if (info)
     {
+        // The responses to a scheduled action set are not aggregated for any request.
+        if (NULL == info->ehRequest)
+        {
+            OCFREE(info)
+            return OC_STACK_DELETE_TRANSACTION;
+        }
+
         OCEntityHandlerResponse response = { 0 };
 
         response.ehResult = OC_EH_OK;
@@ -887,6 +916,7 @@ OCStackApplicationResult ActionSetCB(void* context, OCDoHandle handle,
         if(NULL == clientResponse->payload)
         {
             OC_LOG(ERROR, TAG, "Error sending response");
+            OCFREE(info)
             return OC_STACK_DELETE_TRANSACTION;
         }
 
@@ -901,15 +931,14 @@ OCStackApplicationResult ActionSetCB(void* context, OCDoHandle handle,
         // Indicate that response is NOT in a persistent buffer
         response.persistentBufferFlag = 0;
 
+        OCFREE(info)
+
         // Send the response
         if (OCDoResponse(&response) != OC_STACK_OK)
         {
             OC_LOG(ERROR, TAG, "Error sending response");
-            return OC_STACK_DELETE_TRANSACTION;
         }
-
-        RemoveClientRequestInfo(&clientRequstList, info);
-        OCFREE(info)
+        return OC_STACK_DELETE_TRANSACTION;
     }
 
     return OC_STACK_KEEP_TRANSACTION;
@@ -980,6 +1009,37 @@ OCPayload* BuildActionCBOR(OCAction* action)
     return (OCPayload*) payload;
 }
 
+OCStackResult CompileAction(OCAction* action)
+{
+    if (!action)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    OCPayload *payload = BuildActionCBOR(action);
+    if (!payload)
+    {
+        return OC_STACK_NO_MEMORY;
+    }
+
+    uint8_t *encoded = NULL;
+    size_t encodedSize = 0;
+    OCStackResult result = OCConvertPayload(payload, &encoded, &encodedSize);
+    OCPayloadDestroy(payload);
+
+    if (result != OC_STACK_OK)
+    {
+        OC_LOG_V(ERROR, TAG, "Failed to encode action for %s", action->resourceUri);
+        return result;
+    }
+
+    OICFree(action->encodedPayload);
+    action->encodedPayload = encoded;
+    action->encodedPayloadSize = encodedSize;
+
+    return OC_STACK_OK;
+}
+
 unsigned int GetNumOfTargetResource(OCAction *actionset)
 {
     int numOfResource = 0;
@@ -995,8 +1055,7 @@ unsigned int GetNumOfTargetResource(OCAction *actionset)
     return numOfResource;
 }
 
-OCStackResult SendAction(OCDoHandle *handle, OCServerRequest* requestHandle, const char *targetUri,
-        OCPayload *payload)
+OCStackResult SendAction(OCDoHandle *handle, const OCDevAddr *devAddr, OCAction *action)
 {
 
     OCCallbackData cbData;
@@ -1004,138 +1063,140 @@ OCStackResult SendAction(OCDoHandle *handle, OCServerRequest* requestHandle, con
     cbData.context = (void*)DEFAULT_CONTEXT_VALUE;
     cbData.cd = NULL;
 
-    return OCDoResource(handle, OC_REST_PUT, targetUri, &requestHandle->devAddr,
-                       payload, CT_ADAPTER_IP, OC_NA_QOS, &cbData, NULL, 0);
+    return OCDoEncodedResource(handle, OC_REST_PUT, action->resourceUri,
+                               devAddr,
+                               action->encodedPayload, action->encodedPayloadSize,
+                               CT_ADAPTER_IP, OC_NA_QOS, &cbData, NULL, 0);
 }
 
+/**
+ * Sends every target of the action set its PUT.
+ *
+ * @param requestHandle       Request the responses of the targets are aggregated for,
+ *                            NULL if no request waits for them.
+ * @param numOfFailedTarget   Number of targets which could not be sent their PUT and
+ *                            will not respond.
+ */
 OCStackResult DoAction(OCResource* resource, OCActionSet* actionset,
-        OCServerRequest* requestHandle)
+        const OCDevAddr *devAddr, OCServerRequest* requestHandle,
+        unsigned int *numOfFailedTarget)
 {
-    OCStackResult result = OC_STACK_ERROR;
+    *numOfFailedTarget = 0;
 
     if( NULL == actionset->head)
     {
-        return result;
+        return OC_STACK_ERROR;
     }
 
+    // Every target is sent its PUT before any response is handled; responses are
+    // matched to their request through the client request index as they arrive.
     OCAction *pointerAction = actionset->head;
 
-    while (pointerAction != NULL)
+    for (; pointerAction != NULL; pointerAction = pointerAction->next)
     {
-        OCPayload* payload;
-        payload = BuildActionCBOR(pointerAction);
-
-        if(payload == NULL)
+        if (!pointerAction->encodedPayload && CompileAction(pointerAction) != OC_STACK_OK)
         {
-            return result;
+            (*numOfFailedTarget)++;
+            continue;
         }
 
-        ClientRequestInfo *info = (ClientRequestInfo *) OICMalloc(
+        ClientRequestInfo *info = (ClientRequestInfo *) OICCalloc(1,
                 sizeof(ClientRequestInfo));
 
         if( info == NULL )
         {
-            OCFREE(payload);
-            return OC_STACK_NO_MEMORY;
+            (*numOfFailedTarget)++;
+            continue;
         }
 
-        memset(info, 0, sizeof(ClientRequestInfo));
-
         info->collResource = resource;
         info->ehRequest = requestHandle;
 
-        result = SendAction(&info->required, info->ehRequest, pointerAction->resourceUri,
-                payload);
+        // The response can not be matched before the request is indexed.
+        LockSchedule();
+        OCStackResult ret = SendAction(&info->required, devAddr, pointerAction);
+        if (ret == OC_STACK_OK)
+        {
+            AddClientRequestInfo(info);
+        }
+        UnlockSchedule();
 
-        if (result != OC_STACK_OK)
+        if (ret != OC_STACK_OK)
         {
+            OC_LOG_V(ERROR, TAG, "Failed to send action to %s", pointerAction->resourceUri);
             OICFree(info);
-            return result;
+            (*numOfFailedTarget)++;
         }
-
-        AddClientRequestInfo(&clientRequstList, info);
-
-        pointerAction = pointerAction->next;
     }
 
-    return result;
+    return *numOfFailedTarget ? OC_STACK_ERROR : OC_STACK_OK;
 }
 
 void DoScheduledGroupAction()
 {
     OC_LOG(INFO, TAG, "DoScheduledGroupAction Entering...");
-    ScheduledResourceInfo* info = GetScheduledResource(scheduleResourceList);
 
-    if (info == NULL)
-    {
-        OC_LOG(INFO, TAG, "Target resource is NULL");
-        goto exit;
-    }
-    else if (info->resource == NULL)
+    // The timer which called this function is not registered any longer. A timer
+    // armed by AddScheduledResource in the meantime is not due yet and is kept.
+    LockSchedule();
+    if (scheduleTimerId >= 0
+            && timespec_diff(scheduleTimerDeadline, GetCurrentScheduleTime()) <= 0)
     {
-        OC_LOG(INFO, TAG, "Target resource is NULL");
-        goto exit;
-    }
-    else if (info->actionset == NULL)
-    {
-        OC_LOG(INFO, TAG, "Target ActionSet is NULL");
-        goto exit;
+        scheduleTimerId = -1;
     }
-    else if (info->ehRequest == NULL)
-    {
-        OC_LOG(INFO, TAG, "Target ActionSet is NULL");
-        goto exit;
-    }
-#ifndef WITH_ARDUINO
-    pthread_mutex_lock(&lock);
-#endif
-    DoAction(info->resource, info->actionset, info->ehRequest);
-#ifndef WITH_ARDUINO
-    pthread_mutex_unlock(&lock);
-#endif
+    UnlockSchedule();
 
-    if (info->actionset->type == RECURSIVE)
+    for (;;)
     {
-        ScheduledResourceInfo *schedule;
-        schedule = (ScheduledResourceInfo *) OICMalloc(
-                sizeof(ScheduledResourceInfo));
+        ScheduledResourceInfo info = { 0 };
 
-        if (schedule)
+        LockSchedule();
+        time_t t_now = GetCurrentScheduleTime();
+        if (scheduleHeapSize == 0 || timespec_diff(scheduleHeap[0]->time, t_now) > 0)
         {
-            OC_LOG(INFO, TAG, "Building New Call Info.");
-            memset(schedule, 0, sizeof(ScheduledResourceInfo));
-
-            if (info->actionset->timesteps > 0)
-            {
-#ifndef WITH_ARDUINO
-                pthread_mutex_lock(&lock);
-#endif
-                schedule->resource = info->resource;
-                schedule->actionset = info->actionset;
-                schedule->ehRequest = info->ehRequest;
+            ArmScheduleTimer();
+            UnlockSchedule();
+            break;
+        }
 
-                schedule->time = registerTimer(info->actionset->timesteps,
-                        &schedule->timer_id,
-                        &DoScheduledGroupAction);
+        ScheduledResourceInfo *scheduled = scheduleHeap[0];
+        info = *scheduled;
 
-                OC_LOG(INFO, TAG, "Reregisteration.");
-#ifndef WITH_ARDUINO
-                pthread_mutex_unlock(&lock);
-#endif
-                AddScheduledResource(&scheduleResourceList, schedule);
-            }
-            else
+        if (scheduled->actionset && scheduled->actionset->type == RECURSIVE
+                && scheduled->actionset->timesteps > 0)
+        {
+            // Keep the entry and move it to its next time.
+            timespec_add(&scheduled->time, scheduled->actionset->timesteps);
+            if (timespec_diff(scheduled->time, t_now) <= 0)
             {
-                OICFree(schedule);
+                scheduled->time = t_now;
+                timespec_add(&scheduled->time, scheduled->actionset->timesteps);
             }
+            SiftDownScheduledResource(0);
+            OC_LOG(INFO, TAG, "Reregisteration.");
         }
-    }
-
-    RemoveScheduledResource(&scheduleResourceList, info);
-
-    exit:
+        else
+        {
+            DetachScheduledResource(scheduled);
+            OCFREE(scheduled)
+        }
+        UnlockSchedule();
 
-    return;
+        if (info.resource == NULL)
+        {
+            OC_LOG(INFO, TAG, "Target resource is NULL");
+        }
+        else if (info.actionset == NULL)
+        {
+            OC_LOG(INFO, TAG, "Target ActionSet is NULL");
+        }
+        else
+        {
+            // Nothing waits for the responses, the request was answered when scheduling.
+            unsigned int numOfFailedTarget = 0;
+            DoAction(info.resource, info.actionset, &info.devAddr, NULL, &numOfFailedTarget);
+        }
+    }
 }
 
 OCStackResult BuildCollectionGroupActionCBORResponse(
@@ -1290,17 +1351,25 @@ OCStackResult BuildCollectionGroupActionCBORResponse(
                     {
                         OC_LOG_V(INFO, TAG, "Execute ActionSet : %s",
                                 actionset->actionsetName);
+                        OCServerRequest *request =
+                                (OCServerRequest *) ehRequest->requestHandle;
                         unsigned int num = GetNumOfTargetResource(
                                 actionset->head);
+                        unsigned int numOfFailedTarget = 0;
 
-                        ((OCServerRequest *) ehRequest->requestHandle)->ehResponseHandler =
-                                HandleAggregateResponse;
-                        ((OCServerRequest *) ehRequest->requestHandle)->numResponses =
-                                num + 1;
+                        request->ehResponseHandler = HandleAggregateResponse;
+                        request->numResponses = num + 1;
+                        request->aggregateDeadline =
+                                GetTicks(MAX_CONTAINED_RESOURCE_RESPONSE_TIME);
 
-                        DoAction(resource, actionset,
-                                (OCServerRequest*) ehRequest->requestHandle);
-                        stackRet = OC_STACK_OK;
+                        DoAction(resource, actionset, &request->devAddr, request,
+                                &numOfFailedTarget);
+
+                        // Targets which could not be reached will not respond, so do not
+                        // wait for them. If none was reached, the response of the group
+                        // below fails the request at once.
+                        request->numResponses -= numOfFailedTarget;
+                        stackRet = (numOfFailedTarget < num) ? OC_STACK_OK : OC_STACK_ERROR;
                     }
                     else
                     {
@@ -1322,24 +1391,26 @@ OCStackResult BuildCollectionGroupActionCBORResponse(
 
                             schedule->resource = resource;
                             schedule->actionset = actionset;
-                            schedule->ehRequest =
-                                    (OCServerRequest*) ehRequest->requestHandle;
+                            schedule->devAddr =
+                                    ((OCServerRequest*) ehRequest->requestHandle)->devAddr;
 
                             if (delay > 0)
                             {
-                                OC_LOG_V(INFO, TAG, "delay_time is %lf seconds.",
-                                        actionset->timesteps);
+                                OC_LOG_V(INFO, TAG, "delay_time is %ld seconds.",
+                                        delay);
 
-                                schedule->time = registerTimer(delay,
-                                        &schedule->timer_id,
-                                        &DoScheduledGroupAction);
+                                schedule->time = GetCurrentScheduleTime();
+                                timespec_add(&schedule->time, delay);
 
-                                AddScheduledResource(&scheduleResourceList,
-                                        schedule);
-                                stackRet = OC_STACK_OK;
+                                stackRet = AddScheduledResource(schedule);
+                                if (stackRet != OC_STACK_OK)
+                                {
+                                    OICFree(schedule);
+                                }
                             }
                             else
                             {
+                                OICFree(schedule);
                                 stackRet = OC_STACK_ERROR;
                             }
                         }
@@ -1349,20 +1420,7 @@ OCStackResult BuildCollectionGroupActionCBORResponse(
         }
         else if (strcmp(doWhat, "CancelAction") == 0)
         {
-            ScheduledResourceInfo *info =
-                    GetScheduledResourceByActionSetName(scheduleResourceList, details);
-
-            if(info != NULL)
-            {
-                unregisterTimer(info->timer_id);
-
-                RemoveScheduledResource(&scheduleResourceList, info);
-                stackRet = OC_STACK_OK;
-            }
-            else
-            {
-                stackRet = OC_STACK_ERROR;
-            }
+            stackRet = RemoveScheduledResource(details);
         }
 
         else if (strcmp(doWhat, GET_ACTIONSET) == 0)
@@ -23,6 +23,12 @@ extern "C"
 {
     #include "ocstack.h"
     #include "ocstackinternal.h"
+    #include "ocpayload.h"
+    #include "ocpayloadcbor.h"
+    #include "ocpayloadarena.h"
+    #include "ocserverrequest.h"
+    #include "ocobserve.h"
+    #include "oicgroup.h"
     #include "logger.h"
     #include "oic_malloc.h"
 }
@@ -43,6 +49,8 @@ extern "C"
 
 #include <iostream>
 #include <stdint.h>
+#include <string>
+#include <vector>
 
 #include "gtest_helper.h"
 
@@ -64,6 +72,8 @@ char gManufacturerUrl[] = "www.foooooooooooooooo.baaaaaaaaaaaaar";
 
 std::chrono::seconds const SHORT_TEST_TIMEOUT = std::chrono::seconds(5);
 
+const int NUM_SCENE_ACTIVATIONS = 20;
+
 //-----------------------------------------------------------------------------
 // Callback functions
 //-----------------------------------------------------------------------------
@@ -105,6 +115,17 @@ void InitStack(OCMode mode)
     OC_LOG(INFO, TAG, "Leaving InitStack");
 }
 
+std::vector<char> BuildActionSetDescription(const char *actionSetName, int numTargets)
+{
+    std::string desc = std::string(actionSetName) + "*0 0";
+    for (int i = 0; i < numTargets; i++)
+    {
+        desc += "*uri=coap://192.168.0.1:5683/a/light" + std::to_string(i)
+                + "|power=on|brightness=80";
+    }
+    return std::vector<char>(desc.c_str(), desc.c_str() + desc.size() + 1);
+}
+
 uint8_t InitNumExpectedResources()
 {
 #ifdef WITH_PRESENCE
@@ -1280,15 +1301,65 @@ TEST(StackBind, BindContainedResourceGood)
     EXPECT_EQ(OC_STACK_OK, OCBindResource(containerHandle, handle2));
     EXPECT_EQ(OC_STACK_OK, OCBindResource(containerHandle, handle3));
     EXPECT_EQ(OC_STACK_OK, OCBindResource(containerHandle, handle4));
-    EXPECT_EQ(OC_STACK_ERROR, OCBindResource(containerHandle, handle5));
+    EXPECT_EQ(OC_STACK_OK, OCBindResource(containerHandle, handle5));
 
     EXPECT_EQ(handle0, OCGetResourceHandleFromCollection(containerHandle, 0));
     EXPECT_EQ(handle1, OCGetResourceHandleFromCollection(containerHandle, 1));
     EXPECT_EQ(handle2, OCGetResourceHandleFromCollection(containerHandle, 2));
     EXPECT_EQ(handle3, OCGetResourceHandleFromCollection(containerHandle, 3));
     EXPECT_EQ(handle4, OCGetResourceHandleFromCollection(containerHandle, 4));
+    EXPECT_EQ(handle5, OCGetResourceHandleFromCollection(containerHandle, 5));
+
+    EXPECT_EQ(NULL, OCGetResourceHandleFromCollection(containerHandle, 6));
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackBind, BindManyContainedResourcesAndUnBindOne)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    OC_LOG(INFO, TAG, "Starting BindManyContainedResourcesAndUnBindOne test");
+    InitStack(OC_SERVER);
+
+    const int numContainedResources = 3 * MAX_CONTAINED_RESOURCES;
+    char uri[MAX_URI_LENGTH] = { 0 };
+
+    OCResourceHandle containerHandle;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&containerHandle,
+                                            "core.led",
+                                            "core.rw",
+                                            "/a/floor",
+                                            0,
+                                            NULL,
+                                            OC_DISCOVERABLE|OC_OBSERVABLE));
 
-    EXPECT_EQ(NULL, OCGetResourceHandleFromCollection(containerHandle, 5));
+    OCResourceHandle handles[numContainedResources];
+    for (int i = 0; i < numContainedResources; i++)
+    {
+        snprintf(uri, sizeof(uri), "/a/room%d", i);
+        EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handles[i],
+                                                "core.led",
+                                                "core.rw",
+                                                uri,
+                                                0,
+                                                NULL,
+                                                OC_DISCOVERABLE|OC_OBSERVABLE));
+        EXPECT_EQ(OC_STACK_OK, OCBindResource(containerHandle, handles[i]));
+    }
+
+    for (int i = 0; i < numContainedResources; i++)
+    {
+        EXPECT_EQ(handles[i], OCGetResourceHandleFromCollection(containerHandle, i));
+    }
+
+    EXPECT_EQ(OC_STACK_OK, OCUnBindResource(containerHandle, handles[1]));
+    EXPECT_EQ(OC_STACK_ERROR, OCUnBindResource(containerHandle, handles[1]));
+
+    EXPECT_EQ(handles[0], OCGetResourceHandleFromCollection(containerHandle, 0));
+    EXPECT_EQ(handles[2], OCGetResourceHandleFromCollection(containerHandle, 1));
+    EXPECT_EQ(handles[numContainedResources - 1],
+              OCGetResourceHandleFromCollection(containerHandle, numContainedResources - 2));
+    EXPECT_EQ(NULL, OCGetResourceHandleFromCollection(containerHandle, numContainedResources - 1));
 
     EXPECT_EQ(OC_STACK_OK, OCStop());
 }
@@ -1624,6 +1695,1016 @@ TEST(StackResourceAccess, DeleteMiddleResource)
     EXPECT_EQ(OC_STACK_OK, OCStop());
 }
 
+TEST(StackDiscoveryCache, GetStatisticsBad)
+{
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCGetDiscoveryCacheStatistics(NULL, &misses));
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCGetDiscoveryCacheStatistics(&hits, NULL));
+}
+
+static OCStackResult SendTestDiscoveryRequest(uint32_t id)
+{
+    OCServerProtocolRequest request = {};
+    request.method = OC_REST_GET;
+    request.acceptFormat = OC_FORMAT_CBOR;
+    request.qos = OC_LOW_QOS;
+    strcpy(request.resourceUrl, OC_RSRVD_WELL_KNOWN_URI);
+    request.requestToken = (CAToken_t)&id;
+    request.tokenLength = sizeof(id);
+    request.devAddr.adapter = OC_ADAPTER_IP;
+    request.devAddr.flags = OC_IP_USE_V4;
+    strcpy(request.devAddr.addr, "127.0.0.1");
+    request.devAddr.port = 5683;
+
+    return HandleStackRequests(&request);
+}
+
+TEST(StackDiscoveryCache, RepeatedDiscoveryAnsweredFromCache)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    OCResourceHandle handle;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle,
+                                            "core.led",
+                                            "core.rw",
+                                            "/a/led",
+                                            0,
+                                            NULL,
+                                            OC_DISCOVERABLE|OC_OBSERVABLE));
+
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    EXPECT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStatistics(&hits, &misses));
+
+    EXPECT_EQ(OC_STACK_OK, SendTestDiscoveryRequest(1));
+    EXPECT_EQ(OC_STACK_OK, SendTestDiscoveryRequest(2));
+
+    uint32_t newHits = 0;
+    uint32_t newMisses = 0;
+    EXPECT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStatistics(&newHits, &newMisses));
+    EXPECT_EQ(hits + 1, newHits);
+    EXPECT_EQ(misses + 1, newMisses);
+
+    // A changed resource is not answered from the cache
+    EXPECT_EQ(OC_STACK_OK, OCBindResourceTypeToResource(handle, "core.brightled"));
+    EXPECT_EQ(OC_STACK_OK, SendTestDiscoveryRequest(3));
+
+    EXPECT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStatistics(&newHits, &newMisses));
+    EXPECT_EQ(hits + 1, newHits);
+    EXPECT_EQ(misses + 2, newMisses);
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+static int gPresenceTimeouts = 0;
+
+extern "C" OCStackApplicationResult presenceTimeoutCallback(void* /*ctx*/,
+        OCDoHandle /*handle*/, OCClientResponse * clientResponse)
+{
+    EXPECT_EQ(OC_STACK_PRESENCE_TIMEOUT, clientResponse->result);
+    gPresenceTimeouts++;
+    return OC_STACK_KEEP_TRANSACTION;
+}
+
+static ClientCB *AddTestClientCB(OCMethod method, int index)
+{
+    OCCallbackData cbData = { NULL, presenceTimeoutCallback, NULL };
+    CAToken_t token = (CAToken_t)OICCalloc(1, sizeof(int));
+    OCDoHandle handle = OICMalloc(1);
+    OCDevAddr *devAddr = (OCDevAddr *)OICCalloc(1, sizeof(OCDevAddr));
+    std::string uri = "/a/presence" + std::to_string(index);
+    char *requestUri = (char *)OICMalloc(uri.size() + 1);
+    if (!token || !handle || !devAddr || !requestUri)
+    {
+        return NULL;
+    }
+    memcpy(token, &index, sizeof(int));
+    strcpy(requestUri, uri.c_str());
+
+    ClientCB *cbNode = NULL;
+    EXPECT_EQ(OC_STACK_OK, AddClientCB(&cbNode, &cbData, token, sizeof(int), &handle,
+                                       method, devAddr, requestUri, NULL, 0));
+    return cbNode;
+}
+
+static void SetTestPresence(ClientCB *cbNode, uint32_t TTLlevel, uint32_t deadline)
+{
+    if (!cbNode->presence)
+    {
+        cbNode->presence = (OCPresence *)OICCalloc(1, sizeof(OCPresence));
+        ASSERT_TRUE(cbNode->presence != NULL);
+        cbNode->presence->heapIndex = PRESENCE_NOT_SCHEDULED;
+    }
+    cbNode->presence->TTLlevel = TTLlevel;
+    EXPECT_EQ(OC_STACK_OK, SchedulePresenceCB(cbNode, deadline));
+}
+
+TEST(StackPresence, OnlyExpiredSubscriptionsTimeOut)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_CLIENT);
+
+    // Past the last check, a subscription times out once its deadline passes
+    const uint32_t lastLevel = 1000;
+    ClientCB *expired = AddTestClientCB(OC_REST_PRESENCE, 0);
+    ClientCB *pending = AddTestClientCB(OC_REST_PRESENCE, 1);
+    ClientCB *removed = AddTestClientCB(OC_REST_PRESENCE, 2);
+    ASSERT_TRUE(expired && pending && removed);
+    SetTestPresence(expired, lastLevel, 0);
+    SetTestPresence(pending, lastLevel, GetTicks(60 * 60 * 1000));
+    SetTestPresence(removed, lastLevel, 0);
+    FindAndDeleteClientCB(removed);
+
+    gPresenceTimeouts = 0;
+    EXPECT_EQ(OC_STACK_OK, OCProcessPresence());
+    EXPECT_EQ(1, gPresenceTimeouts);
+
+    // The timed out subscription waits for the server to send its presence again
+    EXPECT_EQ(OC_STACK_OK, OCProcessPresence());
+    EXPECT_EQ(1, gPresenceTimeouts);
+    EXPECT_EQ(PRESENCE_NOT_SCHEDULED, expired->presence->heapIndex);
+
+    // Moving the deadline reorders the schedule
+    SetTestPresence(pending, lastLevel, 0);
+    EXPECT_EQ(OC_STACK_OK, OCProcessPresence());
+    EXPECT_EQ(2, gPresenceTimeouts);
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackPresence, PresenceStormCostPerCallbackCount)
+{
+    const int callbackCounts[] = { 100, 1000, 10000 };
+    const int numSubscriptions = 100;
+    const int numRounds = 1000;
+    const uint32_t lastLevel = 1000;
+
+    for (int numCallbacks : callbackCounts)
+    {
+        InitStack(OC_CLIENT);
+
+        std::vector<ClientCB *> subscriptions;
+        for (int i = 0; i < numCallbacks; i++)
+        {
+            ClientCB *cbNode = AddTestClientCB(i < numSubscriptions ? OC_REST_PRESENCE
+                                                                    : OC_REST_GET, i);
+            ASSERT_TRUE(cbNode != NULL);
+            if (i < numSubscriptions)
+            {
+                SetTestPresence(cbNode, lastLevel,
+                                GetTicks(60 * 60 * 1000));
+                subscriptions.push_back(cbNode);
+            }
+        }
+
+        // OCProcess rounds where no presence deadline has passed.
+        gPresenceTimeouts = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < numRounds; i++)
+        {
+            OCProcessPresence();
+        }
+        auto idle = std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(0, gPresenceTimeouts);
+
+        // Every subscription times out at once.
+        for (ClientCB *cbNode : subscriptions)
+        {
+            SetTestPresence(cbNode, lastLevel, 0);
+        }
+        start = std::chrono::steady_clock::now();
+        OCProcessPresence();
+        auto storm = std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(numSubscriptions, gPresenceTimeouts);
+
+        ::testing::Test::RecordProperty("IdleRoundNanosecondsFor" + std::to_string(numCallbacks)
+                + "Callbacks", (int)(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                idle).count() / numRounds));
+        ::testing::Test::RecordProperty("TimeoutMicrosecondsFor" + std::to_string(numCallbacks)
+                + "Callbacks", (int)std::chrono::duration_cast<std::chrono::microseconds>(
+                storm).count());
+
+        EXPECT_EQ(OC_STACK_OK, OCStop());
+    }
+}
+
+static OCServerRequest *AddTestServerRequest(uint32_t id, uint8_t tokenLength,
+                                             size_t payloadSize = 0)
+{
+    OCDevAddr devAddr = {};
+    char token[CA_MAX_TOKEN_LEN] = {};
+    memcpy(token, &id, sizeof(id));
+    std::vector<uint8_t> payload(payloadSize, 0xA5);
+    char resourceUrl[] = "/a/slow";
+
+    OCServerRequest *request = NULL;
+    EXPECT_EQ(OC_STACK_OK, AddServerRequest(&request, 0, 0, 0, OC_REST_GET, 0, 0, OC_HIGH_QOS,
+                                            NULL, NULL, payload.empty() ? NULL : payload.data(),
+                                            token, tokenLength, resourceUrl, payloadSize,
+                                            OC_FORMAT_CBOR, &devAddr));
+    return request;
+}
+
+TEST(StackServerRequest, LookupByTokenAndHandle)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    OCServerRequest *first = AddTestServerRequest(1, sizeof(uint32_t));
+    OCServerRequest *second = AddTestServerRequest(1, sizeof(uint32_t));
+    OCServerRequest *large = AddTestServerRequest(2, sizeof(uint32_t), 4096);
+    ASSERT_TRUE(first && second && large);
+    EXPECT_EQ(0xA5, large->payload[4095]);
+    EXPECT_EQ(4096u, large->payloadSize);
+
+    // Requests sharing a token are found oldest first, and the token length has to match
+    uint32_t id = 1;
+    EXPECT_EQ(first, GetServerRequestUsingToken((CAToken_t)&id, sizeof(id)));
+    EXPECT_EQ(NULL, GetServerRequestUsingToken((CAToken_t)&id, sizeof(id) - 1));
+    id = 2;
+    EXPECT_EQ(large, GetServerRequestUsingToken((CAToken_t)&id, sizeof(id)));
+
+    EXPECT_EQ(second, GetServerRequestUsingHandle(second));
+    FindAndDeleteServerRequest(first);
+    EXPECT_EQ(NULL, GetServerRequestUsingHandle(first));
+    id = 1;
+    EXPECT_EQ(second, GetServerRequestUsingToken((CAToken_t)&id, sizeof(id)));
+
+    // Deleting a request twice does nothing
+    FindAndDeleteServerRequest(second);
+    FindAndDeleteServerRequest(second);
+    EXPECT_EQ(NULL, GetServerRequestUsingToken((CAToken_t)&id, sizeof(id)));
+    EXPECT_EQ(large, GetServerRequestUsingHandle(large));
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackServerRequest, HandedOutHandleNotReused)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    // A deleted request is taken from the pool again
+    OCServerRequest *request = AddTestServerRequest(1, sizeof(uint32_t));
+    ASSERT_TRUE(request != NULL);
+    FindAndDeleteServerRequest(request);
+    OCServerRequest *reused = AddTestServerRequest(2, sizeof(uint32_t));
+    EXPECT_EQ(request, reused);
+
+    // The handle of a slow request does not match a later request
+    reused->slowFlag = 1;
+    FindAndDeleteServerRequest(reused);
+    for (uint32_t i = 3; i < 13; i++)
+    {
+        request = AddTestServerRequest(i, sizeof(i));
+        ASSERT_TRUE(request != NULL);
+        EXPECT_NE(reused, request);
+    }
+    EXPECT_EQ(NULL, GetServerRequestUsingHandle(reused));
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackServerRequest, ConcurrentSlowRequestsCost)
+{
+    const uint32_t numRequests = 10000;
+    InitStack(OC_SERVER);
+
+    // The second round takes its requests from the pool filled by the first one
+    for (int round = 0; round < 2; round++)
+    {
+        std::vector<OCServerRequest *> requests;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < numRequests; i++)
+        {
+            requests.push_back(AddTestServerRequest(i, sizeof(i), 32));
+            ASSERT_TRUE(requests.back() != NULL);
+        }
+        auto adding = std::chrono::steady_clock::now() - start;
+
+        // Slow entity handlers answer with the handle, repeated requests come by token
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < numRequests; i++)
+        {
+            EXPECT_EQ(requests[i], GetServerRequestUsingHandle(requests[i]));
+            EXPECT_EQ(requests[i], GetServerRequestUsingToken((CAToken_t)&i, sizeof(i)));
+        }
+        auto lookup = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < numRequests; i++)
+        {
+            FindAndDeleteServerRequest(requests[numRequests - i - 1]);
+        }
+        auto deleting = std::chrono::steady_clock::now() - start;
+
+        std::string suffix = "MicrosecondsInRound" + std::to_string(round + 1);
+        ::testing::Test::RecordProperty("Add" + suffix,
+                (int)std::chrono::duration_cast<std::chrono::microseconds>(adding).count());
+        ::testing::Test::RecordProperty("LookUp" + suffix,
+                (int)std::chrono::duration_cast<std::chrono::microseconds>(lookup).count());
+        ::testing::Test::RecordProperty("Delete" + suffix,
+                (int)std::chrono::duration_cast<std::chrono::microseconds>(deleting).count());
+    }
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+static int64_t gSensorValue = 0;
+
+extern "C" OCEntityHandlerResult sensorEntityHandler(OCEntityHandlerFlag flag,
+        OCEntityHandlerRequest *entityHandlerRequest, void* /*callbackParam*/)
+{
+    if (!(flag & OC_REQUEST_FLAG))
+    {
+        return OC_EH_OK;
+    }
+
+    OCRepPayload *payload = OCRepPayloadCreate();
+    OCRepPayloadSetPropInt(payload, "value", gSensorValue);
+
+    OCEntityHandlerResponse response = {};
+    response.requestHandle = entityHandlerRequest->requestHandle;
+    response.resourceHandle = entityHandlerRequest->resource;
+    response.ehResult = OC_EH_OK;
+    response.payload = (OCPayload *)payload;
+    OCDoResponse(&response);
+    OCRepPayloadDestroy(payload);
+    return OC_EH_OK;
+}
+
+static OCResourceHandle CreateTestSensor()
+{
+    OCResourceHandle handle = NULL;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.sensor", "core.r",
+                                            "/a/sensor", sensorEntityHandler, NULL,
+                                            OC_DISCOVERABLE | OC_OBSERVABLE));
+    return handle;
+}
+
+static ResourceObserver *AddTestObserver(OCResourceHandle handle, OCObservationId obsId)
+{
+    OCDevAddr devAddr = {};
+    devAddr.adapter = OC_ADAPTER_IP;
+    devAddr.port = 9;
+    strcpy(devAddr.addr, "127.0.0.1");
+    char token[] = { 'o', 'b', 's', (char)obsId };
+
+    EXPECT_EQ(OC_STACK_OK, AddObserver("/a/sensor", NULL, obsId, token, sizeof(token),
+                                       (OCResource *)handle, OC_LOW_QOS, OC_FORMAT_CBOR,
+                                       &devAddr));
+    return GetObserverUsingId(obsId);
+}
+
+TEST(StackObserve, PolicyBadParams)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+    OCResourceHandle handle = CreateTestSensor();
+    OCObservePolicy policy = {};
+    uint32_t delivered = 0;
+    uint32_t suppressed = 0;
+
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCSetObservePolicy(NULL, &policy));
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCGetObserveStatistics(handle, NULL, &suppressed));
+    EXPECT_EQ(OC_STACK_NO_OBSERVERS, OCSetObserverPolicy(handle, 1, &policy));
+
+    EXPECT_EQ(OC_STACK_OK, OCSetObservePolicy(handle, &policy));
+    EXPECT_EQ(OC_STACK_OK, OCSetObservePolicy(handle, NULL));
+    EXPECT_EQ(OC_STACK_OK, OCGetObserveStatistics(handle, &delivered, &suppressed));
+    EXPECT_EQ(0u, delivered);
+    EXPECT_EQ(0u, suppressed);
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackObserve, MinIntervalCoalescesToLatestValue)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+    OCResourceHandle handle = CreateTestSensor();
+    ResourceObserver *observer = AddTestObserver(handle, 1);
+    ASSERT_TRUE(observer != NULL);
+
+    // A threshold of 0 lets every value through but records the last one sent
+    OCObservePolicy policy = {};
+    policy.maxRate = 5;
+    policy.coalesce = true;
+    policy.changeProperty = "value";
+    EXPECT_EQ(OC_STACK_OK, OCSetObservePolicy(handle, &policy));
+
+    // The registration starts the interval, every sample of the burst is withheld
+    for (int i = 0; i < 100; i++)
+    {
+        gSensorValue = i;
+        EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(handle, OC_LOW_QOS));
+    }
+    uint32_t delivered = 0;
+    uint32_t suppressed = 0;
+    EXPECT_EQ(OC_STACK_OK, OCGetObserveStatistics(handle, &delivered, &suppressed));
+    EXPECT_EQ(0u, delivered);
+    EXPECT_EQ(99u, suppressed);
+
+    // Only the latest value is sent once the interval of 200 ms is over
+    usleep(250 * 1000);
+    OCProcess();
+    OCProcess();
+    EXPECT_EQ(OC_STACK_OK, OCGetObserveStatistics(handle, &delivered, &suppressed));
+    EXPECT_EQ(1u, delivered);
+    EXPECT_EQ(99u, suppressed);
+    EXPECT_TRUE(observer->hasLastValue);
+    EXPECT_EQ(99.0, observer->lastValue);
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackObserve, NotificationAfterIntervalDropsWithheldValue)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+    OCResourceHandle handle = CreateTestSensor();
+    ResourceObserver *observer = AddTestObserver(handle, 1);
+    ASSERT_TRUE(observer != NULL);
+
+    OCObservePolicy policy = {};
+    policy.minInterval = 200;
+    policy.coalesce = true;
+    policy.changeProperty = "value";
+    EXPECT_EQ(OC_STACK_OK, OCSetObservePolicy(handle, &policy));
+
+    // Withheld within the interval started by the registration
+    OCObservationId obsId = 1;
+    OCRepPayload *payload = OCRepPayloadCreate();
+    OCRepPayloadSetPropInt(payload, "value", 1);
+    EXPECT_EQ(OC_STACK_OK, OCNotifyListOfObservers(handle, &obsId, 1, payload, OC_LOW_QOS));
+
+    // Sent right away once the interval is over, before OCProcess sends the withheld one
+    observer->lastNotified -= policy.minInterval;
+    OCRepPayloadSetPropInt(payload, "value", 2);
+    EXPECT_EQ(OC_STACK_OK, OCNotifyListOfObservers(handle, &obsId, 1, payload, OC_LOW_QOS));
+    OCRepPayloadDestroy(payload);
+
+    // Nothing withheld is left to be sent once the next interval is over
+    observer->lastNotified -= policy.minInterval;
+    OCProcess();
+    OCProcess();
+
+    uint32_t delivered = 0;
+    uint32_t suppressed = 0;
+    EXPECT_EQ(OC_STACK_OK, OCGetObserveStatistics(handle, &delivered, &suppressed));
+    EXPECT_EQ(1u, delivered);
+    EXPECT_EQ(1u, suppressed);
+    EXPECT_TRUE(observer->hasLastValue);
+    EXPECT_EQ(2.0, observer->lastValue);
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackObserve, ChangeThresholdPerObserver)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+    OCResourceHandle handle = CreateTestSensor();
+    ASSERT_TRUE(AddTestObserver(handle, 1) != NULL);
+    ASSERT_TRUE(AddTestObserver(handle, 2) != NULL);
+
+    // Only the second observer wants changes of 10 or more
+    OCObservePolicy policy = {};
+    policy.changeProperty = "value";
+    policy.changeThreshold = 10;
+    EXPECT_EQ(OC_STACK_OK, OCSetObserverPolicy(handle, 2, &policy));
+
+    for (gSensorValue = 0; gSensorValue <= 30; gSensorValue++)
+    {
+        EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(handle, OC_LOW_QOS));
+    }
+
+    // The first observer gets all 31 values, the second one 0, 10, 20 and 30
+    uint32_t delivered = 0;
+    uint32_t suppressed = 0;
+    EXPECT_EQ(OC_STACK_OK, OCGetObserveStatistics(handle, &delivered, &suppressed));
+    EXPECT_EQ(31u + 4u, delivered);
+    EXPECT_EQ(27u, suppressed);
+
+    // Values given by the application are checked as well
+    OCObservationId obsId = 2;
+    OCRepPayload *payload = OCRepPayloadCreate();
+    OCRepPayloadSetPropInt(payload, "value", 35);
+    EXPECT_EQ(OC_STACK_OK, OCNotifyListOfObservers(handle, &obsId, 1, payload, OC_LOW_QOS));
+    OCRepPayloadSetPropInt(payload, "value", 40);
+    OCNotifyListOfObservers(handle, &obsId, 1, payload, OC_LOW_QOS);
+    OCRepPayloadDestroy(payload);
+    EXPECT_EQ(OC_STACK_OK, OCGetObserveStatistics(handle, &delivered, &suppressed));
+    EXPECT_EQ(36u, delivered);
+    EXPECT_EQ(28u, suppressed);
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackObserve, SensorBurstCostWithAndWithoutPolicy)
+{
+    const int numObservers = 10;
+    const int numSamples = 1000;
+    InitStack(OC_SERVER);
+    OCResourceHandle handle = CreateTestSensor();
+    for (int i = 1; i <= numObservers; i++)
+    {
+        ASSERT_TRUE(AddTestObserver(handle, (OCObservationId)i) != NULL);
+    }
+
+    OCObservePolicy policy = {};
+    policy.minInterval = 100;
+    policy.coalesce = true;
+    for (int round = 0; round < 2; round++)
+    {
+        EXPECT_EQ(OC_STACK_OK, OCSetObservePolicy(handle, round ? &policy : NULL));
+        auto start = std::chrono::steady_clock::now();
+        for (gSensorValue = 0; gSensorValue < numSamples; gSensorValue++)
+        {
+            OCNotifyAllObservers(handle, OC_LOW_QOS);
+            OCProcess();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        uint32_t delivered = 0;
+        uint32_t suppressed = 0;
+        EXPECT_EQ(OC_STACK_OK, OCGetObserveStatistics(handle, &delivered, &suppressed));
+        std::string suffix = round ? "WithPolicy" : "WithoutPolicy";
+        ::testing::Test::RecordProperty("Microseconds" + suffix,
+                (int)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+        ::testing::Test::RecordProperty("Delivered" + suffix, (int)delivered);
+    }
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackGroupAction, BuildActionSetFromStringEncodesEveryAction)
+{
+    std::vector<char> desc = BuildActionSetDescription("scene", 3);
+
+    OCActionSet *actionSet = NULL;
+    ASSERT_EQ(OC_STACK_OK, BuildActionSetFromString(&actionSet, desc.data()));
+    ASSERT_TRUE(actionSet != NULL);
+    EXPECT_STREQ("scene", actionSet->actionsetName);
+
+    int numActions = 0;
+    for (OCAction *action = actionSet->head; action != NULL; action = action->next)
+    {
+        EXPECT_TRUE(action->encodedPayload != NULL);
+        EXPECT_LT(0u, action->encodedPayloadSize);
+        numActions++;
+    }
+    EXPECT_EQ(3, numActions);
+
+    char *str = NULL;
+    EXPECT_EQ(OC_STACK_OK, BuildStringFromActionSet(actionSet, &str));
+    EXPECT_STREQ("scene*uri=coap://192.168.0.1:5683/a/light0|power=on|brightness=80"
+                 "*uri=coap://192.168.0.1:5683/a/light1|power=on|brightness=80"
+                 "*uri=coap://192.168.0.1:5683/a/light2|power=on|brightness=80", str);
+    OICFree(str);
+
+    DeleteActionSet(&actionSet);
+}
+
+TEST(StackGroupAction, BuildActionSetFromStringCapabilityWithoutTarget)
+{
+    char desc[] = "scene*0 0*power=on|uri=/a/light";
+
+    OCActionSet *actionSet = NULL;
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, BuildActionSetFromString(&actionSet, desc));
+    EXPECT_TRUE(actionSet == NULL);
+}
+
+TEST(StackGroupAction, SceneActivationCostPerTargetCount)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_CLIENT_SERVER);
+
+    OCResourceHandle groupHandle = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCCreateResource(&groupHandle, "core.group", "oic.if.baseline",
+                                            "/a/scenes", entityHandler, NULL,
+                                            OC_DISCOVERABLE));
+    OCResource *group = (OCResource *)groupHandle;
+
+    const int targetCounts[] = { 10, 100, 1000 };
+    uint32_t requestId = 0;
+
+    for (int numTargets : targetCounts)
+    {
+        std::string name = "scene" + std::to_string(numTargets);
+        std::vector<char> desc = BuildActionSetDescription(name.c_str(), numTargets);
+        std::string expected(desc.data());
+        expected.erase(name.size(), strlen("*0 0"));
+
+        OCActionSet *actionSet = NULL;
+        ASSERT_EQ(OC_STACK_OK, BuildActionSetFromString(&actionSet, desc.data()));
+        ASSERT_EQ(OC_STACK_OK, AddActionSet(&group->actionsetHead, actionSet));
+
+        // The description of a large action set is not truncated
+        char *str = NULL;
+        EXPECT_EQ(OC_STACK_OK, BuildStringFromActionSet(actionSet, &str));
+        EXPECT_STREQ(expected.c_str(), str);
+        OICFree(str);
+
+        std::vector<const uint8_t *> compiled;
+        for (OCAction *action = actionSet->head; action != NULL; action = action->next)
+        {
+            compiled.push_back(action->encodedPayload);
+        }
+
+        OCRepPayload *doAction = OCRepPayloadCreate();
+        OCRepPayloadSetPropString(doAction, "DoAction", name.c_str());
+
+        std::chrono::steady_clock::duration elapsed(0);
+        for (int i = 0; i < NUM_SCENE_ACTIVATIONS; i++)
+        {
+            OCServerRequest *request = AddTestServerRequest(++requestId, sizeof(requestId));
+            ASSERT_TRUE(request != NULL);
+
+            OCEntityHandlerRequest ehRequest = {};
+            ehRequest.requestHandle = (OCRequestHandle)request;
+            ehRequest.resource = groupHandle;
+            ehRequest.payload = (OCPayload *)doAction;
+            auto start = std::chrono::steady_clock::now();
+            EXPECT_EQ(OC_STACK_OK,
+                      BuildCollectionGroupActionCBORResponse(OC_REST_POST, group, &ehRequest));
+            elapsed += std::chrono::steady_clock::now() - start;
+
+            // Every target was sent its PUT, only the responses of the targets are left
+            EXPECT_EQ(numTargets, (int)request->numResponses);
+
+            // Nothing answers the PUTs, drop their callbacks as their responses would
+            DeleteClientCBList();
+        }
+        OCRepPayloadDestroy(doAction);
+
+        // The activations replayed the request bodies compiled with the action set
+        size_t index = 0;
+        for (OCAction *action = actionSet->head; action != NULL; action = action->next)
+        {
+            EXPECT_EQ(compiled[index++], action->encodedPayload);
+        }
+
+        ::testing::Test::RecordProperty("ActivationMicrosecondsFor" + std::to_string(numTargets)
+                + "Targets", (int)(std::chrono::duration_cast<std::chrono::microseconds>(
+                elapsed).count() / NUM_SCENE_ACTIVATIONS));
+    }
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackGroupAction, UnreachableTargetsAreNotWaitedFor)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_CLIENT_SERVER);
+
+    OCResourceHandle groupHandle = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCCreateResource(&groupHandle, "core.group", "oic.if.baseline",
+                                            "/a/scenes", entityHandler, NULL,
+                                            OC_DISCOVERABLE));
+    OCResource *group = (OCResource *)groupHandle;
+
+    char someDesc[] = "some*0 0*uri=coap://192.168.0.1:5683/a/light|power=on"
+                      "*uri=coap://[::1/a/light|power=on";
+    char noneDesc[] = "none*0 0*uri=coap://[::1/a/light0|power=on"
+                      "*uri=coap://[::1/a/light1|power=on";
+    for (char *desc : { someDesc, noneDesc })
+    {
+        OCActionSet *actionSet = NULL;
+        ASSERT_EQ(OC_STACK_OK, BuildActionSetFromString(&actionSet, desc));
+        ASSERT_EQ(OC_STACK_OK, AddActionSet(&group->actionsetHead, actionSet));
+    }
+
+    OCRepPayload *doAction = OCRepPayloadCreate();
+    OCEntityHandlerRequest ehRequest = {};
+    ehRequest.resource = groupHandle;
+    ehRequest.payload = (OCPayload *)doAction;
+
+    // Only the response of the reachable target is waited for
+    OCServerRequest *request = AddTestServerRequest(1, sizeof(uint32_t));
+    ASSERT_TRUE(request != NULL);
+    ehRequest.requestHandle = (OCRequestHandle)request;
+    OCRepPayloadSetPropString(doAction, "DoAction", "some");
+    EXPECT_EQ(OC_STACK_OK, BuildCollectionGroupActionCBORResponse(OC_REST_POST, group,
+                                                                  &ehRequest));
+    EXPECT_EQ(1u, request->numResponses);
+
+    // Without any reachable target the request is answered at once
+    request = AddTestServerRequest(2, sizeof(uint32_t));
+    ASSERT_TRUE(request != NULL);
+    ehRequest.requestHandle = (OCRequestHandle)request;
+    OCRepPayloadSetPropString(doAction, "DoAction", "none");
+    EXPECT_EQ(OC_STACK_ERROR, BuildCollectionGroupActionCBORResponse(OC_REST_POST, group,
+                                                                     &ehRequest));
+    uint32_t id = 2;
+    EXPECT_EQ(NULL, GetServerRequestUsingToken((CAToken_t)&id, sizeof(id)));
+
+    OCRepPayloadDestroy(doAction);
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackRepPayload, ManyPropertiesKeepInsertionOrder)
+{
+    const int numProperties = 100;
+    OCRepPayload *payload = OCRepPayloadCreate();
+    ASSERT_TRUE(payload != NULL);
+
+    for (int i = 0; i < numProperties; i++)
+    {
+        std::string name = "p" + std::to_string(i);
+        EXPECT_TRUE(OCRepPayloadSetPropInt(payload, name.c_str(), i));
+    }
+    // Replacing a value keeps its place.
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload, "p50", "fifty"));
+
+    int i = 0;
+    for (OCRepPayloadValue *val = payload->values; val != NULL; val = val->next, i++)
+    {
+        EXPECT_EQ("p" + std::to_string(i), val->name);
+    }
+    EXPECT_EQ(numProperties, i);
+
+    int64_t value = 0;
+    EXPECT_TRUE(OCRepPayloadGetPropInt(payload, "p0", &value));
+    EXPECT_EQ(0, value);
+    EXPECT_TRUE(OCRepPayloadGetPropInt(payload, "p99", &value));
+    EXPECT_EQ(99, value);
+    EXPECT_FALSE(OCRepPayloadGetPropInt(payload, "p50", &value));
+    EXPECT_FALSE(OCRepPayloadGetPropInt(payload, "p100", &value));
+
+    char *str = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropString(payload, "p50", &str));
+    EXPECT_STREQ("fifty", str);
+    OICFree(str);
+
+    OCRepPayloadDestroy(payload);
+}
+
+TEST(StackRepPayload, CloneManyProperties)
+{
+    const int numProperties = 100;
+    OCRepPayload *payload = OCRepPayloadCreate();
+    ASSERT_TRUE(payload != NULL);
+
+    for (int i = 0; i < numProperties; i++)
+    {
+        std::string name = "p" + std::to_string(i);
+        EXPECT_TRUE(OCRepPayloadSetPropInt(payload, name.c_str(), i));
+    }
+
+    OCRepPayload *clone = OCRepPayloadClone(payload);
+    OCRepPayloadDestroy(payload);
+    ASSERT_TRUE(clone != NULL);
+
+    EXPECT_TRUE(OCRepPayloadSetPropInt(clone, "p100", 100));
+    for (int i = 0; i <= numProperties; i++)
+    {
+        std::string name = "p" + std::to_string(i);
+        int64_t value = -1;
+        EXPECT_TRUE(OCRepPayloadGetPropInt(clone, name.c_str(), &value));
+        EXPECT_EQ(i, value);
+    }
+
+    OCRepPayloadDestroy(clone);
+}
+
+TEST(StackRepPayload, SetGetCostPerPropertyCount)
+{
+    const int propertyCounts[] = { 10, 100, 1000 };
+
+    for (int numProperties : propertyCounts)
+    {
+        std::vector<std::string> names;
+        for (int i = 0; i < numProperties; i++)
+        {
+            names.push_back("property" + std::to_string(i));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        OCRepPayload *payload = OCRepPayloadCreate();
+        ASSERT_TRUE(payload != NULL);
+        for (int i = 0; i < numProperties; i++)
+        {
+            EXPECT_TRUE(OCRepPayloadSetPropInt(payload, names[i].c_str(), i));
+        }
+        auto building = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < numProperties; i++)
+        {
+            int64_t value = -1;
+            EXPECT_TRUE(OCRepPayloadGetPropInt(payload, names[i].c_str(), &value));
+            EXPECT_EQ(i, value);
+        }
+        auto reading = std::chrono::steady_clock::now() - start;
+
+        ::testing::Test::RecordProperty("BuildMicrosecondsFor" + std::to_string(numProperties)
+                + "Properties", (int)std::chrono::duration_cast<std::chrono::microseconds>(
+                building).count());
+        ::testing::Test::RecordProperty("ReadMicrosecondsFor" + std::to_string(numProperties)
+                + "Properties", (int)std::chrono::duration_cast<std::chrono::microseconds>(
+                reading).count());
+
+        OCRepPayloadDestroy(payload);
+    }
+}
+
+static OCRepPayload *ParseRepPayload(OCRepPayload *payload, bool scoped)
+{
+    uint8_t *data = NULL;
+    size_t size = 0;
+    OCPayload *parsed = NULL;
+    EXPECT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload *)payload, &data, &size));
+    if (scoped)
+    {
+        EXPECT_EQ(OC_STACK_OK, OCParseScopedPayload(&parsed, PAYLOAD_TYPE_REPRESENTATION,
+                    data, size));
+    }
+    else
+    {
+        EXPECT_EQ(OC_STACK_OK, OCParsePayload(&parsed, PAYLOAD_TYPE_REPRESENTATION,
+                    data, size));
+    }
+    OICFree(data);
+    return (OCRepPayload *)parsed;
+}
+
+TEST(StackRepPayload, ScopedParseRoundTrip)
+{
+    OCRepPayload *payload = OCRepPayloadCreate();
+    ASSERT_TRUE(payload != NULL);
+    OCRepPayloadSetUri(payload, "/a/light");
+    OCRepPayloadAddResourceType(payload, "core.light");
+    OCRepPayloadAddInterface(payload, "oic.if.baseline");
+    OCRepPayloadSetPropInt(payload, "power", 42);
+    OCRepPayloadSetPropDouble(payload, "level", 0.5);
+    OCRepPayloadSetPropBool(payload, "state", true);
+    OCRepPayloadSetPropString(payload, "name", "kitchen");
+    OCRepPayload *child = OCRepPayloadCreate();
+    OCRepPayloadSetPropInt(child, "x", 7);
+    OCRepPayloadSetPropObjectAsOwner(payload, "child", child);
+    const char *modes[] = { "auto", "manual", "off" };
+    size_t dimensions[MAX_REP_ARRAY_DEPTH] = { 3, 0, 0 };
+    OCRepPayloadSetStringArray(payload, "modes", modes, dimensions);
+
+    OCRepPayload *parsed = ParseRepPayload(payload, true);
+    OCRepPayloadDestroy(payload);
+    ASSERT_TRUE(parsed != NULL);
+    EXPECT_TRUE(parsed->arena != NULL);
+    EXPECT_TRUE(parsed->ownsArena);
+
+    EXPECT_STREQ("/a/light", parsed->uri);
+    ASSERT_TRUE(parsed->types != NULL);
+    EXPECT_STREQ("core.light", parsed->types->value);
+    ASSERT_TRUE(parsed->interfaces != NULL);
+    EXPECT_STREQ("oic.if.baseline", parsed->interfaces->value);
+
+    int64_t power = 0;
+    EXPECT_TRUE(OCRepPayloadGetPropInt(parsed, "power", &power));
+    EXPECT_EQ(42, power);
+    double level = 0;
+    EXPECT_TRUE(OCRepPayloadGetPropDouble(parsed, "level", &level));
+    EXPECT_EQ(0.5, level);
+    bool state = false;
+    EXPECT_TRUE(OCRepPayloadGetPropBool(parsed, "state", &state));
+    EXPECT_TRUE(state);
+    char *name = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropString(parsed, "name", &name));
+    EXPECT_STREQ("kitchen", name);
+    OICFree(name);
+
+    OCRepPayload *parsedChild = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropObject(parsed, "child", &parsedChild));
+    ASSERT_TRUE(parsedChild != NULL);
+    int64_t x = 0;
+    EXPECT_TRUE(OCRepPayloadGetPropInt(parsedChild, "x", &x));
+    EXPECT_EQ(7, x);
+    // Getters hand out heap copies, whatever the payload is allocated in.
+    EXPECT_TRUE(parsedChild->arena == NULL);
+    OCRepPayloadDestroy(parsedChild);
+
+    char **parsedModes = NULL;
+    size_t parsedDimensions[MAX_REP_ARRAY_DEPTH] = { 0 };
+    EXPECT_TRUE(OCRepPayloadGetStringArray(parsed, "modes", &parsedModes, parsedDimensions));
+    ASSERT_EQ(3u, parsedDimensions[0]);
+    for (size_t i = 0; i < parsedDimensions[0]; i++)
+    {
+        EXPECT_STREQ(modes[i], parsedModes[i]);
+        OICFree(parsedModes[i]);
+    }
+    OICFree(parsedModes);
+
+    OCRepPayloadDestroy(parsed);
+}
+
+TEST(StackRepPayload, ScopedPayloadTakesHeapValues)
+{
+    OCRepPayload *payload = OCRepPayloadCreate();
+    ASSERT_TRUE(payload != NULL);
+    OCRepPayloadSetPropString(payload, "name", "kitchen");
+    OCRepPayloadSetPropInt(payload, "power", 42);
+
+    OCRepPayload *parsed = ParseRepPayload(payload, true);
+    OCRepPayloadDestroy(payload);
+    ASSERT_TRUE(parsed != NULL);
+
+    // Values replaced or added by a handler may come from the heap, the region frees them.
+    char *hall = (char *)OICMalloc(sizeof("hall"));
+    strcpy(hall, "hall");
+    EXPECT_TRUE(OCRepPayloadSetPropStringAsOwner(parsed, "name", hall));
+    OCRepPayload *child = OCRepPayloadCreate();
+    OCRepPayloadSetPropString(child, "label", "lamp");
+    EXPECT_TRUE(OCRepPayloadSetPropObjectAsOwner(parsed, "power", child));
+    int64_t *values = (int64_t *)OICMalloc(2 * sizeof(int64_t));
+    values[0] = 1;
+    values[1] = 2;
+    size_t dimensions[MAX_REP_ARRAY_DEPTH] = { 2, 0, 0 };
+    EXPECT_TRUE(OCRepPayloadSetIntArrayAsOwner(parsed, "values", values, dimensions));
+    EXPECT_TRUE(OCRepPayloadSetUri(parsed, "/a/hall"));
+
+    char *name = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropString(parsed, "name", &name));
+    EXPECT_STREQ("hall", name);
+    OICFree(name);
+    OCRepPayload *parsedChild = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropObject(parsed, "power", &parsedChild));
+    char *label = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropString(parsedChild, "label", &label));
+    EXPECT_STREQ("lamp", label);
+    OICFree(label);
+    OCRepPayloadDestroy(parsedChild);
+    EXPECT_STREQ("/a/hall", parsed->uri);
+
+    OCRepPayloadDestroy(parsed);
+}
+
+TEST(StackRepPayload, ScopedParseCostPerPropertyCount)
+{
+    const int propertyCounts[] = { 10, 100, 1000 };
+    const int iterations = 100;
+
+    for (int numProperties : propertyCounts)
+    {
+        OCRepPayload *payload = OCRepPayloadCreate();
+        ASSERT_TRUE(payload != NULL);
+        for (int i = 0; i < numProperties; i++)
+        {
+            std::string name = "property" + std::to_string(i);
+            if (i % 2)
+            {
+                OCRepPayloadSetPropString(payload, name.c_str(), "value");
+            }
+            else
+            {
+                OCRepPayloadSetPropInt(payload, name.c_str(), i);
+            }
+        }
+        uint8_t *data = NULL;
+        size_t size = 0;
+        ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload *)payload, &data, &size));
+        OCRepPayloadDestroy(payload);
+
+        std::chrono::steady_clock::duration costs[2];
+        OCPayloadArenaStats stats = { 0, 0, 0 };
+        for (int scoped = 0; scoped < 2; scoped++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            for (int j = 0; j < iterations; j++)
+            {
+                OCPayload *parsed = NULL;
+                OCStackResult result = scoped ?
+                    OCParseScopedPayload(&parsed, PAYLOAD_TYPE_REPRESENTATION, data, size) :
+                    OCParsePayload(&parsed, PAYLOAD_TYPE_REPRESENTATION, data, size);
+                EXPECT_EQ(OC_STACK_OK, result);
+                if (scoped && j == 0)
+                {
+                    stats = OCPayloadArenaGetStats(((OCRepPayload *)parsed)->arena);
+                }
+                OCPayloadDestroy(parsed);
+            }
+            costs[scoped] = std::chrono::steady_clock::now() - start;
+        }
+        OICFree(data);
+
+        // Every allocation in the region would have been a heap allocation otherwise.
+        EXPECT_LT(stats.blocks, stats.allocations);
+        ::testing::Test::RecordProperty("HeapParseMicrosecondsFor" + std::to_string(numProperties)
+                + "Properties", (int)(std::chrono::duration_cast<std::chrono::microseconds>(
+                costs[0]).count() / iterations));
+        ::testing::Test::RecordProperty("ScopedParseMicrosecondsFor"
+                + std::to_string(numProperties) + "Properties",
+                (int)(std::chrono::duration_cast<std::chrono::microseconds>(
+                costs[1]).count() / iterations));
+        ::testing::Test::RecordProperty("ScopedParseAllocationsFor"
+                + std::to_string(numProperties) + "Properties", (int)stats.allocations);
+        ::testing::Test::RecordProperty("ScopedParseBlocksFor"
+                + std::to_string(numProperties) + "Properties", (int)stats.blocks);
+    }
+}
+
 TEST(PODTests, OCHeaderOption)
 {
     EXPECT_TRUE(std::is_pod<OCHeaderOption>::value);
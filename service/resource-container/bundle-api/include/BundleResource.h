@@ -21,6 +21,7 @@
 #ifndef BUNDLERESOURCE_H_
 #define BUNDLERESOURCE_H_
 
+#include <atomic>
 #include <list>
 #include <string>
 #include <map>
@@ -161,6 +162,17 @@ namespace OIC
                 */
                 virtual void handleSetAttributesRequest(RCSResourceAttributes &attrs) = 0;
 
+            protected:
+                /**
+                * Hold back the notifications of attribute updates. When they are no longer
+                * held back, one notification is sent if any attribute was updated meanwhile.
+                *
+                * @param deferred Flag to indicate if notifications are held back
+                *
+                * @return void
+                */
+                void setNotificationDeferred(bool deferred);
+
 
             public:
                 std::string m_bundleId;
@@ -171,6 +183,8 @@ namespace OIC
             private:
                 NotificationReceiver *m_pNotiReceiver;
                 RCSResourceAttributes m_resourceAttributes;
+                std::atomic_bool m_notificationDeferred;
+                std::atomic_bool m_notificationPending;
         };
     }
 }
@@ -21,12 +21,18 @@
 #ifndef SOFTSENSORRESOURCE_H_
 #define SOFTSENSORRESOURCE_H_
 
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+
 #include "BundleResource.h"
 
 namespace OIC
 {
     namespace Service
     {
+        class ExpiryTimer;
 
         /**
         * @class    SoftSensorResource
@@ -37,6 +43,12 @@ namespace OIC
         class SoftSensorResource: public BundleResource
         {
             public:
+                /**
+                * Values of the input attributes, with the attribute name as key
+                */
+                typedef std::map< std::string, std::vector< RCSResourceAttributes::Value > >
+                InputData;
+
                 /**
                 * Constructor for SoftSensorResource
                 */
@@ -87,6 +99,7 @@ namespace OIC
                 /**
                 * SoftSensor logic. Has to be provided by the soft sensor developer.
                 * This function will be executed if an input attribute is updated.
+                * Inputs stored with updateInputData are read with getInputData.
                 *
                 * @return void
                 */
@@ -97,6 +110,7 @@ namespace OIC
                 * This function will be called if input data from remote resources are updated.
                 * SoftSensor resource can get a vector of input data from multiple input resources
                 *    which have attributeName that softsensor needs to execute its logic.
+                * By default the values are stored with updateInputData.
                 *
                 * @param attributeName Attribute key of input data
                 *
@@ -105,11 +119,68 @@ namespace OIC
                 * @return void
                 */
                 virtual void onUpdatedInputResource(const std::string attributeName,
-                                                    std::vector<RCSResourceAttributes::Value> values) = 0;
+                                                    std::vector<RCSResourceAttributes::Value> values);
+
+                /**
+                * Set the window in which input updates are coalesced. The logic is executed
+                *    and clients are notified at most once per window. With a zero window,
+                *    which is the default, the logic is executed on every update.
+                *
+                * @param window Length of the window
+                *
+                * @return void
+                */
+                void setCoalescingWindow(std::chrono::milliseconds window);
+
+            protected:
+                /**
+                * Store the values of an input attribute and execute the logic, either
+                *    immediately or at the end of the coalescing window. The logic is
+                *    executed once all the configured inputs have values.
+                *
+                * @param attributeName Attribute key of input data
+                *
+                * @param values Vector of input data value
+                *
+                * @return void
+                */
+                void updateInputData(const std::string &attributeName,
+                                     std::vector< RCSResourceAttributes::Value > values);
 
+                /**
+                * Return the input data of the current logic execution. The snapshot is
+                *    not changed by updates which arrive while the logic is executed.
+                *
+                * @return Snapshot of the input data
+                */
+                std::shared_ptr< const InputData > getInputData() const;
+
+                /**
+                * Cancel the scheduled logic execution and wait for the one in progress.
+                *    The logic is not executed afterwards. Has to be called first in the
+                *    destructor of the soft sensor, before its own members are destroyed.
+                *
+                * @return void
+                */
+                void stopLogic();
+
+            private:
+                struct LogicGuard;
+
+                bool hasAllInputs();
+                void runLogic();
 
             public:
                 std::list<std::string> m_inputList;
+
+            private:
+                std::chrono::milliseconds m_coalescingWindow;
+                InputData m_inputData;
+                bool m_isLogicScheduled;
+                std::shared_ptr< const InputData > m_inputSnapshot;
+                std::unique_ptr< ExpiryTimer > m_timer;
+                mutable std::mutex m_inputMutex;
+                std::shared_ptr< LogicGuard > m_logicGuard;
         };
     }
 }
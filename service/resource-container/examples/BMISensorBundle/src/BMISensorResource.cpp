@@ -28,6 +28,8 @@ BMISensorResource::BMISensorResource()
 
 BMISensorResource::~BMISensorResource()
 {
+    stopLogic();
+
     delete m_pBMISensor;
 }
 
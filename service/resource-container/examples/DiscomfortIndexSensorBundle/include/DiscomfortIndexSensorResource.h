@@ -45,7 +45,6 @@ class DiscomfortIndexSensorResource : public SoftSensorResource
 
     private:
         DiscomfortIndexSensor *m_pDiscomfortIndexSensor;
-        std::map<std::string, std::string> m_mapInputData;
 };
 
 #endif
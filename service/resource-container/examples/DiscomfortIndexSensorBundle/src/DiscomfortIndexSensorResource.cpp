@@ -23,14 +23,22 @@
 #include <string>
 #include <sstream>
 
+namespace
+{
+    // temperature and humidity updates within the window give one index update
+    const std::chrono::milliseconds DI_COALESCING_WINDOW(500);
+}
 
 DiscomfortIndexSensorResource::DiscomfortIndexSensorResource()
 {
     m_pDiscomfortIndexSensor = new DiscomfortIndexSensor();
+    setCoalescingWindow(DI_COALESCING_WINDOW);
 }
 
 DiscomfortIndexSensorResource::~DiscomfortIndexSensorResource()
 {
+    stopLogic();
+
     delete m_pDiscomfortIndexSensor;
 }
 
@@ -48,12 +56,24 @@ RCSResourceAttributes &DiscomfortIndexSensorResource::handleGetAttributesRequest
 void DiscomfortIndexSensorResource::executeLogic()
 {
     std::string strDiscomfortIndex;
+    std::map<std::string, std::string> mapInputData;
+
+    for (const auto &it : *getInputData())
+    {
+        mapInputData[it.first] = it.second.front().toString();
+    }
 
-    m_pDiscomfortIndexSensor->executeDISensorLogic(&m_mapInputData, &strDiscomfortIndex);
+    if (mapInputData.find("temperature") == mapInputData.end()
+        || mapInputData.find("humidity") == mapInputData.end())
+    {
+        return;
+    }
+
+    m_pDiscomfortIndexSensor->executeDISensorLogic(&mapInputData, &strDiscomfortIndex);
 
     setAttribute("discomfortIndex", RCSResourceAttributes::Value(strDiscomfortIndex.c_str()));
 
-    for (auto it : m_mapInputData)
+    for (auto it : mapInputData)
     {
         setAttribute(it.first, RCSResourceAttributes::Value(it.second.c_str()));
     }
@@ -82,12 +102,6 @@ void DiscomfortIndexSensorResource::onUpdatedInputResource(const std::string att
     convert << result;//add the value of Number to the characters in the stream
     indexCount = convert.str();//set indexCount to the content of the stream
 
-    m_mapInputData[attributeName] = indexCount;
-
-    // execute logic only if all the input data are ready
-    if (m_mapInputData.find("temperature") != m_mapInputData.end()
-        && m_mapInputData.find("humidity") != m_mapInputData.end())
-    {
-        executeLogic();
-    }
+    // the logic is executed once the input data of the window are ready
+    updateInputData(attributeName, { RCSResourceAttributes::Value(indexCount) });
 }
\ No newline at end of file
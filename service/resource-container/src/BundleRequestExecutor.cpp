@@ -0,0 +1,132 @@
+//******************************************************************
+//
+// Copyright 2015 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "BundleRequestExecutor.h"
+
+#include "InternalTypes.h"
+
+namespace OIC
+{
+    namespace Service
+    {
+        BundleRequestExecutor::BundleRequestExecutor(const std::string &bundleId,
+                size_t numWorkers, size_t maxQueueSize)
+            : m_bundleId(bundleId), m_maxQueueSize(maxQueueSize), m_stopped(false),
+              m_totalLatency(0)
+        {
+            for (size_t i = 0; i < numWorkers; ++i)
+            {
+                m_workers.emplace_back(&BundleRequestExecutor::runWorker, this);
+            }
+        }
+
+        BundleRequestExecutor::~BundleRequestExecutor()
+        {
+            {
+                std::lock_guard< std::mutex > lock(m_mutex);
+                m_stopped = true;
+            }
+            m_cond.notify_all();
+
+            for (auto &worker : m_workers)
+            {
+                worker.join();
+            }
+
+            OC_LOG_V(INFO, CONTAINER_TAG,
+                     "Requests of bundle (%s) : %lu completed, %lu rejected, %lu timed out",
+                     m_bundleId.c_str(), m_metrics.completed, m_metrics.rejected,
+                     m_metrics.timedOut);
+        }
+
+        bool BundleRequestExecutor::post(std::function< void() > &&run)
+        {
+            {
+                std::lock_guard< std::mutex > lock(m_mutex);
+
+                if (m_stopped || m_queue.size() >= m_maxQueueSize)
+                {
+                    ++m_metrics.rejected;
+                    OC_LOG_V(WARNING, CONTAINER_TAG, "Request queue of bundle (%s) is full",
+                             m_bundleId.c_str());
+                    return false;
+                }
+
+                m_queue.push_back(Task{ std::move(run), Clock::now() });
+
+                m_metrics.queued = m_queue.size();
+                if (m_metrics.queued > m_metrics.maxQueued)
+                {
+                    m_metrics.maxQueued = m_metrics.queued;
+                }
+            }
+            m_cond.notify_one();
+
+            return true;
+        }
+
+        void BundleRequestExecutor::onTimedOut()
+        {
+            std::lock_guard< std::mutex > lock(m_mutex);
+            ++m_metrics.timedOut;
+        }
+
+        BundleRequestExecutor::Metrics BundleRequestExecutor::getMetrics() const
+        {
+            std::lock_guard< std::mutex > lock(m_mutex);
+            return m_metrics;
+        }
+
+        void BundleRequestExecutor::runWorker()
+        {
+            std::unique_lock< std::mutex > lock(m_mutex);
+
+            while (true)
+            {
+                m_cond.wait(lock, [this]() { return m_stopped || !m_queue.empty(); });
+
+                // pending requests are still handled when the executor is stopped,
+                // their callers are waiting for them.
+                if (m_queue.empty())
+                {
+                    break;
+                }
+
+                Task task = std::move(m_queue.front());
+                m_queue.pop_front();
+                m_metrics.queued = m_queue.size();
+
+                lock.unlock();
+                task.run();
+                auto latency = std::chrono::duration_cast< std::chrono::microseconds >(
+                                   Clock::now() - task.submitted);
+                lock.lock();
+
+                ++m_metrics.completed;
+                m_totalLatency += latency;
+                m_metrics.averageLatency = m_totalLatency / m_metrics.completed;
+                if (latency > m_metrics.maxLatency)
+                {
+                    m_metrics.maxLatency = latency;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,129 @@
+//******************************************************************
+//
+// Copyright 2015 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#ifndef BUNDLEREQUESTEXECUTOR_H_
+#define BUNDLEREQUESTEXECUTOR_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace OIC
+{
+    namespace Service
+    {
+        /**
+        * @class    BundleRequestExecutor
+        * @brief    Runs the request handlers of the resources of one bundle on a fixed
+        *               number of worker threads, with a bounded queue of pending requests.
+        *
+        */
+        class BundleRequestExecutor
+        {
+            public:
+                typedef std::shared_ptr< BundleRequestExecutor > Ptr;
+                typedef std::chrono::steady_clock Clock;
+
+                struct Metrics
+                {
+                    Metrics()
+                        : queued(0), maxQueued(0), completed(0), rejected(0), timedOut(0),
+                          averageLatency(0), maxLatency(0) {}
+
+                    size_t queued;
+                    size_t maxQueued;
+                    unsigned long completed;
+                    unsigned long rejected;
+                    unsigned long timedOut;
+                    // from the submission of a request to the end of its handler
+                    std::chrono::microseconds averageLatency;
+                    std::chrono::microseconds maxLatency;
+                };
+
+                BundleRequestExecutor(const std::string &bundleId, size_t numWorkers,
+                                      size_t maxQueueSize);
+                ~BundleRequestExecutor();
+
+                BundleRequestExecutor(const BundleRequestExecutor &) = delete;
+                BundleRequestExecutor &operator=(const BundleRequestExecutor &) = delete;
+
+                /**
+                * Queue a handler to run on a worker thread
+                *
+                * @param task Handler to run
+                *
+                * @return Future of the result of the handler, which is not valid
+                *     if the queue is full
+                */
+                template< typename T >
+                std::future< T > submit(std::function< T() > task)
+                {
+                    auto packagedTask = std::make_shared< std::packaged_task< T() > >(
+                                            std::move(task));
+                    std::future< T > result = packagedTask->get_future();
+
+                    if (!post([packagedTask]() { (*packagedTask)(); }))
+                    {
+                        return std::future< T >();
+                    }
+                    return result;
+                }
+
+                /**
+                * Record a request whose caller stopped waiting for its result
+                */
+                void onTimedOut();
+
+                Metrics getMetrics() const;
+
+            private:
+                struct Task
+                {
+                    std::function< void() > run;
+                    Clock::time_point submitted;
+                };
+
+                bool post(std::function< void() > &&run);
+                void runWorker();
+
+            private:
+                std::string m_bundleId;
+                size_t m_maxQueueSize;
+                bool m_stopped;
+
+                mutable std::mutex m_mutex;
+                std::condition_variable m_cond;
+                std::deque< Task > m_queue;
+                std::vector< std::thread > m_workers;
+
+                Metrics m_metrics;
+                std::chrono::microseconds m_totalLatency;
+        };
+    }
+}
+
+#endif /* BUNDLEREQUESTEXECUTOR_H_ */
@@ -30,6 +30,7 @@ namespace OIC
     namespace Service
     {
         BundleResource::BundleResource()
+            : m_notificationDeferred(false), m_notificationPending(false)
         {
             m_pNotiReceiver = nullptr;
         }
@@ -80,6 +81,19 @@ namespace OIC
             m_resourceAttributes[key] = value;
 
             if (notify && m_pNotiReceiver)
+            {
+                if (m_notificationDeferred)
+                    m_notificationPending = true;
+                else
+                    m_pNotiReceiver->onNotificationReceived(m_uri);
+            }
+        }
+
+        void BundleResource::setNotificationDeferred(bool deferred)
+        {
+            m_notificationDeferred = deferred;
+
+            if (!deferred && m_notificationPending.exchange(false) && m_pNotiReceiver)
                 m_pNotiReceiver->onNotificationReceived(m_uri);
         }
 
@@ -70,6 +70,7 @@ namespace OIC
 
         bool Configuration::isHasInput(std::string &bundleId) const
         {
+            std::lock_guard< std::mutex > lock(m_mapisHasInputLock);
             try
             {
                 return m_mapisHasInput.at(bundleId);
@@ -223,6 +224,8 @@ namespace OIC
 
                                             if (strKey.compare(INPUT_RESOURCE))
                                             {
+                                                std::lock_guard< std::mutex > lock(
+                                                    m_mapisHasInputLock);
                                                 m_mapisHasInput[strBundleId] = true;
                                             }
 
@@ -28,6 +28,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <mutex>
 
 #include "rapidxml/rapidxml.hpp"
 #include "rapidxml/rapidxml_print.hpp"
@@ -70,6 +71,8 @@ namespace OIC
                 string m_strConfigData;
                 rapidxml::xml_document< char > m_xmlDoc;
                 std::map<std::string, bool> m_mapisHasInput; // bundleId, isHasInput
+                // bundles are activated concurrently
+                mutable std::mutex m_mapisHasInputLock;
         };
     }
 }
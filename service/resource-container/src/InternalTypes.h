@@ -35,6 +35,9 @@ namespace OIC
         constexpr char BUNDLE_VERSION[] = "version";
         constexpr char BUNDLE_ACTIVATOR[] = "activator";
         constexpr char BUNDLE_LIBRARY_PATH[] = "libraryPath";
+        constexpr char BUNDLE_DEPENDENCIES[] = "dependencies";
+        constexpr char BUNDLE_ACTIVATION[] = "activation";
+        constexpr char BUNDLE_ACTIVATION_LAZY[] = "lazy";
 
         constexpr char INPUT_RESOURCE[] = "input";
         constexpr char INPUT_RESOURCE_URI[] = "resourceUri";
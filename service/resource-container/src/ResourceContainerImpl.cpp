@@ -29,6 +29,9 @@
 #include <thread>
 #include <mutex>
 #include <algorithm>
+#include <future>
+#include <set>
+#include <sstream>
 
 #include "BundleActivator.h"
 #include "SoftSensorResource.h"
@@ -48,6 +51,8 @@ namespace OIC
 
         ResourceContainerImpl::~ResourceContainerImpl()
         {
+            joinLateActivations();
+            joinLazyActivations();
             m_config = nullptr;
         }
 
@@ -77,6 +82,11 @@ namespace OIC
                     configInfo bundles;
                     m_config->getConfiguredBundles(&bundles);
 
+                    // <bundleID, bundleInfo> of the bundles activated at start-up
+                    map< std::string, BundleInfoInternal * > startupBundles;
+                    // <bundleID, IDs of the bundles to be activated before>
+                    map< std::string, std::set< std::string > > dependencies;
+
                     for (unsigned int i = 0; i < bundles.size(); i++)
                     {
                         BundleInfoInternal *bundleInfo = new BundleInfoInternal();
@@ -96,9 +106,28 @@ namespace OIC
                                  std::string(bundles[i][BUNDLE_ID] + ";" +
                                              bundles[i][BUNDLE_PATH]).c_str());
 
-                        registerBundle(bundleInfo);
-                        activateBundle(bundleInfo);
+                        if (bundles[i][BUNDLE_ACTIVATION] == BUNDLE_ACTIVATION_LAZY)
+                        {
+                            registerLazyBundle(bundleInfo);
+                            continue;
+                        }
+
+                        startupBundles[bundleInfo->getID()] = bundleInfo;
+
+                        std::istringstream dependencyList(bundles[i][BUNDLE_DEPENDENCIES]);
+                        std::string dependency;
+                        while (std::getline(dependencyList, dependency, ','))
+                        {
+                            dependency.erase(0, dependency.find_first_not_of(" \t"));
+                            dependency.erase(dependency.find_last_not_of(" \t") + 1);
+                            if (!dependency.empty())
+                            {
+                                dependencies[bundleInfo->getID()].insert(dependency);
+                            }
+                        }
                     }
+
+                    activateBundles(startupBundles, dependencies);
                 }
                 else
                 {
@@ -110,24 +139,347 @@ namespace OIC
                 OC_LOG_V(INFO, CONTAINER_TAG, "No configuration file for the container provided.");
             }
 
-            map<std::string, boost::thread >::iterator activatorIterator;
+            activationLock.unlock();
+        }
 
-            for (activatorIterator = m_activators.begin(); activatorIterator != m_activators.end();
-                 activatorIterator++)
+        void ResourceContainerImpl::activateBundles(
+            map< std::string, BundleInfoInternal * > bundles,
+            map< std::string, std::set< std::string > > dependencies)
+        {
+            // bundles which are not activated at start-up can not be waited for
+            for (auto &bundleDependencies : dependencies)
             {
-                activatorIterator->second.timed_join(
-                    boost::posix_time::seconds(BUNDLE_ACTIVATION_WAIT_SEC));
-                // wait for bundles to be activated
+                for (auto it = bundleDependencies.second.begin();
+                     it != bundleDependencies.second.end();)
+                {
+                    if (bundles.find(*it) == bundles.end())
+                    {
+                        OC_LOG_V(WARNING, CONTAINER_TAG, "Dependency (%s) of (%s) ignored",
+                                 it->c_str(), bundleDependencies.first.c_str());
+                        it = bundleDependencies.second.erase(it);
+                    }
+                    else
+                    {
+                        ++it;
+                    }
+                }
+            }
+
+            // Bundles are activated in rounds. A round holds the bundles whose
+            // dependencies are activated, and activates its native bundles concurrently.
+            while (!bundles.empty())
+            {
+                std::vector< BundleInfoInternal * > round;
+
+                for (auto &bundle : bundles)
+                {
+                    bool isReady = true;
+                    for (auto &dependency : dependencies[bundle.first])
+                    {
+                        isReady = isReady && bundles.find(dependency) == bundles.end();
+                    }
+
+                    if (isReady)
+                    {
+                        round.push_back(bundle.second);
+                    }
+                }
+
+                if (round.empty())
+                {
+                    OC_LOG(ERROR, CONTAINER_TAG, "Circular bundle dependencies, activating the rest.");
+                    for (auto &bundle : bundles)
+                    {
+                        round.push_back(bundle.second);
+                    }
+                }
+
+                std::vector< std::pair< std::shared_ptr< StartupActivation >, std::thread > >
+                activations;
+                for (auto bundleInfo : round)
+                {
+                    bundles.erase(bundleInfo->getID());
+
+                    if (has_suffix(bundleInfo->getPath(), ".jar"))
+                    {
+                        continue;
+                    }
+
+                    auto activation = std::make_shared< StartupActivation >();
+                    activation->bundleInfo = bundleInfo;
+                    activation->isDone = false;
+                    activation->isLate = false;
+                    std::thread thread(&ResourceContainerImpl::runStartupActivation, this,
+                                       activation);
+                    activations.emplace_back(activation, std::move(thread));
+                }
+
+                auto deadline = std::chrono::steady_clock::now()
+                                + std::chrono::seconds(BUNDLE_ACTIVATION_WAIT_SEC);
+                std::unique_lock< std::mutex > lock(m_startupActivationsLock);
+                for (auto &activation : activations)
+                {
+                    std::shared_ptr< StartupActivation > state = activation.first;
+                    if (!m_startupActivationDone.wait_until(lock, deadline,
+                                                            [&state]() { return state->isDone; }))
+                    {
+                        OC_LOG_V(ERROR, CONTAINER_TAG, "Activation of bundle (%s) timed out",
+                                 state->bundleInfo->getID().c_str());
+
+                        state->isLate = true;
+                        m_lateActivations.push_back(std::move(activation.second));
+                        continue;
+                    }
+
+                    activation.second.join();
+                    if (state->bundleInfo->isLoaded())
+                    {
+                        m_bundles[state->bundleInfo->getID()] = state->bundleInfo;
+                    }
+                }
+                lock.unlock();
+
+                // the Java VM of the container is not shared by concurrent activations
+                for (auto bundleInfo : round)
+                {
+                    if (has_suffix(bundleInfo->getPath(), ".jar"))
+                    {
+                        auto start = std::chrono::steady_clock::now();
+                        registerBundle(bundleInfo);
+                        auto loaded = std::chrono::steady_clock::now();
+                        activateBundle(bundleInfo);
+
+                        recordStartupTime(bundleInfo->getID(), loaded - start,
+                                          std::chrono::steady_clock::now() - loaded, false);
+                    }
+                }
+            }
+        }
+
+        void ResourceContainerImpl::loadAndActivateSoBundle(BundleInfoInternal *bundleInfo)
+        {
+            auto start = std::chrono::steady_clock::now();
+            ((BundleInfoInternal *) bundleInfo)->setJavaBundle(false);
+            loadSoBundle(bundleInfo);
+            auto loaded = std::chrono::steady_clock::now();
+
+            if (bundleInfo->isLoaded())
+            {
+                OC_LOG_V(INFO, CONTAINER_TAG, "Activating bundle: (%s)",
+                         bundleInfo->getID().c_str());
+                activateSoBundle(bundleInfo);
+            }
+
+            recordStartupTime(bundleInfo->getID(), loaded - start,
+                              std::chrono::steady_clock::now() - loaded, false);
+        }
+
+        void ResourceContainerImpl::runStartupActivation(
+            std::shared_ptr< StartupActivation > activation)
+        {
+            loadAndActivateSoBundle(activation->bundleInfo);
+
+            bool isLate;
+            {
+                std::lock_guard< std::mutex > lock(m_startupActivationsLock);
+                activation->isDone = true;
+                isLate = activation->isLate;
+            }
+            m_startupActivationDone.notify_all();
+
+            // The start-up went on without the bundle, which is registered once the start-up
+            // is over, so that it is listed and stopped with the others.
+            if (isLate)
+            {
+                std::lock_guard< std::recursive_mutex > lock(activationLock);
+                if (activation->bundleInfo->isLoaded())
+                {
+                    OC_LOG_V(INFO, CONTAINER_TAG, "Bundle (%s) activated after timing out",
+                             activation->bundleInfo->getID().c_str());
+                    m_bundles[activation->bundleInfo->getID()] = activation->bundleInfo;
+                }
+            }
+        }
+
+        void ResourceContainerImpl::joinLateActivations()
+        {
+            list< std::thread > activations;
+            m_startupActivationsLock.lock();
+            activations.swap(m_lateActivations);
+            m_startupActivationsLock.unlock();
+
+            for (auto &activation : activations)
+            {
+                activation.join();
+            }
+        }
+
+        void ResourceContainerImpl::recordStartupTime(const std::string &bundleId,
+                std::chrono::steady_clock::duration loading,
+                std::chrono::steady_clock::duration activation, bool isLazy)
+        {
+            BundleStartupTime startupTime;
+            startupTime.loading = std::chrono::duration_cast< std::chrono::microseconds >(loading);
+            startupTime.activation =
+                std::chrono::duration_cast< std::chrono::microseconds >(activation);
+            startupTime.isLazy = isLazy;
+
+            OC_LOG_V(INFO, CONTAINER_TAG, "Bundle (%s) %s: loaded in %lld us, activated in %lld us",
+                     bundleId.c_str(), isLazy ? "loaded on demand" : "started",
+                     (long long) startupTime.loading.count(),
+                     (long long) startupTime.activation.count());
+
+            std::lock_guard< std::mutex > lock(m_startupTimesLock);
+            m_bundleStartupTimes[bundleId] = startupTime;
+        }
+
+        map< std::string, ResourceContainerImpl::BundleStartupTime >
+        ResourceContainerImpl::getBundleStartupTimes()
+        {
+            std::lock_guard< std::mutex > lock(m_startupTimesLock);
+            return m_bundleStartupTimes;
+        }
+
+        void ResourceContainerImpl::registerLazyBundle(BundleInfoInternal *bundleInfo)
+        {
+            OC_LOG_V(INFO, CONTAINER_TAG, "Bundle (%s) is loaded on demand",
+                     bundleInfo->getID().c_str());
+
+            m_lazyBundles[bundleInfo->getID()] = bundleInfo;
+
+            // A request to a resource declared with its uri loads the bundle. The bundle
+            // takes the resource over when it registers a resource with the same uri.
+            std::vector< resourceInfo > resources;
+            m_config->getResourceConfiguration(bundleInfo->getID(), &resources);
+
+            std::lock_guard< std::mutex > lock(registrationLock);
+            for (auto &resource : resources)
+            {
+                if (resource.uri.empty() || m_lazyServers.find(resource.uri) != m_lazyServers.end())
+                {
+                    continue;
+                }
+
+                RCSResourceObject::Ptr server = buildResourceObject(resource.uri,
+                                                resource.resourceType);
+                if (server != nullptr)
+                {
+                    server->setGetRequestHandler(
+                        std::bind(&ResourceContainerImpl::getRequestHandler, this,
+                                  std::placeholders::_1, std::placeholders::_2));
+                    server->setSetRequestHandler(
+                        std::bind(&ResourceContainerImpl::setRequestHandler, this,
+                                  std::placeholders::_1, std::placeholders::_2));
+
+                    m_lazyServers[resource.uri] = std::make_pair(bundleInfo->getID(), server);
+                }
+            }
+        }
+
+        bool ResourceContainerImpl::activateLazyBundle(const std::string &bundleId)
+        {
+            std::lock_guard< std::recursive_mutex > lock(activationLock);
+
+            auto lazyBundle = m_lazyBundles.find(bundleId);
+            if (lazyBundle == m_lazyBundles.end())
+            {
+                return false;
+            }
+
+            BundleInfoInternal *bundleInfo = lazyBundle->second;
+            m_lazyBundles.erase(lazyBundle);
+
+            auto start = std::chrono::steady_clock::now();
+            registerBundle(bundleInfo);
+            auto loaded = std::chrono::steady_clock::now();
+
+            // activated on the calling thread, which is waited for instead of abandoned
+            if (bundleInfo->isLoaded())
+            {
+                activateBundleThread(bundleId);
+            }
+
+            recordStartupTime(bundleId, loaded - start, std::chrono::steady_clock::now() - loaded,
+                              true);
+            return true;
+        }
+
+        bool ResourceContainerImpl::startLazyActivationOf(const std::string &strResourceUri)
+        {
+            std::string bundleId;
+            {
+                std::lock_guard< std::mutex > lock(registrationLock);
+
+                auto lazyServer = m_lazyServers.find(strResourceUri);
+                if (lazyServer == m_lazyServers.end())
+                {
+                    return false;
+                }
+                bundleId = lazyServer->second.first;
+            }
+
+            // The bundle registers its resources through the stack, which is busy with the
+            // request to be answered. It is activated on its own thread instead.
+            std::lock_guard< std::mutex > lock(m_lazyActivationsLock);
+            if (m_lazyActivations.find(bundleId) == m_lazyActivations.end())
+            {
+                m_lazyActivations[bundleId] = std::thread(
+                    [this, bundleId]()
+                {
+                    activateLazyBundle(bundleId);
+                });
+            }
+            return true;
+        }
+
+        void ResourceContainerImpl::joinLazyActivation(const std::string &bundleId)
+        {
+            std::thread activation;
+            {
+                std::lock_guard< std::mutex > lock(m_lazyActivationsLock);
+
+                auto lazyActivation = m_lazyActivations.find(bundleId);
+                if (lazyActivation == m_lazyActivations.end())
+                {
+                    return;
+                }
+                activation = std::move(lazyActivation->second);
+                m_lazyActivations.erase(lazyActivation);
+            }
+
+            if (activation.joinable())
+            {
+                activation.join();
+            }
+        }
+
+        void ResourceContainerImpl::joinLazyActivations()
+        {
+            map< std::string, std::thread > activations;
+            m_lazyActivationsLock.lock();
+            activations.swap(m_lazyActivations);
+            m_lazyActivationsLock.unlock();
+
+            for (auto &activation : activations)
+            {
+                if (activation.second.joinable())
+                {
+                    activation.second.join();
+                }
             }
-            activationLock.unlock();
         }
 
         void ResourceContainerImpl::stopContainer()
         {
             OC_LOG(INFO, CONTAINER_TAG, "Stopping resource container.");
 
-            for (std::map< std::string, BundleInfoInternal * >::iterator it = m_bundles.begin();
-                 it != m_bundles.end(); ++it)
+            joinLateActivations();
+            joinLazyActivations();
+
+            // unregistered bundles are erased from m_bundles
+            map< std::string, BundleInfoInternal * > bundles = m_bundles;
+            for (std::map< std::string, BundleInfoInternal * >::iterator it = bundles.begin();
+                 it != bundles.end(); ++it)
             {
                 BundleInfoInternal *bundleInfo = it->second;
                 deactivateBundle(bundleInfo);
@@ -147,6 +499,24 @@ namespace OIC
                 m_mapBundleResources.clear();
             }
 
+            map< std::string, BundleRequestExecutor::Ptr > executors;
+            registrationLock.lock();
+            executors.swap(m_mapRequestExecutors);
+            m_lazyServers.clear();
+            registrationLock.unlock();
+
+            activationLock.lock();
+            for (auto &lazyBundle : m_lazyBundles)
+            {
+                delete lazyBundle.second;
+            }
+            m_lazyBundles.clear();
+            activationLock.unlock();
+
+            m_startupTimesLock.lock();
+            m_bundleStartupTimes.clear();
+            m_startupTimesLock.unlock();
+
             if (m_config)
                 delete m_config;
         }
@@ -253,8 +623,10 @@ namespace OIC
             }
             else
             {
-                delete m_bundles[id];
-                m_bundles.erase(id);
+                // the id may belong to the deleted bundle info
+                auto bundle = m_bundles.find(id);
+                delete bundle->second;
+                m_bundles.erase(bundle);
             }
         }
 
@@ -270,7 +642,20 @@ namespace OIC
             registrationLock.lock();
             if (m_mapResources.find(strUri) == m_mapResources.end())
             {
-                server = buildResourceObject(strUri, strResourceType);
+                // a server created for a bundle loaded on demand already has its handlers,
+                // it may be handling the request which loaded the bundle.
+                bool isLazyServer = false;
+                auto lazyServer = m_lazyServers.find(strUri);
+                if (lazyServer != m_lazyServers.end())
+                {
+                    server = lazyServer->second.second;
+                    m_lazyServers.erase(lazyServer);
+                    isLazyServer = true;
+                }
+                else
+                {
+                    server = buildResourceObject(strUri, strResourceType);
+                }
 
                 if (server != nullptr)
                 {
@@ -278,13 +663,24 @@ namespace OIC
                     m_mapResources[strUri] = resource;
                     m_mapBundleResources[resource->m_bundleId].push_back(strUri);
 
-                    server->setGetRequestHandler(
-                        std::bind(&ResourceContainerImpl::getRequestHandler, this,
-                                  std::placeholders::_1, std::placeholders::_2));
+                    if (m_mapRequestExecutors.find(resource->m_bundleId)
+                        == m_mapRequestExecutors.end())
+                    {
+                        m_mapRequestExecutors[resource->m_bundleId] =
+                            std::make_shared< BundleRequestExecutor >(resource->m_bundleId,
+                                    BUNDLE_REQUEST_WORKERS, BUNDLE_REQUEST_QUEUE_SIZE);
+                    }
 
-                    server->setSetRequestHandler(
-                        std::bind(&ResourceContainerImpl::setRequestHandler, this,
-                                  std::placeholders::_1, std::placeholders::_2));
+                    if (!isLazyServer)
+                    {
+                        server->setGetRequestHandler(
+                            std::bind(&ResourceContainerImpl::getRequestHandler, this,
+                                      std::placeholders::_1, std::placeholders::_2));
+
+                        server->setSetRequestHandler(
+                            std::bind(&ResourceContainerImpl::setRequestHandler, this,
+                                      std::placeholders::_1, std::placeholders::_2));
+                    }
 
                     OC_LOG_V(INFO, CONTAINER_TAG, "Registration finished (%s)",
                              std::string(strUri + ", " +
@@ -321,13 +717,28 @@ namespace OIC
                 undiscoverInputResource(strUri);
             }
 
+            // released outside of the lock, as it waits for the running requests
+            BundleRequestExecutor::Ptr executor;
+
+            registrationLock.lock();
             if (m_mapServers.find(strUri) != m_mapServers.end())
             {
                 m_mapServers[strUri].reset();
 
                 m_mapResources.erase(m_mapResources.find(strUri));
                 m_mapBundleResources[resource->m_bundleId].remove(strUri);
+
+                if (m_mapBundleResources[resource->m_bundleId].empty())
+                {
+                    auto executorItor = m_mapRequestExecutors.find(resource->m_bundleId);
+                    if (executorItor != m_mapRequestExecutors.end())
+                    {
+                        executor = std::move(executorItor->second);
+                        m_mapRequestExecutors.erase(executorItor);
+                    }
+                }
             }
+            registrationLock.unlock();
         }
 
         void ResourceContainerImpl::getBundleConfiguration(const std::string &bundleId,
@@ -348,26 +759,67 @@ namespace OIC
             }
         }
 
+        bool ResourceContainerImpl::findRequestTarget(const std::string &strResourceUri,
+                BundleResource::Ptr *resource, BundleRequestExecutor::Ptr *executor)
+        {
+            std::lock_guard< std::mutex > lock(registrationLock);
+
+            if (m_mapServers.find(strResourceUri) == m_mapServers.end())
+            {
+                return false;
+            }
+
+            auto resourceItor = m_mapResources.find(strResourceUri);
+            if (resourceItor == m_mapResources.end() || !resourceItor->second)
+            {
+                return false;
+            }
+
+            auto executorItor = m_mapRequestExecutors.find(resourceItor->second->m_bundleId);
+            if (executorItor == m_mapRequestExecutors.end())
+            {
+                return false;
+            }
+
+            *resource = resourceItor->second;
+            *executor = executorItor->second;
+            return true;
+        }
+
         RCSGetResponse ResourceContainerImpl::getRequestHandler(const RCSRequest &request,
                 const RCSResourceAttributes &)
         {
             RCSResourceAttributes attr;
-            std::string strResourceUri = request.getResourceUri();
+            BundleResource::Ptr resource;
+            BundleRequestExecutor::Ptr executor;
 
-            if (m_mapServers.find(strResourceUri) != m_mapServers.end()
-                && m_mapResources.find(strResourceUri) != m_mapResources.end())
+            if (findRequestTarget(request.getResourceUri(), &resource, &executor))
             {
-                if (m_mapResources[strResourceUri])
+                // the handler gets its own copies, it may outlive this request on timeout
+                std::future< RCSResourceAttributes > result =
+                    executor->submit< RCSResourceAttributes >([resource]()
                 {
-                    auto getFunction = [this, &attr, &strResourceUri]()
-                    {
-                        attr = m_mapResources[strResourceUri]->handleGetAttributesRequest();
-                    };
-                    boost::thread getThread(getFunction);
-                    getThread.timed_join(boost::posix_time::seconds(BUNDLE_SET_GET_WAIT_SEC));
+                    return resource->handleGetAttributesRequest();
+                });
 
+                if (result.valid() && result.wait_for(std::chrono::seconds(BUNDLE_SET_GET_WAIT_SEC))
+                    == std::future_status::ready)
+                {
+                    attr = result.get();
+                }
+                else if (result.valid())
+                {
+                    executor->onTimedOut();
+                    OC_LOG_V(ERROR, CONTAINER_TAG, "Get request to (%s) timed out",
+                             request.getResourceUri().c_str());
                 }
             }
+            else if (startLazyActivationOf(request.getResourceUri()))
+            {
+                // the bundle loaded on the request is not active yet, the placeholder
+                // answers with its own attributes and the pending error code
+                return RCSGetResponse::create(BUNDLE_ACTIVATION_PENDING_ERROR_CODE);
+            }
 
             return RCSGetResponse::create(std::move(attr), 200);
         }
@@ -376,33 +828,47 @@ namespace OIC
                 const RCSResourceAttributes &attributes)
         {
             RCSResourceAttributes attr;
-            std::list<std::string> lstAttributes;
-            std::string strResourceUri = request.getResourceUri();
+            BundleResource::Ptr resource;
+            BundleRequestExecutor::Ptr executor;
 
-            if (m_mapServers.find(strResourceUri) != m_mapServers.end()
-                && m_mapResources.find(strResourceUri) != m_mapResources.end())
+            if (findRequestTarget(request.getResourceUri(), &resource, &executor))
             {
-                if (m_mapResources[strResourceUri])
+                std::future< RCSResourceAttributes > result =
+                    executor->submit< RCSResourceAttributes >([resource, attributes]()
                 {
-                    auto setFunction = [this, &lstAttributes, &strResourceUri, &attributes, &attr]()
-                    {
-                        lstAttributes = m_mapResources[strResourceUri]->getAttributeNames();
+                    RCSResourceAttributes accepted;
+                    const RCSResourceAttributes &current = resource->getAttributes();
 
-                        for (RCSResourceAttributes::const_iterator itor = attributes.begin();
-                             itor != attributes.end(); itor++)
+                    for (RCSResourceAttributes::const_iterator itor = attributes.begin();
+                         itor != attributes.end(); itor++)
+                    {
+                        if (current.contains(itor->key()))
                         {
-                            if (std::find(lstAttributes.begin(), lstAttributes.end(), itor->key())
-                                != lstAttributes.end())
-                            {
-                                attr[itor->key()] = itor->value();
-                            }
+                            accepted[itor->key()] = itor->value();
                         }
+                    }
 
-                        m_mapResources[strResourceUri]->handleSetAttributesRequest(attr);
-                    };
-                    boost::thread setThread(setFunction);
-                    setThread.timed_join(boost::posix_time::seconds(BUNDLE_SET_GET_WAIT_SEC));
+                    resource->handleSetAttributesRequest(accepted);
+                    return accepted;
+                });
+
+                if (result.valid() && result.wait_for(std::chrono::seconds(BUNDLE_SET_GET_WAIT_SEC))
+                    == std::future_status::ready)
+                {
+                    attr = result.get();
                 }
+                else if (result.valid())
+                {
+                    executor->onTimedOut();
+                    OC_LOG_V(ERROR, CONTAINER_TAG, "Set request to (%s) timed out",
+                             request.getResourceUri().c_str());
+                }
+            }
+            else if (startLazyActivationOf(request.getResourceUri()))
+            {
+                // the bundle loaded on the request is not active yet, the placeholder
+                // answers with its own attributes and the pending error code
+                return RCSSetResponse::ignore(BUNDLE_ACTIVATION_PENDING_ERROR_CODE);
             }
 
             return RCSSetResponse::create(std::move(attr), 200);
@@ -435,6 +901,13 @@ namespace OIC
 
         void ResourceContainerImpl::startBundle(const std::string &bundleId)
         {
+            joinLazyActivation(bundleId);
+
+            if (activateLazyBundle(bundleId))
+            {
+                return;
+            }
+
             if (m_bundles.find(bundleId) != m_bundles.end())
             {
                 if (!m_bundles[bundleId]->isActivated())
@@ -453,6 +926,8 @@ namespace OIC
 
         void ResourceContainerImpl::stopBundle(const std::string &bundleId)
         {
+            joinLazyActivation(bundleId);
+
             if (m_bundles.find(bundleId) != m_bundles.end())
             {
                 if (m_bundles[bundleId]->isActivated())
@@ -502,6 +977,8 @@ namespace OIC
 
         void ResourceContainerImpl::removeBundle(const std::string &bundleId)
         {
+            joinLazyActivation(bundleId);
+
             if (m_bundles.find(bundleId) != m_bundles.end())
             {
                 BundleInfoInternal *bundleInfo = m_bundles[bundleId];
@@ -530,12 +1007,24 @@ namespace OIC
                     ret.push_back((RCSBundleInfo *) bundleInfo);
                 }
             }
+
+            activationLock.lock();
+            for (auto &lazyBundle : m_lazyBundles)
+            {
+                BundleInfoInternal *bundleInfo = new BundleInfoInternal();
+                bundleInfo->setBundleInfo(lazyBundle.second);
+                ret.push_back((RCSBundleInfo *) bundleInfo);
+            }
+            activationLock.unlock();
             return ret;
         }
 
         void ResourceContainerImpl::addResourceConfig(const std::string &bundleId,
                 const std::string &resourceUri, std::map< string, string > params)
         {
+            joinLazyActivation(bundleId);
+            activateLazyBundle(bundleId);
+
             if (m_bundles.find(bundleId) != m_bundles.end())
             {
                 if (!m_bundles[bundleId]->getJavaBundle())
@@ -590,7 +1079,29 @@ namespace OIC
 
         }
 
+        BundleRequestExecutor::Metrics ResourceContainerImpl::getRequestMetrics(
+            const std::string &bundleId)
+        {
+            std::lock_guard< std::mutex > lock(registrationLock);
+
+            auto executorItor = m_mapRequestExecutors.find(bundleId);
+            if (executorItor != m_mapRequestExecutors.end())
+            {
+                return executorItor->second->getMetrics();
+            }
+
+            return BundleRequestExecutor::Metrics();
+        }
+
         void ResourceContainerImpl::registerSoBundle(RCSBundleInfo *bundleInfo)
+        {
+            if (loadSoBundle((BundleInfoInternal *) bundleInfo))
+            {
+                m_bundles[bundleInfo->getID()] = ((BundleInfoInternal *) bundleInfo);
+            }
+        }
+
+        bool ResourceContainerImpl::loadSoBundle(BundleInfoInternal *bundleInfo)
         {
             const char *error;
 
@@ -635,7 +1146,7 @@ namespace OIC
                     ((BundleInfoInternal *) bundleInfo)->setLoaded(true);
                     ((BundleInfoInternal *) bundleInfo)->setBundleHandle(bundleHandle);
 
-                    m_bundles[bundleInfo->getID()] = ((BundleInfoInternal *) bundleInfo);
+                    return true;
                 }
             }
             else
@@ -645,16 +1156,23 @@ namespace OIC
                     OC_LOG_V(ERROR, CONTAINER_TAG, "Error : (%s)", error);
                 }
             }
+
+            return false;
         }
 
         void ResourceContainerImpl::activateSoBundle(const std::string &bundleId)
         {
-            activator_t *bundleActivator = m_bundles[bundleId]->getBundleActivator();
+            activateSoBundle(m_bundles[bundleId]);
+        }
+
+        void ResourceContainerImpl::activateSoBundle(BundleInfoInternal *bundleInfo)
+        {
+            activator_t *bundleActivator = bundleInfo->getBundleActivator();
 
             if (bundleActivator != NULL)
             {
-                bundleActivator(this, m_bundles[bundleId]->getID());
-                m_bundles[bundleId]->setActivated(true);
+                bundleActivator(this, bundleInfo->getID());
+                bundleInfo->setActivated(true);
             }
             else
             {
@@ -662,8 +1180,7 @@ namespace OIC
                 OC_LOG(ERROR, CONTAINER_TAG, "Activation unsuccessful.");
             }
 
-            BundleInfoInternal *bundleInfoInternal = (BundleInfoInternal *) m_bundles[bundleId];
-            bundleInfoInternal->setActivated(true);
+            bundleInfo->setActivated(true);
 
         }
 
@@ -30,6 +30,7 @@
 #include "RCSResourceObject.h"
 
 #include "DiscoverResourceUnit.h"
+#include "BundleRequestExecutor.h"
 
 #include <boost/thread.hpp>
 #include <boost/date_time.hpp>
@@ -38,10 +39,20 @@
 #include <jni.h>
 #endif
 
+#include <chrono>
+#include <condition_variable>
+#include <list>
 #include <map>
+#include <memory>
+#include <set>
+#include <thread>
 
 #define BUNDLE_ACTIVATION_WAIT_SEC 10
 #define BUNDLE_SET_GET_WAIT_SEC 10
+#define BUNDLE_REQUEST_WORKERS 4
+#define BUNDLE_REQUEST_QUEUE_SIZE 64
+// error code of the responses to a resource whose bundle is still being loaded on demand
+#define BUNDLE_ACTIVATION_PENDING_ERROR_CODE 503
 
 using namespace OIC::Service;
 
@@ -99,22 +110,57 @@ namespace OIC
 
                 std::list< string > listBundleResources(const std::string &bundleId);
 
+                BundleRequestExecutor::Metrics getRequestMetrics(const std::string &bundleId);
+
+                struct BundleStartupTime
+                {
+                    BundleStartupTime() : loading(0), activation(0), isLazy(false) {}
+
+                    std::chrono::microseconds loading;
+                    std::chrono::microseconds activation;
+                    // loaded on the first request instead of at start-up
+                    bool isLazy;
+                };
+
+                map< std::string, BundleStartupTime > getBundleStartupTimes();
+
 #if(JAVA_SUPPORT)
                 JavaVM *getJavaVM(string bundleId);
                 void unregisterBundleJava(string id);
 #endif
 
             private:
+                struct StartupActivation
+                {
+                    BundleInfoInternal *bundleInfo;
+                    bool isDone;
+                    // timed out at start-up, the bundle is registered by its own thread
+                    bool isLate;
+                };
+
                 map< std::string, BundleInfoInternal * > m_bundles; // <bundleID, bundleInfo>
                 map< std::string, RCSResourceObject::Ptr > m_mapServers; //<uri, serverPtr>
                 map< std::string, BundleResource::Ptr > m_mapResources; //<uri, resourcePtr>
                 map< std::string, list< string > > m_mapBundleResources; //<bundleID, vector<uri>>
                 map< std::string, list< DiscoverResourceUnit::Ptr > > m_mapDiscoverResourceUnits;
                 //<uri, DiscoverUnit>
+                map< std::string, BundleRequestExecutor::Ptr > m_mapRequestExecutors;
+                //<bundleID, executor for the requests to its resources>
                 string m_configFile;
                 Configuration *m_config;
-                // holds for a bundle the threads for bundle activation
-                map< std::string, boost::thread > m_activators;
+                map< std::string, BundleInfoInternal * > m_lazyBundles;
+                //<bundleID, bundleInfo> of the bundles not loaded yet
+                map< std::string, std::pair< std::string, RCSResourceObject::Ptr > > m_lazyServers;
+                //<uri, <bundleID, server>> of the resources of bundles not loaded yet
+                map< std::string, std::thread > m_lazyActivations;
+                //<bundleID, thread> of the bundles loaded on a request
+                std::mutex m_lazyActivationsLock;
+                list< std::thread > m_lateActivations;
+                // threads of the bundles whose activation timed out at start-up
+                std::mutex m_startupActivationsLock;
+                std::condition_variable m_startupActivationDone;
+                map< std::string, BundleStartupTime > m_bundleStartupTimes;
+                std::mutex m_startupTimesLock;
                 // used for synchronize the resource registration of multiple bundles
                 std::mutex registrationLock;
                 // used to synchronize the startup of the container with other operation
@@ -130,6 +176,22 @@ namespace OIC
                 ResourceContainerImpl &operator=(ResourceContainerImpl &&) const = delete;
 
                 void activateSoBundle(const std::string &bundleId);
+                void activateSoBundle(BundleInfoInternal *bundleInfo);
+                bool loadSoBundle(BundleInfoInternal *bundleInfo);
+                void loadAndActivateSoBundle(BundleInfoInternal *bundleInfo);
+                void runStartupActivation(std::shared_ptr< StartupActivation > activation);
+                void joinLateActivations();
+                void activateBundles(map< std::string, BundleInfoInternal * > bundles,
+                                     map< std::string, std::set< std::string > > dependencies);
+                void recordStartupTime(const std::string &bundleId,
+                                       std::chrono::steady_clock::duration loading,
+                                       std::chrono::steady_clock::duration activation,
+                                       bool isLazy);
+                void registerLazyBundle(BundleInfoInternal *bundleInfo);
+                bool activateLazyBundle(const std::string &bundleId);
+                bool startLazyActivationOf(const std::string &strResourceUri);
+                void joinLazyActivation(const std::string &bundleId);
+                void joinLazyActivations();
                 void deactivateSoBundle(const std::string &bundleId);
                 void addSoBundleResource(const std::string &bundleId, resourceInfo newResourceInfo);
                 void removeSoBundleResource(const std::string &bundleId,
@@ -138,6 +200,9 @@ namespace OIC
                 void discoverInputResource(const std::string &outputResourceUri);
                 void undiscoverInputResource(const std::string &outputResourceUri);
                 void activateBundleThread(const std::string &bundleId);
+                bool findRequestTarget(const std::string &strResourceUri,
+                                       BundleResource::Ptr *resource,
+                                       BundleRequestExecutor::Ptr *executor);
 
 #if(JAVA_SUPPORT)
                 map<string, JavaVM *> m_bundleVM;
@@ -21,6 +21,9 @@
 #include "SoftSensorResource.h"
 #include <algorithm>
 
+#include "ExpiryTimer.h"
+#include "InternalTypes.h"
+
 using namespace OIC::Service;
 
 namespace
@@ -33,14 +36,38 @@ namespace OIC
 {
     namespace Service
     {
+        // Serializes the logic executions, and keeps a pending one from running
+        // once the resource is destroyed.
+        struct SoftSensorResource::LogicGuard
+        {
+            LogicGuard() : isAlive(true) {}
+
+            std::mutex mutex;
+            bool isAlive;
+        };
+
         SoftSensorResource::SoftSensorResource()
+            : m_coalescingWindow(0), m_isLogicScheduled(false),
+              m_timer(new ExpiryTimer()), m_logicGuard(std::make_shared< LogicGuard >())
         {
 
         }
 
         SoftSensorResource::~SoftSensorResource()
         {
+            stopLogic();
+        }
 
+        void SoftSensorResource::stopLogic()
+        {
+            {
+                std::lock_guard< std::mutex > lock(m_inputMutex);
+                m_timer->cancelAll();
+            }
+
+            // waits for the logic execution in progress, if any
+            std::lock_guard< std::mutex > lock(m_logicGuard->mutex);
+            m_logicGuard->isAlive = false;
         }
 
         void SoftSensorResource::initAttributes()
@@ -52,6 +79,94 @@ namespace OIC
                  itor != m_mapResourceProperty[SS_RESOURCE_OUTPUT].end(); itor++)
                 BundleResource::setAttribute((*itor)[SS_RESOURCE_OUTPUTNAME], nullptr);
         }
+
+        void SoftSensorResource::onUpdatedInputResource(const std::string attributeName,
+                std::vector< RCSResourceAttributes::Value > values)
+        {
+            updateInputData(attributeName, std::move(values));
+        }
+
+        void SoftSensorResource::setCoalescingWindow(std::chrono::milliseconds window)
+        {
+            std::lock_guard< std::mutex > lock(m_inputMutex);
+            m_coalescingWindow = window;
+        }
+
+        void SoftSensorResource::updateInputData(const std::string &attributeName,
+                std::vector< RCSResourceAttributes::Value > values)
+        {
+            {
+                std::lock_guard< std::mutex > lock(m_inputMutex);
+                m_inputData[attributeName] = std::move(values);
+
+                if (m_coalescingWindow.count() > 0)
+                {
+                    // the update is picked up by the execution already scheduled
+                    if (!m_isLogicScheduled)
+                    {
+                        m_isLogicScheduled = true;
+
+                        std::weak_ptr< LogicGuard > weakGuard = m_logicGuard;
+                        m_timer->post(m_coalescingWindow.count(), [this, weakGuard](ExpiryTimer::Id)
+                        {
+                            auto guard = weakGuard.lock();
+                            if (!guard) return;
+
+                            std::lock_guard< std::mutex > lock(guard->mutex);
+                            if (guard->isAlive) runLogic();
+                        });
+                    }
+                    return;
+                }
+            }
+
+            std::lock_guard< std::mutex > lock(m_logicGuard->mutex);
+            runLogic();
+        }
+
+        std::shared_ptr< const SoftSensorResource::InputData >
+        SoftSensorResource::getInputData() const
+        {
+            std::lock_guard< std::mutex > lock(m_inputMutex);
+            return m_inputSnapshot;
+        }
+
+        bool SoftSensorResource::hasAllInputs()
+        {
+            auto inputs = m_mapResourceProperty.find(INPUT_RESOURCE);
+            if (inputs == m_mapResourceProperty.end() || inputs->second.empty())
+            {
+                return !m_inputData.empty();
+            }
+
+            for (const auto &input : inputs->second)
+            {
+                auto name = input.find(INPUT_RESOURCE_ATTRIBUTENAME);
+                if (name != input.end() && m_inputData.find(name->second) == m_inputData.end())
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void SoftSensorResource::runLogic()
+        {
+            {
+                std::lock_guard< std::mutex > lock(m_inputMutex);
+                m_isLogicScheduled = false;
+
+                if (!hasAllInputs())
+                {
+                    return;
+                }
+                m_inputSnapshot = std::make_shared< const InputData >(m_inputData);
+            }
+
+            // one notification for all the output attributes the logic updates
+            setNotificationDeferred(true);
+            executeLogic();
+            setNotificationDeferred(false);
+        }
     }
 }
-
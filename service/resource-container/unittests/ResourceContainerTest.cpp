@@ -19,11 +19,16 @@
 //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 
 #if defined(__linux__)
+#include <dlfcn.h>
 #include <unistd.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <map>
+#include <thread>
 #include <vector>
 
 #include <UnitTestHelper.h>
@@ -34,10 +39,12 @@
 #include "Configuration.h"
 #include "BundleActivator.h"
 #include "BundleResource.h"
+#include "SoftSensorResource.h"
 #include "RCSResourceContainer.h"
 #include "ResourceContainerBundleAPI.h"
 #include "ResourceContainerImpl.h"
 #include "RemoteResourceUnit.h"
+#include "BundleRequestExecutor.h"
 
 #include "RCSResourceObject.h"
 #include "RCSRemoteResourceObject.h"
@@ -51,6 +58,7 @@ using namespace OIC::Service;
 #define MAX_PATH 2048
 
 string CONFIG_FILE = "ResourceContainerTestConfig.xml";
+string DEPENDENCY_CONFIG_FILE = "ResourceContainerDependencyTestConfig.xml";
 
 void getCurrentPath(std::string *pPath)
 {
@@ -95,6 +103,7 @@ class ResourceContainerTest: public TestWithMock
     public:
         RCSResourceContainer *m_pResourceContainer;
         std::string m_strConfigPath;
+        std::string m_strDependencyConfigPath;
 
     protected:
         void SetUp()
@@ -103,7 +112,21 @@ class ResourceContainerTest: public TestWithMock
             m_pResourceContainer = RCSResourceContainer::getInstance();
             getCurrentPath(&m_strConfigPath);
             m_strConfigPath.append("/");
+            m_strDependencyConfigPath = m_strConfigPath;
             m_strConfigPath.append(CONFIG_FILE);
+            m_strDependencyConfigPath.append(DEPENDENCY_CONFIG_FILE);
+        }
+
+        BundleInfoInternal *getListedBundle(const std::string &bundleId)
+        {
+            for (auto bundleInfo : m_pResourceContainer->listBundles())
+            {
+                if (bundleInfo->getID() == bundleId)
+                {
+                    return (BundleInfoInternal *) bundleInfo;
+                }
+            }
+            return nullptr;
         }
 };
 
@@ -147,6 +170,79 @@ TEST_F(ResourceContainerTest, BundleActivatedWhenContainerStartedWithValidConfig
     m_pResourceContainer->stopContainer();
 }
 
+TEST_F(ResourceContainerTest, StartupTimeRecordedWhenContainerStartedWithValidConfigFile)
+{
+    m_pResourceContainer->startContainer(m_strConfigPath);
+
+    auto startupTimes =
+        ((ResourceContainerImpl *) m_pResourceContainer)->getBundleStartupTimes();
+
+    ASSERT_EQ((unsigned int) 1, startupTimes.count("oic.bundle.test"));
+    EXPECT_FALSE(startupTimes["oic.bundle.test"].isLazy);
+
+    m_pResourceContainer->stopContainer();
+}
+
+TEST_F(ResourceContainerTest, DependentBundleActivatedAfterItsDependency)
+{
+    m_pResourceContainer->startContainer(m_strDependencyConfigPath);
+
+    BundleInfoInternal *bundleInfo = getListedBundle("oic.bundle.dependent");
+    ASSERT_NE(nullptr, bundleInfo);
+    EXPECT_TRUE(bundleInfo->isActivated());
+
+    typedef const std::vector< std::string > *activatedBundles_t();
+    activatedBundles_t *activatedBundles =
+        (activatedBundles_t *) dlsym(bundleInfo->getBundleHandle(), "test_activatedBundles");
+    ASSERT_NE(nullptr, activatedBundles);
+
+    // counted back from the latest activation, the test bundle may have been loaded before
+    const std::vector< std::string > &order = *activatedBundles();
+    auto activationsSince = [&order](const std::string & bundleId)
+    {
+        return (size_t) (std::find(order.rbegin(), order.rend(), bundleId) - order.rbegin());
+    };
+
+    ASSERT_LT(activationsSince("oic.bundle.test"), order.size());
+    EXPECT_GT(activationsSince("oic.bundle.test"), activationsSince("oic.bundle.dependent"));
+
+    m_pResourceContainer->stopContainer();
+}
+
+TEST_F(ResourceContainerTest, LazyBundleNotActivatedWhenContainerStarted)
+{
+    m_pResourceContainer->startContainer(m_strDependencyConfigPath);
+
+    BundleInfoInternal *bundleInfo = getListedBundle("oic.bundle.lazy");
+    ASSERT_NE(nullptr, bundleInfo);
+    EXPECT_FALSE(bundleInfo->isLoaded());
+    EXPECT_FALSE(bundleInfo->isActivated());
+    EXPECT_EQ((unsigned int) 0,
+              ((ResourceContainerImpl *) m_pResourceContainer)->getBundleStartupTimes().count(
+                  "oic.bundle.lazy"));
+
+    m_pResourceContainer->stopContainer();
+}
+
+TEST_F(ResourceContainerTest, LazyBundleActivatedWithStartBundleAPI)
+{
+    m_pResourceContainer->startContainer(m_strDependencyConfigPath);
+    m_pResourceContainer->startBundle("oic.bundle.lazy");
+
+    BundleInfoInternal *bundleInfo = getListedBundle("oic.bundle.lazy");
+    ASSERT_NE(nullptr, bundleInfo);
+    EXPECT_TRUE(bundleInfo->isLoaded());
+    EXPECT_TRUE(bundleInfo->isActivated());
+
+    auto startupTimes =
+        ((ResourceContainerImpl *) m_pResourceContainer)->getBundleStartupTimes();
+
+    ASSERT_EQ((unsigned int) 1, startupTimes.count("oic.bundle.lazy"));
+    EXPECT_TRUE(startupTimes["oic.bundle.lazy"].isLazy);
+
+    m_pResourceContainer->stopContainer();
+}
+
 TEST_F(ResourceContainerTest, BundleNotRegisteredWhenContainerStartedWithInvalidConfigFile)
 {
     m_pResourceContainer->startContainer("invalidConfig");
@@ -548,6 +644,201 @@ TEST_F(ResourceContainerImplTest, SoBundleDeactivatedWithBundleID)
 }
 
 
+/* Test for BundleRequestExecutor */
+TEST(BundleRequestExecutorTest, SubmittedHandlerRunsOnWorkerThread)
+{
+    BundleRequestExecutor executor("oic.bundle.test", 2, 8);
+
+    std::future< std::thread::id > result = executor.submit< std::thread::id >([]()
+    {
+        return std::this_thread::get_id();
+    });
+
+    ASSERT_TRUE(result.valid());
+    ASSERT_EQ(std::future_status::ready, result.wait_for(std::chrono::seconds(1)));
+    EXPECT_NE(std::this_thread::get_id(), result.get());
+    EXPECT_EQ(0ul, executor.getMetrics().rejected);
+}
+
+TEST(BundleRequestExecutorTest, HandlerRejectedWhenQueueIsFull)
+{
+    BundleRequestExecutor executor("oic.bundle.test", 1, 1);
+    std::promise< void > release;
+    std::shared_future< void > released = release.get_future().share();
+    std::promise< void > started;
+
+    std::future< int > running = executor.submit< int >([&started, released]()
+    {
+        started.set_value();
+        released.wait();
+        return 1;
+    });
+    started.get_future().wait();
+
+    std::future< int > queued = executor.submit< int >([]() { return 2; });
+    std::future< int > rejected = executor.submit< int >([]() { return 3; });
+
+    EXPECT_TRUE(queued.valid());
+    EXPECT_FALSE(rejected.valid());
+
+    release.set_value();
+    EXPECT_EQ(1, running.get());
+    EXPECT_EQ(2, queued.get());
+
+    BundleRequestExecutor::Metrics metrics = executor.getMetrics();
+    EXPECT_EQ(1ul, metrics.rejected);
+    EXPECT_EQ(1u, metrics.maxQueued);
+}
+
+/* Test for SoftSensorResource */
+class TestSoftSensorResource: public SoftSensorResource
+{
+    public:
+        TestSoftSensorResource() : m_numOfExecutions(0) { }
+
+        virtual void handleSetAttributesRequest(RCSResourceAttributes &attr)
+        {
+            BundleResource::setAttributes(attr);
+        }
+
+        virtual RCSResourceAttributes &handleGetAttributesRequest()
+        {
+            return BundleResource::getAttributes();
+        }
+
+        virtual void executeLogic()
+        {
+            int sum = 0;
+            std::shared_ptr< const InputData > inputData = getInputData();
+
+            for (const auto &input : *inputData)
+            {
+                sum += input.second.back().get< int >();
+            }
+
+            ++m_numOfExecutions;
+            setAttribute("sum", RCSResourceAttributes::Value(sum));
+            setAttribute("inputs", RCSResourceAttributes::Value((int) inputData->size()));
+        }
+
+        virtual ~TestSoftSensorResource()
+        {
+            stopLogic();
+        }
+
+        std::atomic_int m_numOfExecutions;
+};
+
+class CountingNotificationReceiver: public NotificationReceiver
+{
+    public:
+        CountingNotificationReceiver() : m_numOfNotifications(0) { }
+
+        virtual void onNotificationReceived(const std::string &)
+        {
+            ++m_numOfNotifications;
+        }
+
+        std::atomic_int m_numOfNotifications;
+};
+
+class SoftSensorResourceTest: public Test
+{
+    public:
+        std::shared_ptr< TestSoftSensorResource > m_pSoftSensor;
+        CountingNotificationReceiver m_receiver;
+
+    protected:
+        void SetUp()
+        {
+            m_pSoftSensor = std::make_shared< TestSoftSensorResource >();
+            m_pSoftSensor->m_uri = "/softsensor/test";
+            m_pSoftSensor->registerObserver(&m_receiver);
+        }
+
+        void updateInput(const std::string &attributeName, int value)
+        {
+            m_pSoftSensor->onUpdatedInputResource(attributeName,
+            { RCSResourceAttributes::Value(value) });
+        }
+};
+
+TEST_F(SoftSensorResourceTest, LogicExecutedOnEveryUpdateWithoutCoalescingWindow)
+{
+    updateInput("input1", 1);
+    updateInput("input2", 2);
+    updateInput("input1", 3);
+
+    EXPECT_EQ(3, m_pSoftSensor->m_numOfExecutions.load());
+    EXPECT_EQ(3, m_receiver.m_numOfNotifications.load());
+    EXPECT_EQ(5, m_pSoftSensor->getAttribute("sum").get< int >());
+}
+
+TEST_F(SoftSensorResourceTest, LogicExecutedOnceForUpdatesWithinCoalescingWindow)
+{
+    m_pSoftSensor->setCoalescingWindow(std::chrono::milliseconds(100));
+
+    updateInput("input1", 1);
+    updateInput("input2", 2);
+    updateInput("input1", 3);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    EXPECT_EQ(1, m_pSoftSensor->m_numOfExecutions.load());
+    EXPECT_EQ(1, m_receiver.m_numOfNotifications.load());
+    EXPECT_EQ(5, m_pSoftSensor->getAttribute("sum").get< int >());
+    EXPECT_EQ(2, m_pSoftSensor->getAttribute("inputs").get< int >());
+}
+
+TEST_F(SoftSensorResourceTest, NotificationRatePerInputFanIn)
+{
+    const int fanIns[] = { 1, 10, 100 };
+    const int numOfRounds = 20;
+    const std::chrono::milliseconds roundInterval(10);
+    const std::chrono::milliseconds windows[] = { std::chrono::milliseconds(0),
+                                                  std::chrono::milliseconds(50) };
+
+    for (auto window : windows)
+    {
+        for (int fanIn : fanIns)
+        {
+            auto softSensor = std::make_shared< TestSoftSensorResource >();
+            CountingNotificationReceiver receiver;
+            softSensor->registerObserver(&receiver);
+            softSensor->setCoalescingWindow(window);
+
+            // every input resource updates once per round
+            auto start = std::chrono::steady_clock::now();
+            for (int round = 0; round < numOfRounds; ++round)
+            {
+                for (int input = 0; input < fanIn; ++input)
+                {
+                    softSensor->onUpdatedInputResource("input" + std::to_string(input),
+                    { RCSResourceAttributes::Value(round) });
+                }
+                std::this_thread::sleep_for(roundInterval);
+            }
+            std::this_thread::sleep_for(window * 2);
+            auto elapsed = std::chrono::duration_cast< std::chrono::milliseconds >(
+                               std::chrono::steady_clock::now() - start);
+
+            RecordProperty("NotificationsForWindow" + std::to_string(window.count()) + "msFanIn"
+                           + std::to_string(fanIn), receiver.m_numOfNotifications.load());
+
+            if (window.count() == 0)
+            {
+                EXPECT_EQ(fanIn * numOfRounds, receiver.m_numOfNotifications.load());
+            }
+            else
+            {
+                EXPECT_GE(elapsed / window + 1, receiver.m_numOfNotifications.load());
+            }
+
+            softSensor.reset();
+        }
+    }
+}
+
 /* Test for Configuration */
 TEST(ConfigurationTest, ConfigFileLoadedWithValidPath)
 {
@@ -21,6 +21,11 @@
 #include "TestBundleActivator.h"
 
 TestBundleActivator *bundle;
+TestBundleActivator *dependentBundle;
+TestBundleActivator *lazyBundle;
+
+// IDs of the bundles in the order they were activated
+std::vector< std::string > activatedBundles;
 
 TestBundleActivator::TestBundleActivator()
 {
@@ -73,6 +78,7 @@ extern "C" void test_externalActivateBundle(ResourceContainerBundleAPI *resource
 {
     bundle = new TestBundleActivator();
     bundle->activateBundle(resourceContainer, bundleId);
+    activatedBundles.push_back(bundleId);
 }
 
 extern "C" void test_externalDeactivateBundle()
@@ -90,3 +96,56 @@ extern "C" void test_externalDestroyResource(BundleResource::Ptr pBundleResource
 {
     bundle->destroyResource(pBundleResource);
 }
+
+extern "C" void test_dependent_externalActivateBundle(
+    ResourceContainerBundleAPI *resourceContainer, std::string bundleId)
+{
+    dependentBundle = new TestBundleActivator();
+    dependentBundle->activateBundle(resourceContainer, bundleId);
+    activatedBundles.push_back(bundleId);
+}
+
+extern "C" void test_dependent_externalDeactivateBundle()
+{
+    dependentBundle->deactivateBundle();
+    delete dependentBundle;
+}
+
+extern "C" void test_dependent_externalCreateResource(resourceInfo resourceInfo)
+{
+    dependentBundle->createResource(resourceInfo);
+}
+
+extern "C" void test_dependent_externalDestroyResource(BundleResource::Ptr pBundleResource)
+{
+    dependentBundle->destroyResource(pBundleResource);
+}
+
+extern "C" void test_lazy_externalActivateBundle(ResourceContainerBundleAPI *resourceContainer,
+        std::string bundleId)
+{
+    lazyBundle = new TestBundleActivator();
+    lazyBundle->activateBundle(resourceContainer, bundleId);
+    activatedBundles.push_back(bundleId);
+}
+
+extern "C" void test_lazy_externalDeactivateBundle()
+{
+    lazyBundle->deactivateBundle();
+    delete lazyBundle;
+}
+
+extern "C" void test_lazy_externalCreateResource(resourceInfo resourceInfo)
+{
+    lazyBundle->createResource(resourceInfo);
+}
+
+extern "C" void test_lazy_externalDestroyResource(BundleResource::Ptr pBundleResource)
+{
+    lazyBundle->destroyResource(pBundleResource);
+}
+
+extern "C" const std::vector< std::string > *test_activatedBundles()
+{
+    return &activatedBundles;
+}
@@ -35,6 +35,17 @@ extern "C" {
 */
 OCStackResult OCRDStart();
 
+/**
+* This function creates resource /oic/rd, with the published resources recorded in a
+* storage file. The resources published before the last stop are discoverable right away
+* and replaced by what their device publishes next.
+*
+* @param storagePath Path of the storage file, which is created if it does not exist.
+*
+* @return ::OC_STACK_OK upon success, ::OC_STACK_ERROR in case of error.
+*/
+OCStackResult OCRDStartWithStorage(const char *storagePath);
+
 /**
 * Stops resource directory.
 * This function will stop the resource directory and removes all published
@@ -19,31 +19,773 @@
 //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 #include "rd_storage.h"
 
+#include <fcntl.h>
 #include <pthread.h>
+#include <stdio.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
 
 #include "payload_logging.h"
 #include "oic_malloc.h"
+#include "oic_string.h"
 
 #include "rdpayload.h"
+#include "rd_storage_file.h"
 
 #define TAG  PCF("RDStorage")
 
-pthread_mutex_t storageMutex = PTHREAD_MUTEX_INITIALIZER;
+/** Number of buckets of an index holding its first keys. */
+#define INDEX_INITIAL_BUCKETS 64
+
+/** Interval in seconds at which the reaper looks for expired resources. */
+#define REAPER_INTERVAL_SEC 1
+
+/** Number of records the storage file holds beyond twice the published resources before
+ *  it is compacted. */
+#define COMPACTION_MIN_RECORDS 1024
+
+/** Entry of an index pointing to a link of a published resource. */
+typedef struct OCRDIndexEntry
+{
+    OCRDStorePublishResources *resource;
+    /** Indexed link, NULL in the device ID index. */
+    OCLinksPayload *link;
+    /** Order in which the link was stored, a query returns the first stored link. */
+    uint64_t seq;
+    struct OCRDIndexKey *key;
+    struct OCRDIndexEntry *prev;
+    struct OCRDIndexEntry *next;
+    /** Next entry of the same published resource. */
+    struct OCRDIndexEntry *resourceNext;
+} OCRDIndexEntry;
+
+/** Key of an index with its entries in the order they were stored. */
+typedef struct OCRDIndexKey
+{
+    char *value;
+    size_t hash;
+    struct OCRDIndex *index;
+    OCRDIndexEntry *head;
+    OCRDIndexEntry *tail;
+    /** Next key in the same bucket. */
+    struct OCRDIndexKey *next;
+} OCRDIndexKey;
+
+typedef struct OCRDIndex
+{
+    OCRDIndexKey **buckets;
+    size_t bucketCount;
+    size_t keyCount;
+} OCRDIndex;
+
+// Every discovery query reads the published resources, they are only written on
+// publication and expiry.
+static pthread_rwlock_t g_storageLock = PTHREAD_RWLOCK_INITIALIZER;
 // This variable holds the published resources on the RD.
 static OCRDStorePublishResources *g_rdStorage = NULL;
+static OCRDStorePublishResources *g_rdStorageTail = NULL;
+static size_t g_publicationCount = 0;
+static uint64_t g_linkSeq = 0;
+// Earliest expiry of the published resources, 0 if none of them expires.
+static uint64_t g_nextExpiry = 0;
+
+static OCRDIndex g_rtIndex;
+static OCRDIndex g_itfIndex;
+static OCRDIndex g_diIndex;
+
+static pthread_mutex_t g_reaperMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_reaperCond;
+static pthread_t g_reaperThread;
+static bool g_reaperStarted = false;
+static bool g_reaperStop = false;
+
+// Storage file the published resources are recorded in, guarded by g_storageLock.
+static char *g_storageFilePath = NULL;
+static int g_storageFileFd = -1;
+static size_t g_storageFileRecords = 0;
 
-static void printStoragedResources(OCRDStorePublishResources *payload)
+static void printStoragedResources(OCResourceCollectionPayload *payload)
 {
     OC_LOG(DEBUG, TAG, "Print Storage Resources ... ");
-    for (OCRDStorePublishResources *temp = payload; temp; temp = temp->next)
+    OCTagsLog(DEBUG, payload->tags);
+    OCLinksLog(DEBUG, payload->setLinks);
+}
+
+static uint64_t getCurrentTimeMs()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+}
+
+static size_t hashString(const char *value)
+{
+    // FNV-1a
+    size_t hash = 2166136261u;
+    for (; *value; ++value)
+    {
+        hash = (hash ^ (unsigned char)*value) * 16777619u;
+    }
+    return hash;
+}
+
+static OCRDIndexKey *findIndexKey(const OCRDIndex *index, const char *value, size_t hash)
+{
+    if (!index->buckets)
+    {
+        return NULL;
+    }
+    for (OCRDIndexKey *key = index->buckets[hash % index->bucketCount]; key; key = key->next)
+    {
+        if (key->hash == hash && strcmp(key->value, value) == 0)
+        {
+            return key;
+        }
+    }
+    return NULL;
+}
+
+static bool growIndex(OCRDIndex *index)
+{
+    size_t bucketCount = index->buckets ? index->bucketCount * 2 : INDEX_INITIAL_BUCKETS;
+    OCRDIndexKey **buckets = (OCRDIndexKey **)OICCalloc(bucketCount, sizeof(OCRDIndexKey *));
+    if (!buckets)
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < index->bucketCount; ++i)
+    {
+        OCRDIndexKey *key = index->buckets[i];
+        while (key)
+        {
+            OCRDIndexKey *next = key->next;
+            key->next = buckets[key->hash % bucketCount];
+            buckets[key->hash % bucketCount] = key;
+            key = next;
+        }
+    }
+    OICFree(index->buckets);
+    index->buckets = buckets;
+    index->bucketCount = bucketCount;
+    return true;
+}
+
+static void removeIndexKey(OCRDIndexKey *key)
+{
+    OCRDIndex *index = key->index;
+    OCRDIndexKey **prev = &index->buckets[key->hash % index->bucketCount];
+    while (*prev != key)
+    {
+        prev = &(*prev)->next;
+    }
+    *prev = key->next;
+    --index->keyCount;
+
+    OICFree(key->value);
+    OICFree(key);
+}
+
+static bool addIndexEntry(OCRDIndex *index, const char *value, OCRDStorePublishResources *resource,
+        OCLinksPayload *link, uint64_t seq)
+{
+    size_t hash = hashString(value);
+    OCRDIndexKey *key = findIndexKey(index, value, hash);
+    if (!key)
+    {
+        if (index->keyCount >= index->bucketCount && !growIndex(index))
+        {
+            return false;
+        }
+        key = (OCRDIndexKey *)OICCalloc(1, sizeof(OCRDIndexKey));
+        if (!key)
+        {
+            return false;
+        }
+        key->value = OICStrdup(value);
+        if (!key->value)
+        {
+            OICFree(key);
+            return false;
+        }
+        key->hash = hash;
+        key->index = index;
+        key->next = index->buckets[hash % index->bucketCount];
+        index->buckets[hash % index->bucketCount] = key;
+        ++index->keyCount;
+    }
+
+    OCRDIndexEntry *entry = (OCRDIndexEntry *)OICCalloc(1, sizeof(OCRDIndexEntry));
+    if (!entry)
+    {
+        if (!key->head)
+        {
+            removeIndexKey(key);
+        }
+        return false;
+    }
+    entry->resource = resource;
+    entry->link = link;
+    entry->seq = seq;
+    entry->key = key;
+    entry->prev = key->tail;
+    if (key->tail)
+    {
+        key->tail->next = entry;
+    }
+    else
+    {
+        key->head = entry;
+    }
+    key->tail = entry;
+
+    entry->resourceNext = resource->entries;
+    resource->entries = entry;
+    return true;
+}
+
+static void removeIndexEntries(OCRDStorePublishResources *resource)
+{
+    OCRDIndexEntry *entry = resource->entries;
+    while (entry)
+    {
+        OCRDIndexEntry *next = entry->resourceNext;
+        OCRDIndexKey *key = entry->key;
+
+        if (entry->prev)
+        {
+            entry->prev->next = entry->next;
+        }
+        else
+        {
+            key->head = entry->next;
+        }
+        if (entry->next)
+        {
+            entry->next->prev = entry->prev;
+        }
+        else
+        {
+            key->tail = entry->prev;
+        }
+        if (!key->head)
+        {
+            removeIndexKey(key);
+        }
+
+        OICFree(entry);
+        entry = next;
+    }
+    resource->entries = NULL;
+}
+
+static bool addIndexEntries(OCRDStorePublishResources *resource)
+{
+    OCTagsPayload *tags = resource->publishedResource->tags;
+    if (tags->di.id[0]
+        && !addIndexEntry(&g_diIndex, (const char *)tags->di.id, resource, NULL, g_linkSeq))
+    {
+        return false;
+    }
+
+    for (OCLinksPayload *link = resource->publishedResource->setLinks; link; link = link->next)
+    {
+        // Links without resource type or interface type are never returned by a query.
+        if (!link->rt || !link->itf)
+        {
+            OC_LOG(DEBUG, TAG, "Either resource type and interface type are missing.");
+            continue;
+        }
+
+        uint64_t seq = g_linkSeq++;
+        for (OCStringLL *rt = link->rt; rt; rt = rt->next)
+        {
+            if (rt->value && !addIndexEntry(&g_rtIndex, rt->value, resource, link, seq))
+            {
+                return false;
+            }
+        }
+        for (OCStringLL *itf = link->itf; itf; itf = itf->next)
+        {
+            if (itf->value && !addIndexEntry(&g_itfIndex, itf->value, resource, link, seq))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Removes a published resource from the storage, the caller holds the write lock.
+ */
+static void deletePublishedResource(OCRDStorePublishResources *resource)
+{
+    removeIndexEntries(resource);
+
+    if (resource->prev)
+    {
+        resource->prev->next = resource->next;
+    }
+    else
+    {
+        g_rdStorage = resource->next;
+    }
+    if (resource->next)
+    {
+        resource->next->prev = resource->prev;
+    }
+    else
+    {
+        g_rdStorageTail = resource->prev;
+    }
+
+    --g_publicationCount;
+
+    OCFreeCollectionResource(resource->publishedResource);
+    OICFree(resource);
+}
+
+/**
+ * Appends a published resource to the storage, the caller holds the write lock.
+ * The resource is freed if it can not be indexed.
+ */
+static OCStackResult addPublishedResource(OCRDStorePublishResources *resource)
+{
+    resource->prev = g_rdStorageTail;
+    if (g_rdStorageTail)
+    {
+        g_rdStorageTail->next = resource;
+    }
+    else
+    {
+        g_rdStorage = resource;
+    }
+    g_rdStorageTail = resource;
+    ++g_publicationCount;
+
+    if (!addIndexEntries(resource))
+    {
+        OC_LOG(ERROR, TAG, "Failed allocating memory for the index of resources.");
+        deletePublishedResource(resource);
+        return OC_STACK_NO_MEMORY;
+    }
+
+    if (resource->expiry && (!g_nextExpiry || resource->expiry < g_nextExpiry))
+    {
+        g_nextExpiry = resource->expiry;
+    }
+    return OC_STACK_OK;
+}
+
+/**
+ * Removes the resources published by a device, the caller holds the write lock.
+ *
+ * @param restoredOnly Whether only the resources restored from the storage file are removed.
+ *
+ * @return Whether any resource was removed.
+ */
+static bool deleteDeviceResources(const unsigned char *deviceId, bool restoredOnly)
+{
+    OCRDIndexKey *key = findIndexKey(&g_diIndex, (const char *)deviceId,
+            hashString((const char *)deviceId));
+    if (!key)
+    {
+        return false;
+    }
+
+    bool deleted = false;
+    OCRDIndexEntry *entry = key->head;
+    while (entry)
+    {
+        // The key is removed along with the last resource of the device, which has no
+        // next entry.
+        OCRDIndexEntry *next = entry->next;
+        if (!restoredOnly || entry->resource->restored)
+        {
+            deletePublishedResource(entry->resource);
+            deleted = true;
+        }
+        entry = next;
+    }
+    return deleted;
+}
+
+static void deleteExpiredResources(uint64_t now)
+{
+    pthread_rwlock_rdlock(&g_storageLock);
+    bool expired = g_nextExpiry && g_nextExpiry <= now;
+    pthread_rwlock_unlock(&g_storageLock);
+    if (!expired)
+    {
+        return;
+    }
+
+    pthread_rwlock_wrlock(&g_storageLock);
+    uint64_t nextExpiry = 0;
+    OCRDStorePublishResources *resource = g_rdStorage;
+    while (resource)
+    {
+        OCRDStorePublishResources *next = resource->next;
+        if (resource->expiry && resource->expiry <= now)
+        {
+            OC_LOG_V(DEBUG, TAG, "Resources published by %s expired",
+                    resource->publishedResource->tags->di.id);
+            deletePublishedResource(resource);
+        }
+        else if (resource->expiry && (!nextExpiry || resource->expiry < nextExpiry))
+        {
+            nextExpiry = resource->expiry;
+        }
+        resource = next;
+    }
+    g_nextExpiry = nextExpiry;
+    pthread_rwlock_unlock(&g_storageLock);
+}
+
+static void *reapExpiredResources(void *arg)
+{
+    (void)arg;
+
+    pthread_mutex_lock(&g_reaperMutex);
+    while (!g_reaperStop)
+    {
+        struct timespec timeout;
+        clock_gettime(CLOCK_MONOTONIC, &timeout);
+        timeout.tv_sec += REAPER_INTERVAL_SEC;
+        pthread_cond_timedwait(&g_reaperCond, &g_reaperMutex, &timeout);
+        if (g_reaperStop)
+        {
+            break;
+        }
+
+        pthread_mutex_unlock(&g_reaperMutex);
+        deleteExpiredResources(getCurrentTimeMs());
+        pthread_mutex_lock(&g_reaperMutex);
+    }
+    pthread_mutex_unlock(&g_reaperMutex);
+    return NULL;
+}
+
+static void startReaper()
+{
+    pthread_mutex_lock(&g_reaperMutex);
+    if (!g_reaperStarted)
+    {
+        pthread_condattr_t attr;
+        pthread_condattr_init(&attr);
+        pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        pthread_cond_init(&g_reaperCond, &attr);
+        pthread_condattr_destroy(&attr);
+
+        if (pthread_create(&g_reaperThread, NULL, reapExpiredResources, NULL) == 0)
+        {
+            g_reaperStarted = true;
+        }
+        else
+        {
+            // Queries still skip the expired resources, they are only not freed.
+            OC_LOG(ERROR, TAG, "Failed starting the reaper of expired resources.");
+            pthread_cond_destroy(&g_reaperCond);
+        }
+    }
+    pthread_mutex_unlock(&g_reaperMutex);
+}
+
+static void stopReaper()
+{
+    pthread_mutex_lock(&g_reaperMutex);
+    bool started = g_reaperStarted;
+    g_reaperStop = true;
+    if (started)
+    {
+        pthread_cond_signal(&g_reaperCond);
+    }
+    pthread_mutex_unlock(&g_reaperMutex);
+
+    if (started)
+    {
+        pthread_join(g_reaperThread, NULL);
+    }
+
+    pthread_mutex_lock(&g_reaperMutex);
+    if (started)
+    {
+        pthread_cond_destroy(&g_reaperCond);
+    }
+    g_reaperStarted = false;
+    g_reaperStop = false;
+    pthread_mutex_unlock(&g_reaperMutex);
+}
+
+static uint64_t toWallClockExpiry(uint64_t expiry, uint64_t now)
+{
+    if (!expiry)
+    {
+        return 0;
+    }
+    return (uint64_t)time(NULL) + (expiry > now ? (expiry - now + 999) / 1000 : 0);
+}
+
+static bool writeAll(int fd, const uint8_t *data, size_t size)
+{
+    while (size)
+    {
+        ssize_t written = write(fd, data, size);
+        if (written < 0)
+        {
+            return false;
+        }
+        data += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+/**
+ * Replaces the storage file with one recording only the current published resources,
+ * the caller holds the write lock.
+ */
+static bool compactStorageFile()
+{
+    OCRDRecordBuffer records = { NULL, 0, 0 };
+    size_t recordCount = 0;
+    uint64_t now = getCurrentTimeMs();
+
+    bool ok = OCRDEncodeFileHeader(&records);
+    for (OCRDStorePublishResources *resource = g_rdStorage; ok && resource;
+            resource = resource->next)
+    {
+        if (resource->expiry && resource->expiry <= now)
+        {
+            continue;
+        }
+        ok = OCRDEncodePublishRecord(&records, resource->publishedResource,
+                toWallClockExpiry(resource->expiry, now));
+        ++recordCount;
+    }
+
+    // The new file replaces the old one only once it is complete.
+    size_t pathLength = strlen(g_storageFilePath) + sizeof(".tmp");
+    char *tempPath = (char *)OICMalloc(pathLength);
+    int fd = -1;
+    if (ok && tempPath)
+    {
+        snprintf(tempPath, pathLength, "%s.tmp", g_storageFilePath);
+        fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    }
+    ok = fd >= 0 && writeAll(fd, records.data, records.size) && fsync(fd) == 0;
+    if (fd >= 0)
+    {
+        ok = close(fd) == 0 && ok;
+        ok = ok && rename(tempPath, g_storageFilePath) == 0;
+        if (!ok)
+        {
+            unlink(tempPath);
+        }
+    }
+    OICFree(tempPath);
+    OCRDFreeRecordBuffer(&records);
+
+    if (!ok)
+    {
+        OC_LOG(ERROR, TAG, "Failed compacting the storage file.");
+        return false;
+    }
+
+    if (g_storageFileFd >= 0)
+    {
+        close(g_storageFileFd);
+    }
+    g_storageFileFd = open(g_storageFilePath, O_WRONLY | O_APPEND);
+    g_storageFileRecords = recordCount;
+    return g_storageFileFd >= 0;
+}
+
+/**
+ * Appends records to the storage file, the caller holds the write lock.
+ */
+static void appendToStorageFile(const OCRDRecordBuffer *records, size_t recordCount)
+{
+    if (g_storageFileFd < 0 || !records->size)
+    {
+        return;
+    }
+
+    if (!writeAll(g_storageFileFd, records->data, records->size))
+    {
+        // A partly written record is dropped when the file is opened again.
+        OC_LOG(ERROR, TAG, "Failed writing the storage file, resources are not recorded anymore.");
+        close(g_storageFileFd);
+        g_storageFileFd = -1;
+        return;
+    }
+
+    g_storageFileRecords += recordCount;
+    if (g_storageFileRecords > 2 * g_publicationCount + COMPACTION_MIN_RECORDS)
+    {
+        compactStorageFile();
+    }
+}
+
+/**
+ * Restores the published resources recorded in the storage file, the caller holds
+ * the write lock.
+ *
+ * @return Size of the valid records, with the file header.
+ */
+static size_t restoreStorageFile(const uint8_t *data, size_t size, size_t *recordCount)
+{
+    if (!OCRDCheckFileHeader(data, size))
     {
-        if (temp->publishedResource)
+        OC_LOG(ERROR, TAG, "Storage file has an unknown format, it is discarded.");
+        return 0;
+    }
+
+    uint64_t now = getCurrentTimeMs();
+    uint64_t wallClockNow = (uint64_t)time(NULL);
+    size_t offset = OC_RD_FILE_HEADER_SIZE;
+    while (offset < size)
+    {
+        OCRDRecord record;
+        size_t recordSize = OCRDDecodeRecord(data + offset, size - offset, &record);
+        if (!recordSize)
+        {
+            OC_LOG_V(ERROR, TAG, "Storage file is truncated at %lu.", (unsigned long)offset);
+            break;
+        }
+        offset += recordSize;
+        ++*recordCount;
+
+        if (record.type == OC_RD_RECORD_DELETE)
+        {
+            deleteDeviceResources(record.deviceId, false);
+            continue;
+        }
+        if (record.expiry && record.expiry <= wallClockNow)
+        {
+            OCFreeCollectionResource(record.payload);
+            continue;
+        }
+
+        OCRDStorePublishResources *resource =
+            (OCRDStorePublishResources *)OICCalloc(1, sizeof(OCRDStorePublishResources));
+        if (!resource)
         {
-            OCTagsLog(DEBUG, temp->publishedResource->tags);
-            OCLinksLog(DEBUG, temp->publishedResource->setLinks);
+            OCFreeCollectionResource(record.payload);
+            continue;
         }
+        resource->publishedResource = record.payload;
+        resource->restored = true;
+        if (record.expiry)
+        {
+            resource->expiry = now + (record.expiry - wallClockNow) * 1000;
+        }
+        addPublishedResource(resource);
+    }
+    return offset;
+}
+
+OCStackResult OCRDOpenStorageFile(const char *path)
+{
+    if (!path)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    pthread_rwlock_wrlock(&g_storageLock);
+    if (g_storageFilePath)
+    {
+        pthread_rwlock_unlock(&g_storageLock);
+        OC_LOG(ERROR, TAG, "Storage file is already open.");
+        return OC_STACK_ERROR;
+    }
+    g_storageFilePath = OICStrdup(path);
+    if (!g_storageFilePath)
+    {
+        pthread_rwlock_unlock(&g_storageLock);
+        return OC_STACK_NO_MEMORY;
+    }
+
+    // Resources published before the file was open are not recorded in it.
+    bool compact = g_rdStorage != NULL;
+    size_t validSize = 0;
+    size_t recordCount = 0;
+    struct stat fileStat;
+    int fd = open(path, O_RDONLY);
+    if (fd >= 0 && fstat(fd, &fileStat) == 0 && fileStat.st_size > 0)
+    {
+        void *data = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            validSize = restoreStorageFile((const uint8_t *)data, (size_t)fileStat.st_size,
+                    &recordCount);
+            munmap(data, (size_t)fileStat.st_size);
+        }
+        if (validSize && validSize < (size_t)fileStat.st_size)
+        {
+            compact = true;
+        }
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    OC_LOG_V(DEBUG, TAG, "Restored %lu published resources from %lu records.",
+            (unsigned long)g_publicationCount, (unsigned long)recordCount);
+
+    bool opened;
+    if (validSize && !compact)
+    {
+        g_storageFileFd = open(path, O_WRONLY | O_APPEND);
+        g_storageFileRecords = recordCount;
+        opened = g_storageFileFd >= 0;
+    }
+    else
+    {
+        opened = compactStorageFile();
+    }
+    if (!opened)
+    {
+        OICFree(g_storageFilePath);
+        g_storageFilePath = NULL;
+    }
+    bool expires = g_nextExpiry != 0;
+    pthread_rwlock_unlock(&g_storageLock);
+
+    if (expires)
+    {
+        startReaper();
     }
+    return opened ? OC_STACK_OK : OC_STACK_ERROR;
+}
+
+/**
+ * Compacts and closes the storage file, the caller holds the write lock.
+ */
+static void closeStorageFile()
+{
+    if (!g_storageFilePath)
+    {
+        return;
+    }
+
+    // The next start only reads the current resources.
+    if (g_storageFileFd >= 0)
+    {
+        compactStorageFile();
+    }
+    if (g_storageFileFd >= 0)
+    {
+        close(g_storageFileFd);
+        g_storageFileFd = -1;
+    }
+    OICFree(g_storageFilePath);
+    g_storageFilePath = NULL;
+    g_storageFileRecords = 0;
 }
 
 OCStackResult OCRDStorePublishedResources(const OCResourceCollectionPayload *payload)
@@ -67,36 +809,18 @@ OCStackResult OCRDStorePublishedResources(const OCResourceCollectionPayload *pay
         return OC_STACK_NO_MEMORY;
     }
 
+    OCLinksPayload **tail = &storeResource->setLinks;
     for (OCLinksPayload *links = payload->setLinks; links; links = links->next)
     {
-        if (!storeResource->setLinks)
+        *tail = OCCopyLinksResources(links->href, links->rt, links->itf, links->rel,
+            links->obs, links->title, links->uri, links->ins, links->mt);
+        if (!*tail)
         {
-            storeResource->setLinks = OCCopyLinksResources(links->href, links->rt, links->itf,
-                links->rel, links->obs, links->title, links->uri, links->ins, links->mt);
-            if (!storeResource->setLinks)
-            {
-                OC_LOG(ERROR, TAG, "Failed allocating memory for links.");
-                OCFreeCollectionResource(storeResource);
-                return OC_STACK_NO_MEMORY;
-            }
+            OC_LOG(ERROR, TAG, "Failed allocating memory for links.");
+            OCFreeCollectionResource(storeResource);
+            return OC_STACK_NO_MEMORY;
         }
-        else
-        {
-            OCLinksPayload *temp = storeResource->setLinks;
-            while (temp->next)
-            {
-                temp = temp->next;
-            }
-            temp->next = OCCopyLinksResources(links->href, links->rt, links->itf, links->rel,
-                links->obs, links->title, links->uri, links->ins, links->mt);
-            if (!temp->next)
-            {
-                OC_LOG(ERROR, TAG, "Failed allocating memory for links.");
-                OCFreeCollectionResource(storeResource);
-                return OC_STACK_NO_MEMORY;
-            }
-        }
-
+        tail = &(*tail)->next;
     }
     storeResource->next = NULL;
     OCRDStorePublishResources *resources = (OCRDStorePublishResources *)OICCalloc(1, sizeof(OCRDStorePublishResources));
@@ -106,27 +830,134 @@ OCStackResult OCRDStorePublishedResources(const OCResourceCollectionPayload *pay
         return OC_STACK_NO_MEMORY;
     }
     resources->publishedResource = storeResource;
+    uint64_t now = getCurrentTimeMs();
+    if (tags->ttl)
+    {
+        resources->expiry = now + (uint64_t)tags->ttl * 1000;
+    }
 
-    pthread_mutex_lock(&storageMutex);
-    if (g_rdStorage)
+    printStoragedResources(storeResource);
+
+    pthread_rwlock_wrlock(&g_storageLock);
+    // A device publishing again replaces what it published before the restart.
+    bool reconciled = tags->di.id[0] && deleteDeviceResources(tags->di.id, true);
+
+    OCStackResult result = addPublishedResource(resources);
+    if (result == OC_STACK_OK && g_storageFileFd >= 0)
     {
-        OCRDStorePublishResources *temp = g_rdStorage;
-        while (temp->next)
+        OCRDRecordBuffer records = { NULL, 0, 0 };
+        bool encoded = (!reconciled || OCRDEncodeDeleteRecord(&records, tags->di.id))
+            && OCRDEncodePublishRecord(&records, storeResource,
+                    toWallClockExpiry(resources->expiry, now));
+        if (encoded)
+        {
+            appendToStorageFile(&records, reconciled ? 2 : 1);
+        }
+        else
         {
-            temp = temp->next;
+            OC_LOG(ERROR, TAG, "Failed allocating memory for the storage file record.");
         }
-        temp->next = resources;
+        OCRDFreeRecordBuffer(&records);
     }
-    else
+    bool expires = result == OC_STACK_OK && resources->expiry;
+    pthread_rwlock_unlock(&g_storageLock);
+
+    if (expires)
+    {
+        startReaper();
+    }
+    return result;
+}
+
+OCStackResult OCRDDeletePublishedResources(const unsigned char *deviceId)
+{
+    if (!deviceId || !deviceId[0])
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    pthread_rwlock_wrlock(&g_storageLock);
+    bool deleted = deleteDeviceResources(deviceId, false);
+    if (deleted && g_storageFileFd >= 0)
     {
-        g_rdStorage = resources;
+        OCRDRecordBuffer records = { NULL, 0, 0 };
+        if (OCRDEncodeDeleteRecord(&records, deviceId))
+        {
+            appendToStorageFile(&records, 1);
+        }
+        OCRDFreeRecordBuffer(&records);
     }
-    pthread_mutex_unlock(&storageMutex);
+    pthread_rwlock_unlock(&g_storageLock);
+
+    return deleted ? OC_STACK_OK : OC_STACK_NO_RESOURCE;
+}
 
-    printStoragedResources(g_rdStorage);
+void OCRDDeleteAllPublishedResources()
+{
+    stopReaper();
+
+    pthread_rwlock_wrlock(&g_storageLock);
+    closeStorageFile();
+    while (g_rdStorage)
+    {
+        deletePublishedResource(g_rdStorage);
+    }
+    OCRDIndex *indexes[] = { &g_rtIndex, &g_itfIndex, &g_diIndex };
+    for (size_t i = 0; i < sizeof(indexes) / sizeof(indexes[0]); ++i)
+    {
+        OICFree(indexes[i]->buckets);
+        memset(indexes[i], 0, sizeof(OCRDIndex));
+    }
+    g_linkSeq = 0;
+    g_nextExpiry = 0;
+    pthread_rwlock_unlock(&g_storageLock);
+}
+
+static OCStackResult copyPublishedLink(const OCRDStorePublishResources *resource,
+        const OCLinksPayload *tLinks, const char *href, OCResourceCollectionPayload **payload)
+{
+    OCTagsPayload *tag = resource->publishedResource->tags;
+    OCTagsPayload *tags = OCCopyTagsResources(tag->n.deviceName, tag->di.id, tag->baseURI,
+        tag->bitmap, tag->port, tag->ins, tag->rts, tag->drel, tag->ttl);
+    if (!tags)
+    {
+        return OC_STACK_NO_MEMORY;
+    }
+    OCLinksPayload *links = OCCopyLinksResources(href, tLinks->rt, tLinks->itf,
+        tLinks->rel, tLinks->obs, tLinks->title, tLinks->uri, tLinks->ins, tLinks->mt);
+    if (!links)
+    {
+        OCFreeTagsResource(tags);
+        return OC_STACK_NO_MEMORY;
+    }
+    *payload = OCCopyCollectionResource(tags, links);
+    if (!*payload)
+    {
+        OCFreeTagsResource(tags);
+        OCFreeLinksResource(links);
+        return OC_STACK_NO_MEMORY;
+    }
     return OC_STACK_OK;
 }
 
+static const OCRDIndexEntry *findFirstEntry(const OCRDIndex *index, const char *value, uint64_t now)
+{
+    OCRDIndexKey *key = findIndexKey(index, value, hashString(value));
+    if (!key)
+    {
+        return NULL;
+    }
+    // Expired resources may not have been reaped yet.
+    for (const OCRDIndexEntry *entry = key->head; entry; entry = entry->next)
+    {
+        if (!entry->resource->expiry || entry->resource->expiry > now)
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
 OCStackResult OCRDCheckPublishedResource(const char *interfaceType, const char *resourceType,
         OCResourceCollectionPayload **payload)
 {
@@ -139,92 +970,30 @@ OCStackResult OCRDCheckPublishedResource(const char *interfaceType, const char *
     }
 
     OC_LOG(DEBUG, TAG, "Check Resource in RD");
-    if (g_rdStorage && g_rdStorage->publishedResource)
+    uint64_t now = getCurrentTimeMs();
+    OCStackResult result = OC_STACK_ERROR;
+
+    pthread_rwlock_rdlock(&g_storageLock);
+    const OCRDIndexEntry *rtEntry = resourceType ?
+        findFirstEntry(&g_rtIndex, resourceType, now) : NULL;
+    const OCRDIndexEntry *itfEntry = interfaceType ?
+        findFirstEntry(&g_itfIndex, interfaceType, now) : NULL;
+
+    // The first stored link matching either type is returned, the resource type of
+    // a link is matched before its interface type.
+    if (rtEntry && (!itfEntry || rtEntry->seq <= itfEntry->seq))
     {
-        for (OCRDStorePublishResources *pResource = g_rdStorage;
-                pResource; pResource = pResource->next)
-        {
-            if (pResource->publishedResource->setLinks)
-            {
-                for (OCLinksPayload *tLinks = pResource->publishedResource->setLinks; tLinks; tLinks = tLinks->next)
-                {
-                    // If either rt or itf are NULL, it should skip remaining code execution.
-                    if (!tLinks->rt || !tLinks->itf)
-                    {
-                        OC_LOG(DEBUG, TAG, "Either resource type and interface type are missing.");
-                        continue;
-                    }
-                    if (resourceType)
-                    {
-                        OCStringLL *temp = tLinks->rt;
-                        while(temp)
-                        {
-                            OC_LOG_V(DEBUG, TAG, "Resource Type: %s %s", resourceType, temp->value);
-                            if (strcmp(resourceType, temp->value) == 0)
-                            {
-                                OCTagsPayload *tag = pResource->publishedResource->tags;
-                                OCTagsPayload *tags = OCCopyTagsResources(tag->n.deviceName, tag->di.id, tag->baseURI,
-                                    tag->bitmap, tag->port, tag->ins, tag->rts, tag->drel, tag->ttl);
-                                if (!tags)
-                                {
-                                    return OC_STACK_NO_MEMORY;
-                                }
-                                OCLinksPayload *links = OCCopyLinksResources(tLinks->href, tLinks->rt, tLinks->itf,
-                                    tLinks->rel, tLinks->obs, tLinks->title, tLinks->uri, tLinks->ins, tLinks->mt);
-                                if (!links)
-                                {
-                                    OCFreeTagsResource(tags);
-                                    return OC_STACK_NO_MEMORY;
-                                }
-                                *payload = OCCopyCollectionResource(tags, links);
-                                if (!*payload)
-                                {
-                                    OCFreeTagsResource(tags);
-                                    OCFreeLinksResource(links);
-                                    return OC_STACK_NO_MEMORY;
-                                }
-                                return OC_STACK_OK;
-                            }
-                            temp = temp->next;
-                        }
-                    }
-                    if (interfaceType)
-                    {
-                        OCStringLL *temp = tLinks->itf;
-                        while (temp)
-                        {
-                            OC_LOG_V(DEBUG, TAG, "Interface Type: %s %s", interfaceType, temp->value);
-                            if (strcmp(interfaceType, temp->value) == 0)
-                            {
-                                OCTagsPayload *tag = pResource->publishedResource->tags;
-                                OCTagsPayload *tags = OCCopyTagsResources(tag->n.deviceName, tag->di.id, tag->baseURI,
-                                    tag->bitmap, tag->port, tag->ins, tag->rts, tag->drel, tag->ttl);
-                                if (!tags)
-                                {
-                                    return OC_STACK_NO_MEMORY;
-                                }
-                                OCLinksPayload *links = OCCopyLinksResources(tLinks->uri, tLinks->rt, tLinks->itf,
-                                    tLinks->rel, tLinks->obs, tLinks->title, tLinks->uri, tLinks->ins, tLinks->mt);
-                                if (!links)
-                                {
-                                    OCFreeTagsResource(tags);
-                                    return OC_STACK_NO_MEMORY;
-                                }
-                                *payload = OCCopyCollectionResource(tags, links);
-                                if (!*payload)
-                                {
-                                    OCFreeTagsResource(tags);
-                                    OCFreeLinksResource(links);
-                                    return OC_STACK_NO_MEMORY;
-                                }
-                                return OC_STACK_OK;
-                            }
-                            temp = temp->next;
-                        }
-                    }
-                }
-            }
-        }
+        OC_LOG_V(DEBUG, TAG, "Resource Type: %s", resourceType);
+        result = copyPublishedLink(rtEntry->resource, rtEntry->link, rtEntry->link->href,
+                payload);
     }
-    return OC_STACK_ERROR;
+    else if (itfEntry)
+    {
+        OC_LOG_V(DEBUG, TAG, "Interface Type: %s", interfaceType);
+        result = copyPublishedLink(itfEntry->resource, itfEntry->link, itfEntry->link->uri,
+                payload);
+    }
+    pthread_rwlock_unlock(&g_storageLock);
+
+    return result;
 }
@@ -31,6 +31,14 @@ typedef struct OCRDStorePublishResources
 {
     /** Publish resource. */
     OCResourceCollectionPayload *publishedResource;
+    /** Monotonic time in milliseconds at which the resource expires, 0 if it never does. */
+    uint64_t expiry;
+    /** Restored from the storage file and not published again since. */
+    bool restored;
+    /** Index entries pointing to the links of this published resource. */
+    struct OCRDIndexEntry *entries;
+    /** Linked list pointing to previous published resource. */
+    struct OCRDStorePublishResources *prev;
     /** Linked list pointing to next published resource. */
     struct OCRDStorePublishResources *next;
 } OCRDStorePublishResources;
@@ -44,6 +52,34 @@ typedef struct OCRDStorePublishResources
  */
 OCStackResult OCRDStorePublishedResources(const OCResourceCollectionPayload *payload);
 
+/**
+ * Removes the resources published by a device.
+ *
+ * @param deviceId Device ID in the tags of the published resources.
+ *
+ * @return ::OC_STACK_OK upon success, ::OC_STACK_NO_RESOURCE if the device has not
+ * published any resource.
+ */
+OCStackResult OCRDDeletePublishedResources(const unsigned char *deviceId);
+
+/**
+ * Restores the resources published before the last stop from a storage file, and
+ * keeps recording the published resources in it.
+ * Restored resources are replaced by the resources their device publishes next.
+ *
+ * @param path Path of the storage file, which is created if it does not exist.
+ *
+ * @return ::OC_STACK_OK upon success, ::OC_STACK_ERROR if a storage file is already open
+ * or the file can not be written.
+ */
+OCStackResult OCRDOpenStorageFile(const char *path);
+
+/**
+ * Removes all the published resources and stops the expiry of resources.
+ * The storage file, if open, is compacted and closed; it keeps the resources.
+ */
+void OCRDDeleteAllPublishedResources();
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
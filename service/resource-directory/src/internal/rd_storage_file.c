@@ -0,0 +1,433 @@
+//******************************************************************
+//
+// Copyright 2015 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+#include "rd_storage_file.h"
+
+#include <string.h>
+
+#include "oic_malloc.h"
+#include "oic_string.h"
+
+#include "rdpayload.h"
+
+#define TAG  PCF("RDStorageFile")
+
+/** Encoded length of a NULL string. */
+#define NULL_STRING_LENGTH UINT32_MAX
+
+/** Type and body length. */
+#define RECORD_HEADER_SIZE 5
+#define RECORD_CHECKSUM_SIZE 4
+
+typedef struct
+{
+    const uint8_t *data;
+    size_t size;
+    size_t offset;
+} OCRDRecordReader;
+
+static uint32_t checksum(const uint8_t *data, size_t size)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static bool reserve(OCRDRecordBuffer *buffer, size_t size)
+{
+    if (buffer->size + size <= buffer->capacity)
+    {
+        return true;
+    }
+
+    size_t capacity = buffer->capacity ? buffer->capacity : 256;
+    while (capacity < buffer->size + size)
+    {
+        capacity *= 2;
+    }
+    uint8_t *data = (uint8_t *)OICRealloc(buffer->data, capacity);
+    if (!data)
+    {
+        return false;
+    }
+    buffer->data = data;
+    buffer->capacity = capacity;
+    return true;
+}
+
+static bool putUint(OCRDRecordBuffer *buffer, uint64_t value, size_t size)
+{
+    if (!reserve(buffer, size))
+    {
+        return false;
+    }
+    for (size_t i = 0; i < size; ++i)
+    {
+        buffer->data[buffer->size++] = (uint8_t)(value >> (8 * i));
+    }
+    return true;
+}
+
+static void setUint32(uint8_t *data, uint32_t value)
+{
+    for (size_t i = 0; i < 4; ++i)
+    {
+        data[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static bool putString(OCRDRecordBuffer *buffer, const char *value)
+{
+    if (!value)
+    {
+        return putUint(buffer, NULL_STRING_LENGTH, 4);
+    }
+
+    size_t length = strlen(value);
+    if (!putUint(buffer, length, 4) || !reserve(buffer, length))
+    {
+        return false;
+    }
+    memcpy(buffer->data + buffer->size, value, length);
+    buffer->size += length;
+    return true;
+}
+
+static bool putStringLL(OCRDRecordBuffer *buffer, const OCStringLL *values)
+{
+    uint32_t count = 0;
+    for (const OCStringLL *value = values; value; value = value->next)
+    {
+        ++count;
+    }
+    if (!putUint(buffer, count, 4))
+    {
+        return false;
+    }
+    for (const OCStringLL *value = values; value; value = value->next)
+    {
+        if (!putString(buffer, value->value))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static size_t beginRecord(OCRDRecordBuffer *buffer, OCRDRecordType type)
+{
+    if (!putUint(buffer, type, 1) || !putUint(buffer, 0, 4))
+    {
+        return 0;
+    }
+    return buffer->size;
+}
+
+static bool endRecord(OCRDRecordBuffer *buffer, size_t bodyOffset)
+{
+    size_t bodySize = buffer->size - bodyOffset;
+    setUint32(buffer->data + bodyOffset - 4, (uint32_t)bodySize);
+    return putUint(buffer, checksum(buffer->data + bodyOffset, bodySize), RECORD_CHECKSUM_SIZE);
+}
+
+bool OCRDEncodeFileHeader(OCRDRecordBuffer *buffer)
+{
+    if (!reserve(buffer, OC_RD_FILE_HEADER_SIZE))
+    {
+        return false;
+    }
+    memcpy(buffer->data + buffer->size, OC_RD_FILE_MAGIC, 4);
+    buffer->size += 4;
+    return putUint(buffer, OC_RD_FILE_VERSION, 4);
+}
+
+bool OCRDCheckFileHeader(const uint8_t *data, size_t size)
+{
+    return size >= OC_RD_FILE_HEADER_SIZE && memcmp(data, OC_RD_FILE_MAGIC, 4) == 0
+        && data[4] == OC_RD_FILE_VERSION && !data[5] && !data[6] && !data[7];
+}
+
+bool OCRDEncodePublishRecord(OCRDRecordBuffer *buffer, const OCResourceCollectionPayload *payload,
+        uint64_t expiry)
+{
+    size_t size = buffer->size;
+    size_t bodyOffset = beginRecord(buffer, OC_RD_RECORD_PUBLISH);
+    const OCTagsPayload *tags = payload->tags;
+
+    bool ok = bodyOffset
+        && putUint(buffer, expiry, 8)
+        && putString(buffer, tags->n.deviceName)
+        && putString(buffer, (const char *)tags->di.id)
+        && putString(buffer, tags->baseURI)
+        && putUint(buffer, tags->bitmap, 1)
+        && putUint(buffer, tags->port, 2)
+        && putUint(buffer, tags->ins, 1)
+        && putString(buffer, tags->rts)
+        && putString(buffer, tags->drel)
+        && putUint(buffer, tags->ttl, 4);
+
+    uint32_t count = 0;
+    for (const OCLinksPayload *link = payload->setLinks; link; link = link->next)
+    {
+        ++count;
+    }
+    ok = ok && putUint(buffer, count, 4);
+
+    for (const OCLinksPayload *link = payload->setLinks; ok && link; link = link->next)
+    {
+        ok = putString(buffer, link->href)
+            && putStringLL(buffer, link->rt)
+            && putStringLL(buffer, link->itf)
+            && putString(buffer, link->rel)
+            && putUint(buffer, link->obs, 1)
+            && putString(buffer, link->title)
+            && putString(buffer, link->uri)
+            && putUint(buffer, link->ins, 1)
+            && putStringLL(buffer, link->mt);
+    }
+
+    if (!ok || !endRecord(buffer, bodyOffset))
+    {
+        buffer->size = size;
+        return false;
+    }
+    return true;
+}
+
+bool OCRDEncodeDeleteRecord(OCRDRecordBuffer *buffer, const unsigned char *deviceId)
+{
+    size_t size = buffer->size;
+    size_t bodyOffset = beginRecord(buffer, OC_RD_RECORD_DELETE);
+    if (!bodyOffset || !putString(buffer, (const char *)deviceId)
+        || !endRecord(buffer, bodyOffset))
+    {
+        buffer->size = size;
+        return false;
+    }
+    return true;
+}
+
+static bool getUint(OCRDRecordReader *reader, size_t size, uint64_t *value)
+{
+    if (reader->size - reader->offset < size)
+    {
+        return false;
+    }
+    *value = 0;
+    for (size_t i = 0; i < size; ++i)
+    {
+        *value |= (uint64_t)reader->data[reader->offset++] << (8 * i);
+    }
+    return true;
+}
+
+static bool getUint8(OCRDRecordReader *reader, uint8_t *value)
+{
+    uint64_t temp;
+    if (!getUint(reader, 1, &temp))
+    {
+        return false;
+    }
+    *value = (uint8_t)temp;
+    return true;
+}
+
+static bool getString(OCRDRecordReader *reader, char **value)
+{
+    uint64_t length;
+    if (!getUint(reader, 4, &length))
+    {
+        return false;
+    }
+    if (length == NULL_STRING_LENGTH)
+    {
+        *value = NULL;
+        return true;
+    }
+    if (reader->size - reader->offset < length)
+    {
+        return false;
+    }
+
+    *value = (char *)OICMalloc(length + 1);
+    if (!*value)
+    {
+        return false;
+    }
+    memcpy(*value, reader->data + reader->offset, length);
+    (*value)[length] = '\0';
+    reader->offset += length;
+    return true;
+}
+
+/** The values decoded so far are in the list even on failure. */
+static bool getStringLL(OCRDRecordReader *reader, OCStringLL **values)
+{
+    uint64_t count;
+    if (!getUint(reader, 4, &count))
+    {
+        return false;
+    }
+
+    OCStringLL **tail = values;
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        *tail = (OCStringLL *)OICCalloc(1, sizeof(OCStringLL));
+        if (!*tail || !getString(reader, &(*tail)->value))
+        {
+            return false;
+        }
+        tail = &(*tail)->next;
+    }
+    return true;
+}
+
+static OCResourceCollectionPayload *getPublishedResources(OCRDRecordReader *reader,
+        uint64_t *expiry)
+{
+    OCResourceCollectionPayload *payload =
+        (OCResourceCollectionPayload *)OICCalloc(1, sizeof(OCResourceCollectionPayload));
+    if (!payload)
+    {
+        return NULL;
+    }
+    payload->tags = (OCTagsPayload *)OICCalloc(1, sizeof(OCTagsPayload));
+    if (!payload->tags)
+    {
+        OICFree(payload);
+        return NULL;
+    }
+
+    OCTagsPayload *tags = payload->tags;
+    char *deviceId = NULL;
+    uint64_t port, ttl, count;
+    bool ok = getUint(reader, 8, expiry)
+        && getString(reader, &tags->n.deviceName)
+        && getString(reader, &deviceId)
+        && getString(reader, &tags->baseURI)
+        && getUint8(reader, &tags->bitmap)
+        && getUint(reader, 2, &port)
+        && getUint8(reader, &tags->ins)
+        && getString(reader, &tags->rts)
+        && getString(reader, &tags->drel)
+        && getUint(reader, 4, &ttl)
+        && getUint(reader, 4, &count);
+    if (ok)
+    {
+        tags->port = (uint16_t)port;
+        tags->ttl = (uint32_t)ttl;
+        if (deviceId)
+        {
+            OICStrcpy((char *)tags->di.id, MAX_IDENTITY_SIZE, deviceId);
+        }
+    }
+    OICFree(deviceId);
+
+    OCLinksPayload **tail = &payload->setLinks;
+    for (uint64_t i = 0; ok && i < count; ++i)
+    {
+        *tail = (OCLinksPayload *)OICCalloc(1, sizeof(OCLinksPayload));
+        if (!*tail)
+        {
+            ok = false;
+            break;
+        }
+
+        OCLinksPayload *link = *tail;
+        uint8_t obs;
+        ok = getString(reader, &link->href)
+            && getStringLL(reader, &link->rt)
+            && getStringLL(reader, &link->itf)
+            && getString(reader, &link->rel)
+            && getUint8(reader, &obs)
+            && getString(reader, &link->title)
+            && getString(reader, &link->uri)
+            && getUint8(reader, &link->ins)
+            && getStringLL(reader, &link->mt);
+        link->obs = ok && obs;
+        tail = &link->next;
+    }
+
+    if (!ok)
+    {
+        OCFreeCollectionResource(payload);
+        return NULL;
+    }
+    return payload;
+}
+
+size_t OCRDDecodeRecord(const uint8_t *data, size_t size, OCRDRecord *record)
+{
+    OCRDRecordReader header = { data, size, 0 };
+    uint64_t type, bodySize, expectedChecksum;
+    if (!getUint(&header, 1, &type) || !getUint(&header, 4, &bodySize)
+        || size - RECORD_HEADER_SIZE < bodySize + RECORD_CHECKSUM_SIZE)
+    {
+        return 0;
+    }
+
+    const uint8_t *body = data + RECORD_HEADER_SIZE;
+    OCRDRecordReader trailer = { body + bodySize, RECORD_CHECKSUM_SIZE, 0 };
+    getUint(&trailer, RECORD_CHECKSUM_SIZE, &expectedChecksum);
+    if (checksum(body, bodySize) != expectedChecksum)
+    {
+        OC_LOG(ERROR, TAG, "Checksum of record does not match.");
+        return 0;
+    }
+
+    memset(record, 0, sizeof(OCRDRecord));
+    OCRDRecordReader reader = { body, bodySize, 0 };
+    if (type == OC_RD_RECORD_PUBLISH)
+    {
+        record->payload = getPublishedResources(&reader, &record->expiry);
+        if (!record->payload)
+        {
+            return 0;
+        }
+    }
+    else if (type == OC_RD_RECORD_DELETE)
+    {
+        char *deviceId = NULL;
+        if (!getString(&reader, &deviceId) || !deviceId)
+        {
+            OICFree(deviceId);
+            return 0;
+        }
+        OICStrcpy((char *)record->deviceId, MAX_IDENTITY_SIZE, deviceId);
+        OICFree(deviceId);
+    }
+    else
+    {
+        OC_LOG_V(ERROR, TAG, "Unknown record type %d.", (int)type);
+        return 0;
+    }
+    record->type = (OCRDRecordType)type;
+
+    return RECORD_HEADER_SIZE + bodySize + RECORD_CHECKSUM_SIZE;
+}
+
+void OCRDFreeRecordBuffer(OCRDRecordBuffer *buffer)
+{
+    OICFree(buffer->data);
+    memset(buffer, 0, sizeof(OCRDRecordBuffer));
+}
@@ -0,0 +1,120 @@
+//******************************************************************
+//
+// Copyright 2015 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#ifndef _RESOURCE_DIRECTORY_STORAGE_FILE_H_
+#define _RESOURCE_DIRECTORY_STORAGE_FILE_H_
+
+#include "octypes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+/**
+ * The storage file starts with a header followed by records, each of which is a type,
+ * the length of its body, the body and a checksum of the body. All integers are
+ * little endian.
+ */
+#define OC_RD_FILE_MAGIC "OCRD"
+#define OC_RD_FILE_VERSION 1
+/** Magic and version. */
+#define OC_RD_FILE_HEADER_SIZE 8
+
+/** Type of a record of the storage file. */
+typedef enum
+{
+    /** Resources published by a device. */
+    OC_RD_RECORD_PUBLISH = 1,
+    /** Removal of all resources published by a device. */
+    OC_RD_RECORD_DELETE = 2
+} OCRDRecordType;
+
+/** Buffer holding encoded records. */
+typedef struct
+{
+    uint8_t *data;
+    size_t size;
+    size_t capacity;
+} OCRDRecordBuffer;
+
+/** Decoded record of the storage file. */
+typedef struct
+{
+    OCRDRecordType type;
+    /** Published resources of a ::OC_RD_RECORD_PUBLISH record. */
+    OCResourceCollectionPayload *payload;
+    /** Wall clock time in seconds at which the resources expire, 0 if they never do. */
+    uint64_t expiry;
+    /** Device of a ::OC_RD_RECORD_DELETE record. */
+    unsigned char deviceId[MAX_IDENTITY_SIZE];
+} OCRDRecord;
+
+/**
+ * Appends the file header to a buffer.
+ *
+ * @return true upon success, false if the buffer could not grow.
+ */
+bool OCRDEncodeFileHeader(OCRDRecordBuffer *buffer);
+
+/**
+ * Checks the header of a storage file.
+ *
+ * @return true if the data starts with a header of the current version.
+ */
+bool OCRDCheckFileHeader(const uint8_t *data, size_t size);
+
+/**
+ * Appends a record of published resources to a buffer.
+ *
+ * @param buffer Buffer to append to.
+ * @param payload Published resources.
+ * @param expiry Wall clock time in seconds at which the resources expire, 0 if never.
+ *
+ * @return true upon success, false if the buffer could not grow.
+ */
+bool OCRDEncodePublishRecord(OCRDRecordBuffer *buffer, const OCResourceCollectionPayload *payload,
+        uint64_t expiry);
+
+/**
+ * Appends a record removing the resources published by a device to a buffer.
+ *
+ * @return true upon success, false if the buffer could not grow.
+ */
+bool OCRDEncodeDeleteRecord(OCRDRecordBuffer *buffer, const unsigned char *deviceId);
+
+/**
+ * Decodes the record at the beginning of the data.
+ *
+ * @param data Encoded records.
+ * @param size Size of the data.
+ * @param record Decoded record, the caller owns its payload.
+ *
+ * @return Size of the decoded record, 0 if the data does not start with a complete
+ * and valid record or memory could not be allocated.
+ */
+size_t OCRDDecodeRecord(const uint8_t *data, size_t size, OCRDRecord *record);
+
+void OCRDFreeRecordBuffer(OCRDRecordBuffer *buffer);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif //_RESOURCE_DIRECTORY_STORAGE_FILE_H_
@@ -185,6 +185,26 @@ OCStackResult OCRDStart()
     return result;
 }
 
+/**
+ * Registers RD resource with a storage file
+ */
+OCStackResult OCRDStartWithStorage(const char *storagePath)
+{
+    OCStackResult result = OCRDOpenStorageFile(storagePath);
+    if (result != OC_STACK_OK)
+    {
+        OC_LOG(ERROR, TAG, "Failed opening the storage file of Resource Directory.");
+        return result;
+    }
+
+    result = OCRDStart();
+    if (result != OC_STACK_OK)
+    {
+        OCRDDeleteAllPublishedResources();
+    }
+    return result;
+}
+
 /**
  * Stops resource directory server
  */
@@ -192,6 +212,8 @@ OCStackResult OCRDStop()
 {
     OCStackResult result = OCStop();
 
+    OCRDDeleteAllPublishedResources();
+
     if (result == OC_STACK_OK)
     {
         OC_LOG(DEBUG, TAG, "Resource Directory Stopped.");
@@ -0,0 +1,325 @@
+//******************************************************************
+//
+// Copyright 2015 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "rd_server.h"
+#include "rd_storage.h"
+
+#include "ocpayload.h"
+#include "rdpayload.h"
+#include "oic_malloc.h"
+#include "oic_string.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr char STORAGE_FILE_PATH[]{ "RDStorageTest.dat" };
+
+    OCStringLL *createStringLL(const std::string &value)
+    {
+        OCStringLL *stringLL = (OCStringLL *)OICCalloc(1, sizeof(OCStringLL));
+        stringLL->value = OICStrdup(value.c_str());
+        return stringLL;
+    }
+
+    OCLinksPayload *createLink(const std::string &href, const std::string &rt,
+            const std::string &itf)
+    {
+        OCStringLL *rts = createStringLL(rt);
+        OCStringLL *itfs = createStringLL(itf);
+        OCLinksPayload *link = OCCopyLinksResources(href.c_str(), rts, itfs, NULL, false,
+                NULL, NULL, 0, NULL);
+        OCFreeOCStringLL(rts);
+        OCFreeOCStringLL(itfs);
+        return link;
+    }
+
+    OCResourceCollectionPayload *createPublication(const std::string &deviceId,
+            OCLinksPayload *links, uint32_t ttl)
+    {
+        OCTagsPayload *tags = OCCopyTagsResources("device",
+                (const unsigned char *)deviceId.c_str(), NULL, 0, 0, 0, NULL, NULL, ttl);
+        return OCCopyCollectionResource(tags, links);
+    }
+
+    OCStackResult publish(const std::string &deviceId, OCLinksPayload *links, uint32_t ttl = 0)
+    {
+        OCResourceCollectionPayload *payload = createPublication(deviceId, links, ttl);
+        OCStackResult result = OCRDStorePublishedResources(payload);
+        OCFreeCollectionResource(payload);
+        return result;
+    }
+
+    std::string findHref(const char *interfaceType, const char *resourceType)
+    {
+        OCResourceCollectionPayload *payload = NULL;
+        if (OCRDCheckPublishedResource(interfaceType, resourceType, &payload) != OC_STACK_OK)
+        {
+            return "";
+        }
+        std::string href = payload->setLinks->href ? payload->setLinks->href : "";
+        OCFreeCollectionResource(payload);
+        return href;
+    }
+}
+
+class RDStorageTest: public testing::Test
+{
+protected:
+    void TearDown()
+    {
+        OCRDDeleteAllPublishedResources();
+        std::remove(STORAGE_FILE_PATH);
+    }
+
+    void restart()
+    {
+        OCRDDeleteAllPublishedResources();
+        ASSERT_EQ(OC_STACK_OK, OCRDOpenStorageFile(STORAGE_FILE_PATH));
+    }
+};
+
+TEST_F(RDStorageTest, PublishedLinkIsFoundByResourceType)
+{
+    OCLinksPayload *links = createLink("/a/light", "core.light", "oic.if.baseline");
+    links->next = createLink("/a/fan", "core.fan", "oic.if.baseline");
+
+    ASSERT_EQ(OC_STACK_OK, publish("device1", links));
+
+    ASSERT_EQ("/a/fan", findHref(NULL, "core.fan"));
+}
+
+TEST_F(RDStorageTest, PublishedLinkIsFoundByInterfaceType)
+{
+    OCLinksPayload *links = createLink("/a/light", "core.light", "oic.if.baseline");
+    links->next = createLink("/a/fan", "core.fan", "oic.if.a");
+
+    ASSERT_EQ(OC_STACK_OK, publish("device1", links));
+
+    OCResourceCollectionPayload *payload = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCRDCheckPublishedResource("oic.if.a", NULL, &payload));
+    ASSERT_STREQ("core.fan", payload->setLinks->rt->value);
+    OCFreeCollectionResource(payload);
+}
+
+TEST_F(RDStorageTest, FirstPublishedLinkIsReturned)
+{
+    ASSERT_EQ(OC_STACK_OK, publish("device1",
+            createLink("/a/light1", "core.light", "oic.if.baseline")));
+    ASSERT_EQ(OC_STACK_OK, publish("device2",
+            createLink("/a/light2", "core.light", "oic.if.baseline")));
+
+    ASSERT_EQ("/a/light1", findHref(NULL, "core.light"));
+}
+
+TEST_F(RDStorageTest, UnknownResourceTypeIsNotFound)
+{
+    ASSERT_EQ(OC_STACK_OK, publish("device1",
+            createLink("/a/light", "core.light", "oic.if.baseline")));
+
+    OCResourceCollectionPayload *payload = NULL;
+    ASSERT_EQ(OC_STACK_ERROR, OCRDCheckPublishedResource(NULL, "core.fan", &payload));
+}
+
+TEST_F(RDStorageTest, DeletedDeviceResourcesAreNotFound)
+{
+    ASSERT_EQ(OC_STACK_OK, publish("device1",
+            createLink("/a/light1", "core.light", "oic.if.baseline")));
+    ASSERT_EQ(OC_STACK_OK, publish("device2",
+            createLink("/a/light2", "core.light", "oic.if.baseline")));
+
+    ASSERT_EQ(OC_STACK_OK, OCRDDeletePublishedResources((const unsigned char *)"device1"));
+
+    ASSERT_EQ("/a/light2", findHref(NULL, "core.light"));
+    ASSERT_EQ(OC_STACK_NO_RESOURCE,
+            OCRDDeletePublishedResources((const unsigned char *)"device1"));
+}
+
+TEST_F(RDStorageTest, ExpiredResourcesAreNotFound)
+{
+    ASSERT_EQ(OC_STACK_OK, publish("device1",
+            createLink("/a/light1", "core.light", "oic.if.baseline"), 1));
+    ASSERT_EQ(OC_STACK_OK, publish("device2",
+            createLink("/a/light2", "core.light", "oic.if.baseline")));
+
+    ASSERT_EQ("/a/light1", findHref(NULL, "core.light"));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 1100 });
+
+    ASSERT_EQ("/a/light2", findHref(NULL, "core.light"));
+}
+
+TEST_F(RDStorageTest, ExpiredResourcesAreDeleted)
+{
+    ASSERT_EQ(OC_STACK_OK, publish("device1",
+            createLink("/a/light1", "core.light", "oic.if.baseline"), 1));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 2100 });
+
+    ASSERT_EQ(OC_STACK_NO_RESOURCE,
+            OCRDDeletePublishedResources((const unsigned char *)"device1"));
+}
+
+TEST_F(RDStorageTest, PublishAndQueryWithHundredThousandLinks)
+{
+    constexpr int NUM_OF_DEVICES{ 10000 };
+    constexpr int NUM_OF_LINKS_PER_DEVICE{ 10 };
+    constexpr int NUM_OF_RESOURCE_TYPES{ 1000 };
+    constexpr int NUM_OF_QUERIES{ 100000 };
+
+    std::vector< OCResourceCollectionPayload * > payloads;
+    for (int i = 0; i < NUM_OF_DEVICES; ++i)
+    {
+        OCLinksPayload *links = NULL;
+        for (int j = NUM_OF_LINKS_PER_DEVICE - 1; j >= 0; --j)
+        {
+            int type = (i * NUM_OF_LINKS_PER_DEVICE + j) % NUM_OF_RESOURCE_TYPES;
+            OCLinksPayload *link = createLink("/a/" + std::to_string(j),
+                    "core.type" + std::to_string(type), "oic.if.baseline");
+            link->next = links;
+            links = link;
+        }
+        payloads.push_back(createPublication("device" + std::to_string(i), links, 86400));
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    for (auto payload : payloads)
+    {
+        ASSERT_EQ(OC_STACK_OK, OCRDStorePublishedResources(payload));
+    }
+    auto published = std::chrono::steady_clock::now();
+
+    int found{ 0 };
+    for (int i = 0; i < NUM_OF_QUERIES; ++i)
+    {
+        std::string rt = "core.type" + std::to_string(i % NUM_OF_RESOURCE_TYPES);
+        OCResourceCollectionPayload *payload = NULL;
+        if (OCRDCheckPublishedResource(NULL, rt.c_str(), &payload) == OC_STACK_OK)
+        {
+            ++found;
+            OCFreeCollectionResource(payload);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    RecordProperty("PublishMicrosecondsFor"
+            + std::to_string(NUM_OF_DEVICES * NUM_OF_LINKS_PER_DEVICE) + "Links",
+            (int)std::chrono::duration_cast< std::chrono::microseconds >(
+            published - begin).count());
+    RecordProperty("QueryMicrosecondsFor" + std::to_string(NUM_OF_QUERIES) + "Queries",
+            (int)std::chrono::duration_cast< std::chrono::microseconds >(end - published).count());
+
+    for (auto payload : payloads)
+    {
+        OCFreeCollectionResource(payload);
+    }
+
+    ASSERT_EQ(NUM_OF_QUERIES, found);
+}
+
+TEST_F(RDStorageTest, PublishedResourcesAreRestoredFromStorageFile)
+{
+    ASSERT_EQ(OC_STACK_OK, OCRDOpenStorageFile(STORAGE_FILE_PATH));
+    ASSERT_EQ(OC_STACK_OK, publish("device1",
+            createLink("/a/light", "core.light", "oic.if.baseline")));
+
+    restart();
+
+    ASSERT_EQ("/a/light", findHref(NULL, "core.light"));
+}
+
+TEST_F(RDStorageTest, RestoredResourcesAreReplacedWhenDevicePublishesAgain)
+{
+    ASSERT_EQ(OC_STACK_OK, OCRDOpenStorageFile(STORAGE_FILE_PATH));
+    ASSERT_EQ(OC_STACK_OK, publish("device1",
+            createLink("/a/light", "core.light", "oic.if.baseline")));
+
+    restart();
+    ASSERT_EQ(OC_STACK_OK, publish("device1",
+            createLink("/a/fan", "core.fan", "oic.if.baseline")));
+    restart();
+
+    ASSERT_EQ("", findHref(NULL, "core.light"));
+    ASSERT_EQ("/a/fan", findHref(NULL, "core.fan"));
+}
+
+TEST_F(RDStorageTest, DeletedResourcesAreNotRestored)
+{
+    ASSERT_EQ(OC_STACK_OK, OCRDOpenStorageFile(STORAGE_FILE_PATH));
+    ASSERT_EQ(OC_STACK_OK, publish("device1",
+            createLink("/a/light", "core.light", "oic.if.baseline")));
+    ASSERT_EQ(OC_STACK_OK, OCRDDeletePublishedResources((const unsigned char *)"device1"));
+
+    restart();
+
+    ASSERT_EQ("", findHref(NULL, "core.light"));
+}
+
+TEST_F(RDStorageTest, PartlyWrittenRecordIsDropped)
+{
+    ASSERT_EQ(OC_STACK_OK, OCRDOpenStorageFile(STORAGE_FILE_PATH));
+    ASSERT_EQ(OC_STACK_OK, publish("device1",
+            createLink("/a/light", "core.light", "oic.if.baseline")));
+    OCRDDeleteAllPublishedResources();
+
+    std::ofstream(STORAGE_FILE_PATH, std::ios::binary | std::ios::app) << "\x01\x40";
+    restart();
+
+    ASSERT_EQ("/a/light", findHref(NULL, "core.light"));
+}
+
+TEST_F(RDStorageTest, RestartWithHundredThousandLinks)
+{
+    constexpr int NUM_OF_DEVICES{ 10000 };
+    constexpr int NUM_OF_LINKS_PER_DEVICE{ 10 };
+
+    ASSERT_EQ(OC_STACK_OK, OCRDOpenStorageFile(STORAGE_FILE_PATH));
+    for (int i = 0; i < NUM_OF_DEVICES; ++i)
+    {
+        OCLinksPayload *links = NULL;
+        for (int j = NUM_OF_LINKS_PER_DEVICE - 1; j >= 0; --j)
+        {
+            OCLinksPayload *link = createLink("/a/" + std::to_string(j),
+                    "core.type" + std::to_string(j), "oic.if.baseline");
+            link->next = links;
+            links = link;
+        }
+        ASSERT_EQ(OC_STACK_OK, publish("device" + std::to_string(i), links, 86400));
+    }
+    OCRDDeleteAllPublishedResources();
+
+    auto begin = std::chrono::steady_clock::now();
+    ASSERT_EQ(OC_STACK_OK, OCRDOpenStorageFile(STORAGE_FILE_PATH));
+    std::string href = findHref(NULL, "core.type9");
+    auto end = std::chrono::steady_clock::now();
+
+    RecordProperty("RestartMicrosecondsFor"
+            + std::to_string(NUM_OF_DEVICES * NUM_OF_LINKS_PER_DEVICE) + "Links",
+            (int)std::chrono::duration_cast< std::chrono::microseconds >(end - begin).count());
+
+    ASSERT_EQ("/a/9", href);
+}
@@ -30,29 +30,81 @@ namespace OIC
         namespace
         {
             constexpr ExpiryTimerImpl::Id INVALID_ID{ 0U };
+
+            // the root wheel has 256 slots of 1 ms, each upper wheel has 64 slots
+            // covering a whole turn of the wheel below.
+            constexpr size_t ROOT_WHEEL_BITS{ 8 };
+            constexpr size_t WHEEL_BITS{ 6 };
+            constexpr size_t NUM_OF_LEVELS{ 4 };
+
+            constexpr size_t NUM_OF_DISPATCHERS{ 4 };
+            constexpr ExpiryTimerImpl::DelayInMillis DEFAULT_SLACK{ 1 };
+
+            constexpr size_t levelShift(size_t level)
+            {
+                return level == 0 ? 0 : ROOT_WHEEL_BITS + (level - 1) * WHEEL_BITS;
+            }
+
+            constexpr size_t levelSize(size_t level)
+            {
+                return level == 0 ? 1U << ROOT_WHEEL_BITS : 1U << WHEEL_BITS;
+            }
+
+            constexpr long long levelSpan(size_t level)
+            {
+                return 1LL << levelShift(level);
+            }
         }
 
         ExpiryTimerImpl::ExpiryTimerImpl() :
-                m_tasks{ },
+                m_wheel{ },
+                m_taskMap{ },
+                m_startTime{ std::chrono::steady_clock::now() },
+                m_tick{ 0 },
+                m_slack{ DEFAULT_SLACK },
                 m_thread{ },
                 m_mutex{ },
                 m_cond{ },
                 m_stop{ false },
+                m_dispatchers{ },
+                m_dispatchQueue{ },
+                m_dispatchMutex{ },
+                m_dispatchCond{ },
                 m_mt{ std::random_device{ }() },
                 m_dist{ }
         {
+            for (size_t level = 0; level < NUM_OF_LEVELS; ++level)
+            {
+                m_wheel.emplace_back(levelSize(level));
+            }
+
             m_thread = std::thread(&ExpiryTimerImpl::run, this);
+
+            for (size_t i = 0; i < NUM_OF_DISPATCHERS; ++i)
+            {
+                m_dispatchers.emplace_back(&ExpiryTimerImpl::runDispatcher, this);
+            }
         }
 
         ExpiryTimerImpl::~ExpiryTimerImpl()
         {
             {
                 std::lock_guard< std::mutex > lock{ m_mutex };
-                m_tasks.clear();
+                m_wheel.clear();
+                m_taskMap.clear();
+
+                std::lock_guard< std::mutex > dispatchLock{ m_dispatchMutex };
+                m_dispatchQueue.clear();
                 m_stop = true;
             }
             m_cond.notify_all();
+            m_dispatchCond.notify_all();
+
             m_thread.join();
+            for (auto& dispatcher : m_dispatchers)
+            {
+                dispatcher.join();
+            }
         }
 
         ExpiryTimerImpl* ExpiryTimerImpl::getInstance()
@@ -73,7 +125,15 @@ namespace OIC
                 throw RCSInvalidParameterException{ "callback is empty." };
             }
 
-            return addTask(convertToTime(Milliseconds{ delay }), std::move(cb), generateId());
+            Tick expiredTick = currentTick() + delay;
+
+            const DelayInMillis slack = m_slack;
+            if (slack > 1)
+            {
+                expiredTick = (expiredTick + slack - 1) / slack * slack;
+            }
+
+            return addTask(expiredTick, std::move(cb));
         }
 
         bool ExpiryTimerImpl::cancel(Id id)
@@ -82,15 +142,11 @@ namespace OIC
 
             std::lock_guard< std::mutex > lock{ m_mutex };
 
-            for(auto it = m_tasks.begin(); it != m_tasks.end(); ++it)
-            {
-                if(it->second->getId() == id)
-                {
-                    m_tasks.erase(it);
-                    return true;
-                }
-            }
-            return false;
+            auto it = m_taskMap.find(id);
+            if (it == m_taskMap.end()) return false;
+
+            removeTask(it->second);
+            return true;
         }
 
         size_t ExpiryTimerImpl::cancelAll(
@@ -99,34 +155,50 @@ namespace OIC
             std::lock_guard< std::mutex > lock{ m_mutex };
             size_t erased { 0 };
 
-            for(auto it = m_tasks.begin(); it != m_tasks.end();)
+            for (const auto& task : tasks)
             {
-                if(tasks.count(it->second))
+                if (task->m_slot && !task->isExecuted())
                 {
-                    it = m_tasks.erase(it);
+                    removeTask(task);
                     ++erased;
                 }
-                else
-                {
-                    ++it;
-                }
             }
             return erased;
         }
 
-        ExpiryTimerImpl::Milliseconds ExpiryTimerImpl::convertToTime(Milliseconds delay)
+        void ExpiryTimerImpl::setSlack(DelayInMillis slack)
+        {
+            if (slack <= 0LL)
+            {
+                throw RCSInvalidParameterException{ "slack must be positive." };
+            }
+            m_slack = slack;
+        }
+
+        ExpiryTimerImpl::DelayInMillis ExpiryTimerImpl::getSlack() const
         {
-            const auto now = std::chrono::system_clock::now();
-            return std::chrono::duration_cast< Milliseconds >(now.time_since_epoch()) + delay;
+            return m_slack;
         }
 
-        std::shared_ptr< TimerTask > ExpiryTimerImpl::addTask(
-                Milliseconds delay, Callback cb, Id id)
+        ExpiryTimerImpl::Tick ExpiryTimerImpl::currentTick() const
+        {
+            return std::chrono::duration_cast< Milliseconds >(
+                    std::chrono::steady_clock::now() - m_startTime).count();
+        }
+
+        std::shared_ptr< TimerTask > ExpiryTimerImpl::addTask(Tick expiredTick, Callback cb)
         {
             std::lock_guard< std::mutex > lock{ m_mutex };
 
-            auto newTask = std::make_shared< TimerTask >(id, std::move(cb));
-            m_tasks.insert({ delay, newTask });
+            // nothing is armed, so the wheel can be moved forward without processing.
+            if (m_taskMap.empty()) m_tick = currentTick();
+
+            auto newTask = std::make_shared< TimerTask >(generateId(), std::move(cb));
+            newTask->m_expiredTick = expiredTick;
+
+            // the slot of the current tick has already been processed.
+            insertTask(newTask, m_tick + 1);
+            m_taskMap[newTask->getId()] = newTask;
             m_cond.notify_all();
 
             return newTask;
@@ -134,19 +206,13 @@ namespace OIC
 
         bool ExpiryTimerImpl::containsId(Id id) const
         {
-            for (const auto& info : m_tasks)
-            {
-                if (info.second->getId() == id) return true;
-            }
-            return false;
+            return m_taskMap.count(id) != 0;
         }
 
         ExpiryTimerImpl::Id ExpiryTimerImpl::generateId()
         {
             Id newId = m_dist(m_mt);
 
-            std::lock_guard< std::mutex > lock{ m_mutex };
-
             while (newId == INVALID_ID || containsId(newId))
             {
                 newId = m_dist(m_mt);
@@ -154,32 +220,112 @@ namespace OIC
             return newId;
         }
 
+        void ExpiryTimerImpl::insertTask(const std::shared_ptr< TimerTask >& task,
+                Tick earliestTick)
+        {
+            Tick expiredTick = std::max(task->m_expiredTick, earliestTick);
+            Tick delta = expiredTick - m_tick;
+
+            size_t level = 0;
+            while (level + 1 < NUM_OF_LEVELS && delta >= levelSpan(level + 1))
+            {
+                ++level;
+            }
+
+            if (delta >= levelSpan(NUM_OF_LEVELS))
+            {
+                // too far away, park it at the farthest slot; it is rehashed on cascade.
+                expiredTick = m_tick + levelSpan(NUM_OF_LEVELS) - 1;
+            }
+
+            Slot& slot = m_wheel[level][(expiredTick >> levelShift(level)) & (levelSize(level) - 1)];
+
+            task->m_position = slot.insert(slot.end(), task);
+            task->m_slot = &slot;
+        }
+
+        void ExpiryTimerImpl::removeTask(const std::shared_ptr< TimerTask >& task)
+        {
+            m_taskMap.erase(task->getId());
+
+            task->m_slot->erase(task->m_position);
+            task->m_slot = nullptr;
+        }
+
+        void ExpiryTimerImpl::cascade(size_t level)
+        {
+            Slot tasks;
+            tasks.swap(m_wheel[level][(m_tick >> levelShift(level)) & (levelSize(level) - 1)]);
+
+            // cascaded before the slot of the current tick is processed, which still
+            // takes the tasks expiring now.
+            for (const auto& task : tasks)
+            {
+                insertTask(task, m_tick);
+            }
+        }
+
         void ExpiryTimerImpl::executeExpired()
         {
-            if (m_tasks.empty()) return;
+            const Tick now = currentTick();
 
-            auto now = std::chrono::system_clock::now().time_since_epoch();
+            std::vector< std::function< void() > > expired;
 
-            auto it = m_tasks.begin();
-            for (; it != m_tasks.end() && it->first <= now; ++it)
+            while (m_tick < now && !m_taskMap.empty())
             {
-                it->second->execute();
+                ++m_tick;
+
+                for (size_t level = NUM_OF_LEVELS - 1; level > 0; --level)
+                {
+                    if ((m_tick & (levelSpan(level) - 1)) == 0) cascade(level);
+                }
+
+                Slot& slot = m_wheel[0][m_tick & (levelSize(0) - 1)];
+
+                for (const auto& task : slot)
+                {
+                    m_taskMap.erase(task->getId());
+                    task->m_slot = nullptr;
+                    expired.push_back(task->expire());
+                }
+                slot.clear();
             }
 
-            m_tasks.erase(m_tasks.begin(), it);
+            if (m_taskMap.empty()) m_tick = now;
+
+            dispatch(std::move(expired));
         }
 
         ExpiryTimerImpl::Milliseconds ExpiryTimerImpl::remainingTimeForNext() const
         {
-            const Milliseconds& expiredTime = m_tasks.begin()->first;
+            // the next wake-up is either the next occupied slot of the root wheel
+            // or the next cascade of an occupied slot of an upper wheel.
+            Tick nextTick = m_tick + levelSpan(NUM_OF_LEVELS);
+
+            for (size_t level = 0; level < NUM_OF_LEVELS; ++level)
+            {
+                const Tick base = m_tick >> levelShift(level);
+
+                for (size_t i = 1; i <= levelSize(level); ++i)
+                {
+                    const Tick tick = (base + i) << levelShift(level);
+
+                    if (tick >= nextTick) break;
+
+                    if (!m_wheel[level][(base + i) & (levelSize(level) - 1)].empty())
+                    {
+                        nextTick = tick;
+                        break;
+                    }
+                }
+            }
 
-            return std::chrono::duration_cast< Milliseconds >(expiredTime -
-                    std::chrono::system_clock::now().time_since_epoch()) + Milliseconds{ 1 };
+            return Milliseconds{ std::max(nextTick - currentTick(), Tick{ 0 }) };
         }
 
         void ExpiryTimerImpl::run()
         {
-            auto hasTaskOrStop = [this](){ return !m_tasks.empty() || m_stop; };
+            auto hasTaskOrStop = [this](){ return !m_taskMap.empty() || m_stop; };
 
             std::unique_lock< std::mutex > lock{ m_mutex };
 
@@ -189,29 +335,68 @@ namespace OIC
 
                 if (m_stop) break;
 
+                executeExpired();
+
+                if (m_taskMap.empty()) continue;
+
                 m_cond.wait_for(lock, remainingTimeForNext());
+            }
+        }
 
-                executeExpired();
+        void ExpiryTimerImpl::dispatch(std::vector< std::function< void() > >&& callbacks)
+        {
+            if (callbacks.empty()) return;
+
+            {
+                std::lock_guard< std::mutex > lock{ m_dispatchMutex };
+                for (auto& cb : callbacks)
+                {
+                    m_dispatchQueue.push_back(std::move(cb));
+                }
+            }
+            m_dispatchCond.notify_all();
+        }
+
+        void ExpiryTimerImpl::runDispatcher()
+        {
+            auto hasCallbackOrStop = [this](){ return !m_dispatchQueue.empty() || m_stop; };
+
+            std::unique_lock< std::mutex > lock{ m_dispatchMutex };
+
+            while(true)
+            {
+                m_dispatchCond.wait(lock, hasCallbackOrStop);
+
+                if (m_stop) break;
+
+                auto cb = std::move(m_dispatchQueue.front());
+                m_dispatchQueue.pop_front();
+
+                lock.unlock();
+                cb();
+                lock.lock();
             }
         }
 
 
         TimerTask::TimerTask(ExpiryTimerImpl::Id id, ExpiryTimerImpl::Callback cb) :
             m_id{ id },
-            m_callback{ std::move(cb) }
+            m_callback{ std::move(cb) },
+            m_expiredTick{ 0 },
+            m_slot{ nullptr },
+            m_position{ }
         {
         }
 
-        void TimerTask::execute()
+        std::function< void() > TimerTask::expire()
         {
-            if (isExecuted()) return;
-
             ExpiryTimerImpl::Id id { m_id };
             m_id = INVALID_ID;
 
-            std::thread(std::move(m_callback), id).detach();
-
+            std::function< void() > cb = std::bind(std::move(m_callback), id);
             m_callback = ExpiryTimerImpl::Callback{ };
+
+            return cb;
         }
 
         bool TimerTask::isExecuted() const
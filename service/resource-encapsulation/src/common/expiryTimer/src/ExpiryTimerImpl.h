@@ -22,13 +22,16 @@
 #define _EXPIRY_TIMER_IMPL_H_
 
 #include <functional>
-#include <map>
+#include <list>
+#include <vector>
+#include <deque>
 #include <mutex>
 #include <thread>
 #include <chrono>
 #include <condition_variable>
 #include <random>
 #include <unordered_set>
+#include <unordered_map>
 #include <atomic>
 
 namespace OIC
@@ -37,6 +40,14 @@ namespace OIC
     {
         class TimerTask;
 
+        /**
+         * Timer backend shared by all ExpiryTimer instances.
+         *
+         * Tasks are kept in a hierarchical timing wheel with a resolution of one millisecond,
+         * so that post and cancel take constant time regardless of the number of armed tasks.
+         * Expired callbacks are handed over to a fixed pool of dispatch threads, so that a slow
+         * callback never delays the tick thread or the other timers.
+         */
         class ExpiryTimerImpl
         {
         public:
@@ -47,6 +58,9 @@ namespace OIC
 
         private:
             typedef std::chrono::milliseconds Milliseconds;
+            typedef long long Tick;
+
+            typedef std::list< std::shared_ptr< TimerTask > > Slot;
 
         private:
             ExpiryTimerImpl();
@@ -63,17 +77,47 @@ namespace OIC
             bool cancel(Id);
             size_t cancelAll(const std::unordered_set< std::shared_ptr<TimerTask > >&);
 
+            /**
+             * Sets how late a task is allowed to expire, so that tasks expiring close to
+             * each other are coalesced into a single wake-up of the tick thread.
+             *
+             * @throw RCSInvalidParameterException If slack is not positive.
+             */
+            void setSlack(DelayInMillis);
+            DelayInMillis getSlack() const;
+
         private:
-            static Milliseconds convertToTime(Milliseconds);
+            Tick currentTick() const;
 
-            std::shared_ptr< TimerTask > addTask(Milliseconds, Callback, Id);
+            std::shared_ptr< TimerTask > addTask(Tick, Callback);
 
             /**
              * @pre The lock must be acquired with m_mutex.
              */
             bool containsId(Id) const;
+
+            /**
+             * @pre The lock must be acquired with m_mutex.
+             */
             Id generateId();
 
+            /**
+             * Places the task in the wheel, not earlier than the given tick.
+             *
+             * @pre The lock must be acquired with m_mutex.
+             */
+            void insertTask(const std::shared_ptr< TimerTask >&, Tick earliestTick);
+
+            /**
+             * @pre The lock must be acquired with m_mutex.
+             */
+            void removeTask(const std::shared_ptr< TimerTask >&);
+
+            /**
+             * @pre The lock must be acquired with m_mutex.
+             */
+            void cascade(size_t level);
+
             /**
              * @pre The lock must be acquired with m_mutex.
              */
@@ -86,14 +130,27 @@ namespace OIC
 
             void run();
 
+            void dispatch(std::vector< std::function< void() > >&&);
+            void runDispatcher();
+
         private:
-            std::multimap< Milliseconds, std::shared_ptr< TimerTask > > m_tasks;
+            std::vector< std::vector< Slot > > m_wheel;
+            std::unordered_map< Id, std::shared_ptr< TimerTask > > m_taskMap;
+
+            const std::chrono::steady_clock::time_point m_startTime;
+            Tick m_tick;
+            std::atomic< DelayInMillis > m_slack;
 
             std::thread m_thread;
             std::mutex m_mutex;
             std::condition_variable m_cond;
             bool m_stop;
 
+            std::vector< std::thread > m_dispatchers;
+            std::deque< std::function< void() > > m_dispatchQueue;
+            std::mutex m_dispatchMutex;
+            std::condition_variable m_dispatchCond;
+
             std::mt19937 m_mt;
             std::uniform_int_distribution< Id > m_dist;
 
@@ -114,12 +171,19 @@ namespace OIC
             ExpiryTimerImpl::Id getId() const;
 
         private:
-            void execute();
+            /**
+             * Marks the task as executed and returns the callback bound with the task id.
+             */
+            std::function< void() > expire();
 
         private:
             std::atomic< ExpiryTimerImpl::Id > m_id;
             ExpiryTimerImpl::Callback m_callback;
 
+            long long m_expiredTick;
+            std::list< std::shared_ptr< TimerTask > >* m_slot;
+            std::list< std::shared_ptr< TimerTask > >::iterator m_position;
+
             friend class ExpiryTimerImpl;
         };
 
@@ -22,6 +22,9 @@
 
 #include <mutex>
 #include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
 
 #include "RCSException.h"
 #include "ExpiryTimer.h"
@@ -169,6 +172,110 @@ TEST_F(ExpiryTimerImplTest, CallbackBeInvokedWithinToleranceWithMultiplePost)
     ASSERT_EQ(NUM_OF_POST, called);
 }
 
+TEST_F(ExpiryTimerImplTest, CallbackBeInvokedWithinToleranceAfterCascade)
+{
+    FunctionObject* functor = mocks.Mock< FunctionObject >();
+
+    mocks.ExpectCall(functor, FunctionObject::execute).Do(
+            [this](ExpiryTimerImpl::Id){
+                Proceed();
+            }
+    );
+
+    ExpiryTimerImpl::getInstance()->post(600,
+            std::bind(&FunctionObject::execute, functor, std::placeholders::_1));
+
+    Wait(600 + TOLERANCE_IN_MILLIS);
+}
+
+TEST_F(ExpiryTimerImplTest, SetSlackThrowsIfSlackIsNotPositive)
+{
+    ASSERT_THROW(ExpiryTimerImpl::getInstance()->setSlack(0), RCSException);
+}
+
+TEST_F(ExpiryTimerImplTest, CallbackBeInvokedWithinSlack)
+{
+    constexpr ExpiryTimerImpl::DelayInMillis SLACK{ 20 };
+    FunctionObject* functor = mocks.Mock< FunctionObject >();
+
+    mocks.ExpectCall(functor, FunctionObject::execute).Do(
+            [this](ExpiryTimerImpl::Id){
+                Proceed();
+            }
+    );
+
+    auto defaultSlack = ExpiryTimerImpl::getInstance()->getSlack();
+    ExpiryTimerImpl::getInstance()->setSlack(SLACK);
+
+    ExpiryTimerImpl::getInstance()->post(10,
+            std::bind(&FunctionObject::execute, functor, std::placeholders::_1));
+
+    ExpiryTimerImpl::getInstance()->setSlack(defaultSlack);
+
+    Wait(SLACK + TOLERANCE_IN_MILLIS);
+}
+
+TEST_F(ExpiryTimerImplTest, PostAndCancelWithHundredThousandArmedTimers)
+{
+    constexpr int NUM_OF_POST{ 100000 };
+    std::vector< ExpiryTimerImpl::Id > ids;
+    ids.reserve(NUM_OF_POST);
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i=0; i<NUM_OF_POST; ++i)
+    {
+        ids.push_back(ExpiryTimerImpl::getInstance()->post(rand() % 100000 + 1000,
+                [](ExpiryTimerImpl::Id){ })->getId());
+    }
+    auto posted = std::chrono::steady_clock::now();
+
+    int canceled{ 0 };
+    for (auto id : ids)
+    {
+        canceled += ExpiryTimerImpl::getInstance()->cancel(id) ? 1 : 0;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    RecordProperty("PostMicrosecondsFor" + std::to_string(NUM_OF_POST) + "Timers",
+            (int)std::chrono::duration_cast< std::chrono::microseconds >(posted - begin).count());
+    RecordProperty("CancelMicrosecondsFor" + std::to_string(NUM_OF_POST) + "Timers",
+            (int)std::chrono::duration_cast< std::chrono::microseconds >(end - posted).count());
+
+    ASSERT_EQ(NUM_OF_POST, canceled);
+}
+
+TEST_F(ExpiryTimerImplTest, HundredThousandTimersExpireWithinTolerance)
+{
+    constexpr int NUM_OF_POST{ 100000 };
+    constexpr int MAX_DELAY_IN_MILLIS{ 25 };
+    std::atomic_int called{ 0 };
+
+    // callbacks are invoked one after another by the dispatching thread.
+    std::chrono::steady_clock::time_point lastExpired;
+
+    auto begin = std::chrono::steady_clock::now();
+    for (int i=0; i<NUM_OF_POST; ++i)
+    {
+        ExpiryTimerImpl::getInstance()->post(rand() % (MAX_DELAY_IN_MILLIS - 5) + 5,
+                [this, &called, &lastExpired](ExpiryTimerImpl::Id)
+                {
+                    lastExpired = std::chrono::steady_clock::now();
+                    if (++called == NUM_OF_POST) Proceed();
+                });
+    }
+    auto posted = std::chrono::steady_clock::now();
+
+    Wait(TOLERANCE_IN_MILLIS * 4);
+
+    ASSERT_EQ(NUM_OF_POST, called);
+
+    RecordProperty("PostMicrosecondsFor" + std::to_string(NUM_OF_POST) + "Timers",
+            (int)std::chrono::duration_cast< std::chrono::microseconds >(posted - begin).count());
+    RecordProperty("LastExpiryMicrosecondsAfterLatestDeadline",
+            (int)std::chrono::duration_cast< std::chrono::microseconds >(lastExpired
+                    - posted - std::chrono::milliseconds{ MAX_DELAY_IN_MILLIS }).count());
+}
+
 class ExpiryTimerTest: public TestWithMock
 {
 public:
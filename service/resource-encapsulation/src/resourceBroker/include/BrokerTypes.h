@@ -24,6 +24,7 @@
 #include <iostream>
 #include <functional>
 #include <list>
+#include <unordered_map>
 
 #include "logger.h"
 #include "PrimitiveResource.h"
@@ -36,6 +37,7 @@ namespace OIC
         #define BROKER_DEVICE_PRESENCE_TIMEROUT (15000l)
         #define BROKER_SAFE_SECOND (5l)
         #define BROKER_SAFE_MILLISECOND (BROKER_SAFE_SECOND * (1000))
+        #define BROKER_POLLING_JITTER_MILLISECOND (1000l)
         #define BROKER_TRANSPORT OCConnectivityType::CT_ADAPTER_IP
 
         /*
@@ -97,7 +99,20 @@ namespace OIC
 
         typedef std::shared_ptr<ResourcePresence> ResourcePresencePtr;
         typedef std::shared_ptr<DevicePresence> DevicePresencePtr;
-        typedef std::list< ResourcePresencePtr > PresenceList;
+        typedef std::unordered_map< PrimitiveResourcePtr, ResourcePresencePtr > PresenceMap;
+
+        /*
+         * @BrokerProbeCount
+         * brief : counters of liveness probes (requestGet) for non-presence resources
+         * sentProbe    - probes actually sent to the remote resource
+         * skippedProbe - probes saved because the device of the resource was
+         *                proven alive by another resource or by presence
+         */
+        struct BrokerProbeCount
+        {
+            unsigned long long sentProbe;
+            unsigned long long skippedProbe;
+        };
 
         struct BrokerCBResourcePair
         {
@@ -23,6 +23,7 @@
 
 #include <list>
 #include <string>
+#include <unordered_map>
 #include <algorithm>
 #include <mutex>
 #include <condition_variable>
@@ -50,7 +51,7 @@ namespace OIC
 
             static DeviceAssociation * s_instance;
             static std::mutex s_mutexForCreation;
-            static std::list< DevicePresencePtr > s_deviceList;
+            static std::unordered_map< std::string, DevicePresencePtr > s_deviceMap;
         };
     } // namespace Service
 } // namespace OIC
@@ -24,6 +24,7 @@
 #include <list>
 #include <string>
 #include <atomic>
+#include <unordered_set>
 
 #include "BrokerTypes.h"
 #include "ResourcePresence.h"
@@ -47,16 +48,20 @@ namespace OIC
             void addPresenceResource(ResourcePresence * rPresence);
             void removePresenceResource(ResourcePresence * rPresence);
 
+            void notifyAliveSignal();
+            bool isAliveWithin(long long millisec) const;
+
             bool isEmptyResourcePresence() const;
             const std::string getAddress() const;
             DEVICE_STATE getDeviceState() const noexcept;
 
         private:
-            std::list<ResourcePresence * > resourcePresenceList;
+            std::unordered_set<ResourcePresence * > resourcePresenceList;
 
             std::string address;
             std::atomic_int state;
             std::atomic_bool isRunningTimeOut;
+            std::atomic_llong lastAliveTime;
 
             std::mutex timeoutMutex;
             std::condition_variable condition;
@@ -59,10 +59,12 @@ namespace OIC
             BROKER_STATE getResourceState(BrokerID brokerId);
             BROKER_STATE getResourceState(PrimitiveResourcePtr pResource);
 
+            BrokerProbeCount getProbeCount() const;
+
         private:
             static ResourceBroker * s_instance;
             static std::mutex s_mutexForCreation;
-            static std::unique_ptr<PresenceList>  s_presenceList;
+            static std::unique_ptr<PresenceMap>  s_presenceMap;
             static std::unique_ptr<BrokerIDMap> s_brokerIDMap;
 
             ResourceBroker() = default;
@@ -55,9 +55,12 @@ namespace OIC
             const PrimitiveResourcePtr getPrimitiveResource() const;
             BROKER_STATE getResourceState() const;
 
+            static BrokerProbeCount getProbeCount();
+
         private:
             std::unique_ptr<std::list<BrokerRequesterInfoPtr>> requesterList;
             PrimitiveResourcePtr primitiveResource;
+            std::weak_ptr<DevicePresence> devicePresence;
             ExpiryTimer expiryTimer;
 
             BROKER_STATE state;
@@ -72,6 +75,9 @@ namespace OIC
             TimerCB pTimeoutCB;
             TimerCB pPollingCB;
 
+            static std::atomic_ullong s_sentProbeCount;
+            static std::atomic_ullong s_skippedProbeCount;
+
             void registerDevicePresence();
         public:
             void getCB(const HeaderOptions &hos, const ResponseStatement& rep, int eCode);
@@ -80,6 +86,8 @@ namespace OIC
             void verifiedGetResponse(int eCode);
 
             void pollingCB(unsigned int msg = 0);
+            void sendProbe();
+            bool isDeviceAliveWithinSafeTime() const;
 
             void executeAllBrokerCB(BROKER_STATE changedState);
             void setResourcestate(BROKER_STATE _state);
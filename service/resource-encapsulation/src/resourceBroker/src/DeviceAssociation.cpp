@@ -28,7 +28,7 @@ namespace OIC
     {
         DeviceAssociation * DeviceAssociation::s_instance = nullptr;
         std::mutex DeviceAssociation::s_mutexForCreation;
-        std::list< DevicePresencePtr >  DeviceAssociation::s_deviceList;
+        std::unordered_map< std::string, DevicePresencePtr >  DeviceAssociation::s_deviceMap;
 
         DeviceAssociation::DeviceAssociation()
         {
@@ -58,14 +58,11 @@ namespace OIC
         {
             OC_LOG_V(DEBUG,BROKER_TAG,"findDevice()");
             DevicePresencePtr retDevice = nullptr;
-            for(auto it : s_deviceList)
+            auto it = s_deviceMap.find(address);
+            if(it != s_deviceMap.end())
             {
-                if(address == it->getAddress())
-                {
-                    OC_LOG_V(DEBUG,BROKER_TAG,"find device in deviceList");
-                    retDevice = it;
-                    break;
-                }
+                OC_LOG_V(DEBUG,BROKER_TAG,"find device in deviceMap");
+                retDevice = it->second;
             }
 
             return retDevice;
@@ -74,30 +71,25 @@ namespace OIC
         void DeviceAssociation::addDevice(DevicePresencePtr dPresence)
         {
             OC_LOG_V(DEBUG,BROKER_TAG,"addDevice()");
-            DevicePresencePtr foundDevice = findDevice(dPresence->getAddress());
-            if(foundDevice == nullptr)
+            if(s_deviceMap.insert(std::make_pair(dPresence->getAddress(), dPresence)).second)
             {
-                OC_LOG_V(DEBUG,BROKER_TAG,"add device in deviceList");
-                s_deviceList.push_back(dPresence);
+                OC_LOG_V(DEBUG,BROKER_TAG,"add device in deviceMap");
             }
         }
 
         void DeviceAssociation::removeDevice(DevicePresencePtr dPresence)
         {
             OC_LOG_V(DEBUG,BROKER_TAG,"removeDevice()");
-            DevicePresencePtr foundDevice = findDevice(dPresence->getAddress());
-            if(foundDevice != nullptr)
+            if(s_deviceMap.erase(dPresence->getAddress()) != 0)
             {
-                OC_LOG_V(DEBUG,BROKER_TAG,"remove device in deviceList");
-                s_deviceList.remove(foundDevice);
-                foundDevice.reset();
+                OC_LOG_V(DEBUG,BROKER_TAG,"remove device in deviceMap");
             }
         }
 
         bool DeviceAssociation::isEmptyDeviceList()
         {
             OC_LOG_V(DEBUG,BROKER_TAG,"isEmptyDeviceList()");
-            return s_deviceList.empty();
+            return s_deviceMap.empty();
         }
     } // namespace Service
 } // namespace OIC
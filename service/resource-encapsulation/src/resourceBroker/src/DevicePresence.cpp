@@ -19,8 +19,20 @@
 //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 
 #include "DevicePresence.h"
+
+#include <chrono>
+
 #include "RCSException.h"
 
+namespace
+{
+    long long getCurrentMilliSec()
+    {
+        return std::chrono::duration_cast< std::chrono::milliseconds >(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
 namespace OIC
 {
     namespace Service
@@ -31,6 +43,7 @@ namespace OIC
 
             presenceTimerHandle = 0;
             isRunningTimeOut = false;
+            lastAliveTime = 0;
 
             pSubscribeRequestCB = std::bind(&DevicePresence::subscribeCB, this,
                         std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
@@ -89,13 +102,13 @@ namespace OIC
         void DevicePresence::addPresenceResource(ResourcePresence * rPresence)
         {
             OC_LOG_V(DEBUG, BROKER_TAG, "addPresenceResource()");
-            resourcePresenceList.push_back(rPresence);
+            resourcePresenceList.insert(rPresence);
         }
 
         void DevicePresence::removePresenceResource(ResourcePresence * rPresence)
         {
             OC_LOG_V(DEBUG, BROKER_TAG, "removePresenceResource()");
-            resourcePresenceList.remove(rPresence);
+            resourcePresenceList.erase(rPresence);
         }
 
         void DevicePresence::changeAllPresenceMode(BROKER_MODE mode)
@@ -110,6 +123,17 @@ namespace OIC
             }
         }
 
+        void DevicePresence::notifyAliveSignal()
+        {
+            lastAliveTime = getCurrentMilliSec();
+        }
+
+        bool DevicePresence::isAliveWithin(long long millisec) const
+        {
+            long long aliveTime = lastAliveTime;
+            return aliveTime != 0 && (getCurrentMilliSec() - aliveTime) < millisec;
+        }
+
         bool DevicePresence::isEmptyResourcePresence() const
         {
             OC_LOG_V(DEBUG, BROKER_TAG, "isEmptyResourcePresence()");
@@ -138,6 +162,7 @@ namespace OIC
                 {
                     OC_LOG_V(DEBUG, BROKER_TAG, "SEQ# %d",seq);
                     setDeviceState(DEVICE_STATE::ALIVE);
+                    notifyAliveSignal();
                     OC_LOG_V(DEBUG, BROKER_TAG, "device state : %d",
                             (int)getDeviceState());
                     changeAllPresenceMode(BROKER_MODE::DEVICE_PRESENCE_MODE);
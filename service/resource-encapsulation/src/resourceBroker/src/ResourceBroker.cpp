@@ -29,16 +29,15 @@ namespace OIC
     {
         ResourceBroker * ResourceBroker::s_instance = NULL;
         std::mutex ResourceBroker::s_mutexForCreation;
-        std::unique_ptr<PresenceList>  ResourceBroker::s_presenceList(nullptr);
+        std::unique_ptr<PresenceMap>  ResourceBroker::s_presenceMap(nullptr);
         std::unique_ptr<BrokerIDMap> ResourceBroker::s_brokerIDMap(nullptr);
 
         ResourceBroker::~ResourceBroker()
         {
-            if(s_presenceList != nullptr)
+            if(s_presenceMap != nullptr)
             {
-                OC_LOG_V(DEBUG, BROKER_TAG, "clear the ResourcePresenceList.");
-                s_presenceList->erase(s_presenceList->begin(), s_presenceList->end());
-                s_presenceList->clear();
+                OC_LOG_V(DEBUG, BROKER_TAG, "clear the ResourcePresenceMap.");
+                s_presenceMap->clear();
             }
             if(s_brokerIDMap != nullptr)
             {
@@ -88,10 +87,10 @@ namespace OIC
                 {
                     throw FailedSubscribePresenceException(e.getReasonCode());
                 }
-                if(s_presenceList != nullptr)
+                if(s_presenceMap != nullptr)
                 {
-                    OC_LOG_V(DEBUG, BROKER_TAG, "push the ResourcePresence in presenceList.");
-                    s_presenceList->push_back(presenceItem);
+                    OC_LOG_V(DEBUG, BROKER_TAG, "insert the ResourcePresence in presenceMap.");
+                    s_presenceMap->insert(std::make_pair(pResource, presenceItem));
                 }
             }
             OC_LOG_V(DEBUG, BROKER_TAG, "add the BrokerRequester in ResourcePresence.");
@@ -130,8 +129,8 @@ namespace OIC
 
                 if(presenceItem->isEmptyRequester())
                 {
-                    OC_LOG_V(DEBUG,BROKER_TAG,"remove resourcePresence in presenceList because it is not including any requester info.");
-                    s_presenceList->remove(presenceItem);
+                    OC_LOG_V(DEBUG,BROKER_TAG,"remove resourcePresence in presenceMap because it is not including any requester info.");
+                    s_presenceMap->erase(presenceItem->getPrimitiveResource());
                 }
             }
         }
@@ -182,13 +181,19 @@ namespace OIC
             return retState;
         }
 
+        BrokerProbeCount ResourceBroker::getProbeCount() const
+        {
+            OC_LOG_V(DEBUG,BROKER_TAG,"getProbeCount().");
+            return ResourcePresence::getProbeCount();
+        }
+
         void ResourceBroker::initializeResourceBroker()
         {
             OC_LOG_V(DEBUG,BROKER_TAG,"initializeResourceBroker().");
-            if(s_presenceList == nullptr)
+            if(s_presenceMap == nullptr)
             {
-                OC_LOG_V(DEBUG,BROKER_TAG,"create the presenceList.");
-                s_presenceList = std::unique_ptr<PresenceList>(new PresenceList);
+                OC_LOG_V(DEBUG,BROKER_TAG,"create the presenceMap.");
+                s_presenceMap = std::unique_ptr<PresenceMap>(new PresenceMap);
             }
             if(s_brokerIDMap == nullptr)
             {
@@ -202,17 +207,10 @@ namespace OIC
             OC_LOG_V(DEBUG,BROKER_TAG,"findResourcePresence().");
             ResourcePresencePtr retResource(nullptr);
 
-            if(s_presenceList->empty() != true)
+            PresenceMap::iterator it = s_presenceMap->find(pResource);
+            if(it != s_presenceMap->end())
             {
-                for(auto & it : * s_presenceList)
-                {
-                    PrimitiveResourcePtr temp = it->getPrimitiveResource();
-                    if(temp == pResource)
-                    {
-                        retResource = it;
-                        break;
-                    }
-                }
+                retResource = it->second;
             }
 
             return retResource;
@@ -28,6 +28,7 @@
 #include <exception>
 #include <iostream>
 #include <memory>
+#include <random>
 
 #include "PrimitiveResource.h"
 #include "DeviceAssociation.h"
@@ -56,12 +57,25 @@ using namespace OIC::Service;
             Ptr->timeOutCB(msg);
         }
     }
+
+    long long getJitteredPollingDelay()
+    {
+        // spread the polling of resources over time, so that resources monitored
+        // from the same moment do not send their probes at once.
+        static thread_local std::mt19937 generator{ std::random_device{}() };
+        std::uniform_int_distribution< long long >
+        distribution(0, BROKER_POLLING_JITTER_MILLISECOND - 1);
+        return BROKER_SAFE_MILLISECOND + distribution(generator);
+    }
 }
 
 namespace OIC
 {
     namespace Service
     {
+        std::atomic_ullong ResourcePresence::s_sentProbeCount(0);
+        std::atomic_ullong ResourcePresence::s_skippedProbeCount(0);
+
         ResourcePresence::ResourcePresence()
         : requesterList(nullptr), primitiveResource(nullptr),
           state(BROKER_STATE::REQUESTED), mode(BROKER_MODE::NON_PRESENCE_MODE),
@@ -158,6 +172,7 @@ namespace OIC
         void ResourcePresence::requestResourceState() const
         {
             OC_LOG_V(DEBUG,BROKER_TAG,"requestResourceState().\n");
+            ++s_sentProbeCount;
             primitiveResource->requestGet(pGetCB);
             OC_LOG_V(DEBUG, BROKER_TAG, "Request Get\n");
         }
@@ -183,6 +198,13 @@ namespace OIC
                 DeviceAssociation::getInstance()->addDevice(foundDevice);
             }
             foundDevice->addPresenceResource(this);
+            devicePresence = foundDevice;
+        }
+
+        bool ResourcePresence::isDeviceAliveWithinSafeTime() const
+        {
+            DevicePresencePtr foundDevice = devicePresence.lock();
+            return foundDevice != nullptr && foundDevice->isAliveWithin(BROKER_SAFE_MILLISECOND);
         }
 
         void ResourcePresence::executeAllBrokerCB(BROKER_STATE changedState)
@@ -228,13 +250,40 @@ namespace OIC
                     "Timeout execution. will be discard after receiving cb message.\n");
 
             executeAllBrokerCB(BROKER_STATE::LOST_SIGNAL);
-            pollingCB();
+            sendProbe();
         }
 
         void ResourcePresence::pollingCB(unsigned int /*msg*/)
         {
             OC_LOG_V(DEBUG, BROKER_TAG, "pollingCB().\n");
             if(this->requesterList->size() != 0)
+            {
+                if(state == BROKER_STATE::ALIVE && isDeviceAliveWithinSafeTime())
+                {
+                    // another resource of the same device or the device presence
+                    // already proved that the device is alive within the safe time.
+                    OC_LOG_V(DEBUG, BROKER_TAG, "skip probe, device is alive.\n");
+                    ++s_skippedProbeCount;
+
+                    if(mode == BROKER_MODE::NON_PRESENCE_MODE)
+                    {
+                        std::unique_lock<std::mutex> lock(cbMutex);
+                        time_t currentTime;
+                        time(&currentTime);
+                        receivedTime = currentTime;
+
+                        expiryTimer.post(getJitteredPollingDelay(), pPollingCB);
+                    }
+                    return;
+                }
+                sendProbe();
+            }
+        }
+
+        void ResourcePresence::sendProbe()
+        {
+            OC_LOG_V(DEBUG, BROKER_TAG, "sendProbe().\n");
+            if(this->requesterList->size() != 0)
             {
                 this->requestResourceState();
                 timeoutHandle = expiryTimer.post(BROKER_SAFE_MILLISECOND,pTimeoutCB);
@@ -254,6 +303,15 @@ namespace OIC
 
             verifiedGetResponse(eCode);
 
+            if(state == BROKER_STATE::ALIVE)
+            {
+                DevicePresencePtr foundDevice = devicePresence.lock();
+                if(foundDevice != nullptr)
+                {
+                    foundDevice->notifyAliveSignal();
+                }
+            }
+
             if(isWithinTime)
             {
                 expiryTimer.cancel(timeoutHandle);
@@ -262,7 +320,7 @@ namespace OIC
 
             if(mode == BROKER_MODE::NON_PRESENCE_MODE)
             {
-                expiryTimer.post(BROKER_SAFE_MILLISECOND,pPollingCB);
+                expiryTimer.post(getJitteredPollingDelay(),pPollingCB);
             }
 
         }
@@ -308,6 +366,14 @@ namespace OIC
             return state;
         }
 
+        BrokerProbeCount ResourcePresence::getProbeCount()
+        {
+            BrokerProbeCount count;
+            count.sentProbe = s_sentProbeCount;
+            count.skippedProbe = s_skippedProbeCount;
+            return count;
+        }
+
         void ResourcePresence::changePresenceMode(BROKER_MODE newMode)
         {
             OC_LOG_V(DEBUG, BROKER_TAG, "changePresenceMode()\n");
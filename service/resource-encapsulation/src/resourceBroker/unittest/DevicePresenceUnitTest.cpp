@@ -133,6 +133,21 @@ TEST_F(DevicePresenceTest,isEmptyResourcePresence_NormalHandling)
 
 }
 
+TEST_F(DevicePresenceTest,isAliveWithin_ReturnFalseIfNoAliveSignal)
+{
+
+    ASSERT_FALSE(instance->isAliveWithin(BROKER_SAFE_MILLISECOND));
+
+}
+
+TEST_F(DevicePresenceTest,isAliveWithin_ReturnTrueAfterAliveSignal)
+{
+
+    instance->notifyAliveSignal();
+    ASSERT_TRUE(instance->isAliveWithin(BROKER_SAFE_MILLISECOND));
+
+}
+
 TEST_F(DevicePresenceTest,getAddress_NormalHandling)
 {
 
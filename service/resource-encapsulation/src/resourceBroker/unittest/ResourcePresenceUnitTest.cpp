@@ -161,6 +161,20 @@ TEST_F(ResourcePresenceTest,requestResourceState_NormalHandling)
 
 }
 
+TEST_F(ResourcePresenceTest,requestResourceState_IncreaseSentProbeCount)
+{
+
+    MockingFunc();
+
+    instance->initializeResourcePresence(pResource);
+    unsigned long long sentProbe = ResourcePresence::getProbeCount().sentProbe;
+
+    instance->requestResourceState();
+
+    ASSERT_EQ(sentProbe + 1, ResourcePresence::getProbeCount().sentProbe);
+
+}
+
 TEST_F(ResourcePresenceTest,changePresenceMode_NormalHandlingIfNewModeDifferent)
 {
 
@@ -41,6 +41,7 @@ namespace OIC
 #define CACHE_TAG  "CACHE"
 #define CACHE_DEFAULT_REPORT_MILLITIME 10000
 #define CACHE_DEFAULT_EXPIRED_MILLITIME 15000
+#define CACHE_NOTIFY_BATCH_MILLITIME 10
 
         enum class REPORT_FREQUENCY
         {
@@ -84,6 +85,8 @@ namespace OIC
         typedef PrimitiveResource::GetCallback GetCB;
         typedef PrimitiveResource::ObserveCallback ObserveCB;
 
+        typedef std::shared_ptr<const RCSResourceAttributes> CachedDataPtr;
+
         typedef std::shared_ptr<DataCache> DataCachePtr;
         typedef std::shared_ptr<PrimitiveResource> PrimitiveResourcePtr;
     } // namespace Service
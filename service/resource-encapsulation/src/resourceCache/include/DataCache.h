@@ -25,6 +25,7 @@
 #include <string>
 #include <memory>
 #include <mutex>
+#include <atomic>
 
 #include "CacheTypes.h"
 #include "ExpiryTimer.h"
@@ -50,6 +51,7 @@ namespace OIC
 
                 CACHE_STATE getCacheState() const;
                 const RCSResourceAttributes getCachedData() const;
+                CachedDataPtr getCachedDataPtr() const;
                 const PrimitiveResourcePtr getPrimitiveResource() const;
 
                 void requestGet();
@@ -61,7 +63,8 @@ namespace OIC
                 PrimitiveResourcePtr sResource;
 
                 // cached data info
-                RCSResourceAttributes attributes;
+                // immutable snapshot, replaced as a whole on update (copy-on-write)
+                CachedDataPtr attributes;
                 CACHE_STATE state;
                 CACHE_MODE mode;
                 bool isReady;
@@ -75,25 +78,34 @@ namespace OIC
                 ExpiryTimer pollingTimer;
                 TimerID networkTimeOutHandle;
                 TimerID pollingHandle;
+                std::atomic<TimerID> getTimeOutHandle;
 
                 ObserveCB pObserveCB;
                 GetCB pGetCB;
                 TimerCB pTimerCB;
                 TimerCB pPollingCB;
+                TimerCB pGetTimeOutCB;
 
                 unsigned int lastSequenceNum;
 
+                // true while a GET is on the wire, further GET requests are coalesced
+                std::atomic_bool isGetRequested;
+                std::atomic_bool isNotifyPending;
+
             public:
                 void onObserve(const HeaderOptions &_hos,
                                const ResponseStatement &_rep, int _result, int _seq);
                 void onGet(const HeaderOptions &_hos, const ResponseStatement &_rep, int _result);
+                void notifyObservers();
             private:
                 void onTimeOut(const unsigned int timerID);
                 void onPollingOut(const unsigned int timerID);
+                void onGetTimeOut(const unsigned int timerID);
 
                 CacheID generateCacheID();
                 SubscriberInfoPair findSubscriber(CacheID id);
-                void notifyObservers(const RCSResourceAttributes Att);
+                void sendGetRequest();
+                void updateCachedData(const RCSResourceAttributes &Att);
         };
     } // namespace Service
 } // namespace OIC
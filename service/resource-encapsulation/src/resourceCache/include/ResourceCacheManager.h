@@ -25,6 +25,7 @@
 #include <string>
 #include <mutex>
 #include <map>
+#include <unordered_map>
 
 #include "CacheTypes.h"
 #include "DataCache.h"
@@ -68,6 +69,10 @@ namespace OIC
                 const RCSResourceAttributes getCachedData(PrimitiveResourcePtr pResource) const;
                 const RCSResourceAttributes getCachedData(CacheID id) const;
 
+                // throw InvalidParameterException;
+                // throw HasNoCachedDataException;
+                CachedDataPtr getCachedDataPtr(PrimitiveResourcePtr pResource) const;
+
                 // throw InvalidParameterException;
                 CACHE_STATE getResourceCacheState(PrimitiveResourcePtr pResource) const;
                 CACHE_STATE getResourceCacheState(CacheID id) const;
@@ -80,7 +85,7 @@ namespace OIC
                 static ResourceCacheManager *s_instance;
                 static std::mutex s_mutex;
                 static std::mutex s_mutexForCreation;
-                static std::unique_ptr<std::list<DataCachePtr>> s_cacheDataList;
+                static std::unique_ptr<std::unordered_map<std::string, DataCachePtr>> s_cacheDataMap;
                 std::map<CacheID, DataCachePtr> cacheIDmap;
 
                 ResourceCacheManager() = default;
@@ -94,6 +99,7 @@ namespace OIC
                 static void initializeResourceCacheManager();
                 DataCachePtr findDataCache(PrimitiveResourcePtr pResource) const;
                 DataCachePtr findDataCache(CacheID id) const;
+                static std::string getCacheKey(PrimitiveResourcePtr pResource);
         };
     } // namespace Service
 } // namespace OIC
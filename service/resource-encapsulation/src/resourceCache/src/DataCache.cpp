@@ -24,6 +24,7 @@
 #include <map>
 #include <utility>
 #include <ctime>
+#include <vector>
 
 #include "DataCache.h"
 
@@ -73,6 +74,51 @@ namespace OIC
                                  std::placeholders::_1, std::placeholders::_2,
                                  std::placeholders::_3, rpPtr);
             }
+
+            // caches updated within the same batch window notify their subscribers together,
+            // each with its latest snapshot.
+            std::mutex notifyMutex;
+            std::vector<std::weak_ptr<DataCache>> pendingCaches;
+
+            ExpiryTimer &getNotifyTimer()
+            {
+                static ExpiryTimer notifyTimer;
+                return notifyTimer;
+            }
+
+            void flushPendingNotifications(unsigned int /*timerID*/)
+            {
+                std::vector<std::weak_ptr<DataCache>> caches;
+                {
+                    std::lock_guard<std::mutex> lock(notifyMutex);
+                    caches.swap(pendingCaches);
+                }
+
+                for (auto &weakCache : caches)
+                {
+                    std::shared_ptr<DataCache> Ptr = weakCache.lock();
+                    if (Ptr)
+                    {
+                        Ptr->notifyObservers();
+                    }
+                }
+            }
+
+            void requestNotification(std::weak_ptr<DataCache> rpPtr)
+            {
+                std::lock_guard<std::mutex> lock(notifyMutex);
+                if (pendingCaches.empty())
+                {
+                    getNotifyTimer().post(CACHE_NOTIFY_BATCH_MILLITIME, flushPendingNotifications);
+                }
+                pendingCaches.push_back(std::move(rpPtr));
+            }
+
+            CachedDataPtr getEmptyCachedData()
+            {
+                static CachedDataPtr emptyData = std::make_shared<const RCSResourceAttributes>();
+                return emptyData;
+            }
         }
 
         DataCache::DataCache()
@@ -86,8 +132,11 @@ namespace OIC
 
             networkTimeOutHandle = 0;
             pollingHandle = 0;
+            getTimeOutHandle = 0;
             lastSequenceNum = 0;
             isReady = false;
+            isGetRequested = false;
+            isNotifyPending = false;
         }
 
         DataCache::~DataCache()
@@ -120,8 +169,10 @@ namespace OIC
             pGetCB = verifiedGetCB(std::weak_ptr<DataCache>(shared_from_this()));
             pTimerCB = (TimerCB)(std::bind(&DataCache::onTimeOut, this, std::placeholders::_1));
             pPollingCB = (TimerCB)(std::bind(&DataCache::onPollingOut, this, std::placeholders::_1));
+            pGetTimeOutCB = (TimerCB)(std::bind(&DataCache::onGetTimeOut, this,
+                                                std::placeholders::_1));
 
-            sResource->requestGet(pGetCB);
+            sendGetRequest();
             if (sResource->isObservable())
             {
                 sResource->requestObserve(pObserveCB);
@@ -189,12 +240,17 @@ namespace OIC
 
         const RCSResourceAttributes DataCache::getCachedData() const
         {
-            std::lock_guard<std::mutex> lock(att_mutex);
-            if (state != CACHE_STATE::READY)
+            return *getCachedDataPtr();
+        }
+
+        CachedDataPtr DataCache::getCachedDataPtr() const
+        {
+            CachedDataPtr data = std::atomic_load(&attributes);
+            if (state != CACHE_STATE::READY || data == nullptr)
             {
-                return RCSResourceAttributes();
+                return getEmptyCachedData();
             }
-            return attributes;
+            return data;
         }
 
         bool DataCache::isCachedData() const
@@ -229,12 +285,15 @@ namespace OIC
             networkTimer.cancel(networkTimeOutHandle);
             networkTimeOutHandle = networkTimer.post(CACHE_DEFAULT_EXPIRED_MILLITIME, pTimerCB);
 
-            notifyObservers(_rep.getAttributes());
+            updateCachedData(_rep.getAttributes());
         }
 
         void DataCache::onGet(const HeaderOptions & /*_hos*/,
                               const ResponseStatement &_rep, int _result)
         {
+            networkTimer.cancel(getTimeOutHandle);
+            isGetRequested = false;
+
             if (_result != OC_STACK_OK || _rep.getAttributes().empty())
             {
                 return;
@@ -255,18 +314,36 @@ namespace OIC
                 pollingHandle = pollingTimer.post(CACHE_DEFAULT_REPORT_MILLITIME, pPollingCB);
             }
 
-            notifyObservers(_rep.getAttributes());
+            updateCachedData(_rep.getAttributes());
         }
 
-        void DataCache::notifyObservers(const RCSResourceAttributes Att)
+        void DataCache::updateCachedData(const RCSResourceAttributes &Att)
         {
             {
                 std::lock_guard<std::mutex> lock(att_mutex);
-                if (attributes == Att)
+                CachedDataPtr current = std::atomic_load(&attributes);
+                if (current != nullptr && *current == Att)
                 {
                     return;
                 }
-                attributes = Att;
+                std::atomic_store(&attributes,
+                                  CachedDataPtr(std::make_shared<const RCSResourceAttributes>(Att)));
+            }
+
+            if (!isNotifyPending.exchange(true))
+            {
+                requestNotification(shared_from_this());
+            }
+        }
+
+        void DataCache::notifyObservers()
+        {
+            isNotifyPending = false;
+
+            CachedDataPtr data = std::atomic_load(&attributes);
+            if (data == nullptr)
+            {
+                return;
             }
 
             std::lock_guard<std::mutex> lock(m_mutex);
@@ -274,7 +351,7 @@ namespace OIC
             {
                 if (i.second.first.rf == REPORT_FREQUENCY::UPTODATE)
                 {
-                    i.second.second(this->sResource, Att);
+                    i.second.second(this->sResource, *data);
                 }
             }
         }
@@ -306,11 +383,20 @@ namespace OIC
             if (sResource != nullptr)
             {
                 mode = CACHE_MODE::FREQUENCY;
-                sResource->requestGet(pGetCB);
+                sendGetRequest();
             }
             return;
         }
 
+        void DataCache::onGetTimeOut(const unsigned int timerID)
+        {
+            // the pending GET is regarded as lost, allow the next one to be sent.
+            if (getTimeOutHandle == timerID)
+            {
+                isGetRequested = false;
+            }
+        }
+
         CacheID DataCache::generateCacheID()
         {
             CacheID retID = 0;
@@ -331,9 +417,25 @@ namespace OIC
         void DataCache::requestGet()
         {
             state = CACHE_STATE::UPDATING;
-            if (sResource != nullptr)
+            sendGetRequest();
+        }
+
+        void DataCache::sendGetRequest()
+        {
+            if (sResource != nullptr && !isGetRequested.exchange(true))
             {
-                sResource->requestGet(pGetCB);
+                try
+                {
+                    getTimeOutHandle = networkTimer.post(
+                                           CACHE_DEFAULT_EXPIRED_MILLITIME, pGetTimeOutCB);
+                    sResource->requestGet(pGetCB);
+                }
+                catch (...)
+                {
+                    networkTimer.cancel(getTimeOutHandle);
+                    isGetRequested = false;
+                    throw;
+                }
             }
         }
 
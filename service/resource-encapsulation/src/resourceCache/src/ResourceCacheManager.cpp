@@ -27,14 +27,15 @@ namespace OIC
         ResourceCacheManager *ResourceCacheManager::s_instance = NULL;
         std::mutex ResourceCacheManager::s_mutexForCreation;
         std::mutex ResourceCacheManager::s_mutex;
-        std::unique_ptr<std::list<DataCachePtr>> ResourceCacheManager::s_cacheDataList(nullptr);
+        std::unique_ptr<std::unordered_map<std::string, DataCachePtr>>
+        ResourceCacheManager::s_cacheDataMap(nullptr);
 
         ResourceCacheManager::~ResourceCacheManager()
         {
             std::lock_guard<std::mutex> lock(s_mutex);
-            if (s_cacheDataList != nullptr)
+            if (s_cacheDataMap != nullptr)
             {
-                s_cacheDataList->clear();
+                s_cacheDataMap->clear();
             }
         }
 
@@ -83,7 +84,7 @@ namespace OIC
                 std::lock_guard<std::mutex> lock(s_mutex);
                 newHandler.reset(new DataCache());
                 newHandler->initializeDataCache(pResource);
-                s_cacheDataList->push_back(newHandler);
+                s_cacheDataMap->insert(std::make_pair(getCacheKey(pResource), newHandler));
             }
             retID = newHandler->addSubscriber(func, rf, reportTime);
 
@@ -110,7 +111,7 @@ namespace OIC
                 std::lock_guard<std::mutex> lock(s_mutex);
                 if (foundCacheHandler->isEmptySubscriber())
                 {
-                    s_cacheDataList->remove(foundCacheHandler);
+                    s_cacheDataMap->erase(getCacheKey(foundCacheHandler->getPrimitiveResource()));
                 }
             }
         }
@@ -190,6 +191,27 @@ namespace OIC
             return handler->getCachedData();
         }
 
+        CachedDataPtr ResourceCacheManager::getCachedDataPtr(PrimitiveResourcePtr pResource) const
+        {
+            if (pResource == nullptr)
+            {
+                throw InvalidParameterException {"[getCachedDataPtr] Primitive Resource is nullptr"};
+            }
+
+            DataCachePtr handler = findDataCache(pResource);
+            if (handler == nullptr)
+            {
+                throw InvalidParameterException {"[getCachedDataPtr] Primitive Resource is invaild"};
+            }
+
+            if (handler->isCachedData() == false)
+            {
+                throw HasNoCachedDataException {"[getCachedDataPtr] Cached Data is not stored"};
+            }
+
+            return handler->getCachedDataPtr();
+        }
+
         CACHE_STATE ResourceCacheManager::getResourceCacheState(
             PrimitiveResourcePtr pResource) const
         {
@@ -254,10 +276,10 @@ namespace OIC
         void ResourceCacheManager::initializeResourceCacheManager()
         {
             std::lock_guard<std::mutex> lock(s_mutex);
-            if (s_cacheDataList == nullptr)
+            if (s_cacheDataMap == nullptr)
             {
-                s_cacheDataList
-                    = std::unique_ptr<std::list<DataCachePtr>>(new std::list<DataCachePtr>);
+                s_cacheDataMap = std::unique_ptr<std::unordered_map<std::string, DataCachePtr>>(
+                                     new std::unordered_map<std::string, DataCachePtr>);
             }
         }
 
@@ -265,14 +287,10 @@ namespace OIC
         {
             DataCachePtr retHandler = nullptr;
             std::lock_guard<std::mutex> lock(s_mutex);
-            for (auto &i : * s_cacheDataList)
+            auto it = s_cacheDataMap->find(getCacheKey(pResource));
+            if (it != s_cacheDataMap->end())
             {
-                if (i->getPrimitiveResource()->getUri() == pResource->getUri() &&
-                    i->getPrimitiveResource()->getHost() == pResource->getHost())
-                {
-                    retHandler = i;
-                    break;
-                }
+                retHandler = it->second;
             }
             return retHandler;
         }
@@ -280,16 +298,18 @@ namespace OIC
         DataCachePtr ResourceCacheManager::findDataCache(CacheID id) const
         {
             DataCachePtr retHandler = nullptr;
-            for (auto it : cacheIDmap)
+            auto it = cacheIDmap.find(id);
+            if (it != cacheIDmap.end())
             {
-                if (it.first == id)
-                {
-                    retHandler = it.second;
-                    break;
-                }
+                retHandler = it->second;
             }
 
             return retHandler;
         }
+
+        std::string ResourceCacheManager::getCacheKey(PrimitiveResourcePtr pResource)
+        {
+            return pResource->getHost() + pResource->getUri();
+        }
     } // namespace Service
 } // namespace OIC
@@ -215,7 +215,51 @@ TEST_F(DataCacheTest, getPrimitiveResource_normalCase)
 TEST_F(DataCacheTest, requestGet_normalCase)
 {
 
+    mocks.ExpectCall(pResource.get(), PrimitiveResource::requestGet).Do(
+        [](GetCallback callback)
+    {
+        OIC::Service::HeaderOptions hos;
+        OIC::Service::RCSResourceAttributes attr;
+        OIC::Service::ResponseStatement rep(attr);
+        callback(hos, rep, OC_STACK_OK);
+        return;
+    });
+    mocks.ExpectCall(pResource.get(), PrimitiveResource::isObservable).Return(true);
+    mocks.ExpectCall(pResource.get(), PrimitiveResource::requestObserve);
     mocks.ExpectCall(pResource.get(), PrimitiveResource::requestGet);
+    mocks.OnCall(pResource.get(), PrimitiveResource::cancelObserve);
+
+    cacheHandler->initializeDataCache(pResource);
+
+    cacheHandler->requestGet();
+}
+
+TEST_F(DataCacheTest, requestGet_coalescedWhileGetInFlight)
+{
+
+    mocks.ExpectCall(pResource.get(), PrimitiveResource::requestGet);
+    mocks.ExpectCall(pResource.get(), PrimitiveResource::isObservable).Return(true);
+    mocks.ExpectCall(pResource.get(), PrimitiveResource::requestObserve);
+    mocks.OnCall(pResource.get(), PrimitiveResource::cancelObserve);
+
+    cacheHandler->initializeDataCache(pResource);
+
+    cacheHandler->requestGet();
+    cacheHandler->requestGet();
+}
+
+TEST_F(DataCacheTest, requestGet_sentAgainAfterFailedGet)
+{
+
+    mocks.ExpectCall(pResource.get(), PrimitiveResource::requestGet).Do(
+        [](GetCallback callback)
+    {
+        OIC::Service::HeaderOptions hos;
+        OIC::Service::RCSResourceAttributes attr;
+        OIC::Service::ResponseStatement rep(attr);
+        callback(hos, rep, OC_STACK_ERROR);
+        return;
+    });
     mocks.ExpectCall(pResource.get(), PrimitiveResource::isObservable).Return(true);
     mocks.ExpectCall(pResource.get(), PrimitiveResource::requestObserve);
     mocks.ExpectCall(pResource.get(), PrimitiveResource::requestGet);
@@ -226,6 +270,20 @@ TEST_F(DataCacheTest, requestGet_normalCase)
     cacheHandler->requestGet();
 }
 
+TEST_F(DataCacheTest, getCachedDataPtr_normalCase)
+{
+
+    mocks.ExpectCall(pResource.get(), PrimitiveResource::requestGet);
+    mocks.ExpectCall(pResource.get(), PrimitiveResource::isObservable).Return(true);
+    mocks.ExpectCall(pResource.get(), PrimitiveResource::requestObserve);
+    mocks.OnCall(pResource.get(), PrimitiveResource::cancelObserve);
+
+    cacheHandler->initializeDataCache(pResource);
+
+    ASSERT_NE(cacheHandler->getCachedDataPtr(), nullptr);
+    ASSERT_EQ(*cacheHandler->getCachedDataPtr(), RCSResourceAttributes());
+}
+
 TEST_F(DataCacheTest, isEmptySubscriber_normalCase)
 {
 
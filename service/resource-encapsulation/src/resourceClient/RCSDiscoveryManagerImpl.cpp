@@ -19,6 +19,9 @@
 //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 #include "RCSDiscoveryManagerImpl.h"
 
+#include <algorithm>
+#include <chrono>
+
 #include "OCPlatform.h"
 #include "PresenceSubscriber.h"
 #include "RCSAddressDetail.h"
@@ -27,6 +30,34 @@
 namespace
 {
     constexpr unsigned int POLLING_INTERVAL_TIME = 60000;
+    constexpr unsigned int MAX_POLLING_INTERVAL_TIME = POLLING_INTERVAL_TIME * 16;
+
+    // A task joining a request which was sent within this time reuses its responses
+    // instead of sending the same query again.
+    constexpr long long REDISCOVERY_GUARD_TIME = 1000;
+
+    long long getCurrentTime()
+    {
+        return std::chrono::duration_cast< std::chrono::milliseconds >(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    std::string makeRequestKey(const std::string& address, const std::string& relativeUri,
+            const std::string& resourceType)
+    {
+        std::string key;
+        key.reserve(address.size() + relativeUri.size() + resourceType.size() + 2);
+        key.append(address).push_back('\0');
+        key.append(relativeUri).push_back('\0');
+        key.append(resourceType);
+        return key;
+    }
+
+    OIC::Service::DiscoveryRequestInfo::ResourceId makeResourceId(
+            const std::shared_ptr< OIC::Service::PrimitiveResource >& resource)
+    {
+        return std::hash< std::string >()(resource->getSid() + resource->getUri());
+    }
 }
 
 namespace OIC
@@ -37,7 +68,6 @@ namespace OIC
         {
             srand (time(NULL));
             requestMulticastPresence();
-            m_timer.post(POLLING_INTERVAL_TIME, std::bind(&RCSDiscoveryManagerImpl::onPolling, this));
         }
 
         RCSDiscoveryManagerImpl* RCSDiscoveryManagerImpl::getInstance()
@@ -47,17 +77,52 @@ namespace OIC
         }
 
         void RCSDiscoveryManagerImpl::onResourceFound(std::shared_ptr<PrimitiveResource> resource,
-                RCSDiscoveryManagerImpl::ID discoveryId,
-                const RCSDiscoveryManager::ResourceDiscoveredCallback& discoverCB)
+                const std::string& requestKey)
         {
+            const auto resourceId = makeResourceId(resource);
+            std::vector< RCSDiscoveryManager::ResourceDiscoveredCallback > callbacks;
+
             {
                 std::lock_guard < std::mutex > lock(m_mutex);
-                auto it = m_discoveryMap.find(discoveryId);
+                auto requestIt = m_requestMap.find(requestKey);
+
+                if (requestIt == m_requestMap.end()) return;
+                requestIt->second.addResource(resourceId, resource);
 
-                if (it == m_discoveryMap.end()) return;
-                if (it->second.isKnownResource(resource)) return;
+                for (const auto& taskId : requestIt->second.getTasks())
+                {
+                    auto it = m_discoveryMap.find(taskId);
+
+                    if (it == m_discoveryMap.end()) continue;
+                    if (it->second.isKnownResource(resourceId)) continue;
+
+                    callbacks.push_back(it->second.getCallback());
+                }
+            }
+
+            for (const auto& cb : callbacks)
+            {
+                cb(std::make_shared < RCSRemoteResourceObject > (resource));
+            }
+        }
+
+        void RCSDiscoveryManagerImpl::onKnownResources(RCSDiscoveryManagerImpl::ID discoveryId,
+                const std::vector< std::shared_ptr< PrimitiveResource > >& resources)
+        {
+            for (const auto& resource : resources)
+            {
+                RCSDiscoveryManager::ResourceDiscoveredCallback cb;
+                {
+                    std::lock_guard < std::mutex > lock(m_mutex);
+                    auto it = m_discoveryMap.find(discoveryId);
+
+                    if (it == m_discoveryMap.end()) return;
+                    if (it->second.isKnownResource(makeResourceId(resource))) continue;
+
+                    cb = it->second.getCallback();
+                }
+                cb(std::make_shared < RCSRemoteResourceObject > (resource));
             }
-            discoverCB(std::make_shared < RCSRemoteResourceObject > (resource));
         }
 
         RCSDiscoveryManager::DiscoveryTask::Ptr RCSDiscoveryManagerImpl::startDiscovery(
@@ -70,15 +135,46 @@ namespace OIC
             }
 
             ID discoveryId = createId();
-            auto discoverCb = std::bind(&RCSDiscoveryManagerImpl::onResourceFound, this,
-                    std::placeholders::_1, discoveryId, std::move(cb));
-            DiscoveryRequestInfo discoveryInfo(RCSAddressDetail::getDetail(address)->getAddress(),
-                    relativeUri, resourceType, std::move(discoverCb));
-            discoveryInfo.discover();
+            const std::string hostAddress = RCSAddressDetail::getDetail(address)->getAddress();
+            const std::string requestKey = makeRequestKey(hostAddress, relativeUri, resourceType);
 
             {
                 std::lock_guard < std::mutex > lock(m_mutex);
-                m_discoveryMap.insert(std::make_pair(discoveryId, std::move(discoveryInfo)));
+                auto requestIt = m_requestMap.find(requestKey);
+
+                if (requestIt == m_requestMap.end())
+                {
+                    auto discoverCb = std::bind(&RCSDiscoveryManagerImpl::onResourceFound, this,
+                            std::placeholders::_1, requestKey);
+
+                    requestIt = m_requestMap.insert(std::make_pair(requestKey,
+                            DiscoveryRequestInfo(hostAddress, relativeUri, resourceType,
+                                    std::move(discoverCb)))).first;
+                    postPolling(requestKey, requestIt->second);
+                }
+
+                auto& requestInfo = requestIt->second;
+                requestInfo.addTask(discoveryId);
+                m_discoveryMap.insert(std::make_pair(discoveryId,
+                        DiscoveryTaskInfo(requestKey, std::move(cb))));
+
+                if (!requestInfo.getResources().empty())
+                {
+                    std::vector< std::shared_ptr< PrimitiveResource > > resources;
+                    resources.reserve(requestInfo.getResources().size());
+
+                    for (const auto& it : requestInfo.getResources())
+                    {
+                        resources.push_back(it.second);
+                    }
+                    m_timer.post(0, std::bind(&RCSDiscoveryManagerImpl::onKnownResources, this,
+                            discoveryId, std::move(resources)));
+                }
+
+                if (!requestInfo.isDiscoveredWithin(REDISCOVERY_GUARD_TIME))
+                {
+                    requestInfo.discover();
+                }
             }
 
             return std::unique_ptr < RCSDiscoveryManager::DiscoveryTask> (
@@ -96,15 +192,22 @@ namespace OIC
                             std::placeholders::_3)));
         }
 
-        void RCSDiscoveryManagerImpl::onPolling()
+        void RCSDiscoveryManagerImpl::postPolling(const std::string& requestKey,
+                DiscoveryRequestInfo& requestInfo)
+        {
+            requestInfo.setTimerId(m_timer.post(requestInfo.getNextPollingInterval(),
+                    std::bind(&RCSDiscoveryManagerImpl::onPolling, this, requestKey)));
+        }
+
+        void RCSDiscoveryManagerImpl::onPolling(const std::string& requestKey)
         {
             std::lock_guard < std::mutex > lock(m_mutex);
 
-            for (const auto& it : m_discoveryMap)
-            {
-                it.second.discover();
-            }
-            m_timer.post(POLLING_INTERVAL_TIME, std::bind(&RCSDiscoveryManagerImpl::onPolling, this));
+            auto it = m_requestMap.find(requestKey);
+            if (it == m_requestMap.end()) return;
+
+            it->second.discover();
+            postPolling(requestKey, it->second);
         }
 
         void RCSDiscoveryManagerImpl::onPresence(OCStackResult ret, const unsigned int /*seq*/,
@@ -113,10 +216,11 @@ namespace OIC
             if (ret != OC_STACK_OK && ret != OC_STACK_RESOURCE_CREATED) return;
 
             std::lock_guard < std::mutex > lock(m_mutex);
-            for (const auto& it : m_discoveryMap)
+            for (auto& it : m_requestMap)
             {
                 if (it.second.isMatchingAddress(address))
                 {
+                    it.second.resetPollingInterval();
                     it.second.discover();
                 }
             }
@@ -138,7 +242,20 @@ namespace OIC
         void RCSDiscoveryManagerImpl::cancel(ID id)
         {
             std::lock_guard < std::mutex > lock(m_mutex);
-            m_discoveryMap.erase(id);
+            auto it = m_discoveryMap.find(id);
+            if (it == m_discoveryMap.end()) return;
+
+            auto requestIt = m_requestMap.find(it->second.getRequestKey());
+            m_discoveryMap.erase(it);
+
+            if (requestIt == m_requestMap.end()) return;
+
+            requestIt->second.removeTask(id);
+            if (!requestIt->second.hasTask())
+            {
+                m_timer.cancel(requestIt->second.getTimerId());
+                m_requestMap.erase(requestIt);
+            }
         }
 
         bool RCSDiscoveryManagerImpl::isCanceled(ID id)
@@ -154,26 +271,23 @@ namespace OIC
                 const std::string &relativeUri, const std::string &resourceType,
                 DiscoverCallback cb) :
                 m_address(address), m_relativeUri(relativeUri), m_resourceType(resourceType),
-                m_discoverCb(std::move(cb))
+                m_discoverCb(std::move(cb)), m_isChanged{ true },
+                m_pollingInterval{ POLLING_INTERVAL_TIME }, m_lastDiscoveredTime{ 0 },
+                m_timerId{ 0 }
         {
         }
 
-        void DiscoveryRequestInfo::discover() const
+        void DiscoveryRequestInfo::discover()
         {
+            m_lastDiscoveredTime = getCurrentTime();
             OIC::Service::discoverResource(m_address, m_relativeUri + "?rt=" + m_resourceType,
                     OCConnectivityType::CT_DEFAULT, m_discoverCb);
         }
 
-        bool DiscoveryRequestInfo::isKnownResource(
-                const std::shared_ptr<PrimitiveResource>& resource)
+        bool DiscoveryRequestInfo::isDiscoveredWithin(long long millisec) const
         {
-            std::string resourceId = resource->getSid() + resource->getUri();
-
-            auto it = std::find(m_receivedIds.begin(), m_receivedIds.end(), resourceId);
-
-            if (it != m_receivedIds.end()) return true;
-            m_receivedIds.insert(resourceId);
-            return false;
+            return m_lastDiscoveredTime != 0
+                    && getCurrentTime() - m_lastDiscoveredTime < millisec;
         }
 
         bool DiscoveryRequestInfo::isMatchingAddress(const std::string& address) const
@@ -181,5 +295,90 @@ namespace OIC
             return m_address == RCSAddressDetail::getDetail(RCSAddress::multicast())->getAddress()
                     || m_address == address;
         }
+
+        bool DiscoveryRequestInfo::addResource(ResourceId id,
+                const std::shared_ptr<PrimitiveResource>& resource)
+        {
+            if (!m_resources.insert(std::make_pair(id, resource)).second) return false;
+
+            m_isChanged = true;
+            return true;
+        }
+
+        const DiscoveryRequestInfo::ResourceMap& DiscoveryRequestInfo::getResources() const
+        {
+            return m_resources;
+        }
+
+        void DiscoveryRequestInfo::addTask(TaskId id)
+        {
+            m_tasks.insert(id);
+        }
+
+        void DiscoveryRequestInfo::removeTask(TaskId id)
+        {
+            m_tasks.erase(id);
+        }
+
+        bool DiscoveryRequestInfo::hasTask() const
+        {
+            return !m_tasks.empty();
+        }
+
+        const std::unordered_set<DiscoveryRequestInfo::TaskId>& DiscoveryRequestInfo::getTasks() const
+        {
+            return m_tasks;
+        }
+
+        unsigned int DiscoveryRequestInfo::getNextPollingInterval()
+        {
+            if (m_isChanged)
+            {
+                m_pollingInterval = POLLING_INTERVAL_TIME;
+            }
+            else
+            {
+                m_pollingInterval = std::min(m_pollingInterval * 2, MAX_POLLING_INTERVAL_TIME);
+            }
+            m_isChanged = false;
+
+            return m_pollingInterval;
+        }
+
+        void DiscoveryRequestInfo::resetPollingInterval()
+        {
+            m_isChanged = true;
+        }
+
+        ExpiryTimer::Id DiscoveryRequestInfo::getTimerId() const
+        {
+            return m_timerId;
+        }
+
+        void DiscoveryRequestInfo::setTimerId(ExpiryTimer::Id id)
+        {
+            m_timerId = id;
+        }
+
+        DiscoveryTaskInfo::DiscoveryTaskInfo(const std::string& requestKey,
+                RCSDiscoveryManager::ResourceDiscoveredCallback cb) :
+                m_requestKey(requestKey), m_discoverCb(std::move(cb))
+        {
+        }
+
+        bool DiscoveryTaskInfo::isKnownResource(DiscoveryRequestInfo::ResourceId id)
+        {
+            return !m_receivedIds.insert(id).second;
+        }
+
+        const std::string& DiscoveryTaskInfo::getRequestKey() const
+        {
+            return m_requestKey;
+        }
+
+        const RCSDiscoveryManager::ResourceDiscoveredCallback& DiscoveryTaskInfo::getCallback() const
+        {
+            return m_discoverCb;
+        }
     }
 }
@@ -34,6 +34,7 @@
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "RCSDiscoveryManager.h"
 #include "ExpiryTimer.h"
@@ -49,27 +50,80 @@ namespace OIC
         class RCSAddress;
 
         /**
-         * The class contains discovery request information
+         * The class contains the information of a discovery query sent on the wire.
+         *
+         * Discovery tasks which look for the same address, uri and resource type share
+         * one DiscoveryRequestInfo, so the query goes out once and its responses are
+         * fanned out to every task.
          *
          * @see RCSDiscoveryManager
          */
         class DiscoveryRequestInfo
         {
+            public:
+                typedef unsigned int TaskId;
+                typedef size_t ResourceId;
+                typedef std::unordered_map< ResourceId, std::shared_ptr< PrimitiveResource > >
+                        ResourceMap;
+
             public:
                 DiscoveryRequestInfo(const std::string &, const std::string &,
                         const std::string &, DiscoverCallback);
 
             public:
-                void discover() const;
-                bool isKnownResource(const std::shared_ptr<PrimitiveResource>&);
+                void discover();
+                bool isDiscoveredWithin(long long millisec) const;
                 bool isMatchingAddress(const std::string&) const;
 
+                bool addResource(ResourceId, const std::shared_ptr<PrimitiveResource>&);
+                const ResourceMap& getResources() const;
+
+                void addTask(TaskId);
+                void removeTask(TaskId);
+                bool hasTask() const;
+                const std::unordered_set<TaskId>& getTasks() const;
+
+                unsigned int getNextPollingInterval();
+                void resetPollingInterval();
+
+                ExpiryTimer::Id getTimerId() const;
+                void setTimerId(ExpiryTimer::Id);
+
             private:
                 std::string m_address;
                 std::string m_relativeUri;
                 std::string m_resourceType;
-                std::unordered_set<std::string> m_receivedIds;
+                ResourceMap m_resources;
+                std::unordered_set<TaskId> m_tasks;
                 DiscoverCallback m_discoverCb;
+
+                bool m_isChanged;
+                unsigned int m_pollingInterval;
+                long long m_lastDiscoveredTime;
+                ExpiryTimer::Id m_timerId;
+        };
+
+        /**
+         * The class contains the information of a discovery task.
+         *
+         * Resource ids already delivered to the task are kept as hashed values of
+         * device id and uri.
+         */
+        class DiscoveryTaskInfo
+        {
+            public:
+                DiscoveryTaskInfo(const std::string &,
+                        RCSDiscoveryManager::ResourceDiscoveredCallback);
+
+            public:
+                bool isKnownResource(DiscoveryRequestInfo::ResourceId);
+                const std::string& getRequestKey() const;
+                const RCSDiscoveryManager::ResourceDiscoveredCallback& getCallback() const;
+
+            private:
+                std::string m_requestKey;
+                std::unordered_set<DiscoveryRequestInfo::ResourceId> m_receivedIds;
+                RCSDiscoveryManager::ResourceDiscoveredCallback m_discoverCb;
         };
 
         /**
@@ -126,21 +180,29 @@ namespace OIC
                 void requestMulticastPresence();
 
                 /**
-                 * Check duplicated callback and invoke callback when resource is discovered
+                 * Check duplicated resource and invoke callbacks of all tasks sharing the
+                 * request when resource is discovered
                  *
                  * @param resource     A pointer of discovered resource
-                 * @param discoverID   The ID of discovery request
-                 * @param cb           Callback
+                 * @param requestKey   The key of discovery request
                  *
                  * @see PrimitiveResource
                  */
-                void onResourceFound(std::shared_ptr<PrimitiveResource> resource, ID discoveryId,
-                        const RCSDiscoveryManager::ResourceDiscoveredCallback& cb);
+                void onResourceFound(std::shared_ptr<PrimitiveResource> resource,
+                        const std::string& requestKey);
 
                 /**
-                 * Discover resource on all requests and posting timer when timer is expired
+                 * Deliver resources the request already knows to a newly joined task
                  */
-                void onPolling();
+                void onKnownResources(ID discoveryId,
+                        const std::vector< std::shared_ptr< PrimitiveResource > >& resources);
+
+                /**
+                 * Discover resource on the request and post timer with the next polling interval
+                 */
+                void onPolling(const std::string& requestKey);
+
+                void postPolling(const std::string& requestKey, DiscoveryRequestInfo&);
 
                 /**
                  * Discover resource on all requests when supporting presence function resource
@@ -159,7 +221,8 @@ namespace OIC
                 ExpiryTimer m_timer;
 
             private:
-                std::unordered_map<ID,DiscoveryRequestInfo> m_discoveryMap;
+                std::unordered_map<ID,DiscoveryTaskInfo> m_discoveryMap;
+                std::unordered_map<std::string,DiscoveryRequestInfo> m_requestMap;
                 std::mutex m_mutex;
         };
     }
@@ -287,7 +287,18 @@ namespace OIC
         {
             SCOPE_LOG_F(DEBUG, TAG);
 
-            return getCachedAttributes().at(key);
+            if (!isCaching())
+            {
+                throw RCSBadRequestException{ "Caching not started." };
+            }
+
+            if (!isCachedAvailable())
+            {
+                throw RCSBadRequestException{ "Cache data is not available." };
+            }
+
+            return ResourceCacheManager::getInstance()->getCachedDataPtr(
+                    m_primitiveResource)->at(key);
         }
 
         std::string RCSRemoteResourceObject::getUri() const
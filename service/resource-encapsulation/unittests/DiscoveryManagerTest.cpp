@@ -40,6 +40,7 @@ constexpr int DEFAULT_DISCOVERYTASK_DELAYTIME = 3000;
 
 void resourceDiscoveredForCall(RCSRemoteResourceObject::Ptr) {}
 void resourceDiscoveredForNeverCall(RCSRemoteResourceObject::Ptr) {}
+void resourceDiscoveredForSecondCall(RCSRemoteResourceObject::Ptr) {}
 
 class DiscoveryManagerTest: public TestWithMock
 {
@@ -196,3 +197,20 @@ TEST_F(DiscoveryManagerTest, equalDiscoveryRequestsAndCancelJustOneRequest)
     createResource();
     waitForDiscoveryTask();
 }
+
+TEST_F(DiscoveryManagerTest, equalDiscoveryRequestReceivesResourceAlreadyDiscovered)
+{
+    createResource();
+
+    mocks.ExpectCallFunc(resourceDiscoveredForCall).Do(
+        [this](RCSRemoteResourceObject::Ptr){ proceed();});
+
+    DiscoveryTaskPtr firstTask = discoverResource(resourceDiscoveredForCall);
+    waitForDiscoveryTask();
+
+    mocks.ExpectCallFunc(resourceDiscoveredForSecondCall).Do(
+        [this](RCSRemoteResourceObject::Ptr){ proceed();});
+
+    DiscoveryTaskPtr secondTask = discoverResource(resourceDiscoveredForSecondCall);
+    waitForDiscoveryTask();
+}
@@ -180,32 +180,15 @@ void HostingObject::dataChangedCB(const RCSResourceAttributes & attributes, Remo
         }
     }
 
-    RCSResourceAttributes rData;
+    // copy outside of the mirror lock and move it in, so requests on the mirror
+    // are not blocked while the attributes are being copied.
+    RCSResourceAttributes rData{ attributes };
     {
         RCSResourceObject::LockGuard guard(mirroredServer);
-        rData = mirroredServer->getAttributes();
-    }
-    if(rData.empty() || rData != attributes)
-    {
+        RCSResourceAttributes & mirroredAttributes = mirroredServer->getAttributes();
+        if(mirroredAttributes != rData)
         {
-            RCSResourceObject::LockGuard guard(mirroredServer);
-            for(auto it = rData.begin(); ; ++it)
-            {
-                if(it == rData.end())
-                {
-                    break;
-                }
-                mirroredServer->removeAttribute(it->key());
-            }
-
-            for(auto it = attributes.begin();; ++it)
-            {
-                if(it == attributes.end())
-                {
-                    break;
-                }
-                mirroredServer->setAttribute(it->key(), it->value());
-            }
+            mirroredAttributes = std::move(rData);
         }
     }
 }
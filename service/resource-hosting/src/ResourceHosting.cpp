@@ -41,7 +41,7 @@ ResourceHosting * ResourceHosting::s_instance(nullptr);
 std::mutex ResourceHosting::s_mutexForCreation;
 
 ResourceHosting::ResourceHosting()
-: hostingObjectList(),
+: hostingObjectMap(),
   discoveryManager(nullptr),
   pDiscoveryCB(nullptr)
 {
@@ -87,8 +87,12 @@ void ResourceHosting::startHosting()
 
 void ResourceHosting::stopHosting()
 {
-
-    hostingObjectList.clear();
+    std::unordered_map<std::string, HostingObjectPtr> releasedObjects;
+    {
+        std::unique_lock<std::mutex> lock(mutexForList);
+        releasedObjects.swap(hostingObjectMap);
+    }
+    releaseDestroyedObjects();
 }
 
 void ResourceHosting::initializeResourceHosting()
@@ -107,6 +111,8 @@ void ResourceHosting::requestMulticastDiscovery()
 
 void ResourceHosting::discoverHandler(RemoteObjectPtr remoteResource)
 {
+    releaseDestroyedObjects();
+
     std::string discoverdUri = remoteResource->getUri();
     if(discoverdUri.compare(
             discoverdUri.size()-HOSTING_TAG_SIZE, HOSTING_TAG_SIZE, HOSTING_TAG) != 0)
@@ -114,60 +120,68 @@ void ResourceHosting::discoverHandler(RemoteObjectPtr remoteResource)
         return;
     }
 
-    HostingObjectPtr foundHostingObject = findRemoteResource(remoteResource);
-    if(foundHostingObject == nullptr)
+    const std::string hostingKey = getHostingKey(remoteResource);
+
     {
-        try
-        {
-            foundHostingObject = std::make_shared<HostingObject>();
-            foundHostingObject->initializeHostingObject(remoteResource,
-                    std::bind(&ResourceHosting::destroyedHostingObject, this,
-                            HostingObjectWeakPtr(foundHostingObject)));
-            hostingObjectList.push_back(foundHostingObject);
-        }catch(const RCSInvalidParameterException &e)
+        // reserve the key, so a concurrent discovery of the same origin is dropped.
+        std::unique_lock<std::mutex> lock(mutexForList);
+        if(!hostingObjectMap.emplace(hostingKey, nullptr).second)
         {
-            OIC_HOSTING_LOG(DEBUG,
-                    "[ResourceHosting::discoverHandler]InvalidParameterException:%s", e.what());
+            return;
         }
     }
-}
 
-ResourceHosting::HostingObjectPtr ResourceHosting::findRemoteResource(
-        RemoteObjectPtr remoteResource)
-{
-    HostingObjectPtr retObject = nullptr;
+    HostingObjectPtr foundHostingObject = std::make_shared<HostingObject>();
+    try
+    {
+        foundHostingObject->initializeHostingObject(remoteResource,
+                std::bind(&ResourceHosting::destroyedHostingObject, this, hostingKey));
+    }catch(const RCSInvalidParameterException &e)
+    {
+        OIC_HOSTING_LOG(DEBUG,
+                "[ResourceHosting::discoverHandler]InvalidParameterException:%s", e.what());
+
+        std::unique_lock<std::mutex> lock(mutexForList);
+        hostingObjectMap.erase(hostingKey);
+        return;
+    }
 
-    for(auto it : hostingObjectList)
+    std::unique_lock<std::mutex> lock(mutexForList);
+    auto found = hostingObjectMap.find(hostingKey);
+    if(found != hostingObjectMap.end() && found->second == nullptr)
     {
-        RemoteObjectPtr inListPtr = it->getRemoteResource();
-        if(inListPtr != nullptr && isSameRemoteResource(inListPtr, remoteResource))
-        {
-            retObject = it;
-        }
+        found->second = std::move(foundHostingObject);
     }
+}
 
-    return retObject;
+std::string ResourceHosting::getHostingKey(RemoteObjectPtr remoteResource) const
+{
+    return remoteResource->getAddress() + remoteResource->getUri();
 }
 
-bool ResourceHosting::isSameRemoteResource(
-        RemoteObjectPtr remoteResource_1, RemoteObjectPtr remoteResource_2)
+void ResourceHosting::destroyedHostingObject(const std::string & hostingKey)
 {
-    bool ret = false;
-    if(remoteResource_1->getAddress() == remoteResource_2->getAddress() &&
-       remoteResource_1->getUri() == remoteResource_2->getUri())
+    // called back from the state callback of the object, which can not be released in it.
+    std::unique_lock<std::mutex> lock(mutexForList);
+    auto found = hostingObjectMap.find(hostingKey);
+    if(found != hostingObjectMap.end())
     {
-        ret = true;
+        if(found->second)
+        {
+            destroyedObjects.push_back(std::move(found->second));
+        }
+        hostingObjectMap.erase(found);
     }
-    return ret;
 }
 
-void ResourceHosting::destroyedHostingObject(HostingObjectWeakPtr destroyedWeakPtr)
+void ResourceHosting::releaseDestroyedObjects()
 {
-    auto destroyedPtr = destroyedWeakPtr.lock();
-    if (destroyedPtr) return;
-
-    std::unique_lock<std::mutex> lock(mutexForList);
-    hostingObjectList.remove(destroyedPtr);
+    // the objects are released outside of the lock.
+    std::vector<HostingObjectPtr> releasedObjects;
+    {
+        std::unique_lock<std::mutex> lock(mutexForList);
+        releasedObjects.swap(destroyedObjects);
+    }
 }
 
 } /* namespace Service */
@@ -23,7 +23,8 @@
 
 #include <cstdbool>
 #include <iostream>
-#include <list>
+#include <unordered_map>
+#include <vector>
 #include <memory>
 #include <functional>
 #include <string>
@@ -46,7 +47,6 @@ class ResourceHosting
 {
 private:
     typedef std::shared_ptr<HostingObject> HostingObjectPtr;
-    typedef std::weak_ptr<HostingObject> HostingObjectWeakPtr;
 
     typedef std::shared_ptr<RCSRemoteResourceObject> RemoteObjectPtr;
     typedef std::shared_ptr<PrimitiveResource> PrimiteveResourcePtr;
@@ -74,7 +74,9 @@ private:
     static std::mutex s_mutexForCreation;
     std::mutex mutexForList;
 
-    std::list<HostingObjectPtr> hostingObjectList;
+    std::unordered_map<std::string, HostingObjectPtr> hostingObjectMap;
+    // objects destroyed by their origin, released on the next discovery or stop.
+    std::vector<HostingObjectPtr> destroyedObjects;
 
     RCSDiscoveryManager * discoveryManager;
     std::unique_ptr<RCSDiscoveryManager::DiscoveryTask> discoveryTask;
@@ -87,10 +89,10 @@ private:
 
     void discoverHandler(RemoteObjectPtr remoteResource);
 
-    HostingObjectPtr findRemoteResource(RemoteObjectPtr remoteResource);
-    bool isSameRemoteResource(RemoteObjectPtr remoteResource_1, RemoteObjectPtr remoteResource_2);
+    std::string getHostingKey(RemoteObjectPtr remoteResource) const;
 
-    void destroyedHostingObject(HostingObjectWeakPtr destroyedWeakPtr);
+    void destroyedHostingObject(const std::string & hostingKey);
+    void releaseDestroyedObjects();
 
 };
 
@@ -18,7 +18,12 @@
 //
 //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "ResourceEncapsulationTestSimulator.h"
 #include "HostingObject.h"
@@ -30,6 +35,9 @@ using namespace OIC::Service;
 
 namespace
 {
+    constexpr int HOSTED_CLIENT_COUNT = 10;
+    constexpr int UPDATE_COUNT = 100;
+
     bool isDeleted = false;
     void onDestroy(std::weak_ptr<HostingObject> rPtr)
     {
@@ -197,3 +205,98 @@ TEST_F(HostingObjectTest, UpdateCachedDataWhenChangedOriginResource)
     EXPECT_EQ(result.toString(), settingValue.toString());
 
 }
+
+TEST_F(HostingObjectTest, UpdateThroughputFromOriginToHostedClients)
+{
+    int waitForResponse = 1000;
+
+    HostingObject::Ptr instance = std::make_shared<HostingObject>();
+    instance->initializeHostingObject(
+            remoteObject, std::bind(onDestroy, std::weak_ptr<HostingObject>(instance)));
+    std::this_thread::sleep_for(std::chrono::milliseconds {waitForResponse});
+
+    std::mutex mutexForClients;
+    std::vector<RCSRemoteResourceObject::Ptr> hostedClients;
+    std::vector<std::unique_ptr<RCSDiscoveryManager::DiscoveryTask>> discoveryTasks;
+
+    mocks.OnCallFunc(onDiscoveryResource).Do(
+            [this, &mutexForClients, &hostedClients](RCSRemoteResourceObject::Ptr ptr)
+            {
+                if(ptr->getUri() == testObject->getHostedServerUri())
+                {
+                    std::unique_lock<std::mutex> lock(mutexForClients);
+                    hostedClients.push_back(ptr);
+                    if(hostedClients.size() == HOSTED_CLIENT_COUNT)
+                    {
+                        notifyCondition();
+                    }
+                }
+            });
+
+    for(int i = 0; i < HOSTED_CLIENT_COUNT; ++i)
+    {
+        discoveryTasks.push_back(RCSDiscoveryManager::getInstance()->discoverResourceByType(
+                RCSAddress::multicast(), "resource.hosting", onDiscoveryResource));
+    }
+    waitForCondition(waitForResponse);
+
+    for(auto & task : discoveryTasks)
+    {
+        task->cancel();
+    }
+
+    std::atomic_int receivedCount{ 0 };
+    std::atomic_int completedClients{ 0 };
+    std::mutex mutexForCompletion;
+    std::chrono::steady_clock::time_point completed;
+    {
+        std::unique_lock<std::mutex> lock(mutexForClients);
+        ASSERT_EQ(HOSTED_CLIENT_COUNT, (int)hostedClients.size());
+
+        for(auto & client : hostedClients)
+        {
+            client->startCaching(
+                    [this, &receivedCount, &completedClients, &completed, &mutexForCompletion](
+                            const RCSResourceAttributes & att)
+                    {
+                        ++receivedCount;
+                        if(att.contains("Temperature")
+                                && att.at("Temperature") == UPDATE_COUNT
+                                && ++completedClients == HOSTED_CLIENT_COUNT)
+                        {
+                            {
+                                std::unique_lock<std::mutex> lock(mutexForCompletion);
+                                completed = std::chrono::steady_clock::now();
+                            }
+                            notifyCondition();
+                        }
+                    });
+        }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds {waitForResponse});
+    receivedCount = 0;
+
+    auto begin = std::chrono::steady_clock::now();
+    for(int i = 1; i <= UPDATE_COUNT; ++i)
+    {
+        testObject->getResourceServer()->setAttribute("Temperature", i);
+    }
+    waitForCondition(waitForResponse * 5);
+
+    for(auto & client : hostedClients)
+    {
+        client->stopCaching();
+    }
+
+    ASSERT_EQ(HOSTED_CLIENT_COUNT, completedClients);
+    EXPECT_LE(HOSTED_CLIENT_COUNT, receivedCount);
+
+    long long elapsed;
+    {
+        std::unique_lock<std::mutex> lock(mutexForCompletion);
+        elapsed = std::chrono::duration_cast< std::chrono::microseconds >(
+                completed - begin).count();
+    }
+    RecordProperty("UpdatesPerSecondTo" + std::to_string(HOSTED_CLIENT_COUNT) + "HostedClients",
+            (int)(receivedCount * 1000000LL / std::max(elapsed, 1LL)));
+}
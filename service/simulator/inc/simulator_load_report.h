@@ -0,0 +1,137 @@
+/******************************************************************
+ *
+ * Copyright 2015 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file simulator_load_report.h
+ *
+ * @brief This file provides the types for generating load on remote resources
+ *        and the report of a load generation session.
+ *
+ */
+
+#ifndef SIMULATOR_LOAD_REPORT_H_
+#define SIMULATOR_LOAD_REPORT_H_
+
+#include <map>
+#include <mutex>
+#include <string>
+#include "simulator_resource_model.h"
+
+enum class LoadRequestType
+{
+    LOAD_GET,
+    LOAD_PUT,
+    LOAD_POST,
+    /** Observe registrations, each cancelled on its first notification. */
+    LOAD_OBSERVE
+};
+
+enum class LoadMode
+{
+    /** Requests are sent at a fixed rate whatever the response time (open loop). */
+    LOAD_FIXED_RATE,
+    /** A fixed number of requests is kept in flight (closed loop). */
+    LOAD_FIXED_CONCURRENCY
+};
+
+/**
+ * @struct  LoadProfile
+ * @brief   Describes the load to be generated on a resource.
+ */
+struct LoadProfile
+{
+    LoadProfile()
+        :   type(LoadRequestType::LOAD_GET), mode(LoadMode::LOAD_FIXED_RATE),
+            requestRate(10), concurrency(1), durationSec(10), responseTimeoutSec(5) {}
+
+    LoadRequestType type;
+    LoadMode mode;
+    /** Requests per second in LOAD_FIXED_RATE mode. */
+    double requestRate;
+    /** Requests in flight in LOAD_FIXED_CONCURRENCY mode. */
+    int concurrency;
+    int durationSec;
+    /** Time given to the requests in flight after the duration elapsed. */
+    int responseTimeoutSec;
+    std::map<std::string, std::string> queryParams;
+    /** Body of PUT and POST requests. */
+    SimulatorResourceModelSP representation;
+};
+
+/**
+ * @struct  ResourceLoadStats
+ * @brief   Latencies and outcomes of the requests sent to one resource.
+ *          Latencies are in microseconds, measured from the time a request was
+ *          scheduled to be sent, so a slow server can not hide its queueing delay.
+ */
+struct ResourceLoadStats
+{
+    ResourceLoadStats()
+        :   requestCount(0), responseCount(0), timeoutCount(0), p50(0), p99(0), p999(0),
+            max(0), mean(0) {}
+
+    std::string uri;
+    long requestCount;
+    /** Successful responses, the latencies are of these responses. */
+    long responseCount;
+    /** Requests still without a response when the session ended. */
+    long timeoutCount;
+    long p50;
+    long p99;
+    long p999;
+    long max;
+    long mean;
+    /** Number of error responses and send failures per error code. */
+    std::map<int, long> errors;
+};
+
+/**
+ * @class   SimulatorLoadReport
+ * @brief   Collects the statistics of load generation sessions per resource and exports them.
+ */
+class SimulatorLoadReport
+{
+    public:
+        void add(const ResourceLoadStats &stats);
+        void merge(const SimulatorLoadReport &report);
+        std::map<std::string, ResourceLoadStats> getStats() const;
+
+        /**
+         * API for exporting the report as CSV, one line per resource.
+         *
+         * @return CSV string with a header line.
+         */
+        std::string toCSV() const;
+
+        /**
+         * API for exporting the report as a JSON array, one object per resource.
+         *
+         * @return JSON string.
+         */
+        std::string toJSON() const;
+
+    private:
+        mutable std::mutex m_lock;
+        std::map<std::string, ResourceLoadStats> m_stats;
+};
+
+typedef std::shared_ptr<SimulatorLoadReport> SimulatorLoadReportSP;
+
+#endif
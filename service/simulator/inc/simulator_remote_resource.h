@@ -30,6 +30,7 @@
 
 #include "simulator_client_types.h"
 #include "simulator_resource_model.h"
+#include "simulator_load_report.h"
 
 /**
  * @class   SimulatorRemoteResource
@@ -60,6 +61,14 @@ class SimulatorRemoteResource
         typedef std::function<void(std::string, int, OperationState)>
         StateCallback;
 
+        /**
+         * Callback method for receiving load generation progress state, and the report
+         * of the session once it is completed or aborted.
+         *
+         */
+        typedef std::function<void(std::string, int, OperationState, SimulatorLoadReportSP)>
+        LoadStateCallback;
+
         /**
          * API for getting URI of resource.
          *
@@ -150,6 +159,21 @@ class SimulatorRemoteResource
 
         virtual void stopVerification(int id) = 0;
 
+        /**
+         * API to start generating load on the resource as described by the profile.
+         * Load can only be generated on resources hosted on the loopback interface.
+         *
+         * @param profile - Request type, rate or concurrency and duration of the load.
+         * @param callback - Callback for receiving progress state and the final report.
+         *
+         * @return ID of the load generation session.
+         *
+         */
+        virtual int startLoadGeneration(const LoadProfile &profile,
+                                        LoadStateCallback callback) = 0;
+
+        virtual void stopLoadGeneration(int id) = 0;
+
         virtual void configure(const std::string &path) = 0;
 };
 
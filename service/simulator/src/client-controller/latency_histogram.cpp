@@ -0,0 +1,107 @@
+/******************************************************************
+ *
+ * Copyright 2015 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "latency_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#define EXACT_BUCKETS 128
+#define SUB_BUCKETS 64
+// values below 2^41 are kept apart, larger ones share the last bucket
+#define MAX_EXPONENT 34
+
+LatencyHistogram::LatencyHistogram()
+    :   m_buckets(EXACT_BUCKETS + MAX_EXPONENT * SUB_BUCKETS, 0),
+        m_count(0),
+        m_max(0),
+        m_sum(0) {}
+
+void LatencyHistogram::record(int64_t value)
+{
+    if (value < 0)
+        value = 0;
+
+    m_buckets[bucketIndex(value)]++;
+    m_count++;
+    m_sum += value;
+    m_max = std::max(m_max, value);
+}
+
+void LatencyHistogram::reset()
+{
+    std::fill(m_buckets.begin(), m_buckets.end(), 0);
+    m_count = 0;
+    m_max = 0;
+    m_sum = 0;
+}
+
+int64_t LatencyHistogram::mean() const
+{
+    return m_count ? m_sum / m_count : 0;
+}
+
+int64_t LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    if (!m_count)
+        return 0;
+
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    int64_t rank = static_cast<int64_t>(std::ceil(percentile / 100.0 * m_count));
+    rank = std::max(rank, static_cast<int64_t>(1));
+
+    int64_t seen = 0;
+    for (size_t index = 0; index < m_buckets.size(); index++)
+    {
+        seen += m_buckets[index];
+        if (seen >= rank)
+            return std::min(bucketValue(index), m_max);
+    }
+
+    return m_max;
+}
+
+size_t LatencyHistogram::bucketIndex(int64_t value)
+{
+    if (value < EXACT_BUCKETS)
+        return static_cast<size_t>(value);
+
+    // Shift the value until it falls in [64, 128), the shift selects the sub range
+    int exponent = 0;
+    while ((value >> exponent) >= EXACT_BUCKETS)
+        exponent++;
+
+    if (exponent > MAX_EXPONENT)
+        return EXACT_BUCKETS + MAX_EXPONENT * SUB_BUCKETS - 1;
+
+    return EXACT_BUCKETS + (exponent - 1) * SUB_BUCKETS
+           + static_cast<size_t>((value >> exponent) - SUB_BUCKETS);
+}
+
+int64_t LatencyHistogram::bucketValue(size_t index)
+{
+    if (index < EXACT_BUCKETS)
+        return static_cast<int64_t>(index);
+
+    // Highest value of the bucket
+    size_t exponent = (index - EXACT_BUCKETS) / SUB_BUCKETS + 1;
+    int64_t subBucket = (index - EXACT_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS;
+    return ((subBucket + 1) << exponent) - 1;
+}
@@ -0,0 +1,70 @@
+/******************************************************************
+ *
+ * Copyright 2015 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file latency_histogram.h
+ *
+ * @brief This file provides a histogram of latencies with a bounded relative error.
+ *
+ */
+
+#ifndef LATENCY_HISTOGRAM_H_
+#define LATENCY_HISTOGRAM_H_
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Values below 128 are counted exactly. Above, every power of two is split in 64
+ * buckets, so a value is reported with at most 1.6% error, in constant memory and
+ * whatever the range of the values.
+ */
+class LatencyHistogram
+{
+    public:
+        LatencyHistogram();
+
+        void record(int64_t value);
+        void reset();
+
+        int64_t count() const { return m_count; }
+        int64_t max() const { return m_max; }
+        int64_t mean() const;
+
+        /**
+         * @param percentile - Percentile in [0, 100].
+         *
+         * @return Smallest value which is not exceeded by the given percentile of
+         *         the recorded values, 0 if nothing was recorded.
+         */
+        int64_t valueAtPercentile(double percentile) const;
+
+    private:
+        static size_t bucketIndex(int64_t value);
+        static int64_t bucketValue(size_t index);
+
+        std::vector<int64_t> m_buckets;
+        int64_t m_count;
+        int64_t m_max;
+        int64_t m_sum;
+};
+
+#endif
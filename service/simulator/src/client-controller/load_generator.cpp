@@ -0,0 +1,199 @@
+/******************************************************************
+ *
+ * Copyright 2015 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "load_generator.h"
+#include "simulator_exceptions.h"
+#include "logger.h"
+
+#include <thread>
+
+#define TAG "LOAD_GENERATOR"
+
+LoadGenerator::LoadGenerator(int id, const std::string &uri, const LoadProfile &profile,
+                             SendFunction send, ProgressStateCallback callback)
+    :   m_id(id),
+        m_uri(uri),
+        m_profile(profile),
+        m_send(send),
+        m_callback(callback),
+        m_started(false),
+        m_stopRequested(false),
+        m_finished(false),
+        m_inFlight(0),
+        m_requestCount(0),
+        m_responseCount(0) {}
+
+void LoadGenerator::start()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_started)
+    {
+        OC_LOG(ERROR, TAG, "Operation already in progress !");
+        throw OperationInProgressException("Load generation session is already in progress!");
+    }
+
+    // The thread keeps the generator alive until the session is over
+    std::thread(&LoadGenerator::generate, shared_from_this()).detach();
+    m_started = true;
+}
+
+void LoadGenerator::stop()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_stopRequested = true;
+    m_condition.notify_all();
+}
+
+void LoadGenerator::generate()
+{
+    OC_LOG(DEBUG, TAG, "Sending OP_START event");
+    m_callback(m_id, OP_START, nullptr);
+
+    Clock::time_point startTime = Clock::now();
+    Clock::time_point endTime = startTime + std::chrono::seconds(m_profile.durationSec);
+    Clock::time_point scheduledTime;
+    long requestIndex = 0;
+
+    while (waitForNextRequest(startTime, endTime, scheduledTime, requestIndex++))
+    {
+        sendRequest(scheduledTime);
+    }
+
+    // Give the requests in flight a chance to complete, the ones which do not are timed out
+    std::unique_lock<std::mutex> lock(m_lock);
+    m_condition.wait_until(lock,
+                           Clock::now() + std::chrono::seconds(m_profile.responseTimeoutSec),
+                           [this]() { return m_inFlight == 0; });
+    m_finished = true;
+    bool aborted = m_stopRequested;
+    lock.unlock();
+
+    SimulatorLoadReportSP report = createReport();
+    if (aborted)
+    {
+        OC_LOG(DEBUG, TAG, "Sending OP_ABORT event");
+        m_callback(m_id, OP_ABORT, report);
+    }
+    else
+    {
+        OC_LOG(DEBUG, TAG, "Sending OP_COMPLETE event");
+        m_callback(m_id, OP_COMPLETE, report);
+    }
+}
+
+bool LoadGenerator::waitForNextRequest(Clock::time_point startTime, Clock::time_point endTime,
+                                       Clock::time_point &scheduledTime, long requestIndex)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    if (LoadMode::LOAD_FIXED_RATE == m_profile.mode)
+    {
+        // Requests are scheduled from the start of the session and not from the
+        // previous send, so a slow response does not lower the offered load.
+        scheduledTime = startTime + std::chrono::duration_cast<Clock::duration>(
+                            std::chrono::duration<double>(requestIndex / m_profile.requestRate));
+        if (scheduledTime >= endTime)
+            return false;
+
+        return !m_condition.wait_until(lock, scheduledTime,
+                                       [this]() { return m_stopRequested; });
+    }
+
+    bool slotFree = m_condition.wait_until(lock, endTime, [this]()
+    {
+        return m_stopRequested || m_inFlight < m_profile.concurrency;
+    });
+
+    scheduledTime = Clock::now();
+    return slotFree && !m_stopRequested;
+}
+
+void LoadGenerator::sendRequest(Clock::time_point scheduledTime)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_inFlight++;
+        m_requestCount++;
+    }
+
+    std::weak_ptr<LoadGenerator> weakSelf = shared_from_this();
+    CompletionCallback completion = [weakSelf, scheduledTime](SimulatorResult result)
+    {
+        if (LoadGeneratorSP self = weakSelf.lock())
+            self->onRequestCompleted(scheduledTime, result);
+    };
+
+    try
+    {
+        m_send(completion);
+    }
+    catch (SimulatorException &e)
+    {
+        OC_LOG_V(ERROR, TAG, "Sending request failed [errorcode: %d]", e.code());
+        onRequestCompleted(scheduledTime, e.code());
+    }
+}
+
+void LoadGenerator::onRequestCompleted(Clock::time_point scheduledTime, SimulatorResult result)
+{
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                       Clock::now() - scheduledTime);
+
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    // Responses after the report was created are left out of it
+    if (m_finished)
+        return;
+
+    m_inFlight--;
+    if (SIMULATOR_OK == result || SIMULATOR_RESOURCE_CREATED == result
+        || SIMULATOR_RESOURCE_DELETED == result)
+    {
+        m_responseCount++;
+        m_latencies.record(latency.count());
+    }
+    else
+    {
+        m_errors[result]++;
+    }
+
+    m_condition.notify_all();
+}
+
+SimulatorLoadReportSP LoadGenerator::createReport()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    ResourceLoadStats stats;
+    stats.uri = m_uri;
+    stats.requestCount = m_requestCount;
+    stats.responseCount = m_responseCount;
+    stats.timeoutCount = m_inFlight;
+    stats.p50 = m_latencies.valueAtPercentile(50);
+    stats.p99 = m_latencies.valueAtPercentile(99);
+    stats.p999 = m_latencies.valueAtPercentile(99.9);
+    stats.max = m_latencies.max();
+    stats.mean = m_latencies.mean();
+    stats.errors = m_errors;
+
+    SimulatorLoadReportSP report = std::make_shared<SimulatorLoadReport>();
+    report->add(stats);
+    return report;
+}
@@ -0,0 +1,90 @@
+/******************************************************************
+ *
+ * Copyright 2015 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file load_generator.h
+ *
+ * @brief This file provides class for generating load on a remote resource at a
+ *        configured request rate or concurrency.
+ *
+ */
+
+#ifndef LOAD_GENERATOR_H_
+#define LOAD_GENERATOR_H_
+
+#include "simulator_client_types.h"
+#include "simulator_load_report.h"
+#include "latency_histogram.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+class LoadGenerator : public std::enable_shared_from_this<LoadGenerator>
+{
+    public:
+        typedef std::chrono::steady_clock Clock;
+        typedef std::function<void (SimulatorResult)> CompletionCallback;
+        typedef std::function<void (CompletionCallback)> SendFunction;
+        typedef std::function<void (int, OperationState, SimulatorLoadReportSP)>
+        ProgressStateCallback;
+
+        /**
+         * @param send - Sends one request, and calls the given callback with the
+         *               result of the request once its response is received.
+         *               Throws SimulatorException if the request could not be sent.
+         */
+        LoadGenerator(int id, const std::string &uri, const LoadProfile &profile,
+                      SendFunction send, ProgressStateCallback callback);
+
+        int id() const {return m_id;}
+        void start();
+        void stop();
+
+    private:
+        void generate();
+        bool waitForNextRequest(Clock::time_point startTime, Clock::time_point endTime,
+                                Clock::time_point &scheduledTime, long requestIndex);
+        void sendRequest(Clock::time_point scheduledTime);
+        void onRequestCompleted(Clock::time_point scheduledTime, SimulatorResult result);
+        SimulatorLoadReportSP createReport();
+
+        int m_id;
+        std::string m_uri;
+        LoadProfile m_profile;
+        SendFunction m_send;
+        ProgressStateCallback m_callback;
+
+        std::mutex m_lock;
+        std::condition_variable m_condition;
+        bool m_started;
+        bool m_stopRequested;
+        bool m_finished;
+        int m_inFlight;
+        long m_requestCount;
+        long m_responseCount;
+        std::map<int, long> m_errors;
+        LatencyHistogram m_latencies;
+};
+
+typedef std::shared_ptr<LoadGenerator> LoadGeneratorSP;
+
+#endif
@@ -0,0 +1,133 @@
+/******************************************************************
+ *
+ * Copyright 2015 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "simulator_load_report.h"
+
+#include <sstream>
+
+static std::string escapeJSON(const std::string &value)
+{
+    std::ostringstream escaped;
+    for (auto ch : value)
+    {
+        if ('"' == ch || '\\' == ch)
+            escaped << '\\';
+        escaped << ch;
+    }
+
+    return escaped.str();
+}
+
+static std::string escapeCSV(const std::string &value)
+{
+    if (std::string::npos == value.find_first_of(",\"\n"))
+        return value;
+
+    std::ostringstream escaped;
+    escaped << '"';
+    for (auto ch : value)
+    {
+        if ('"' == ch)
+            escaped << '"';
+        escaped << ch;
+    }
+    escaped << '"';
+
+    return escaped.str();
+}
+
+void SimulatorLoadReport::add(const ResourceLoadStats &stats)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    m_stats[stats.uri] = stats;
+}
+
+void SimulatorLoadReport::merge(const SimulatorLoadReport &report)
+{
+    if (this == &report)
+        return;
+
+    for (auto &stats : report.getStats())
+    {
+        add(stats.second);
+    }
+}
+
+std::map<std::string, ResourceLoadStats> SimulatorLoadReport::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_stats;
+}
+
+std::string SimulatorLoadReport::toCSV() const
+{
+    std::ostringstream csv;
+    csv << "uri,requests,responses,timeouts,p50_us,p99_us,p999_us,max_us,mean_us,errors\n";
+
+    for (auto &entry : getStats())
+    {
+        const ResourceLoadStats &stats = entry.second;
+        csv << escapeCSV(stats.uri) << "," << stats.requestCount << "," << stats.responseCount
+            << "," << stats.timeoutCount << "," << stats.p50 << "," << stats.p99 << ","
+            << stats.p999 << "," << stats.max << "," << stats.mean << ",";
+
+        // Errors are listed as "code:count" pairs separated by ';'
+        for (auto error = stats.errors.begin(); error != stats.errors.end(); ++error)
+        {
+            if (error != stats.errors.begin())
+                csv << ";";
+            csv << error->first << ":" << error->second;
+        }
+        csv << "\n";
+    }
+
+    return csv.str();
+}
+
+std::string SimulatorLoadReport::toJSON() const
+{
+    std::ostringstream json;
+    json << "[";
+
+    bool first = true;
+    for (auto &entry : getStats())
+    {
+        const ResourceLoadStats &stats = entry.second;
+        json << (first ? "" : ",") << "{\"uri\":\"" << escapeJSON(stats.uri) << "\""
+             << ",\"requests\":" << stats.requestCount
+             << ",\"responses\":" << stats.responseCount
+             << ",\"timeouts\":" << stats.timeoutCount
+             << ",\"latencyUs\":{\"p50\":" << stats.p50 << ",\"p99\":" << stats.p99
+             << ",\"p999\":" << stats.p999 << ",\"max\":" << stats.max
+             << ",\"mean\":" << stats.mean << "}"
+             << ",\"errors\":{";
+
+        for (auto error = stats.errors.begin(); error != stats.errors.end(); ++error)
+        {
+            json << (error != stats.errors.begin() ? "," : "")
+                 << "\"" << error->first << "\":" << error->second;
+        }
+        json << "}}";
+        first = false;
+    }
+
+    json << "]";
+    return json.str();
+}
@@ -32,6 +32,7 @@ SimulatorRemoteResourceImpl::SimulatorRemoteResourceImpl(std::shared_ptr<OC::OCR
         m_putRequestSender(new PUTRequestSender(ocResource)),
         m_postRequestSender(new POSTRequestSender(ocResource)),
         m_autoRequestGenMngr(nullptr),
+        m_loadGenId(0),
         m_ocResource(ocResource)
 {
     m_id = m_ocResource->sid().append(m_ocResource->uri());
@@ -352,6 +353,164 @@ void SimulatorRemoteResourceImpl::stopVerification(int id)
     m_autoRequestGenMngr->stop(id);
 }
 
+int SimulatorRemoteResourceImpl::startLoadGeneration(const LoadProfile &profile,
+        LoadStateCallback callback)
+{
+    if (!callback)
+    {
+        OC_LOG(ERROR, TAG, "Invalid callback!");
+        throw InvalidArgsException(SIMULATOR_INVALID_CALLBACK, "Invalid callback!");
+    }
+
+    if ((LoadMode::LOAD_FIXED_RATE == profile.mode && profile.requestRate <= 0)
+        || (LoadMode::LOAD_FIXED_CONCURRENCY == profile.mode && profile.concurrency <= 0)
+        || profile.durationSec <= 0 || profile.responseTimeoutSec < 0)
+    {
+        OC_LOG(ERROR, TAG, "Invalid load profile!");
+        throw InvalidArgsException(SIMULATOR_INVALID_PARAM, "Invalid load profile!");
+    }
+
+    // Load is only generated on servers of the local host
+    if (!isLoopbackHost())
+    {
+        OC_LOG_V(ERROR, TAG, "Resource host is not a loopback address [%s]",
+                 m_ocResource->host().c_str());
+        throw NoSupportException("Load can only be generated on resources hosted on loopback!");
+    }
+
+    LoadGenerator::SendFunction sendFunction = createLoadSender(profile);
+
+    // Local callback for handling progress state callback
+    std::lock_guard<std::mutex> lock(m_loadGenLock);
+    int id = m_loadGenId++;
+    LoadGenerator::ProgressStateCallback localCallback = [this, callback](int sessionId,
+            OperationState state, SimulatorLoadReportSP report)
+    {
+        if (OP_START != state)
+        {
+            std::lock_guard<std::mutex> lock(m_loadGenLock);
+            m_loadGenList.erase(sessionId);
+        }
+
+        callback(m_id, sessionId, state, report);
+    };
+
+    LoadGeneratorSP loadGen = std::make_shared<LoadGenerator>(id, getURI(), profile,
+                              sendFunction, localCallback);
+    m_loadGenList[id] = loadGen;
+    loadGen->start();
+    return id;
+}
+
+void SimulatorRemoteResourceImpl::stopLoadGeneration(int id)
+{
+    std::lock_guard<std::mutex> lock(m_loadGenLock);
+    if (m_loadGenList.end() == m_loadGenList.find(id))
+    {
+        OC_LOG(ERROR, TAG, "Invalid session id!");
+        throw InvalidArgsException(SIMULATOR_INVALID_PARAM, "Invalid ID!");
+    }
+
+    m_loadGenList[id]->stop();
+}
+
+bool SimulatorRemoteResourceImpl::isLoopbackHost() const
+{
+    // Host is of the form "coap://127.0.0.1:5683" or "coap://[::1]:5683"
+    std::string host = m_ocResource->host();
+    size_t addressPos = host.find("://");
+    addressPos = (std::string::npos == addressPos) ? 0 : addressPos + 3;
+
+    return 0 == host.compare(addressPos, 4, "127.")
+           || 0 == host.compare(addressPos, 5, "[::1]")
+           || 0 == host.compare(addressPos, 9, "localhost");
+}
+
+LoadGenerator::SendFunction SimulatorRemoteResourceImpl::createLoadSender(
+    const LoadProfile &profile)
+{
+    std::map<std::string, std::string> queryParams = profile.queryParams;
+    SimulatorResourceModelSP representation = profile.representation;
+    RequestSenderSP requestSender;
+
+    switch (profile.type)
+    {
+        case LoadRequestType::LOAD_GET:
+            requestSender = m_getRequestSender;
+            break;
+
+        case LoadRequestType::LOAD_PUT:
+            requestSender = m_putRequestSender;
+            break;
+
+        case LoadRequestType::LOAD_POST:
+            requestSender = m_postRequestSender;
+            break;
+
+        case LoadRequestType::LOAD_OBSERVE:
+            {
+                if (!isObservable())
+                    throw NoSupportException("Resource is not observable!");
+
+                // Every request registers as a new observer, and cancels the
+                // observation once it is notified the registration result.
+                std::shared_ptr<OC::OCResource> ocResource = m_ocResource;
+                return [ocResource, queryParams](LoadGenerator::CompletionCallback done)
+                {
+                    auto observer = std::make_shared<std::shared_ptr<OC::OCResource>>(
+                                        OC::OCPlatform::constructResourceObject(ocResource->host(),
+                                                ocResource->uri(), ocResource->connectivityType(), true,
+                                                ocResource->getResourceTypes(),
+                                                ocResource->getResourceInterfaces()));
+
+                    OC::ObserveCallback observeCallback = [observer, done](
+                            const OC::HeaderOptions &, const OC::OCRepresentation &,
+                            const int errorCode, const int)
+                    {
+                        std::shared_ptr<OC::OCResource> resource;
+                        resource.swap(*observer);
+                        if (!resource)
+                            return;
+
+                        resource->cancelObserve(OC::QualityOfService::LowQos);
+                        done(static_cast<SimulatorResult>(errorCode));
+                    };
+
+                    OCStackResult ocResult = (*observer)->observe(OC::ObserveType::Observe,
+                                             queryParams, observeCallback);
+                    if (OC_STACK_OK != ocResult)
+                    {
+                        observer->reset();
+                        throw SimulatorException(static_cast<SimulatorResult>(ocResult),
+                                                 OC::OCException::reason(ocResult));
+                    }
+                };
+            }
+    }
+
+    if (!requestSender)
+    {
+        OC_LOG(ERROR, TAG, "Invalid request sender!");
+        throw NoSupportException("Can not send this request on this resource!");
+    }
+
+    if (LoadRequestType::LOAD_GET != profile.type && !representation)
+    {
+        OC_LOG(ERROR, TAG, "Invalid representation!");
+        throw InvalidArgsException(SIMULATOR_INVALID_PARAM, "Representation is required!");
+    }
+
+    return [requestSender, queryParams, representation](
+               LoadGenerator::CompletionCallback done)
+    {
+        requestSender->sendRequest(queryParams, representation,
+                                   [done](SimulatorResult result, SimulatorResourceModelSP)
+        {
+            done(result);
+        });
+    };
+}
+
 void SimulatorRemoteResourceImpl::configure(const std::string &path)
 {
     if (path.empty())
@@ -30,6 +30,7 @@
 
 #include "simulator_remote_resource.h"
 #include "auto_request_gen_mngr.h"
+#include "load_generator.h"
 #include "RamlParser.h"
 #include "request_model.h"
 
@@ -78,6 +79,8 @@ class SimulatorRemoteResourceImpl : public SimulatorRemoteResource
 
         int startVerification(RequestType type, StateCallback callback);
         void stopVerification(int id);
+        int startLoadGeneration(const LoadProfile &profile, LoadStateCallback callback);
+        void stopLoadGeneration(int id);
         void configure(const std::string &path);
 
     private:
@@ -85,6 +88,8 @@ class SimulatorRemoteResourceImpl : public SimulatorRemoteResource
         void onResponseReceived(SimulatorResult result, SimulatorResourceModelSP repModel,
                                 ResponseCallback clientCallback);
         SimulatorConnectivityType convertConnectivityType(OCConnectivityType type) const;
+        bool isLoopbackHost() const;
+        LoadGenerator::SendFunction createLoadSender(const LoadProfile &profile);
 
         std::string m_id;
         std::mutex m_observeMutex;
@@ -94,6 +99,9 @@ class SimulatorRemoteResourceImpl : public SimulatorRemoteResource
         POSTRequestSenderSP m_postRequestSender;
         AutoRequestGenMngrSP m_autoRequestGenMngr;
         std::map<RequestType, RequestModelSP> m_requestModelList;
+        std::mutex m_loadGenLock;
+        std::map<int, LoadGeneratorSP> m_loadGenList;
+        int m_loadGenId;
         std::shared_ptr<OC::OCResource> m_ocResource;
 };
 
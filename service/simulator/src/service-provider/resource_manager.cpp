@@ -79,19 +79,17 @@ std::vector<SimulatorResourceServerSP> ResourceManager::createResource(
 
     std::vector<SimulatorResourceServerSP> resourceList;
 
-    // Create resources
-    for (unsigned short i = 0; i < count; i++)
-    {
-        OC_LOG_V(INFO, TAG, "Creating resource [%d]", i + 1);
-        SIM_LOG(ILogger::INFO, "Creating resource [" << i + 1 << "]");
+    // Create resources from a single parse of the RAML file
+    std::vector<SimulatorResourceServerImplSP> resourceImplList =
+        m_resourceCreator.createResources(configPath, count);
+    resourceList.reserve(resourceImplList.size());
 
-        SimulatorResourceServerSP resource = buildResource(configPath, callback);
-        if (!resource)
-        {
-            break;
-        }
+    for (auto &resourceImpl : resourceImplList)
+    {
+        OC_LOG_V(INFO, TAG, "Creating resource [%d]", (int) resourceList.size() + 1);
 
-        resourceList.push_back(resource);
+        registerResource(resourceImpl, callback);
+        resourceList.push_back(resourceImpl);
     }
 
     SIM_LOG(ILogger::INFO, "[" << resourceList.size() << " out of " << count <<
@@ -183,19 +181,23 @@ SimulatorResourceServerSP ResourceManager::buildResource(const std::string &conf
         throw SimulatorException(SIMULATOR_ERROR, "Failed to create resource!");
     }
 
+    registerResource(resourceImpl, callback);
+    return resourceImpl;
+}
+
+void ResourceManager::registerResource(const SimulatorResourceServerImplSP &resourceImpl,
+                                       SimulatorResourceServer::ResourceModelChangedCB callback)
+{
     resourceImpl->setModelChangeCallback(callback);
     resourceImpl->start();
 
     // Add the resource to resource list table
     std::lock_guard<std::recursive_mutex> lock(m_lock);
-    SimulatorResourceServerSP resource =
-        std::dynamic_pointer_cast<SimulatorResourceServer>(resourceImpl);
     m_resources[resourceImpl->getResourceType()].insert(
         std::pair<std::string, SimulatorResourceServerSP>(resourceImpl->getURI(), resourceImpl));
 
     SIM_LOG(ILogger::INFO, "Created an OIC resource of type [" <<
             resourceImpl->getResourceType() << "]");
-    return resourceImpl;
 }
 
 /**
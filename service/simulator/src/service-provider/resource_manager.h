@@ -106,6 +106,8 @@ class ResourceManager
 
         SimulatorResourceServerSP buildResource(const std::string &configPath,
                                                 SimulatorResourceServer::ResourceModelChangedCB callback);
+        void registerResource(const SimulatorResourceServerImplSP &resourceImpl,
+                              SimulatorResourceServer::ResourceModelChangedCB callback);
         std::string constructURI(const std::string &uri);
 
         /*Member variables*/
@@ -20,6 +20,7 @@
 
 #include "resource_update_automation.h"
 #include "simulator_resource_server_impl.h"
+#include "update_scheduler.h"
 #include "simulator_exceptions.h"
 #include "simulator_logger.h"
 #include "logger.h"
@@ -27,8 +28,6 @@
 #define ATAG "ATTRIBUTE_AUTOMATION"
 #define RTAG "RESOURCE_AUTOMATION"
 
-#define SLEEP_FOR(X) if (X > 0) std::this_thread::sleep_for(std::chrono::milliseconds(X));
-
 AttributeUpdateAutomation::AttributeUpdateAutomation(int id, SimulatorResourceServer *resource,
         const std::string &attrName, AutomationType type, int interval,
         updateCompleteCallback callback, std::function<void (const int)> finishedCallback)
@@ -36,11 +35,11 @@ AttributeUpdateAutomation::AttributeUpdateAutomation(int id, SimulatorResourceSe
         m_attrName(attrName),
         m_type(type),
         m_id(id),
-        m_stopRequested(false),
         m_updateInterval(interval),
         m_callback(callback),
         m_finishedCallback(finishedCallback),
-        m_thread(nullptr) {}
+        m_scheduleId(-1),
+        m_nextValue(0) {}
 
 void AttributeUpdateAutomation::start()
 {
@@ -52,6 +51,14 @@ void AttributeUpdateAutomation::start()
         throw SimulatorException(SIMULATOR_ERROR, "Attribute is not present in resource!");
     }
 
+    SimulatorResourceServerImpl *resourceImpl =
+        dynamic_cast<SimulatorResourceServerImpl *>(m_resource);
+    if (!resourceImpl)
+    {
+        OC_LOG(ERROR, ATAG, "Invalid resource!");
+        throw SimulatorException(SIMULATOR_ERROR, "Invalid resource!");
+    }
+
     if (m_updateInterval < 0)
     {
         m_updateInterval = m_attribute.getUpdateFrequencyTime();
@@ -59,53 +66,31 @@ void AttributeUpdateAutomation::start()
             m_updateInterval = 0;
     }
 
-    m_thread = new std::thread(&AttributeUpdateAutomation::updateAttribute, this);
-}
+    if (SimulatorResourceModel::Attribute::ValueType::INTEGER == m_attribute.getValueType())
+    {
+        int max;
+        m_attribute.getRange(m_nextValue, max);
+    }
 
-void AttributeUpdateAutomation::stop()
-{
-    m_stopRequested = true;
-    if (m_thread)
-        m_thread->join();
+    m_scheduleId = UpdateScheduler::getInstance()->schedule(resourceImpl, m_updateInterval,
+                   std::bind(&AttributeUpdateAutomation::updateAttribute, this),
+                   std::bind(&AttributeUpdateAutomation::completed, this));
 }
 
-void AttributeUpdateAutomation::updateAttribute()
+void AttributeUpdateAutomation::stop()
 {
-    do
-    {
-        try
-        {
-            setAttributeValue();
-        }
-        catch (SimulatorException &e)
-        {
-            break;
-        }
-        if (m_stopRequested)
-            break;
-    }
-    while (AutomationType::RECURRENT == m_type);
-
-    if (!m_stopRequested)
-    {
-        OC_LOG_V(DEBUG, ATAG, "Attribute:%s automation is completed!", m_attrName.c_str());
-        SIM_LOG(ILogger::INFO, "Automation of " << m_attrName << " attribute is completed.");
-    }
+    if (m_scheduleId < 0)
+        return;
 
-    // Notify application through callback
-    if (m_callback)
+    // The application is told the automation is over even when it is stopped
+    if (UpdateScheduler::getInstance()->cancel(m_scheduleId) && m_callback)
         m_callback(m_resource->getURI(), m_id);
-
-    if (m_finishedCallback && !m_stopRequested)
-        m_finishedCallback(m_id);
 }
 
-void AttributeUpdateAutomation::setAttributeValue()
+bool AttributeUpdateAutomation::updateAttribute()
 {
     SimulatorResourceServerImpl *resourceImpl =
         dynamic_cast<SimulatorResourceServerImpl *>(m_resource);
-    if (!resourceImpl)
-        return;
 
     if (SimulatorResourceModel::Attribute::ValueType::INTEGER ==
             m_attribute.getValueType()) // For integer type values
@@ -114,26 +99,44 @@ void AttributeUpdateAutomation::setAttributeValue()
         int max;
 
         m_attribute.getRange(min, max);
-        for (int value = min; value <= max; value++)
-        {
-            if (m_stopRequested)
-                break;
-            resourceImpl->updateAttributeValue(m_attribute.getName(), value);
-            resourceImpl->notifyApp();
-            SLEEP_FOR(m_updateInterval);
-        }
+        if (m_nextValue > max && AutomationType::RECURRENT == m_type)
+            m_nextValue = min;
+        if (m_nextValue > max)
+            return false;
+
+        resourceImpl->setAttributeValue(m_attribute.getName(), m_nextValue++);
     }
     else
     {
-        for (int index = 0; index < m_attribute.getAllowedValuesSize(); index++)
-        {
-            if (m_stopRequested)
-                break;
-            resourceImpl->updateFromAllowedValues(m_attribute.getName(), index);
-            resourceImpl->notifyApp();
-            SLEEP_FOR(m_updateInterval);
-        }
+        if (m_nextValue >= m_attribute.getAllowedValuesSize()
+            && AutomationType::RECURRENT == m_type)
+            m_nextValue = 0;
+        if (m_nextValue >= m_attribute.getAllowedValuesSize())
+            return false;
+
+        resourceImpl->setFromAllowedValues(m_attribute.getName(), m_nextValue++);
     }
+
+    return true;
+}
+
+void AttributeUpdateAutomation::completed()
+{
+    OC_LOG_V(DEBUG, ATAG, "Attribute:%s automation is completed!", m_attrName.c_str());
+    SIM_LOG(ILogger::INFO, "Automation of " << m_attrName << " attribute is completed.");
+
+    // The finished callback may release this automation
+    updateCompleteCallback callback = m_callback;
+    std::function<void (const int)> finishedCallback = m_finishedCallback;
+    std::string uri = m_resource->getURI();
+    int id = m_id;
+
+    // Notify application through callback
+    if (callback)
+        callback(uri, id);
+
+    if (finishedCallback)
+        finishedCallback(id);
 }
 
 ResourceUpdateAutomation::ResourceUpdateAutomation(int id, SimulatorResourceServer *resource,
@@ -143,6 +146,7 @@ ResourceUpdateAutomation::ResourceUpdateAutomation(int id, SimulatorResourceServ
         m_type(type),
         m_id(id),
         m_updateInterval(interval),
+        m_stopRequested(false),
         m_callback(callback),
         m_finishedCallback(finishedCallback) {}
 
@@ -163,7 +167,11 @@ void ResourceUpdateAutomation::start()
                     id, m_resource, attribute.first, m_type, m_updateInterval, nullptr,
                     std::bind(&ResourceUpdateAutomation::finished, this, std::placeholders::_1)));
 
-        m_attrUpdationList[id++] = attributeAutomation;
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_attrUpdationList[id++] = attributeAutomation;
+        }
+
         try
         {
             attributeAutomation->start();
@@ -178,29 +186,43 @@ void ResourceUpdateAutomation::start()
 
 void ResourceUpdateAutomation::finished(int id)
 {
-    if (m_attrUpdationList.end() != m_attrUpdationList.find(id))
     {
-        m_attrUpdationList.erase(m_attrUpdationList.find(id));
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (m_attrUpdationList.end() != m_attrUpdationList.find(id))
+        {
+            m_attrUpdationList.erase(m_attrUpdationList.find(id));
+        }
+
+        if (m_stopRequested || m_attrUpdationList.size())
+            return;
     }
 
-    if (!m_attrUpdationList.size())
-    {
-        // Notify application through callback
-        if (m_callback)
-            m_callback(m_resource->getURI(), m_id);
+    // The finished callback may release this automation
+    updateCompleteCallback callback = m_callback;
+    std::function<void (const int)> finishedCallback = m_finishedCallback;
+    int resourceAutomationId = m_id;
 
-        if (m_finishedCallback)
-            m_finishedCallback(m_id);
-    }
+    // Notify application through callback
+    if (callback)
+        callback(m_resource->getURI(), resourceAutomationId);
+
+    if (finishedCallback)
+        finishedCallback(resourceAutomationId);
 }
 
 void ResourceUpdateAutomation::stop()
 {
+    // Attribute automations may complete meanwhile, and are stopped without the lock
+    std::map<int, AttributeUpdateAutomationSP> attrUpdationList;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_stopRequested = true;
+        attrUpdationList.swap(m_attrUpdationList);
+    }
+
     // Stop all the attributes updation
-    for (auto & attrAutomation : m_attrUpdationList)
+    for (auto & attrAutomation : attrUpdationList)
     {
         (attrAutomation.second)->stop();
     }
-
-    m_attrUpdationList.clear();
 }
@@ -22,7 +22,7 @@
 #define RESOURCE_UPDATE_AUTOMATION_H_
 
 #include "simulator_resource_server.h"
-#include <thread>
+#include <mutex>
 
 class AttributeUpdateAutomation
 {
@@ -37,19 +37,20 @@ class AttributeUpdateAutomation
         void stop();
 
     private:
-        void updateAttribute();
-        void setAttributeValue();
+        bool updateAttribute();
+        void completed();
 
         SimulatorResourceServer *m_resource;
         std::string m_attrName;
         AutomationType m_type;
         int m_id;
-        bool m_stopRequested;
         int m_updateInterval;
         SimulatorResourceModel::Attribute m_attribute;
         updateCompleteCallback m_callback;
         std::function<void (const int)> m_finishedCallback;
-        std::thread *m_thread;
+        int m_scheduleId;
+        // next integer value, or index of the next allowed value
+        int m_nextValue;
 };
 
 typedef std::shared_ptr<AttributeUpdateAutomation> AttributeUpdateAutomationSP;
@@ -74,6 +75,8 @@ class ResourceUpdateAutomation
         int m_id;
         int m_updateInterval;
         SimulatorResourceModel m_resModel;
+        std::mutex m_lock;
+        bool m_stopRequested;
         std::map<int, AttributeUpdateAutomationSP> m_attrUpdationList;
         updateCompleteCallback m_callback;
         std::function<void (const int)> m_finishedCallback;
@@ -100,36 +100,50 @@ std::vector<int> UpdateAutomationMngr::getAttributeAutomationIds()
 
 void UpdateAutomationMngr::stop(int id)
 {
-    std::lock_guard<std::mutex> lock(m_lock);
-    if (m_resourceUpdationList.end() != m_resourceUpdationList.find(id))
+    // Automations are stopped without the lock, as they may be completing meanwhile
+    ResourceUpdateAutomationSP resourceAutomation;
+    AttributeUpdateAutomationSP attributeAutomation;
     {
-        m_resourceUpdationList[id]->stop();
-        m_resourceUpdationList.erase(m_resourceUpdationList.find(id));
-    }
-    else if (m_attrUpdationList.end() != m_attrUpdationList.find(id))
-    {
-        m_attrUpdationList[id]->stop();
-        m_attrUpdationList.erase(m_attrUpdationList.find(id));
+        std::lock_guard<std::mutex> lock(m_lock);
+        if (m_resourceUpdationList.end() != m_resourceUpdationList.find(id))
+        {
+            resourceAutomation = m_resourceUpdationList[id];
+            m_resourceUpdationList.erase(m_resourceUpdationList.find(id));
+        }
+        else if (m_attrUpdationList.end() != m_attrUpdationList.find(id))
+        {
+            attributeAutomation = m_attrUpdationList[id];
+            m_attrUpdationList.erase(m_attrUpdationList.find(id));
+        }
     }
+
+    if (resourceAutomation)
+        resourceAutomation->stop();
+    else if (attributeAutomation)
+        attributeAutomation->stop();
 }
 
 void UpdateAutomationMngr::stopAll()
 {
-    std::lock_guard<std::mutex> lock(m_lock);
-    std::for_each(m_resourceUpdationList.begin(),
-                  m_resourceUpdationList.end(), [] (std::pair<int, ResourceUpdateAutomationSP> element)
+    std::map<int, ResourceUpdateAutomationSP> resourceUpdationList;
+    std::map<int, AttributeUpdateAutomationSP> attrUpdationList;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        resourceUpdationList.swap(m_resourceUpdationList);
+        attrUpdationList.swap(m_attrUpdationList);
+    }
+
+    std::for_each(resourceUpdationList.begin(),
+                  resourceUpdationList.end(), [] (std::pair<int, ResourceUpdateAutomationSP> element)
     {
         element.second->stop();
     });
-    m_resourceUpdationList.clear();
 
-    std::for_each(m_attrUpdationList.begin(),
-                  m_attrUpdationList.end(), [] (std::pair<int, AttributeUpdateAutomationSP> element)
+    std::for_each(attrUpdationList.begin(),
+                  attrUpdationList.end(), [] (std::pair<int, AttributeUpdateAutomationSP> element)
     {
         element.second->stop();
     });
-
-    m_attrUpdationList.clear();
 }
 
 void UpdateAutomationMngr::automationCompleted(int id)
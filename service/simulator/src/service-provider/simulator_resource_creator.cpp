@@ -29,19 +29,44 @@ unsigned int SimulatorResourceCreator::s_id;
 SimulatorResourceServerImplSP SimulatorResourceCreator::createResource(
     const std::string &configPath)
 {
-    RAML::RamlPtr raml;
+    return createResource(parseRAML(configPath));
+}
+
+std::vector<SimulatorResourceServerImplSP> SimulatorResourceCreator::createResources(
+    const std::string &configPath, unsigned short count)
+{
+    RAML::RamlPtr raml = parseRAML(configPath);
+
+    std::vector<SimulatorResourceServerImplSP> resources;
+    resources.reserve(count);
+    for (unsigned short i = 0; i < count; i++)
+    {
+        SimulatorResourceServerImplSP resource = createResource(raml);
+        if (!resource)
+            break;
+
+        resources.push_back(resource);
+    }
+
+    return resources;
+}
 
+RAML::RamlPtr SimulatorResourceCreator::parseRAML(const std::string &configPath)
+{
     try
     {
         std::shared_ptr<RAML::RamlParser> ramlParser = std::make_shared<RAML::RamlParser>(configPath);
-        raml = ramlParser->getRamlPtr();
+        return ramlParser->getRamlPtr();
     }
     catch (RAML::RamlException &e)
     {
         OC_LOG_V(ERROR, TAG, "RAML Exception occured! [%s]", e.what());
         throw;
     }
+}
 
+SimulatorResourceServerImplSP SimulatorResourceCreator::createResource(const RAML::RamlPtr &raml)
+{
     std::map<std::string, RAML::RamlResourcePtr> ramlResources = raml->getResources();
     RAML::RamlResourcePtr ramlResource;
     if (0 == ramlResources.size() || (ramlResource = ramlResources.begin()->second) == nullptr)
@@ -22,13 +22,22 @@
 #define SIMULATOR_RESOURCE_CREATOR_H_
 
 #include "simulator_resource_server_impl.h"
+#include "Raml.h"
 
 class SimulatorResourceCreator
 {
     public:
         SimulatorResourceServerImplSP createResource(const std::string &configPath);
 
+        /**
+         * Creates resources of the same type, parsing the RAML file only once.
+         */
+        std::vector<SimulatorResourceServerImplSP> createResources(const std::string &configPath,
+                unsigned short count);
+
     private:
+        RAML::RamlPtr parseRAML(const std::string &configPath);
+        SimulatorResourceServerImplSP createResource(const RAML::RamlPtr &raml);
         std::string constructURI(const std::string &uri);
         static unsigned int s_id;
 };
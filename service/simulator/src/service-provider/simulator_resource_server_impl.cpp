@@ -246,6 +246,23 @@ void SimulatorResourceServerImpl::notifyApp()
     }
 }
 
+void SimulatorResourceServerImpl::setAttributeValue(const std::string &attrName, int value)
+{
+    m_resModel.updateAttribute(attrName, value);
+}
+
+void SimulatorResourceServerImpl::setFromAllowedValues(const std::string &attrName,
+        unsigned int index)
+{
+    m_resModel.updateAttributeFromAllowedValues(attrName, index);
+}
+
+void SimulatorResourceServerImpl::notifyUpdated()
+{
+    notifyAll();
+    notifyApp();
+}
+
 OC::OCRepresentation SimulatorResourceServerImpl::getOCRepresentation()
 {
     return m_resModel.getOCRepresentation();
@@ -69,6 +69,16 @@ class SimulatorResourceServerImpl : public SimulatorResourceServer
 
         void notifyApp();
 
+        /**
+         * Updates the resource model without notifying, so the updates of the automations
+         * which are due together are notified once with notifyUpdated().
+         */
+        void setAttributeValue(const std::string &attrName, int value);
+
+        void setFromAllowedValues(const std::string &attrName, unsigned int index);
+
+        void notifyUpdated();
+
     private:
         OC::OCRepresentation getOCRepresentation();
         bool modifyResourceModel(OC::OCRepresentation &ocRep);
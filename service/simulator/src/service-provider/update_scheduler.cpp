@@ -0,0 +1,267 @@
+/******************************************************************
+ *
+ * Copyright 2015 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "update_scheduler.h"
+#include "simulator_resource_server_impl.h"
+#include "simulator_exceptions.h"
+#include "logger.h"
+
+#include <chrono>
+
+#define TAG "UPDATE_SCHEDULER"
+
+// Resolution of the update intervals
+#define SCHEDULER_TICK_MS 10
+// Number of slots of the timer wheel, intervals longer than a turn take several rounds
+#define SCHEDULER_WHEEL_SIZE 512
+#define SCHEDULER_MIN_WORKERS 2
+
+// Set on the worker threads, which must not wait for their own batches to complete
+static thread_local bool s_isWorkerThread = false;
+
+UpdateScheduler *UpdateScheduler::getInstance()
+{
+    static UpdateScheduler s_instance;
+    return &s_instance;
+}
+
+UpdateScheduler::UpdateScheduler()
+    :   m_started(false),
+        m_stopRequested(false),
+        m_id(0),
+        m_wheel(SCHEDULER_WHEEL_SIZE) {}
+
+UpdateScheduler::~UpdateScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_stopRequested = true;
+        m_timerCondition.notify_all();
+        for (auto &worker : m_workers)
+            worker->condition.notify_all();
+    }
+
+    if (m_timerThread.joinable())
+        m_timerThread.join();
+
+    for (auto &worker : m_workers)
+    {
+        if (worker->thread.joinable())
+            worker->thread.join();
+    }
+}
+
+int UpdateScheduler::schedule(SimulatorResourceServerImpl *resource, int interval,
+                              UpdateFunction update, FinishedCallback finished)
+{
+    if (!resource || !update)
+    {
+        OC_LOG(ERROR, TAG, "Invalid resource or update function!");
+        throw InvalidArgsException(SIMULATOR_INVALID_PARAM, "Invalid update schedule!");
+    }
+
+    EntrySP entry = std::make_shared<Entry>();
+    entry->resource = resource;
+    entry->intervalTicks = (interval > SCHEDULER_TICK_MS) ?
+                           (interval + SCHEDULER_TICK_MS - 1) / SCHEDULER_TICK_MS : 1;
+    entry->update = update;
+    entry->finished = finished;
+    entry->cancelled = false;
+    entry->runningBatches = 0;
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (!m_started)
+        startThreads();
+
+    entry->id = m_id++;
+    m_entries[entry->id] = entry;
+
+    // The first update is applied on the next tick
+    m_wheel.insert(entry, 1);
+    return entry->id;
+}
+
+bool UpdateScheduler::cancel(int id)
+{
+    std::unique_lock<std::mutex> lock(m_lock);
+    auto entryIter = m_entries.find(id);
+    if (m_entries.end() == entryIter)
+        return false;
+
+    EntrySP entry = entryIter->second;
+    entry->cancelled = true;
+
+    if (!s_isWorkerThread)
+    {
+        m_entryDone.wait(lock, [&entry]() { return 0 == entry->runningBatches; });
+    }
+
+    // Entries in the wheel are dropped once they are due
+    m_entries.erase(id);
+    return true;
+}
+
+void UpdateScheduler::startThreads()
+{
+    unsigned int workerCount = std::thread::hardware_concurrency();
+    if (workerCount < SCHEDULER_MIN_WORKERS)
+        workerCount = SCHEDULER_MIN_WORKERS;
+
+    for (unsigned int i = 0; i < workerCount; i++)
+    {
+        m_workers.emplace_back(new Worker);
+        m_workers.back()->thread = std::thread(&UpdateScheduler::runWorker, this,
+                                               m_workers.back().get());
+    }
+
+    m_timerThread = std::thread(&UpdateScheduler::runTimer, this);
+    m_started = true;
+}
+
+void UpdateScheduler::runTimer()
+{
+    auto nextTick = std::chrono::steady_clock::now();
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    while (!m_stopRequested)
+    {
+        nextTick += std::chrono::milliseconds(SCHEDULER_TICK_MS);
+        if (m_timerCondition.wait_until(lock, nextTick, [this]() { return m_stopRequested; }))
+            break;
+
+        // Batch the due updates per resource
+        std::map<SimulatorResourceServerImpl *, Batch> batches;
+        for (auto &entry : m_wheel.advance())
+        {
+            if (entry->cancelled)
+                continue;
+
+            entry->runningBatches++;
+            batches[entry->resource].push_back(entry);
+        }
+
+        for (auto &batch : batches)
+        {
+            Worker *worker = m_workers[std::hash<SimulatorResourceServerImpl *>()(batch.first)
+                                       % m_workers.size()].get();
+            worker->batches.push_back(std::move(batch.second));
+            worker->condition.notify_one();
+        }
+    }
+}
+
+void UpdateScheduler::runWorker(Worker *worker)
+{
+    s_isWorkerThread = true;
+    std::unique_lock<std::mutex> lock(m_lock);
+
+    while (true)
+    {
+        worker->condition.wait(lock, [this, worker]()
+        {
+            return m_stopRequested || !worker->batches.empty();
+        });
+
+        if (m_stopRequested)
+            break;
+
+        Batch batch = std::move(worker->batches.front());
+        worker->batches.pop_front();
+
+        lock.unlock();
+        runBatch(batch);
+        lock.lock();
+    }
+}
+
+void UpdateScheduler::runBatch(Batch &batch)
+{
+    std::vector<bool> cancelled(batch.size());
+    std::vector<bool> updated(batch.size(), false);
+    bool modelChanged = false;
+
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (size_t index = 0; index < batch.size(); index++)
+            cancelled[index] = batch[index]->cancelled;
+    }
+
+    for (size_t index = 0; index < batch.size(); index++)
+    {
+        if (cancelled[index])
+            continue;
+
+        try
+        {
+            updated[index] = batch[index]->update();
+        }
+        catch (SimulatorException &e)
+        {
+            OC_LOG_V(ERROR, TAG, "Update failed [%s]", e.what());
+        }
+        modelChanged = modelChanged || updated[index];
+    }
+
+    bool notified = true;
+    if (modelChanged)
+    {
+        try
+        {
+            batch.front()->resource->notifyUpdated();
+        }
+        catch (SimulatorException &e)
+        {
+            OC_LOG_V(ERROR, TAG, "Notification failed [%s]", e.what());
+            notified = false;
+        }
+    }
+
+    std::vector<EntrySP> finished;
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        for (size_t index = 0; index < batch.size(); index++)
+        {
+            EntrySP &entry = batch[index];
+            if (entry->cancelled)
+                continue;
+
+            if (updated[index] && notified)
+            {
+                m_wheel.insert(entry, entry->intervalTicks);
+            }
+            else
+            {
+                m_entries.erase(entry->id);
+                finished.push_back(entry);
+            }
+        }
+    }
+
+    for (auto &entry : finished)
+    {
+        if (entry->finished)
+            entry->finished();
+    }
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    for (auto &entry : batch)
+        entry->runningBatches--;
+    m_entryDone.notify_all();
+}
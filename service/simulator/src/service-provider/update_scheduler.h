@@ -0,0 +1,181 @@
+/******************************************************************
+ *
+ * Copyright 2015 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file   update_scheduler.h
+ *
+ * @brief   This file provides the scheduler which drives the update automations of
+ *          all the simulated resources.
+ */
+
+#ifndef UPDATE_SCHEDULER_H_
+#define UPDATE_SCHEDULER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+class SimulatorResourceServerImpl;
+
+/**
+ * @class   SchedulerWheel
+ * @brief   Timer wheel of the update scheduler. An item due after more ticks than the
+ *          wheel has slots stays in its slot for as many turns as needed.
+ */
+template <typename T>
+class SchedulerWheel
+{
+    public:
+        explicit SchedulerWheel(size_t size) : m_slots(size), m_currentSlot(0) {}
+
+        /**
+         * @param ticks - Number of ticks after which the item is due, at least 1.
+         */
+        void insert(const T &item, unsigned int ticks)
+        {
+            m_slots[(m_currentSlot + ticks - 1) % m_slots.size()].push_back(
+                std::make_pair((ticks - 1) / m_slots.size(), item));
+        }
+
+        /**
+         * Advances the wheel by a tick.
+         *
+         * @return Items which are due on the tick.
+         */
+        std::vector<T> advance()
+        {
+            std::vector<std::pair<size_t, T>> slot;
+            slot.swap(m_slots[m_currentSlot]);
+
+            std::vector<T> due;
+            for (auto &item : slot)
+            {
+                if (item.first > 0)
+                {
+                    // Wait for another turn in the same slot
+                    item.first--;
+                    m_slots[m_currentSlot].push_back(std::move(item));
+                }
+                else
+                {
+                    due.push_back(std::move(item.second));
+                }
+            }
+
+            m_currentSlot = (m_currentSlot + 1) % m_slots.size();
+            return due;
+        }
+
+    private:
+        // Items of each slot with the number of turns they still wait
+        std::vector<std::vector<std::pair<size_t, T>>> m_slots;
+        size_t m_currentSlot;
+};
+
+/**
+ * @class   UpdateScheduler
+ * @brief   Runs the attribute updates of all the automations from a timer wheel and a
+ *          fixed pool of worker threads, instead of a thread per automated attribute.
+ *          Updates of a resource which are due on the same tick are applied together and
+ *          notified to the observers and to the application once. All the updates of a
+ *          resource are run by the same worker, so they never run concurrently.
+ */
+class UpdateScheduler
+{
+    public:
+        /**
+         * Applies the next value to the resource model without notifying.
+         * Returns false once there is no value left, which ends the schedule.
+         */
+        typedef std::function<bool ()> UpdateFunction;
+        typedef std::function<void ()> FinishedCallback;
+
+        static UpdateScheduler *getInstance(void);
+
+        /**
+         * @param interval - Interval in milliseconds between the updates.
+         * @param finished - Called once the update function returned false.
+         *
+         * @return ID of the schedule.
+         */
+        int schedule(SimulatorResourceServerImpl *resource, int interval,
+                     UpdateFunction update, FinishedCallback finished);
+
+        /**
+         * Cancels a schedule. Once it returns, the update function and the finished callback
+         * of the schedule are not called anymore, unless it is called from the callbacks
+         * of the scheduler.
+         *
+         * @return true if the schedule was still running.
+         */
+        bool cancel(int id);
+
+    private:
+        struct Entry
+        {
+            int id;
+            SimulatorResourceServerImpl *resource;
+            unsigned int intervalTicks;
+            UpdateFunction update;
+            FinishedCallback finished;
+            bool cancelled;
+            // batches of the entry dispatched to a worker and not completed yet
+            unsigned int runningBatches;
+        };
+
+        typedef std::shared_ptr<Entry> EntrySP;
+        typedef std::vector<EntrySP> Batch;
+
+        struct Worker
+        {
+            std::thread thread;
+            std::condition_variable condition;
+            std::deque<Batch> batches;
+        };
+
+        UpdateScheduler();
+        ~UpdateScheduler();
+        UpdateScheduler(const UpdateScheduler &) = delete;
+        UpdateScheduler &operator=(const UpdateScheduler &) = delete;
+
+        void startThreads();
+        void runTimer();
+        void runWorker(Worker *worker);
+        void runBatch(Batch &batch);
+
+        std::mutex m_lock;
+        std::condition_variable m_timerCondition;
+        std::condition_variable m_entryDone;
+        bool m_started;
+        bool m_stopRequested;
+        int m_id;
+        std::map<int, EntrySP> m_entries;
+        SchedulerWheel<EntrySP> m_wheel;
+        std::thread m_timerThread;
+        std::vector<std::unique_ptr<Worker>> m_workers;
+};
+
+#endif
@@ -0,0 +1,77 @@
+/******************************************************************
+ *
+ * Copyright 2015 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "update_scheduler.h"
+
+#include <gtest/gtest.h>
+
+namespace
+{
+    constexpr unsigned int WHEEL_SIZE{ 8 };
+}
+
+TEST(SchedulerWheelTest, ItemIsDueAfterItsTicks)
+{
+    SchedulerWheel<unsigned int> wheel(WHEEL_SIZE);
+    wheel.insert(1, 1);
+    wheel.insert(3, 3);
+
+    EXPECT_EQ(std::vector<unsigned int>{ 1 }, wheel.advance());
+    EXPECT_TRUE(wheel.advance().empty());
+    EXPECT_EQ(std::vector<unsigned int>{ 3 }, wheel.advance());
+}
+
+TEST(SchedulerWheelTest, ItemIsDueAfterSeveralTurns)
+{
+    SchedulerWheel<unsigned int> wheel(WHEEL_SIZE);
+    for (unsigned int ticks : { WHEEL_SIZE, WHEEL_SIZE + 1, 3 * WHEEL_SIZE + 2 })
+    {
+        wheel.insert(ticks, ticks);
+    }
+
+    unsigned int numOfDue{ 0 };
+    for (unsigned int tick = 1; tick <= 4 * WHEEL_SIZE; tick++)
+    {
+        for (unsigned int item : wheel.advance())
+        {
+            EXPECT_EQ(item, tick);
+            numOfDue++;
+        }
+    }
+    EXPECT_EQ(3u, numOfDue);
+}
+
+TEST(SchedulerWheelTest, ReinsertedItemKeepsMultiTurnInterval)
+{
+    constexpr unsigned int interval{ 2 * WHEEL_SIZE + 3 };
+    SchedulerWheel<unsigned int> wheel(WHEEL_SIZE);
+    wheel.insert(interval, interval);
+
+    std::vector<unsigned int> dueTicks;
+    for (unsigned int tick = 1; tick <= 3 * interval; tick++)
+    {
+        for (unsigned int item : wheel.advance())
+        {
+            dueTicks.push_back(tick);
+            wheel.insert(item, item);
+        }
+    }
+    EXPECT_EQ((std::vector<unsigned int>{ interval, 2 * interval, 3 * interval }), dueTicks);
+}